@@ -12,8 +12,14 @@
 #include <sstream>
 #include <map>
 #include <queue>
+#include <cstdio>
+
+#include <unistd.h>
 
 #include "CCSDSLibrary/CCSDS.hh"
+#include "CCSDSLibrary/CCSDSCRC16.hh"
+#include "CCSDSLibrary/CCSDSFlightRecorder.hh"
+#include "CCSDSLibrary/TelemetryDataStruct.hh"
 
 /** A class that represents a complete ADU.
  */
@@ -33,12 +39,108 @@ public:
 
 public:
 	std::vector<uint8_t> data;
+	/** Shared payload; used instead of data when data is empty (see sharePayload()). */
+	CCSDSSharedPayload payload;
 
 public:
 	bool isTMPacket() const {
 		return packettype == 0;
 	}
 
+public:
+	/** Moves data into a shared payload (on the first call) and returns the payload.
+	 * After this call, data is empty and the bytes are accessed via payload
+	 * (or getPayloadData()/getPayloadSize()).
+	 */
+	const CCSDSSharedPayload& sharePayload() {
+		if (payload.empty() && !data.empty()) {
+			payload = CCSDSSharedPayload(std::move(data));
+			data.clear();
+		}
+		return payload;
+	}
+
+public:
+	/** Returns a pointer to the ADU data (in data or payload). */
+	const uint8_t* getPayloadData() const {
+		return data.empty() ? payload.data() : &data[0];
+	}
+
+public:
+	/** Returns the size of the ADU data (in data or payload). */
+	size_t getPayloadSize() const {
+		return data.empty() ? payload.size() : data.size();
+	}
+
+public:
+	/** Converts to sib2::SMCPPacketData. data is left intact; if this ADU already
+	 * shares its payload, the payload is shared, otherwise data is copied.
+	 * Use moveToSMCPPacketData() to avoid the copy.
+	 */
+	sib2::SMCPPacketData toSMCPPacketData() const {
+		sib2::SMCPPacketData smcp;
+		copyHeaderTo(smcp);
+		smcp.data = data;
+		smcp.payload = payload;
+		return smcp;
+	}
+
+public:
+	/** Converts to sib2::SMCPPacketData sharing the payload (the bytes are not copied).
+	 * data is moved into the shared payload (see sharePayload()) and becomes empty.
+	 */
+	sib2::SMCPPacketData moveToSMCPPacketData() {
+		sib2::SMCPPacketData smcp;
+		copyHeaderTo(smcp);
+		smcp.payload = sharePayload();
+		return smcp;
+	}
+
+public:
+	/** Converts to sib2::UserData. data is left intact; if this ADU already
+	 * shares its payload, the payload is shared, otherwise data is copied.
+	 * Use moveToUserData() to avoid the copy.
+	 */
+	sib2::UserData toUserData(uint16_t lowerFOID = 0, uint16_t attributeID = 0) const {
+		sib2::UserData userData;
+		copyIDTo(userData, lowerFOID, attributeID);
+		userData.data = data;
+		userData.payload = payload;
+		return userData;
+	}
+
+public:
+	/** Converts to sib2::UserData sharing the payload (the bytes are not copied).
+	 * data is moved into the shared payload (see sharePayload()) and becomes empty.
+	 */
+	sib2::UserData moveToUserData(uint16_t lowerFOID = 0, uint16_t attributeID = 0) {
+		sib2::UserData userData;
+		copyIDTo(userData, lowerFOID, attributeID);
+		userData.payload = sharePayload();
+		return userData;
+	}
+
+private:
+	void copyHeaderTo(sib2::SMCPPacketData& smcp) const {
+		smcp.packettype = packettype;
+		smcp.upperAPID = upperAPID;
+		smcp.lowerAPID = lowerAPID;
+		smcp.ADUChannelID = ADUChannelID;
+		smcp.ADUCount = ADUCount;
+		smcp.TI = TI;
+	}
+
+private:
+	void copyIDTo(sib2::UserData& userData, uint16_t lowerFOID, uint16_t attributeID) const {
+		userData.id.upperAPID = upperAPID;
+		userData.id.lowerAPID = lowerAPID;
+		userData.id.ADUChannelID = ADUChannelID;
+		userData.id.ADUCount = ADUCount;
+		userData.id.TI = TI;
+		userData.id.lowerFOID = lowerFOID;
+		userData.id.attributeID = attributeID;
+	}
+
 public:
 	bool isTCPacket() const {
 		return packettype == 1;
@@ -75,6 +177,56 @@ public:
 	std::string message;
 };
 
+/** Little-endian helpers for the checkpoint format of ADUUnsegmenter.
+ */
+class ADUCheckpointCodec {
+public:
+	static void append(std::vector<uint8_t>& output, uint64_t value, size_t nBytes) {
+		for (size_t i = 0; i < nBytes; i++) {
+			output.push_back((value >> (8 * i)) & 0xFF);
+		}
+	}
+
+public:
+	/** Reads integers and byte arrays from a checkpoint; throws ADUUnsegmenterException on underrun. */
+	class Reader {
+	private:
+		const uint8_t* p;
+		const uint8_t* end;
+
+	public:
+		Reader(const uint8_t* data, size_t length) {
+			this->p = data;
+			this->end = data + length;
+		}
+
+	public:
+		uint64_t read(size_t nBytes) {
+			const uint8_t* bytes = readBytes(nBytes);
+			uint64_t value = 0;
+			for (size_t i = 0; i < nBytes; i++) {
+				value |= (uint64_t) bytes[i] << (8 * i);
+			}
+			return value;
+		}
+
+	public:
+		const uint8_t* readBytes(size_t nBytes) {
+			if (nBytes > (size_t) (end - p)) {
+				throw ADUUnsegmenterException("CheckpointTruncated");
+			}
+			const uint8_t* bytes = p;
+			p += nBytes;
+			return bytes;
+		}
+
+	public:
+		size_t getNumberOfRemainingBytes() const {
+			return end - p;
+		}
+	};
+};
+
 /** A class that represents a collection of pending ADU segments (of a certain ADU Channel ID).
  */
 class ADUSegments {
@@ -106,6 +258,7 @@ private:
 		for (size_t i = 0; i < pendingPackets.size(); i++) {
 			delete pendingPackets[i];
 		}
+		CCSDS_METRICS_ADD(TotalPendingADUSegments, -(int64_t) pendingPackets.size());
 		pendingPackets.clear();
 	}
 
@@ -150,11 +303,13 @@ public:
 			adu->data.insert(adu->data.end(), nextdata->begin(), nextdata->end());
 		}
 		initialize();
+		CCSDS_METRICS_ADD(CompletedADUs, 1);
 		return adu;
 	}
 
 private:
 	void error_process(std::string message = "") {
+		CCSDS_METRICS_ADD(ADUSegmentErrors, 1);
 		initialize();
 		currentSegmentFlag = ErrorSegment;
 		throw ADUSegmentsException(message);
@@ -208,6 +363,7 @@ public:
 							<< (uint32_t) secondaryHeader->getADUChannelID() << endl;
 					ss << "ADUSegments::push(): ADU Segment Counter for ADU Channel ID " << hex << right << setw(2)
 							<< setfill('0') << (uint32_t) secondaryHeader->getADUChannelID() << " will be reset to 0." << endl;
+					CCSDS_METRICS_ADD(ADUSegmentCountJumps, 1);
 					error_process(ss.str());
 				}
 			}
@@ -219,6 +375,7 @@ public:
 				currentSegmentCount = secondaryHeader->getADUSegmentCount().to_ulong();
 				clearAndDeletePendingPackets();
 				pendingPackets.push_back(packet);
+				CCSDS_METRICS_ADD(TotalPendingADUSegments, 1);
 				complete = true;
 			} else {
 				currentSegmentFlag = secondaryHeader->getADUSegmentFlag().to_ulong();
@@ -231,6 +388,7 @@ public:
 				currentSegmentCount = secondaryHeader->getADUSegmentCount().to_ulong();
 				clearAndDeletePendingPackets();
 				pendingPackets.push_back(packet);
+				CCSDS_METRICS_ADD(TotalPendingADUSegments, 1);
 				complete = false;
 			} else {
 				currentSegmentFlag = secondaryHeader->getADUSegmentFlag().to_ulong();
@@ -243,6 +401,7 @@ public:
 				currentSegmentFlag = secondaryHeader->getADUSegmentFlag().to_ulong();
 				currentSegmentCount = secondaryHeader->getADUSegmentCount().to_ulong();
 				pendingPackets.push_back(packet);
+				CCSDS_METRICS_ADD(TotalPendingADUSegments, 1);
 				complete = false;
 			} else {
 				currentSegmentFlag = secondaryHeader->getADUSegmentFlag().to_ulong();
@@ -255,6 +414,7 @@ public:
 				currentSegmentFlag = secondaryHeader->getADUSegmentFlag().to_ulong();
 				currentSegmentCount = secondaryHeader->getADUSegmentCount().to_ulong();
 				pendingPackets.push_back(packet);
+				CCSDS_METRICS_ADD(TotalPendingADUSegments, 1);
 				complete = true;
 			} else {
 				currentSegmentFlag = secondaryHeader->getADUSegmentFlag().to_ulong();
@@ -266,6 +426,87 @@ public:
 		}
 	}
 
+public:
+	/** Deletes pending segments and resets the segment flag and count.
+	 */
+	void clear() {
+		initialize();
+	}
+
+public:
+	/** Appends the state (segment flag/count and pending packets) to a checkpoint.
+	 * Each pending packet is stored as a flag byte (bit 0: Packet Error Control used),
+	 * the Primary Header, and the Secondary Header and the User Data Field with their
+	 * lengths, so that the packet is restored field by field without re-interpretation.
+	 */
+	void serialize(std::vector<uint8_t>& output) const {
+		ADUCheckpointCodec::append(output, aduChannelID, 2);
+		ADUCheckpointCodec::append(output, watchADUSegmentCount ? 1 : 0, 1);
+		ADUCheckpointCodec::append(output, complete ? 1 : 0, 1);
+		ADUCheckpointCodec::append(output, (uint16_t) (int16_t) currentSegmentFlag, 2);
+		ADUCheckpointCodec::append(output, currentSegmentCount, 2);
+		ADUCheckpointCodec::append(output, pendingPackets.size(), 4);
+		for (size_t i = 0; i < pendingPackets.size(); i++) {
+			CCSDSSpacePacket* packet = pendingPackets[i];
+			ADUCheckpointCodec::append(output, packet->isPacketErrorControlUsed() ? 1 : 0, 1);
+			std::vector<uint8_t> primaryHeader = packet->getPrimaryHeader()->getAsByteVector();
+			output.insert(output.end(), primaryHeader.begin(), primaryHeader.end());
+			std::vector<uint8_t> secondaryHeader;
+			if (packet->isSecondaryHeaderPresent()) {
+				secondaryHeader = packet->getSecondaryHeader()->getAsByteVector();
+			}
+			ADUCheckpointCodec::append(output, secondaryHeader.size(), 4);
+			output.insert(output.end(), secondaryHeader.begin(), secondaryHeader.end());
+			std::vector<uint8_t>* userDataField = packet->getUserDataField();
+			ADUCheckpointCodec::append(output, userDataField->size(), 4);
+			output.insert(output.end(), userDataField->begin(), userDataField->end());
+		}
+	}
+
+public:
+	/** Replaces the state with one written by serialize() (after the ADU Channel ID).
+	 */
+	void deserialize(ADUCheckpointCodec::Reader& reader) {
+		initialize();
+		watchADUSegmentCount = (reader.read(1) != 0);
+		bool restoredComplete = (reader.read(1) != 0);
+		int restoredSegmentFlag = (int16_t) reader.read(2);
+		uint16_t restoredSegmentCount = reader.read(2);
+		size_t nPackets = reader.read(4);
+		for (size_t i = 0; i < nPackets; i++) {
+			bool packetErrorControlUsed = (reader.read(1) & 0x01) != 0;
+			const uint8_t* primaryHeader = reader.readBytes(CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength);
+			size_t secondaryHeaderLength = reader.read(4);
+			const uint8_t* secondaryHeader = reader.readBytes(secondaryHeaderLength);
+			size_t userDataFieldLength = reader.read(4);
+			const uint8_t* userDataField = reader.readBytes(userDataFieldLength);
+			CCSDSSpacePacket* packet = new CCSDSSpacePacket;
+			try {
+				packet->getPrimaryHeader()->interpret(primaryHeader);
+				if (packet->isSecondaryHeaderPresent() != (secondaryHeaderLength != 0)) {
+					throw CCSDSSpacePacketException(CCSDSSpacePacketException::SecondaryHeaderTooShort);
+				}
+				if (secondaryHeaderLength != 0) {
+					packet->getSecondaryHeader()->interpret(secondaryHeader, secondaryHeaderLength);
+					if (packet->getSecondaryHeader()->getLength() != secondaryHeaderLength) {
+						throw CCSDSSpacePacketException(CCSDSSpacePacketException::SecondaryHeaderTooShort);
+					}
+				}
+			} catch (CCSDSSpacePacketException& e) {
+				delete packet;
+				initialize();
+				throw ADUUnsegmenterException("CheckpointBrokenPacket");
+			}
+			packet->getUserDataField()->assign(userDataField, userDataField + userDataFieldLength);
+			packet->setPacketErrorControlUsed(packetErrorControlUsed);
+			pendingPackets.push_back(packet);
+			CCSDS_METRICS_ADD(TotalPendingADUSegments, 1);
+		}
+		complete = restoredComplete;
+		currentSegmentFlag = restoredSegmentFlag;
+		currentSegmentCount = restoredSegmentCount;
+	}
+
 public:
 	/** Returns a vector containing pointers to pending CCSDS SpacePackets.
 	 */
@@ -293,6 +534,8 @@ private:
 private:
 	ADUSegmentMap aduSegmentMap;
 	std::queue<ADU*> completedADUs;
+	CCSDSFlightRecorder* flightRecorder;
+	std::vector<uint8_t> checkpointBuffer;
 
 public:
 	uint16_t lowerAPID;
@@ -300,6 +543,19 @@ public:
 public:
 	ADUUnsegmenter(uint16_t lowerAPID) {
 		this->lowerAPID = lowerAPID;
+		this->flightRecorder = NULL;
+	}
+
+public:
+	/** Sets a flight recorder that records every pushed packet.
+	 * When a pushed packet cannot be interpreted or a reassembly error occurs,
+	 * CCSDSFlightRecorder::onError() is invoked
+	 * so that the recent packets of the APID/ADU Channel are dumped.
+	 * The recorder is not deleted by this class.
+	 * @param[in] flightRecorder a recorder, or NULL to disable recording.
+	 */
+	void setFlightRecorder(CCSDSFlightRecorder* flightRecorder) {
+		this->flightRecorder = flightRecorder;
 	}
 
 public:
@@ -329,10 +585,23 @@ public:
 	 * ADU via the popCompleteADU() method.
 	 * @param[in] ccsdsSpacePacketByteArray a CCSDS SpacePacket that contains an ADU segment
 	 */
-	void push(const std::vector<uint8_t>& ccsdsSpacePacketByteArray) throw (ADUUnsegmenterException,
+	void push(const std::vector<uint8_t>& ccsdsSpacePacketByteArray) CCSDS_THROWS(ADUUnsegmenterException,
 			CCSDSSpacePacketException) {
+		if (flightRecorder != NULL && ccsdsSpacePacketByteArray.size() != 0) {
+			flightRecorder->record(&ccsdsSpacePacketByteArray[0], ccsdsSpacePacketByteArray.size());
+		}
 		CCSDSSpacePacket* packet = new CCSDSSpacePacket;
-		packet->interpret(&ccsdsSpacePacketByteArray[0], ccsdsSpacePacketByteArray.size());
+		try {
+			packet->interpret(&ccsdsSpacePacketByteArray[0], ccsdsSpacePacketByteArray.size());
+		} catch (CCSDSSpacePacketException& e) {
+			delete packet;
+			if (flightRecorder != NULL && ccsdsSpacePacketByteArray.size() != 0) {
+				flightRecorder->onError(
+						flightRecorder->getKey(&ccsdsSpacePacketByteArray[0], ccsdsSpacePacketByteArray.size()),
+						e.toString());
+			}
+			throw;
+		}
 		if (packet->isTCPacket()) {
 			delete packet;
 			return;
@@ -355,6 +624,9 @@ public:
 		try {
 			segments->push(packet);
 		} catch (ADUSegmentsException& e) {
+			if (flightRecorder != NULL) {
+				flightRecorder->onError(flightRecorder->getKey(packet), e.toString());
+			}
 			throw ADUUnsegmenterException(e.toString());
 		}
 
@@ -378,7 +650,11 @@ public:
 	 * CCSDSSpacePacket instance should be taken care outside this method.
 	 * @param[in] ccsdsSpacePacketByteArray a CCSDS SpacePacket that contains an ADU segment
 	 */
-	void push(CCSDSSpacePacket* ccsdsSpacePacket) throw (ADUUnsegmenterException) {
+	void push(CCSDSSpacePacket* ccsdsSpacePacket) CCSDS_THROWS(ADUUnsegmenterException) {
+		//every pushed packet is recorded, as in push(const std::vector<uint8_t>&)
+		if (flightRecorder != NULL) {
+			flightRecorder->record(ccsdsSpacePacket);
+		}
 		if (ccsdsSpacePacket->isTCPacket()) {
 			return;
 		}
@@ -401,6 +677,9 @@ public:
 		try {
 			segments->push(packet);
 		} catch (ADUSegmentsException& e) {
+			if (flightRecorder != NULL) {
+				flightRecorder->onError(flightRecorder->getKey(packet), e.toString());
+			}
 			throw ADUUnsegmenterException(e.toString());
 		}
 
@@ -410,6 +689,175 @@ public:
 		}
 	}
 
+public:
+	static const uint16_t CheckpointVersion = 2;
+
+public:
+	/** Serializes the state into a checkpoint.
+	 * The checkpoint holds, for each ADU Channel, the segment flag/count used for continuity
+	 * checks and the pending segments (field by field), and the completed ADUs not yet popped.
+	 * Its size is about the total size of pending segments and completed ADUs.
+	 * Format (little endian): "ADUU", uint16 version, uint16 lowerAPID, uint32 nChannels,
+	 * channels, uint32 nCompletedADUs, ADUs, uint16 CRC-16 of the preceding bytes.
+	 * @param[out] output the checkpoint (replaced).
+	 */
+	void checkpoint(std::vector<uint8_t>& output) const {
+		output.clear();
+		const char* magic = "ADUU";
+		for (size_t i = 0; i < 4; i++) {
+			output.push_back(magic[i]);
+		}
+		ADUCheckpointCodec::append(output, CheckpointVersion, 2);
+		ADUCheckpointCodec::append(output, lowerAPID, 2);
+		ADUCheckpointCodec::append(output, aduSegmentMap.size(), 4);
+		for (auto it = aduSegmentMap.begin(); it != aduSegmentMap.end(); it++) {
+			it->second->serialize(output);
+		}
+		std::queue<ADU*> adus = completedADUs;
+		ADUCheckpointCodec::append(output, adus.size(), 4);
+		while (!adus.empty()) {
+			ADU* adu = adus.front();
+			adus.pop();
+			ADUCheckpointCodec::append(output, adu->packettype, 2);
+			ADUCheckpointCodec::append(output, adu->upperAPID, 2);
+			ADUCheckpointCodec::append(output, adu->lowerAPID, 2);
+			ADUCheckpointCodec::append(output, adu->ADUChannelID, 2);
+			ADUCheckpointCodec::append(output, adu->ADUCount, 1);
+			ADUCheckpointCodec::append(output, adu->category, 1);
+			ADUCheckpointCodec::append(output, adu->TI, 4);
+			ADUCheckpointCodec::append(output, adu->getPayloadSize(), 4);
+			output.insert(output.end(), adu->getPayloadData(), adu->getPayloadData() + adu->getPayloadSize());
+		}
+		ADUCheckpointCodec::append(output, CCSDSCRC16::calculate(&output[0], output.size()), 2);
+	}
+
+public:
+	/** Serializes the state into a checkpoint (see checkpoint(std::vector<uint8_t>&)). */
+	std::vector<uint8_t> checkpoint() const {
+		std::vector<uint8_t> output;
+		checkpoint(output);
+		return output;
+	}
+
+public:
+	/** Replaces the state with a checkpoint.
+	 * Pending segments and completed ADUs held before this call are deleted.
+	 * @throw ADUUnsegmenterException if the checkpoint is broken or was taken for another lower APID
+	 * (the state is then empty).
+	 */
+	void restore(const uint8_t* data, size_t length) CCSDS_THROWS(ADUUnsegmenterException) {
+		clear();
+		if (length < 14 || std::memcmp(data, "ADUU", 4) != 0) {
+			throw ADUUnsegmenterException("CheckpointBroken");
+		}
+		uint16_t crc = ((uint16_t) data[length - 1] << 8) | data[length - 2];
+		if (CCSDSCRC16::calculate(data, length - 2) != crc) {
+			throw ADUUnsegmenterException("CheckpointCRCMismatch");
+		}
+		ADUCheckpointCodec::Reader reader(data + 4, length - 6);
+		try {
+			if (reader.read(2) != CheckpointVersion) {
+				throw ADUUnsegmenterException("CheckpointVersionMismatch");
+			}
+			if (reader.read(2) != lowerAPID) {
+				throw ADUUnsegmenterException("CheckpointAPIDMismatch");
+			}
+			size_t nChannels = reader.read(4);
+			for (size_t i = 0; i < nChannels; i++) {
+				uint16_t aduChannelID = reader.read(2);
+				ADUSegments* segments = aduSegmentMap[aduChannelID];
+				if (segments == NULL) {
+					segments = new ADUSegments(aduChannelID);
+					aduSegmentMap[aduChannelID] = segments;
+				}
+				segments->deserialize(reader);
+			}
+			size_t nADUs = reader.read(4);
+			for (size_t i = 0; i < nADUs; i++) {
+				ADU* adu = new ADU;
+				completedADUs.push(adu);
+				adu->packettype = reader.read(2);
+				adu->upperAPID = reader.read(2);
+				adu->lowerAPID = reader.read(2);
+				adu->ADUChannelID = reader.read(2);
+				adu->ADUCount = reader.read(1);
+				adu->category = reader.read(1);
+				adu->TI = reader.read(4);
+				size_t size = reader.read(4);
+				const uint8_t* bytes = reader.readBytes(size);
+				adu->data.assign(bytes, bytes + size);
+			}
+			if (reader.getNumberOfRemainingBytes() != 0) {
+				throw ADUUnsegmenterException("CheckpointBroken");
+			}
+		} catch (ADUUnsegmenterException& e) {
+			clear();
+			throw;
+		}
+	}
+
+public:
+	/** Replaces the state with a checkpoint (see restore(const uint8_t*, size_t)). */
+	void restore(const std::vector<uint8_t>& checkpoint) CCSDS_THROWS(ADUUnsegmenterException) {
+		if (checkpoint.empty()) {
+			throw ADUUnsegmenterException("CheckpointBroken");
+		}
+		restore(&checkpoint[0], checkpoint.size());
+	}
+
+public:
+	/** Writes a checkpoint to a file.
+	 * The checkpoint is written to filename + ".tmp" and then renamed, so the file always
+	 * holds a complete checkpoint even if the process stops while writing.
+	 */
+	void saveCheckpoint(std::string filename) CCSDS_THROWS(ADUUnsegmenterException) {
+		checkpoint(checkpointBuffer);
+		std::string temporaryFilename = filename + ".tmp";
+		FILE* file = fopen(temporaryFilename.c_str(), "wb");
+		if (file == NULL) {
+			throw ADUUnsegmenterException("CannotOpen " + temporaryFilename);
+		}
+		bool failed = (fwrite(&checkpointBuffer[0], 1, checkpointBuffer.size(), file) != checkpointBuffer.size());
+		//the data must reach the disk before rename() replaces the previous checkpoint
+		failed = failed || (fflush(file) != 0) || (fsync(fileno(file)) != 0);
+		failed = (fclose(file) != 0) || failed;
+		if (failed || std::rename(temporaryFilename.c_str(), filename.c_str()) != 0) {
+			throw ADUUnsegmenterException("CannotWrite " + filename);
+		}
+	}
+
+public:
+	/** Restores the state from a file written by saveCheckpoint(). */
+	void loadCheckpoint(std::string filename) CCSDS_THROWS(ADUUnsegmenterException) {
+		FILE* file = fopen(filename.c_str(), "rb");
+		if (file == NULL) {
+			throw ADUUnsegmenterException("CannotOpen " + filename);
+		}
+		checkpointBuffer.clear();
+		std::vector<uint8_t> chunk(65536);
+		size_t n;
+		while ((n = fread(&chunk[0], 1, chunk.size(), file)) != 0) {
+			checkpointBuffer.insert(checkpointBuffer.end(), chunk.begin(), chunk.begin() + n);
+		}
+		fclose(file);
+		restore(checkpointBuffer);
+	}
+
+public:
+	/** Deletes pending segments of all ADU Channels and completed ADUs not yet popped.
+	 */
+	void clear() {
+		for (auto it = aduSegmentMap.begin(); it != aduSegmentMap.end(); it++) {
+			it->second->clear();
+			delete it->second;
+		}
+		aduSegmentMap.clear();
+		while (!completedADUs.empty()) {
+			delete completedADUs.front();
+			completedADUs.pop();
+		}
+	}
+
 public:
 	/** Return true if there is a complete ADU in the internal buffer.
 	 */
@@ -424,7 +872,7 @@ public:
 	 * internal buffer, nullptr will be returned.
 	 * @return a pointer to a complete ADU instance
 	 */
-	ADU* popCompletedADU() throw (ADUUnsegmenterException) {
+	ADU* popCompletedADU() CCSDS_THROWS(ADUUnsegmenterException) {
 		if (!completedADUs.empty()) {
 			ADU* product = completedADUs.front();
 			completedADUs.pop();
@@ -9,5 +9,6 @@
 #define CCSDS_HH_
 
 #include "CCSDSSpacePacket.hh"
+#include "CCSDSSpacePacketView.hh"
 
 #endif /* CCSDS_HH_ */
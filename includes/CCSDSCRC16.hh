@@ -0,0 +1,197 @@
+/*
+ * CCSDSCRC16.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSCRC16_HH_
+#define CCSDSCRC16_HH_
+
+#include <cstddef>
+#include <cstring>
+
+#if (defined(__GXX_EXPERIMENTAL_CXX0X) || (__cplusplus >= 201103L))
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(CCSDS_DISABLE_CLMUL)
+#define CCSDS_CRC16_HAS_CLMUL 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+/** A class that calculates the CRC-16-CCITT used by the Packet Error Control
+ * field of CCSDS SpacePackets (polynomial x^16+x^12+x^5+1, initial value 0xFFFF,
+ * no reflection, no final XOR).
+ *
+ * Data are processed 8 bytes at a time with slicing-by-8 tables. On x86 processors
+ * that support PCLMULQDQ, long inputs are folded 16 bytes at a time with carry-less
+ * multiplication; the kernel is selected at run time (define CCSDS_DISABLE_CLMUL
+ * to compile it out).
+ *
+ * @par
+ * Example:
+ * @code
+ uint16_t crc = CCSDSCRC16::calculate(data, length);
+ bool valid = CCSDSCRC16::verify(packet, packetLength); //the last 2 bytes hold the CRC
+ * @endcode
+ */
+class CCSDSCRC16 {
+public:
+	static const uint16_t Polynomial = 0x1021;
+	static const uint16_t InitialValue = 0xFFFF;
+
+	/** Inputs shorter than this are processed with tables even if PCLMULQDQ is available. */
+	static const size_t MinimumLengthForCLMUL = 64;
+
+private:
+	class Tables {
+	public:
+		uint16_t table[8][256];
+
+		Tables() {
+			for (uint32_t b = 0; b < 256; b++) {
+				uint16_t crc = b << 8;
+				for (size_t bit = 0; bit < 8; bit++) {
+					crc = (crc & 0x8000) ? ((crc << 1) ^ Polynomial) : (crc << 1);
+				}
+				table[0][b] = crc;
+			}
+			for (size_t k = 1; k < 8; k++) {
+				for (uint32_t b = 0; b < 256; b++) {
+					uint16_t previous = table[k - 1][b];
+					table[k][b] = (previous << 8) ^ table[0][previous >> 8];
+				}
+			}
+		}
+	};
+
+	static const Tables& getTables() {
+		static const Tables tables;
+		return tables;
+	}
+
+public:
+	/** Calculates CRC-16 with the fastest kernel available on this processor.
+	 * @param[in] data a pointer to a byte array.
+	 * @param[in] length the length of the byte array.
+	 * @param[in] crc initial value, or the result of a previous call to continue a calculation.
+	 */
+	static uint16_t calculate(const uint8_t* data, size_t length, uint16_t crc = InitialValue) {
+#ifdef CCSDS_CRC16_HAS_CLMUL
+		if (length >= MinimumLengthForCLMUL && isCLMULAvailable()) {
+			return calculateCLMUL(data, length, crc);
+		}
+#endif
+		return calculateSlicingBy8(data, length, crc);
+	}
+
+public:
+	/** Calculates CRC-16 with slicing-by-8 tables. */
+	static uint16_t calculateSlicingBy8(const uint8_t* data, size_t length, uint16_t crc = InitialValue) {
+		const Tables& t = getTables();
+		while (length >= 8) {
+			crc = t.table[7][data[0] ^ (crc >> 8)] ^ t.table[6][data[1] ^ (crc & 0xFF)] ^ t.table[5][data[2]]
+					^ t.table[4][data[3]] ^ t.table[3][data[4]] ^ t.table[2][data[5]] ^ t.table[1][data[6]]
+					^ t.table[0][data[7]];
+			data += 8;
+			length -= 8;
+		}
+		for (size_t i = 0; i < length; i++) {
+			crc = (crc << 8) ^ t.table[0][(crc >> 8) ^ data[i]];
+		}
+		return crc;
+	}
+
+public:
+	/** Checks a byte array whose last two bytes hold a CRC-16 (big endian) of the preceding bytes.
+	 * @param[in] data a pointer to a byte array such as a whole packet with Packet Error Control.
+	 * @param[in] length the length of the byte array including the CRC.
+	 * @returns true if the CRC matches.
+	 */
+	static bool verify(const uint8_t* data, size_t length) {
+		if (length < 2) {
+			return false;
+		}
+		uint16_t expected = ((uint16_t) data[length - 2] << 8) + data[length - 1];
+		return calculate(data, length - 2) == expected;
+	}
+
+#ifdef CCSDS_CRC16_HAS_CLMUL
+public:
+	/** True if the processor supports PCLMULQDQ and SSSE3. */
+	static bool isCLMULAvailable() {
+		static const bool available = detectCLMUL();
+		return available;
+	}
+
+private:
+	static bool detectCLMUL() {
+		unsigned int eax, ebx, ecx, edx;
+		if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) {
+			return false;
+		}
+		return (ecx & bit_PCLMUL) != 0 && (ecx & bit_SSSE3) != 0;
+	}
+
+private:
+	/** Returns x^n mod P. */
+	static uint64_t xPowerModP(size_t n) {
+		uint32_t value = 1;
+		for (size_t i = 0; i < n; i++) {
+			value <<= 1;
+			if (value & 0x10000) {
+				value ^= 0x10000 | Polynomial;
+			}
+		}
+		return value;
+	}
+
+public:
+	/** Calculates CRC-16 by folding 16-byte blocks with PCLMULQDQ.
+	 * Must be called only when isCLMULAvailable() returns true.
+	 */
+	__attribute__((target("pclmul,ssse3")))
+	static uint16_t calculateCLMUL(const uint8_t* data, size_t length, uint16_t crc = InitialValue) {
+		if (length < 32) {
+			return calculateSlicingBy8(data, length, crc);
+		}
+		static const uint64_t k128 = xPowerModP(128);
+		static const uint64_t k192 = xPowerModP(192);
+		const __m128i constants = _mm_set_epi64x(k192, k128);
+		const __m128i byteReverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+		//x holds the message processed so far as a 128-bit polynomial congruent modulo P;
+		//the initial value is added to the leading 16 bits of the message
+		__m128i x = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) data), byteReverse);
+		x = _mm_xor_si128(x, _mm_set_epi64x((uint64_t) crc << 48, 0));
+		data += 16;
+		length -= 16;
+		while (length >= 16) {
+			__m128i block = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) data), byteReverse);
+			__m128i high = _mm_clmulepi64_si128(x, constants, 0x11);
+			__m128i low = _mm_clmulepi64_si128(x, constants, 0x00);
+			x = _mm_xor_si128(_mm_xor_si128(high, low), block);
+			data += 16;
+			length -= 16;
+		}
+
+		//reduce the remaining 128-bit polynomial with tables, then process the tail
+		uint8_t folded[16];
+		_mm_storeu_si128((__m128i*) folded, _mm_shuffle_epi8(x, byteReverse));
+		crc = calculateSlicingBy8(folded, 16, 0x0000);
+		return calculateSlicingBy8(data, length, crc);
+	}
+#else
+public:
+	/** True if the processor supports PCLMULQDQ and SSSE3. */
+	static bool isCLMULAvailable() {
+		return false;
+	}
+#endif
+};
+
+#endif /* CCSDSCRC16_HH_ */
@@ -0,0 +1,260 @@
+/*
+ * CCSDSCurrentValueTable.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSCURRENTVALUETABLE_HH_
+#define CCSDSCURRENTVALUETABLE_HH_
+
+#include "TelemetryDataStruct.hh"
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+/** A table that holds the latest value of each telemetry item, keyed by sib2::ID.
+ * Items are identified by upperAPID, lowerAPID, ADUChannelID, lowerFOID and
+ * attributeID; ADUCount and TI of the latest update are stored with the value
+ * (and returned in the ID of get()).
+ *
+ * The table is an open-addressing hash table (linear probing on sib2::ID::hash())
+ * whose slots and value storage are allocated at construction, so update() never
+ * allocates. Items are never removed. One writer thread may call update() while
+ * any number of reader threads call get()/snapshot(): each slot is protected by a
+ * sequence counter (seqlock), so readers do not block the writer and retry only
+ * when they overlap an update of the same item.
+ *
+ * @par
+ * Example:
+ * @code
+ CCSDSCurrentValueTable table(4096, 256);
+ //writer thread
+ table.update(userData);
+ //display thread
+ sib2::UserData latest;
+ if (table.get(id, latest)) {
+ 	...latest.data...
+ }
+ * @endcode
+ */
+class CCSDSCurrentValueTable {
+private:
+	class Slot {
+	public:
+		std::atomic<uint32_t> occupied;
+		sib2::ID key;
+		std::atomic<uint64_t> sequence;
+		std::atomic<uint64_t> updateCount;
+		std::atomic<uint32_t> length;
+		std::atomic<uint32_t> ti;
+		std::atomic<uint32_t> aduCount;
+	};
+
+private:
+	size_t maxItems;
+	size_t maxValueSize;
+	size_t nWordsPerValue;
+	size_t capacity;
+	Slot* slots;
+	std::atomic<uint64_t>* words;
+	std::atomic<size_t> nItems;
+	uint64_t nRejectedUpdates;
+
+public:
+	/** Constructs a table.
+	 * @param[in] maxItems maximum number of items.
+	 * @param[in] maxValueSize maximum size of a value in bytes.
+	 */
+	CCSDSCurrentValueTable(size_t maxItems, size_t maxValueSize) {
+		this->maxItems = (maxItems == 0) ? 1 : maxItems;
+		this->maxValueSize = maxValueSize;
+		this->nWordsPerValue = (maxValueSize + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+		//load factor is kept at or below 0.5
+		this->capacity = 1;
+		while (this->capacity < this->maxItems * 2) {
+			this->capacity <<= 1;
+		}
+		this->slots = new Slot[capacity];
+		for (size_t i = 0; i < capacity; i++) {
+			slots[i].occupied.store(0, std::memory_order_relaxed);
+			slots[i].sequence.store(0, std::memory_order_relaxed);
+			slots[i].updateCount.store(0, std::memory_order_relaxed);
+			slots[i].length.store(0, std::memory_order_relaxed);
+			slots[i].ti.store(0, std::memory_order_relaxed);
+			slots[i].aduCount.store(0, std::memory_order_relaxed);
+		}
+		size_t nWords = capacity * nWordsPerValue;
+		this->words = new std::atomic<uint64_t>[(nWords == 0) ? 1 : nWords];
+		for (size_t i = 0; i < nWords; i++) {
+			words[i].store(0, std::memory_order_relaxed);
+		}
+		this->nItems.store(0, std::memory_order_relaxed);
+		this->nRejectedUpdates = 0;
+	}
+
+public:
+	~CCSDSCurrentValueTable() {
+		delete[] slots;
+		delete[] words;
+	}
+
+private:
+	CCSDSCurrentValueTable(const CCSDSCurrentValueTable&);
+	CCSDSCurrentValueTable& operator=(const CCSDSCurrentValueTable&);
+
+private:
+	static inline sib2::ID getItemKey(const sib2::ID& id) {
+		sib2::ID key = id;
+		key.ADUCount = 0;
+		key.TI = 0;
+		return key;
+	}
+
+private:
+	/** Returns the slot of an item, or NULL if the item is not in the table. */
+	inline const Slot* find(const sib2::ID& key) const {
+		size_t index = key.hash() & (capacity - 1);
+		while (slots[index].occupied.load(std::memory_order_acquire) != 0) {
+			if (slots[index].key == key) {
+				return &slots[index];
+			}
+			index = (index + 1) & (capacity - 1);
+		}
+		return NULL;
+	}
+
+public:
+	/** Stores the latest value of an item (single writer).
+	 * @returns false if the value exceeds maxValueSize or the table is full.
+	 */
+	bool update(const sib2::ID& id, const uint8_t* data, size_t length) {
+		if (length > maxValueSize) {
+			nRejectedUpdates++;
+			return false;
+		}
+		sib2::ID key = getItemKey(id);
+		size_t index = key.hash() & (capacity - 1);
+		while (slots[index].occupied.load(std::memory_order_relaxed) != 0 && slots[index].key != key) {
+			index = (index + 1) & (capacity - 1);
+		}
+		Slot& slot = slots[index];
+		bool isNewItem = (slot.occupied.load(std::memory_order_relaxed) == 0);
+		if (isNewItem) {
+			if (nItems.load(std::memory_order_relaxed) == maxItems) {
+				nRejectedUpdates++;
+				return false;
+			}
+			slot.key = key;
+		}
+		uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+		slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		std::atomic<uint64_t>* value = &words[index * nWordsPerValue];
+		for (size_t i = 0; i * sizeof(uint64_t) < length; i++) {
+			uint64_t word = 0;
+			size_t n = (length - i * sizeof(uint64_t) < sizeof(uint64_t)) ? length - i * sizeof(uint64_t) : sizeof(uint64_t);
+			std::memcpy(&word, data + i * sizeof(uint64_t), n);
+			value[i].store(word, std::memory_order_relaxed);
+		}
+		slot.length.store(length, std::memory_order_relaxed);
+		slot.ti.store(id.TI, std::memory_order_relaxed);
+		slot.aduCount.store(id.ADUCount, std::memory_order_relaxed);
+		slot.updateCount.store(slot.updateCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		slot.sequence.store(sequence + 2, std::memory_order_release);
+		if (isNewItem) {
+			//published only after the first value is complete, so readers never see an empty item
+			slot.occupied.store(1, std::memory_order_release);
+			nItems.fetch_add(1, std::memory_order_relaxed);
+		}
+		return true;
+	}
+
+public:
+	/** Stores the latest value of an item (single writer). */
+	bool update(const sib2::UserData& userData) {
+		return update(userData.id, userData.getPayloadData(), userData.getPayloadSize());
+	}
+
+private:
+	void read(const Slot* slot, sib2::UserData& userData, uint64_t* updateCount) const {
+		const std::atomic<uint64_t>* value = &words[(slot - slots) * nWordsPerValue];
+		while (true) {
+			uint64_t before = slot->sequence.load(std::memory_order_acquire);
+			if (before % 2 != 0) {
+				continue;
+			}
+			size_t length = slot->length.load(std::memory_order_relaxed);
+			if (length > maxValueSize) {
+				continue;
+			}
+			userData.data.resize(length);
+			for (size_t i = 0; i * sizeof(uint64_t) < length; i++) {
+				uint64_t word = value[i].load(std::memory_order_relaxed);
+				size_t n = (length - i * sizeof(uint64_t) < sizeof(uint64_t)) ? length - i * sizeof(uint64_t) : sizeof(uint64_t);
+				std::memcpy(&userData.data[i * sizeof(uint64_t)], &word, n);
+			}
+			uint32_t ti = slot->ti.load(std::memory_order_relaxed);
+			uint32_t aduCount = slot->aduCount.load(std::memory_order_relaxed);
+			uint64_t count = slot->updateCount.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (slot->sequence.load(std::memory_order_relaxed) == before) {
+				userData.id = slot->key;
+				userData.id.TI = ti;
+				userData.id.ADUCount = aduCount;
+				userData.payload.reset();
+				if (updateCount != NULL) {
+					*updateCount = count;
+				}
+				return;
+			}
+		}
+	}
+
+public:
+	/** Copies the latest value of an item.
+	 * @param[in] id item ID (ADUCount and TI are ignored).
+	 * @param[out] userData the latest value and its ID (with ADUCount and TI of the update).
+	 * @param[out] updateCount if not NULL, the number of updates of the item so far.
+	 * @returns false if the item has not been updated.
+	 */
+	bool get(const sib2::ID& id, sib2::UserData& userData, uint64_t* updateCount = NULL) const {
+		const Slot* slot = find(getItemKey(id));
+		if (slot == NULL) {
+			return false;
+		}
+		read(slot, userData, updateCount);
+		return true;
+	}
+
+public:
+	/** Returns the latest values of all items (each item is consistent; items are read one by one). */
+	std::vector<sib2::UserData> snapshot() const {
+		std::vector<sib2::UserData> result;
+		for (size_t i = 0; i < capacity; i++) {
+			if (slots[i].occupied.load(std::memory_order_acquire) != 0) {
+				result.push_back(sib2::UserData());
+				read(&slots[i], result.back(), NULL);
+			}
+		}
+		return result;
+	}
+
+public:
+	size_t getNumberOfItems() const {
+		return nItems.load(std::memory_order_relaxed);
+	}
+
+public:
+	size_t getMaximumNumberOfItems() const {
+		return maxItems;
+	}
+
+public:
+	/** Returns the number of updates rejected because of value size or table capacity (writer thread). */
+	uint64_t getNumberOfRejectedUpdates() const {
+		return nRejectedUpdates;
+	}
+};
+
+#endif /* CCSDSCURRENTVALUETABLE_HH_ */
@@ -0,0 +1,500 @@
+/*
+ * CCSDSDecommutator.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSDECOMMUTATOR_HH_
+#define CCSDSDECOMMUTATOR_HH_
+
+#include "CCSDSSpacePacketView.hh"
+#include "CCSDSPacketLayout.hh"
+#include "ADUUnsegmenter.hh"
+#include "TelemetryDataStruct.hh"
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#if !defined(CCSDS_DISABLE_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CCSDS_DECOMMUTATOR_HAS_AVX2 1
+#endif
+
+class CCSDSDecommutatorException {
+public:
+	CCSDSDecommutatorException(std::string str) {
+		message = str;
+	}
+
+public:
+	std::string toString() {
+		return message;
+	}
+
+public:
+	std::string message;
+};
+
+/** A parameter of a packet loaded at run time (e.g. from a mission database).
+ * The location is a bit offset from the top of the User Data Field (or ADU data),
+ * with the same rules as CCSDSField.
+ */
+class CCSDSParameterDefinition {
+public:
+	std::string name;
+	uint16_t apid;
+	size_t bitOffset;
+	size_t width;
+	int endianness;
+	bool isSigned;
+
+public:
+	CCSDSParameterDefinition(std::string name, uint16_t apid, size_t bitOffset, size_t width,
+			int endianness = CCSDSFieldEndianness::BigEndian, bool isSigned = false) {
+		this->name = name;
+		this->apid = apid;
+		this->bitOffset = bitOffset;
+		this->width = width;
+		this->endianness = endianness;
+		this->isSigned = isSigned;
+	}
+};
+
+/** Columnar output of CCSDSDecommutator.
+ * values[i] holds parameter i for every packet of its APID in the batch, and
+ * getRows(i) holds the batch indices of those packets (in batch order).
+ * Signed parameters are sign-extended; unsigned 64-bit parameters are stored
+ * with the same bit pattern.
+ */
+class CCSDSDecommutationResult {
+public:
+	std::vector<std::vector<int64_t> > values;
+	std::vector<std::vector<uint32_t> > rows;
+	std::vector<size_t> planIndices;
+
+public:
+	/** Returns the batch indices of the values of a parameter. */
+	const std::vector<uint32_t>& getRows(size_t parameterIndex) const {
+		return rows[planIndices[parameterIndex]];
+	}
+
+public:
+	/** Returns the values of a parameter. */
+	const std::vector<int64_t>& getValues(size_t parameterIndex) const {
+		return values[parameterIndex];
+	}
+};
+
+/** A table-driven decommutation engine for batches of packets.
+ * Parameter definitions are compiled into one execution plan per APID. A plan
+ * is a list of instructions (byte offset, shift, mask, sign bit) that extract
+ * a parameter from one 8-byte load. A batch is first bucketed by APID, and then
+ * each instruction is executed over the packets of its APID, so that the values
+ * of a parameter are written contiguously (columnar output).
+ *
+ * When the CPU supports AVX2 (detected at run time), an instruction is executed
+ * on 4 packets at once: one 64-bit gather loads the parameter from 4 packets,
+ * followed by a byte swap, shift, mask and sign extension, and one store into
+ * the column. Parameters whose 8-byte load would cross the end of the shortest
+ * packet of the plan are extracted with a scalar byte loop. A field must fit in
+ * one 8-byte load (bitOffset % 8 + width <= 64), which addParameter() enforces.
+ * The scalar fallback produces identical results.
+ * SIMD can be disabled at build time by defining CCSDS_DISABLE_SIMD.
+ *
+ * An instance must be used by one thread at a time.
+ *
+ * @par
+ * Example:
+ * @code
+ CCSDSDecommutator decommutator;
+ size_t voltage = decommutator.addParameter(CCSDSParameterDefinition("BusVoltage", 0x123, 0, 16));
+ size_t temperature = decommutator.addParameter(
+ 		CCSDSParameterDefinition("Temperature", 0x123, 16, 12, CCSDSFieldEndianness::BigEndian, true));
+ CCSDSDecommutationResult result;
+ decommutator.decommutate(views, result);
+ for (size_t i = 0; i < result.getRows(voltage).size(); i++) {
+ 	...result.getValues(voltage)[i]...
+ }
+ * @endcode
+ */
+class CCSDSDecommutator {
+public:
+	static const size_t NAPIDs = 2048;
+	/** Number of packets processed per block (keeps a block of packets in cache across instructions). */
+	static const size_t BlockSize = 256;
+
+private:
+	class Instruction {
+	public:
+		size_t parameterIndex;
+		uint32_t byteOffset;
+		uint32_t byteLength;
+		uint32_t shift;
+		uint64_t mask;
+		uint64_t signBit;
+		bool littleEndian;
+		bool isSigned;
+	};
+
+	class Plan {
+	public:
+		uint16_t apid;
+		size_t requiredLength;
+		/** Extracted with one 8-byte load (vectorizable). */
+		std::vector<Instruction> wordInstructions;
+		/** Extracted with a byte loop. */
+		std::vector<Instruction> byteInstructions;
+	};
+
+	class Input {
+	public:
+		const uint8_t* data;
+		size_t length;
+		uint16_t apid;
+	};
+
+private:
+	std::vector<CCSDSParameterDefinition> parameters;
+	std::vector<Plan> plans;
+	std::vector<int32_t> planTable;
+	bool compiled;
+	bool simdEnabled;
+	std::vector<Input> inputs;
+	std::vector<std::vector<const uint8_t*> > pointers;
+	std::vector<int64_t> relativeAddresses;
+	uint64_t nExtractedParameters;
+	uint64_t nSkippedPackets;
+	uint64_t nShortPackets;
+
+public:
+	CCSDSDecommutator() {
+		this->compiled = false;
+		this->simdEnabled = true;
+		this->nExtractedParameters = 0;
+		this->nSkippedPackets = 0;
+		this->nShortPackets = 0;
+	}
+
+public:
+	/** Adds a parameter.
+	 * Throws CCSDSDecommutatorException if the field does not fit in one 8-byte load
+	 * (bitOffset % 8 + width > 64), or if a little-endian field is not byte-aligned.
+	 * @returns the parameter index (the column index in CCSDSDecommutationResult).
+	 */
+	size_t addParameter(const CCSDSParameterDefinition& parameter) {
+		if (parameter.apid >= NAPIDs) {
+			throw CCSDSDecommutatorException("CCSDSDecommutator: invalid APID for " + parameter.name);
+		}
+		if (parameter.width < 1 || parameter.bitOffset % 8 + parameter.width > 64) {
+			throw CCSDSDecommutatorException("CCSDSDecommutator: invalid width for " + parameter.name);
+		}
+		if (parameter.endianness == CCSDSFieldEndianness::LittleEndian
+				&& (parameter.bitOffset % 8 != 0 || parameter.width % 8 != 0)) {
+			throw CCSDSDecommutatorException("CCSDSDecommutator: little-endian parameter must be byte-aligned: " + parameter.name);
+		}
+		parameters.push_back(parameter);
+		compiled = false;
+		return parameters.size() - 1;
+	}
+
+public:
+	/** Returns the index of a parameter, or throws CCSDSDecommutatorException. */
+	size_t getParameterIndex(const std::string& name) const {
+		for (size_t i = 0; i < parameters.size(); i++) {
+			if (parameters[i].name == name) {
+				return i;
+			}
+		}
+		throw CCSDSDecommutatorException("CCSDSDecommutator: no such parameter " + name);
+	}
+
+public:
+	size_t getNumberOfParameters() const {
+		return parameters.size();
+	}
+
+public:
+	const CCSDSParameterDefinition& getParameterDefinition(size_t parameterIndex) const {
+		return parameters.at(parameterIndex);
+	}
+
+public:
+	/** Builds execution plans (called automatically by decommutate() after parameters are added). */
+	void compile() {
+		plans.clear();
+		planTable.assign(NAPIDs, -1);
+		for (size_t i = 0; i < parameters.size(); i++) {
+			const CCSDSParameterDefinition& parameter = parameters[i];
+			if (planTable[parameter.apid] < 0) {
+				planTable[parameter.apid] = plans.size();
+				plans.push_back(Plan());
+				plans.back().apid = parameter.apid;
+				plans.back().requiredLength = 0;
+			}
+			Plan& plan = plans[planTable[parameter.apid]];
+			Instruction instruction;
+			instruction.parameterIndex = i;
+			instruction.byteOffset = parameter.bitOffset / 8;
+			instruction.byteLength = (parameter.bitOffset % 8 + parameter.width + 7) / 8;
+			instruction.mask = (parameter.width == 64) ? ~(uint64_t) 0 : (((uint64_t) 1 << parameter.width) - 1);
+			instruction.signBit = (uint64_t) 1 << (parameter.width - 1);
+			instruction.littleEndian = (parameter.endianness == CCSDSFieldEndianness::LittleEndian);
+			instruction.isSigned = parameter.isSigned;
+			instruction.shift = instruction.littleEndian ? 0 : 64 - parameter.bitOffset % 8 - parameter.width;
+			if (plan.requiredLength < instruction.byteOffset + instruction.byteLength) {
+				plan.requiredLength = instruction.byteOffset + instruction.byteLength;
+			}
+			plan.byteInstructions.push_back(instruction);
+		}
+		//instructions whose 8-byte load stays within the shortest accepted packet use word loads
+		for (size_t p = 0; p < plans.size(); p++) {
+			Plan& plan = plans[p];
+			std::vector<Instruction> all;
+			all.swap(plan.byteInstructions);
+			for (size_t i = 0; i < all.size(); i++) {
+				if (all[i].byteOffset + 8 <= plan.requiredLength) {
+					plan.wordInstructions.push_back(all[i]);
+				} else {
+					plan.byteInstructions.push_back(all[i]);
+				}
+			}
+		}
+		compiled = true;
+	}
+
+public:
+	/** Decommutates a batch of packet views (row index = index in the vector). */
+	void decommutate(const std::vector<CCSDSSpacePacketView>& views, CCSDSDecommutationResult& result) {
+		inputs.resize(views.size());
+		for (size_t i = 0; i < views.size(); i++) {
+			inputs[i].data = views[i].getUserDataField();
+			inputs[i].length = views[i].getUserDataFieldLength();
+			inputs[i].apid = views[i].getAPIDAsInteger();
+		}
+		execute(result);
+	}
+
+public:
+	/** Decommutates a batch of completed ADUs (the APID is upperAPID << 8 | lowerAPID). */
+	void decommutate(const std::vector<ADU*>& adus, CCSDSDecommutationResult& result) {
+		inputs.resize(adus.size());
+		for (size_t i = 0; i < adus.size(); i++) {
+			inputs[i].data = adus[i]->getPayloadData();
+			inputs[i].length = adus[i]->getPayloadSize();
+			inputs[i].apid = ((adus[i]->upperAPID << 8) | adus[i]->lowerAPID) & 0x7FF;
+		}
+		execute(result);
+	}
+
+public:
+	/** Decommutates a batch of sib2::UserData (the APID is id.upperAPID << 8 | id.lowerAPID). */
+	void decommutate(const std::vector<sib2::UserData>& userData, CCSDSDecommutationResult& result) {
+		inputs.resize(userData.size());
+		for (size_t i = 0; i < userData.size(); i++) {
+			inputs[i].data = userData[i].getPayloadData();
+			inputs[i].length = userData[i].getPayloadSize();
+			inputs[i].apid = ((userData[i].id.upperAPID << 8) | userData[i].id.lowerAPID) & 0x7FF;
+		}
+		execute(result);
+	}
+
+private:
+	void execute(CCSDSDecommutationResult& result) {
+		if (!compiled) {
+			compile();
+		}
+		result.values.resize(parameters.size());
+		result.rows.resize(plans.size());
+		result.planIndices.resize(parameters.size());
+		pointers.resize(plans.size());
+		for (size_t p = 0; p < plans.size(); p++) {
+			result.rows[p].clear();
+			pointers[p].clear();
+		}
+		for (size_t i = 0; i < inputs.size(); i++) {
+			int32_t p = planTable[inputs[i].apid];
+			if (p < 0) {
+				nSkippedPackets++;
+				continue;
+			}
+			if (inputs[i].length < plans[p].requiredLength) {
+				nShortPackets++;
+				continue;
+			}
+			result.rows[p].push_back(i);
+			pointers[p].push_back(inputs[i].data);
+		}
+		bool useAVX2 = simdEnabled && isAVX2Available();
+		for (size_t p = 0; p < plans.size(); p++) {
+			const Plan& plan = plans[p];
+			size_t n = pointers[p].size();
+			const std::vector<Instruction>* lists[2] = { &plan.wordInstructions, &plan.byteInstructions };
+			for (size_t l = 0; l < 2; l++) {
+				for (size_t i = 0; i < lists[l]->size(); i++) {
+					size_t parameterIndex = (*lists[l])[i].parameterIndex;
+					result.planIndices[parameterIndex] = p;
+					result.values[parameterIndex].resize(n);
+				}
+			}
+			if (n == 0) {
+				continue;
+			}
+			const uint8_t* const * ptrs = &pointers[p][0];
+			for (size_t begin = 0; begin < n; begin += BlockSize) {
+				size_t end = (begin + BlockSize < n) ? begin + BlockSize : n;
+				size_t done = begin;
+#ifdef CCSDS_DECOMMUTATOR_HAS_AVX2
+				if (useAVX2 && !plan.wordInstructions.empty()) {
+					done = executeWordInstructionsAVX2(plan, ptrs, begin, end, result);
+				}
+#endif
+				executeWordInstructions(plan, ptrs, done, end, result);
+				executeByteInstructions(plan, ptrs, begin, end, result);
+			}
+			nExtractedParameters += n * (plan.wordInstructions.size() + plan.byteInstructions.size());
+		}
+		(void) useAVX2;
+	}
+
+private:
+	static inline uint64_t extractWord(const Instruction& instruction, const uint8_t* data) {
+		uint64_t raw;
+		std::memcpy(&raw, data + instruction.byteOffset, sizeof(raw));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+		if (!instruction.littleEndian) {
+			raw = __builtin_bswap64(raw);
+		}
+#else
+		if (instruction.littleEndian) {
+			raw = __builtin_bswap64(raw);
+		}
+#endif
+		raw = (raw >> instruction.shift) & instruction.mask;
+		if (instruction.isSigned) {
+			raw = (raw ^ instruction.signBit) - instruction.signBit;
+		}
+		return raw;
+	}
+
+private:
+	void executeWordInstructions(const Plan& plan, const uint8_t* const * ptrs, size_t begin, size_t end,
+			CCSDSDecommutationResult& result) {
+		for (size_t i = 0; i < plan.wordInstructions.size(); i++) {
+			const Instruction& instruction = plan.wordInstructions[i];
+			int64_t* column = &result.values[instruction.parameterIndex][0];
+			for (size_t r = begin; r < end; r++) {
+				column[r] = extractWord(instruction, ptrs[r]);
+			}
+		}
+	}
+
+private:
+	void executeByteInstructions(const Plan& plan, const uint8_t* const * ptrs, size_t begin, size_t end,
+			CCSDSDecommutationResult& result) {
+		for (size_t i = 0; i < plan.byteInstructions.size(); i++) {
+			const Instruction& instruction = plan.byteInstructions[i];
+			const CCSDSParameterDefinition& parameter = parameters[instruction.parameterIndex];
+			size_t rightShift = instruction.byteLength * 8 - parameter.bitOffset % 8 - parameter.width;
+			int64_t* column = &result.values[instruction.parameterIndex][0];
+			for (size_t r = begin; r < end; r++) {
+				const uint8_t* data = ptrs[r] + instruction.byteOffset;
+				uint64_t raw = 0;
+				if (instruction.littleEndian) {
+					for (size_t b = 0; b < instruction.byteLength; b++) {
+						raw |= (uint64_t) data[b] << (8 * b);
+					}
+				} else {
+					for (size_t b = 0; b < instruction.byteLength; b++) {
+						raw = (raw << 8) | data[b];
+					}
+					raw >>= rightShift;
+				}
+				raw &= instruction.mask;
+				if (instruction.isSigned) {
+					raw = (raw ^ instruction.signBit) - instruction.signBit;
+				}
+				column[r] = raw;
+			}
+		}
+	}
+
+#ifdef CCSDS_DECOMMUTATOR_HAS_AVX2
+private:
+	/** Executes word instructions on groups of 4 packets with 64-bit gathers.
+	 * @returns the first row not processed (the remainder is left to the scalar loop).
+	 */
+	__attribute__((target("avx2")))
+	size_t executeWordInstructionsAVX2(const Plan& plan, const uint8_t* const * ptrs, size_t begin, size_t end,
+			CCSDSDecommutationResult& result) {
+		size_t n4 = begin + (end - begin) / 4 * 4;
+		if (n4 == begin) {
+			return begin;
+		}
+		//gather indices are relative to the first packet of the block
+		const uint8_t* base = ptrs[begin];
+		relativeAddresses.resize(BlockSize);
+		for (size_t r = begin; r < n4; r++) {
+			relativeAddresses[r - begin] = ptrs[r] - base;
+		}
+		const __m256i byteSwap = _mm256_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12,
+				13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+		for (size_t i = 0; i < plan.wordInstructions.size(); i++) {
+			const Instruction& instruction = plan.wordInstructions[i];
+			int64_t* column = &result.values[instruction.parameterIndex][0];
+			const long long* source = (const long long*) (base + instruction.byteOffset);
+			__m128i shift = _mm_cvtsi32_si128(instruction.shift);
+			__m256i mask = _mm256_set1_epi64x(instruction.mask);
+			__m256i signBit = _mm256_set1_epi64x(instruction.isSigned ? instruction.signBit : 0);
+			for (size_t r = begin; r < n4; r += 4) {
+				__m256i index = _mm256_loadu_si256((const __m256i*) &relativeAddresses[r - begin]);
+				__m256i v = _mm256_i64gather_epi64(source, index, 1);
+				if (!instruction.littleEndian) {
+					v = _mm256_shuffle_epi8(v, byteSwap);
+				}
+				v = _mm256_and_si256(_mm256_srl_epi64(v, shift), mask);
+				v = _mm256_sub_epi64(_mm256_xor_si256(v, signBit), signBit);
+				_mm256_storeu_si256((__m256i*) &column[r], v);
+			}
+		}
+		return n4;
+	}
+#endif
+
+public:
+	/** True if the AVX2 kernel can be used on this CPU. */
+	static bool isAVX2Available() {
+#ifdef CCSDS_DECOMMUTATOR_HAS_AVX2
+		static const bool available = __builtin_cpu_supports("avx2");
+		return available;
+#else
+		return false;
+#endif
+	}
+
+public:
+	/** Enables or disables the SIMD kernel (enabled by default when available). */
+	void setSIMDEnabled(bool simdEnabled) {
+		this->simdEnabled = simdEnabled;
+	}
+
+public:
+	uint64_t getNumberOfExtractedParameters() const {
+		return nExtractedParameters;
+	}
+
+public:
+	/** Returns the number of packets whose APID has no parameter. */
+	uint64_t getNumberOfSkippedPackets() const {
+		return nSkippedPackets;
+	}
+
+public:
+	/** Returns the number of packets shorter than the parameters of their APID require. */
+	uint64_t getNumberOfShortPackets() const {
+		return nShortPackets;
+	}
+};
+
+#endif /* CCSDSDECOMMUTATOR_HH_ */
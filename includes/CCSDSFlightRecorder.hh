@@ -0,0 +1,486 @@
+/*
+ * CCSDSFlightRecorder.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSFLIGHTRECORDER_HH_
+#define CCSDSFLIGHTRECORDER_HH_
+
+#include "CCSDSSpacePacketView.hh"
+#include "CCSDSCRC16.hh"
+#include "CCSDSFormatBuffer.hh"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+/** A raw packet retrieved from CCSDSFlightRecorder.
+ */
+class CCSDSFlightRecorderEntry {
+public:
+	/** Sequential number of the packet among all packets recorded by the recorder. */
+	uint64_t index;
+	/** Original length of the packet (data may be truncated to the slot size). */
+	size_t length;
+	std::vector<uint8_t> data;
+};
+
+/** A fixed-memory recorder of the most recent raw packets of each APID or ADU Channel.
+ * Each channel owns a ring of nPacketsPerChannel slots allocated when the channel
+ * is first seen; recording a packet is a memcpy into the next slot and an index
+ * increment, so the recorder can stay enabled on the hot path. Packets longer
+ * than the slot size are truncated (the original length is kept). The number of
+ * rings is capped (maxChannels); packets of channels seen after the cap is reached
+ * share one overflow ring (OverflowKey), so memory stays bounded even when
+ * corrupted headers produce many distinct keys.
+ *
+ * When a reassembly error is reported via onError() (e.g. by ADUUnsegmenter,
+ * see ADUUnsegmenter::setFlightRecorder()), the packets of the channel are
+ * dumped to the dump stream, so that the packets that caused the error can be
+ * examined after the fact. dump() and dumpAll() dump on demand.
+ *
+ * An instance must be used by one thread at a time.
+ *
+ * @par
+ * Example:
+ * @code
+ CCSDSFlightRecorder recorder(CCSDSFlightRecorder::PerADUChannel, 32);
+ ADUUnsegmenter unsegmenter(0x23);
+ unsegmenter.setFlightRecorder(&recorder);
+ ...
+ recorder.dumpAll(std::cout);
+ * @endcode
+ */
+class CCSDSFlightRecorder {
+public:
+	enum Mode {
+		/** Key is APID. */
+		PerAPID,
+		/** Key is (lower APID << 8 | ADU Channel ID); packets without ADU Channel use ADU Channel ID 0. */
+		PerADUChannel
+	};
+
+	static const size_t DefaultNumberOfPacketsPerChannel = 64;
+	static const size_t DefaultSlotSize = 1024;
+	static const size_t DefaultMaximumNumberOfChannels = 256;
+	/** Key of the ring shared by channels seen after maxChannels rings have been allocated. */
+	static const uint32_t OverflowKey = 0xFFFFFFFF;
+
+private:
+	class Ring {
+	public:
+		std::vector<uint8_t> data;
+		std::vector<uint64_t> indices;
+		std::vector<size_t> lengths;
+		uint64_t nRecorded;
+	};
+
+private:
+	Mode mode;
+	size_t nPacketsPerChannel;
+	size_t slotSize;
+	size_t maxChannels;
+	std::map<uint32_t, Ring*> rings;
+	Ring* overflowRing;
+	uint32_t lastKey;
+	Ring* lastRing;
+	uint64_t nRecordedPackets;
+	uint64_t nErrors;
+	bool automaticDumpEnabled;
+	std::ostream* dumpStream;
+
+public:
+	/** Constructs an instance.
+	 * @param[in] mode PerAPID or PerADUChannel.
+	 * @param[in] nPacketsPerChannel number of recent packets kept per channel.
+	 * @param[in] slotSize maximum number of bytes kept per packet.
+	 * @param[in] maxChannels maximum number of channels with their own ring.
+	 */
+	CCSDSFlightRecorder(Mode mode = PerAPID, size_t nPacketsPerChannel = DefaultNumberOfPacketsPerChannel,
+			size_t slotSize = DefaultSlotSize, size_t maxChannels = DefaultMaximumNumberOfChannels) {
+		this->mode = mode;
+		this->maxChannels = maxChannels;
+		this->overflowRing = NULL;
+		this->nPacketsPerChannel = (nPacketsPerChannel == 0) ? 1 : nPacketsPerChannel;
+		this->slotSize = (slotSize < CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength) ?
+				CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength : slotSize;
+		this->lastKey = 0;
+		this->lastRing = NULL;
+		this->nRecordedPackets = 0;
+		this->nErrors = 0;
+		this->automaticDumpEnabled = true;
+		this->dumpStream = &std::cerr;
+	}
+
+public:
+	~CCSDSFlightRecorder() {
+		for (std::map<uint32_t, Ring*>::iterator it = rings.begin(); it != rings.end(); it++) {
+			delete it->second;
+		}
+		delete overflowRing;
+	}
+
+private:
+	CCSDSFlightRecorder(const CCSDSFlightRecorder&);
+	CCSDSFlightRecorder& operator=(const CCSDSFlightRecorder&);
+
+public:
+	/** Returns the key of an ADU Channel in PerADUChannel mode. */
+	static inline uint32_t getADUChannelKey(uint16_t lowerAPID, uint8_t aduChannelID) {
+		return ((uint32_t) (lowerAPID & 0xFF) << 8) | aduChannelID;
+	}
+
+public:
+	/** Returns the key of a packet according to the mode. */
+	inline uint32_t getKey(const uint8_t* data, size_t length) const {
+		if (length < CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength) {
+			return 0;
+		}
+		CCSDSSpacePacketView view(data, length);
+		if (mode == PerAPID) {
+			return view.getAPIDAsInteger();
+		}
+		uint8_t aduChannelID = 0;
+		if (view.isSecondaryHeaderPresent()
+				&& length >= CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength
+						+ CCSDSSpacePacketSecondaryHeader::SecondaryHeaderLengthWithADUChannel && view.isADUChannelUsed()) {
+			aduChannelID = view.getADUChannelID();
+		}
+		return getADUChannelKey(view.getAPIDAsInteger(), aduChannelID);
+	}
+
+private:
+	inline Ring* getRing(uint32_t key) {
+		if (lastRing != NULL && key == lastKey) {
+			return lastRing;
+		}
+		std::map<uint32_t, Ring*>::iterator it = rings.find(key);
+		Ring* ring;
+		if (it != rings.end()) {
+			ring = it->second;
+		} else if (rings.size() < maxChannels && key != OverflowKey) {
+			ring = newRing();
+			rings[key] = ring;
+		} else {
+			if (overflowRing == NULL) {
+				overflowRing = newRing();
+			}
+			ring = overflowRing;
+		}
+		lastKey = key;
+		lastRing = ring;
+		return ring;
+	}
+
+private:
+	Ring* newRing() const {
+		Ring* ring = new Ring;
+		ring->data.resize(nPacketsPerChannel * slotSize);
+		ring->indices.resize(nPacketsPerChannel);
+		ring->lengths.resize(nPacketsPerChannel);
+		ring->nRecorded = 0;
+		return ring;
+	}
+
+private:
+	/** Returns the ring that holds the packets of a key (the overflow ring for keys without their own ring). */
+	const Ring* findRing(uint32_t key) const {
+		std::map<uint32_t, Ring*>::const_iterator it = rings.find(key);
+		if (it != rings.end()) {
+			return it->second;
+		}
+		if (key == OverflowKey || rings.size() >= maxChannels) {
+			return overflowRing;
+		}
+		return NULL;
+	}
+
+public:
+	/** Records a raw packet under a key. */
+	inline void record(uint32_t key, const uint8_t* data, size_t length) {
+		Ring* ring = getRing(key);
+		std::memcpy(getSlot(ring), data, (length < slotSize) ? length : slotSize);
+		advance(ring, length);
+	}
+
+private:
+	inline uint8_t* getSlot(Ring* ring) {
+		return &ring->data[(ring->nRecorded % nPacketsPerChannel) * slotSize];
+	}
+
+private:
+	inline void advance(Ring* ring, size_t length) {
+		size_t slot = ring->nRecorded % nPacketsPerChannel;
+		ring->indices[slot] = nRecordedPackets;
+		ring->lengths[slot] = length;
+		ring->nRecorded++;
+		nRecordedPackets++;
+	}
+
+private:
+	/** Copies part of a packet to a slot at offset, truncating at the slot size. */
+	inline void copyToSlot(uint8_t* slot, size_t& offset, const uint8_t* data, size_t length) const {
+		if (offset >= slotSize || length == 0) {
+			return;
+		}
+		size_t n = (length < slotSize - offset) ? length : slotSize - offset;
+		std::memcpy(slot + offset, data, n);
+		offset += n;
+	}
+
+private:
+	/** Packs the Primary and Secondary Headers of a packet; returns the number of bytes written. */
+	static size_t packHeaders(CCSDSSpacePacket* packet, uint8_t* buffer, size_t packetDataLengthExcludingHeaders) {
+		CCSDSSpacePacketPrimaryHeader* primaryHeader = packet->getPrimaryHeader();
+		uint16_t apid = primaryHeader->getAPIDAsInteger();
+		uint16_t sequenceCount = (uint16_t) primaryHeader->getSequenceCount().to_ulong();
+		buffer[0] = (uint8_t) ((primaryHeader->getPacketVersionNum().to_ulong() << 5)
+				| (primaryHeader->getPacketType().to_ulong() << 4) | (primaryHeader->getSecondaryHeaderFlag().to_ulong() << 3)
+				| (apid >> 8));
+		buffer[1] = (uint8_t) (apid & 0xFF);
+		buffer[2] = (uint8_t) ((primaryHeader->getSequenceFlag().to_ulong() << 6) | (sequenceCount >> 8));
+		buffer[3] = (uint8_t) (sequenceCount & 0xFF);
+		size_t length = CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength;
+		if (packet->isSecondaryHeaderPresent()) {
+			CCSDSSpacePacketSecondaryHeader* secondaryHeader = packet->getSecondaryHeader();
+			uint32_t time = secondaryHeader->getTimeAsInteger();
+			buffer[6] = (uint8_t) (time >> 24);
+			buffer[7] = (uint8_t) (time >> 16);
+			buffer[8] = (uint8_t) (time >> 8);
+			buffer[9] = (uint8_t) time;
+			buffer[10] = (uint8_t) ((secondaryHeader->getSecondaryHeaderType().to_ulong() << 7)
+					| secondaryHeader->getCategory().to_ulong());
+			buffer[11] = secondaryHeader->getADUCount();
+			length += CCSDSSpacePacketSecondaryHeader::SecondaryHeaderLengthWithoutADUChannel;
+			if (secondaryHeader->isADUChannelUsed()) {
+				uint16_t flagAndSegmentCount = (uint16_t) ((secondaryHeader->getADUSegmentFlag().to_ulong() << 14)
+						| secondaryHeader->getADUSegmentCount().to_ulong());
+				buffer[12] = secondaryHeader->getADUChannelID();
+				buffer[13] = (uint8_t) (flagAndSegmentCount >> 8);
+				buffer[14] = (uint8_t) (flagAndSegmentCount & 0xFF);
+				length = CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength
+						+ CCSDSSpacePacketSecondaryHeader::SecondaryHeaderLengthWithADUChannel;
+			}
+		}
+		uint16_t packetDataLength = (uint16_t) (length - CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength
+				+ packetDataLengthExcludingHeaders - 1);
+		buffer[4] = (uint8_t) (packetDataLength >> 8);
+		buffer[5] = (uint8_t) (packetDataLength & 0xFF);
+		return length;
+	}
+
+public:
+	/** Records a raw packet under the key derived from its header. */
+	inline void record(const uint8_t* data, size_t length) {
+		record(getKey(data, length), data, length);
+	}
+
+public:
+	/** Records a packet view. */
+	inline void record(const CCSDSSpacePacketView& view) {
+		record(getKey(view.data, view.length), view.data, view.length);
+	}
+
+public:
+	/** Returns the key of a packet instance according to the mode. */
+	uint32_t getKey(CCSDSSpacePacket* packet) const {
+		uint16_t apid = packet->getPrimaryHeader()->getAPIDAsInteger();
+		if (mode == PerAPID) {
+			return apid;
+		}
+		uint8_t aduChannelID = 0;
+		if (packet->isSecondaryHeaderPresent() && packet->getSecondaryHeader()->isADUChannelUsed()) {
+			aduChannelID = packet->getSecondaryHeader()->getADUChannelID();
+		}
+		return getADUChannelKey(apid, aduChannelID);
+	}
+
+public:
+	/** Records a packet instance. The headers are packed and the User Data Field
+	 * is copied directly into the slot (the packet is not serialized with
+	 * CCSDSSpacePacket::getAsByteVector(), and is not modified).
+	 */
+	void record(CCSDSSpacePacket* packet) {
+		const std::vector<uint8_t>& userDataField = *packet->getUserDataField();
+		size_t packetErrorControlLength = packet->isPacketErrorControlUsed() ? 2 : 0;
+		uint8_t header[CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength
+				+ CCSDSSpacePacketSecondaryHeader::SecondaryHeaderLengthWithADUChannel];
+		size_t headerLength = packHeaders(packet, header, userDataField.size() + packetErrorControlLength);
+		const uint8_t* userData = userDataField.empty() ? NULL : &userDataField[0];
+
+		Ring* ring = getRing(getKey(packet));
+		uint8_t* slot = getSlot(ring);
+		size_t offset = 0;
+		copyToSlot(slot, offset, header, headerLength);
+		copyToSlot(slot, offset, userData, userDataField.size());
+		if (packetErrorControlLength != 0 && offset < slotSize) {
+			uint16_t crc = CCSDSCRC16::calculate(header, headerLength);
+			if (userData != NULL) {
+				crc = CCSDSCRC16::calculate(userData, userDataField.size(), crc);
+			}
+			uint8_t packetErrorControl[2] = { (uint8_t) (crc >> 8), (uint8_t) (crc & 0xFF) };
+			copyToSlot(slot, offset, packetErrorControl, packetErrorControlLength);
+		}
+		advance(ring, headerLength + userDataField.size() + packetErrorControlLength);
+	}
+
+public:
+	/** Returns the keys of channels that have been recorded (OverflowKey last, if used). */
+	std::vector<uint32_t> getKeys() const {
+		std::vector<uint32_t> result;
+		for (std::map<uint32_t, Ring*>::const_iterator it = rings.begin(); it != rings.end(); it++) {
+			result.push_back(it->first);
+		}
+		if (overflowRing != NULL) {
+			result.push_back((uint32_t) OverflowKey);
+		}
+		return result;
+	}
+
+public:
+	/** Returns the recorded packets of a channel, oldest first.
+	 * For a channel without its own ring, the packets of the overflow ring are returned.
+	 */
+	std::vector<CCSDSFlightRecorderEntry> getEntries(uint32_t key) const {
+		std::vector<CCSDSFlightRecorderEntry> result;
+		const Ring* ring = findRing(key);
+		if (ring == NULL) {
+			return result;
+		}
+		uint64_t first = (ring->nRecorded > nPacketsPerChannel) ? ring->nRecorded - nPacketsPerChannel : 0;
+		for (uint64_t i = first; i < ring->nRecorded; i++) {
+			size_t slot = i % nPacketsPerChannel;
+			CCSDSFlightRecorderEntry entry;
+			entry.index = ring->indices[slot];
+			entry.length = ring->lengths[slot];
+			const uint8_t* begin = &ring->data[slot * slotSize];
+			entry.data.assign(begin, begin + ((entry.length < slotSize) ? entry.length : slotSize));
+			result.push_back(entry);
+		}
+		return result;
+	}
+
+public:
+	/** Writes the recorded packets of a channel as hex dumps. */
+	void dump(uint32_t key, std::ostream& os, const std::string& reason = "") const {
+		std::vector<CCSDSFlightRecorderEntry> entries = getEntries(key);
+		CCSDSFormatBuffer buffer;
+		buffer.append("CCSDSFlightRecorder: ").append(getKeyName(key)).append(" ");
+		buffer.appendDecimal(entries.size()).append(" packets");
+		if (reason.size() != 0) {
+			std::string line = reason;
+			while (line.size() != 0 && line[line.size() - 1] == '\n') {
+				line.erase(line.size() - 1);
+			}
+			std::replace(line.begin(), line.end(), '\n', ' ');
+			buffer.append(" (").append(line).append(")");
+		}
+		buffer.appendChar('\n');
+		for (size_t i = 0; i < entries.size(); i++) {
+			buffer.append("  #").appendDecimal(entries[i].index).append(" length=").appendDecimal(entries[i].length);
+			if (entries[i].data.size() < entries[i].length) {
+				buffer.append(" (truncated)");
+			}
+			for (size_t j = 0; j < entries[i].data.size(); j++) {
+				if (j % 16 == 0) {
+					buffer.append("\n    ");
+				} else {
+					buffer.appendChar(' ');
+				}
+				buffer.appendHexByte(entries[i].data[j]);
+			}
+			buffer.appendChar('\n');
+		}
+		buffer.writeTo(os);
+	}
+
+public:
+	/** Writes the recorded packets of all channels. */
+	void dumpAll(std::ostream& os) const {
+		std::vector<uint32_t> keys = getKeys();
+		for (size_t i = 0; i < keys.size(); i++) {
+			dump(keys[i], os);
+		}
+	}
+
+public:
+	/** Reports an error of a channel; the channel is dumped if automatic dump is enabled.
+	 * @param[in] key the channel key.
+	 * @param[in] reason a message written in the dump header.
+	 */
+	void onError(uint32_t key, const std::string& reason) {
+		nErrors++;
+		if (automaticDumpEnabled && dumpStream != NULL) {
+			dump(key, *dumpStream, reason);
+		}
+	}
+
+public:
+	/** Returns a name of a key such as "APID=0x123" or "lowerAPID=0x23 ADUChannelID=0x01"
+	 * (" (overflow)" is appended for a channel without its own ring).
+	 */
+	std::string getKeyName(uint32_t key) const {
+		CCSDSFormatBuffer buffer;
+		if (key == OverflowKey) {
+			return "overflow";
+		} else if (mode == PerAPID) {
+			buffer.append("APID=0x").appendHexByte(key >> 8).appendHexByte(key & 0xFF);
+		} else {
+			buffer.append("lowerAPID=0x").appendHexByte(key >> 8).append(" ADUChannelID=0x").appendHexByte(key & 0xFF);
+		}
+		if (overflowRing != NULL && findRing(key) == overflowRing) {
+			buffer.append(" (overflow)");
+		}
+		return buffer.str();
+	}
+
+public:
+	/** Sets the stream to which onError() dumps (default std::cerr). */
+	void setDumpStream(std::ostream* dumpStream) {
+		this->dumpStream = dumpStream;
+	}
+
+public:
+	/** Enables or disables dumping in onError() (enabled by default). */
+	void setAutomaticDumpEnabled(bool automaticDumpEnabled) {
+		this->automaticDumpEnabled = automaticDumpEnabled;
+	}
+
+public:
+	Mode getMode() const {
+		return mode;
+	}
+
+public:
+	/** Discards all recorded packets (allocated rings are kept). */
+	void clear() {
+		for (std::map<uint32_t, Ring*>::iterator it = rings.begin(); it != rings.end(); it++) {
+			it->second->nRecorded = 0;
+		}
+		if (overflowRing != NULL) {
+			overflowRing->nRecorded = 0;
+		}
+	}
+
+public:
+	size_t getMaximumNumberOfChannels() const {
+		return maxChannels;
+	}
+
+public:
+	uint64_t getNumberOfRecordedPackets() const {
+		return nRecordedPackets;
+	}
+
+public:
+	/** Returns the number of errors reported via onError(). */
+	uint64_t getNumberOfErrors() const {
+		return nErrors;
+	}
+};
+
+#endif /* CCSDSFLIGHTRECORDER_HH_ */
@@ -0,0 +1,230 @@
+/*
+ * CCSDSFormatBuffer.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSFORMATBUFFER_HH_
+#define CCSDSFORMATBUFFER_HH_
+
+#include <string>
+#include <cstring>
+#include <ostream>
+
+#if (defined(__GXX_EXPERIMENTAL_CXX0X) || (__cplusplus >= 201103L))
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+/** A reusable character buffer used to format packet dumps.
+ * Numbers are converted without std::stringstream, and hexadecimal digits are
+ * produced from a lookup table. Calling clear() keeps the allocated capacity,
+ * so that a buffer reused across packets does not allocate once it has grown.
+ *
+ * @par
+ * Example:
+ * @code
+ CCSDSFormatBuffer buffer;
+ for (...) {
+ 	buffer.clear();
+ 	ccsdsPacket->format(buffer); //or formatCompact(buffer)
+ 	buffer.writeTo(std::cout);
+ }
+ * @endcode
+ */
+class CCSDSFormatBuffer {
+public:
+	/** Modes of appendArray(). */
+	enum {
+		Decimal, //
+		Hexadecimal, //
+		Character
+	};
+
+private:
+	std::string buffer;
+
+public:
+	/** Constructs an instance.
+	 * @param[in] initialCapacity number of bytes reserved in advance.
+	 */
+	CCSDSFormatBuffer(size_t initialCapacity = 1024) {
+		buffer.reserve(initialCapacity);
+	}
+
+public:
+	/** Empties the buffer while keeping its capacity. */
+	inline void clear() {
+		buffer.clear();
+	}
+
+public:
+	/** Returns formatted content. */
+	inline const std::string& str() const {
+		return buffer;
+	}
+
+public:
+	/** Returns a pointer to formatted characters (not null-terminated). */
+	inline const char* data() const {
+		return buffer.data();
+	}
+
+public:
+	/** Returns the number of formatted characters. */
+	inline size_t size() const {
+		return buffer.size();
+	}
+
+public:
+	/** Writes formatted content to an output stream. */
+	inline void writeTo(std::ostream& os) const {
+		os.write(buffer.data(), buffer.size());
+	}
+
+public:
+	inline CCSDSFormatBuffer& append(const char* str) {
+		buffer.append(str, strlen(str));
+		return *this;
+	}
+
+public:
+	inline CCSDSFormatBuffer& append(const char* str, size_t length) {
+		buffer.append(str, length);
+		return *this;
+	}
+
+public:
+	inline CCSDSFormatBuffer& append(const std::string& str) {
+		buffer.append(str);
+		return *this;
+	}
+
+public:
+	inline CCSDSFormatBuffer& appendChar(char c) {
+		buffer.push_back(c);
+		return *this;
+	}
+
+public:
+	/** Appends an unsigned integer in decimal. */
+	CCSDSFormatBuffer& appendDecimal(uint64_t value) {
+		char digits[20];
+		size_t n = 0;
+		do {
+			digits[sizeof(digits) - 1 - n] = '0' + (value % 10);
+			value /= 10;
+			n++;
+		} while (value != 0);
+		buffer.append(digits + sizeof(digits) - n, n);
+		return *this;
+	}
+
+public:
+	/** Appends an unsigned integer in lower-case hexadecimal without prefix.
+	 * @param[in] value value to be appended.
+	 * @param[in] minimumWidth the result is zero-padded to this number of digits.
+	 */
+	CCSDSFormatBuffer& appendHex(uint64_t value, size_t minimumWidth = 1) {
+		static const char hexDigits[] = "0123456789abcdef";
+		char digits[16];
+		size_t n = 0;
+		do {
+			digits[sizeof(digits) - 1 - n] = hexDigits[value & 0x0f];
+			value >>= 4;
+			n++;
+		} while (value != 0);
+		for (; n < minimumWidth && n < sizeof(digits); n++) {
+			digits[sizeof(digits) - 1 - n] = '0';
+		}
+		buffer.append(digits + sizeof(digits) - n, n);
+		return *this;
+	}
+
+public:
+	/** Appends a byte as two lower-case hexadecimal digits. */
+	inline CCSDSFormatBuffer& appendHexByte(uint8_t value) {
+		buffer.append(hexByteTable() + 2 * value, 2);
+		return *this;
+	}
+
+public:
+	/** Appends the lowest nBits of a value as a string of '0' and '1' (MSB first). */
+	CCSDSFormatBuffer& appendBits(uint64_t value, size_t nBits) {
+		char bits[64];
+		for (size_t i = 0; i < nBits && i < sizeof(bits); i++) {
+			bits[i] = ((value >> (nBits - 1 - i)) & 0x01) ? '1' : '0';
+		}
+		buffer.append(bits, nBits);
+		return *this;
+	}
+
+public:
+	/** Appends a byte array in the format of CCSDSSpacePacket::arrayToString().
+	 * @param[in] data a pointer to a byte array.
+	 * @param[in] length the length of the byte array.
+	 * @param[in] mode Decimal, Hexadecimal, or Character.
+	 * @param[in] maxBytesToBeDumped bytes after this are omitted and the total size is shown.
+	 */
+	CCSDSFormatBuffer& appendArray(const uint8_t* data, size_t length, int mode, size_t maxBytesToBeDumped) {
+		size_t maxSize = (length < maxBytesToBeDumped) ? length : maxBytesToBeDumped;
+		if (mode == Hexadecimal) {
+			const char* table = hexByteTable();
+			size_t offset = buffer.size();
+			size_t n = (maxSize == 0) ? 0 : maxSize * 5 - 1;
+			buffer.resize(offset + n);
+			char* p = &buffer[0] + offset;
+			for (size_t i = 0; i < maxSize; i++) {
+				p[0] = '0';
+				p[1] = 'x';
+				p[2] = table[2 * data[i]];
+				p[3] = table[2 * data[i] + 1];
+				if (i != maxSize - 1) {
+					p[4] = ' ';
+				}
+				p += 5;
+			}
+		} else {
+			for (size_t i = 0; i < maxSize; i++) {
+				if (mode == Decimal) {
+					appendDecimal(data[i]);
+				} else {
+					buffer.push_back((char) data[i]);
+				}
+				if (i != maxSize - 1) {
+					buffer.push_back(' ');
+				}
+			}
+		}
+		if (maxSize < length) {
+			append(" ... (total size = ").appendDecimal(length);
+			append((length == 1) ? " entry)" : " entries)");
+		}
+		return *this;
+	}
+
+private:
+	static const char* hexByteTable() {
+		static const char table[] = "000102030405060708090a0b0c0d0e0f"
+				"101112131415161718191a1b1c1d1e1f"
+				"202122232425262728292a2b2c2d2e2f"
+				"303132333435363738393a3b3c3d3e3f"
+				"404142434445464748494a4b4c4d4e4f"
+				"505152535455565758595a5b5c5d5e5f"
+				"606162636465666768696a6b6c6d6e6f"
+				"707172737475767778797a7b7c7d7e7f"
+				"808182838485868788898a8b8c8d8e8f"
+				"909192939495969798999a9b9c9d9e9f"
+				"a0a1a2a3a4a5a6a7a8a9aaabacadaeaf"
+				"b0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+				"c0c1c2c3c4c5c6c7c8c9cacbcccdcecf"
+				"d0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+				"e0e1e2e3e4e5e6e7e8e9eaebecedeeef"
+				"f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+		return table;
+	}
+};
+
+#endif /* CCSDSFORMATBUFFER_HH_ */
@@ -0,0 +1,323 @@
+/*
+ * CCSDSLatencyInstrumentation.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSLATENCYINSTRUMENTATION_HH_
+#define CCSDSLATENCYINSTRUMENTATION_HH_
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if (defined(__GXX_EXPERIMENTAL_CXX0X) || (__cplusplus >= 201103L))
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+/** A fixed-memory histogram of latencies in nanoseconds with log-linear buckets.
+ * Each power of two is divided into 16 linear sub-buckets, so values are resolved
+ * within 1/16 (6.25%) from 1 ns up to 2^64 ns in 976 buckets (about 8 kB).
+ * record() is lock-free and can be called from multiple threads.
+ */
+class CCSDSLatencyHistogram {
+public:
+	static const size_t NSubBucketBits = 4;
+	static const size_t NSubBuckets = 1 << NSubBucketBits;
+	static const size_t NBuckets = (64 - NSubBucketBits + 1) * NSubBuckets;
+
+private:
+	std::atomic<uint64_t> counts[NBuckets];
+	std::atomic<uint64_t> nSamples;
+	std::atomic<uint64_t> sum;
+	std::atomic<uint64_t> maximum;
+
+public:
+	CCSDSLatencyHistogram() {
+		reset();
+	}
+
+public:
+	/** Returns the bucket index of a value. */
+	static inline size_t getBucketIndex(uint64_t value) {
+		if (value < NSubBuckets) {
+			return (size_t) value;
+		}
+		size_t msb = 63 - __builtin_clzll(value);
+		size_t shift = msb - NSubBucketBits;
+		return (msb - NSubBucketBits + 1) * NSubBuckets + (size_t) ((value >> shift) - NSubBuckets);
+	}
+
+public:
+	/** Returns the smallest value that falls in a bucket. */
+	static inline uint64_t getBucketLowerBound(size_t index) {
+		if (index < NSubBuckets) {
+			return index;
+		}
+		size_t shift = index / NSubBuckets - 1;
+		return (uint64_t) (NSubBuckets + index % NSubBuckets) << shift;
+	}
+
+public:
+	/** Records a latency. */
+	inline void record(uint64_t latencyInNanoseconds) {
+		counts[getBucketIndex(latencyInNanoseconds)].fetch_add(1, std::memory_order_relaxed);
+		nSamples.fetch_add(1, std::memory_order_relaxed);
+		sum.fetch_add(latencyInNanoseconds, std::memory_order_relaxed);
+		uint64_t current = maximum.load(std::memory_order_relaxed);
+		while (latencyInNanoseconds > current
+				&& !maximum.compare_exchange_weak(current, latencyInNanoseconds, std::memory_order_relaxed)) {
+		}
+	}
+
+public:
+	/** Clears all buckets. */
+	void reset() {
+		for (size_t i = 0; i < NBuckets; i++) {
+			counts[i].store(0, std::memory_order_relaxed);
+		}
+		nSamples.store(0, std::memory_order_relaxed);
+		sum.store(0, std::memory_order_relaxed);
+		maximum.store(0, std::memory_order_relaxed);
+	}
+
+public:
+	/** Returns the number of recorded latencies. */
+	uint64_t getNumberOfSamples() const {
+		return nSamples.load(std::memory_order_relaxed);
+	}
+
+public:
+	/** Returns the mean latency in nanoseconds. */
+	double getMean() const {
+		uint64_t n = getNumberOfSamples();
+		return (n == 0) ? 0 : (double) sum.load(std::memory_order_relaxed) / n;
+	}
+
+public:
+	/** Returns the largest recorded latency in nanoseconds. */
+	uint64_t getMaximum() const {
+		return maximum.load(std::memory_order_relaxed);
+	}
+
+public:
+	/** Returns a percentile (e.g. 99.9) in nanoseconds, as the midpoint of the bucket that contains it. */
+	uint64_t getPercentile(double percentile) const {
+		uint64_t n = getNumberOfSamples();
+		if (n == 0) {
+			return 0;
+		}
+		uint64_t rank = (uint64_t) (percentile / 100.0 * n + 0.5);
+		rank = (rank == 0) ? 1 : ((rank > n) ? n : rank);
+		uint64_t accumulated = 0;
+		for (size_t i = 0; i < NBuckets; i++) {
+			accumulated += counts[i].load(std::memory_order_relaxed);
+			if (accumulated >= rank) {
+				uint64_t lower = getBucketLowerBound(i);
+				uint64_t upper = (i + 1 < NBuckets) ? getBucketLowerBound(i + 1) : lower;
+				uint64_t midpoint = lower + (upper - lower) / 2;
+				return (midpoint < getMaximum()) ? midpoint : getMaximum();
+			}
+		}
+		return getMaximum();
+	}
+
+public:
+	/** Returns a one-line summary (count, mean, p50, p99, p99.9, max). */
+	std::string toString() const {
+		std::stringstream ss;
+		ss << "n=" << getNumberOfSamples() << " mean=" << std::fixed << std::setprecision(0) << getMean() << "ns"
+				<< " p50=" << getPercentile(50) << "ns p99=" << getPercentile(99) << "ns p99.9=" << getPercentile(99.9)
+				<< "ns max=" << getMaximum() << "ns";
+		return ss.str();
+	}
+};
+
+/** Timestamps of a sampled packet as it passes the stages (nanoseconds, steady clock).
+ * @see CCSDSLatencyInstrumentation
+ */
+class CCSDSPacketTrace {
+public:
+	uint64_t traceID;
+	uint16_t apid;
+	uint16_t sequenceCount;
+	uint64_t ingestTime;
+	uint64_t framedTime;
+	uint64_t decodedTime;
+	uint64_t reassembledTime;
+	uint64_t deliveredTime;
+
+public:
+	std::string toString() const {
+		std::stringstream ss;
+		ss << "trace " << traceID << " APID=0x" << std::hex << std::setw(3) << std::setfill('0') << apid << std::dec
+				<< " seq=" << sequenceCount << " framing=" << (framedTime - ingestTime) << "ns decode="
+				<< (decodedTime - framedTime) << "ns reassembly=" << (reassembledTime - decodedTime) << "ns sink="
+				<< (deliveredTime - reassembledTime) << "ns total=" << (deliveredTime - ingestTime) << "ns";
+		return ss.str();
+	}
+};
+
+/** A class that collects per-stage latency histograms and sampled packet traces.
+ * The latency of a stage is the time from the end of the previous stage (or the
+ * ingest timestamp) to the end of the stage, so it includes the time spent waiting
+ * in the queue in front of the stage. For ADUs, latencies are measured from the
+ * arrival of the first segment (so Reassembly includes the wait for the remaining
+ * segments), and an ADU is traced when any of its segments was sampled.
+ *
+ * Histograms and the trace ring use fixed memory allocated at construction and are
+ * updated without locks, so the instrumentation can stay enabled in production.
+ * Traces are written by one thread (the sink stage of CCSDSPipeline) and stored in a
+ * ring of the most recent traces; each slot is protected by a sequence counter so
+ * that getTraces() never returns torn records.
+ *
+ * @par
+ * Example:
+ * @code
+ CCSDSLatencyInstrumentation instrumentation(1000); //trace 1 in 1000 packets
+ pipeline.setLatencyInstrumentation(&instrumentation);
+ ...
+ std::cout << instrumentation.toString();
+ * @endcode
+ */
+class CCSDSLatencyInstrumentation {
+public:
+	enum Stage {
+		Framing, Decode, Reassembly, Sink, EndToEnd, NStages
+	};
+
+	static const size_t DefaultTraceRingSize = 1024;
+
+private:
+	class TraceSlot {
+	public:
+		std::atomic<uint64_t> sequence;
+		CCSDSPacketTrace trace;
+	};
+
+private:
+	CCSDSLatencyHistogram histograms[NStages];
+	uint64_t samplingInterval;
+	std::atomic<uint64_t> nSamplingCandidates;
+	std::vector<TraceSlot> traceSlots;
+	std::atomic<uint64_t> nTraces;
+
+public:
+	/** Constructs an instance.
+	 * @param[in] samplingInterval a full trace is recorded for 1 in samplingInterval packets (0 disables tracing).
+	 * @param[in] traceRingSize number of recent traces kept.
+	 */
+	CCSDSLatencyInstrumentation(uint64_t samplingInterval = 0, size_t traceRingSize = DefaultTraceRingSize) :
+			traceSlots((traceRingSize == 0) ? 1 : traceRingSize) {
+		this->samplingInterval = samplingInterval;
+		for (size_t i = 0; i < traceSlots.size(); i++) {
+			traceSlots[i].sequence.store(0, std::memory_order_relaxed);
+		}
+		nSamplingCandidates.store(0, std::memory_order_relaxed);
+		nTraces.store(0, std::memory_order_relaxed);
+	}
+
+public:
+	/** Returns the current time of the steady clock in nanoseconds. */
+	static inline uint64_t now() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+public:
+	/** Records the latency of a stage. */
+	inline void record(Stage stage, uint64_t latencyInNanoseconds) {
+		histograms[stage].record(latencyInNanoseconds);
+	}
+
+public:
+	/** Records the latency of a stage from a start time to now.
+	 * @returns the current time (the start time of the next stage).
+	 */
+	inline uint64_t recordSince(Stage stage, uint64_t startTime) {
+		uint64_t t = now();
+		histograms[stage].record(t - startTime);
+		return t;
+	}
+
+public:
+	/** Decides whether the next packet should be traced (1 in samplingInterval). */
+	inline bool shouldSample() {
+		if (samplingInterval == 0) {
+			return false;
+		}
+		return nSamplingCandidates.fetch_add(1, std::memory_order_relaxed) % samplingInterval == 0;
+	}
+
+public:
+	/** Stores a trace in the ring (single writer). */
+	void recordTrace(const CCSDSPacketTrace& trace) {
+		uint64_t index = nTraces.load(std::memory_order_relaxed);
+		TraceSlot& slot = traceSlots[index % traceSlots.size()];
+		uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+		slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		slot.trace = trace;
+		slot.trace.traceID = index;
+		slot.sequence.store(sequence + 2, std::memory_order_release);
+		nTraces.store(index + 1, std::memory_order_release);
+	}
+
+public:
+	/** Returns the recorded traces, oldest first (traces being written are skipped). */
+	std::vector<CCSDSPacketTrace> getTraces() const {
+		std::vector<CCSDSPacketTrace> result;
+		uint64_t n = nTraces.load(std::memory_order_acquire);
+		uint64_t first = (n > traceSlots.size()) ? n - traceSlots.size() : 0;
+		for (uint64_t i = first; i < n; i++) {
+			const TraceSlot& slot = traceSlots[i % traceSlots.size()];
+			uint64_t before = slot.sequence.load(std::memory_order_acquire);
+			CCSDSPacketTrace trace = slot.trace;
+			std::atomic_thread_fence(std::memory_order_acquire);
+			uint64_t after = slot.sequence.load(std::memory_order_relaxed);
+			if (before % 2 == 0 && before == after && trace.traceID == i) {
+				result.push_back(trace);
+			}
+		}
+		return result;
+	}
+
+public:
+	/** Returns the histogram of a stage. */
+	const CCSDSLatencyHistogram& getHistogram(Stage stage) const {
+		return histograms[stage];
+	}
+
+public:
+	/** Clears histograms (traces are kept). */
+	void resetHistograms() {
+		for (size_t i = 0; i < NStages; i++) {
+			histograms[i].reset();
+		}
+	}
+
+public:
+	/** Returns the name of a stage. */
+	static std::string getStageName(size_t stage) {
+		static const char* names[NStages] = { "Framing", "Decode", "Reassembly", "Sink", "EndToEnd" };
+		return (stage < NStages) ? names[stage] : "Undefined";
+	}
+
+public:
+	/** Returns one line per stage. */
+	std::string toString() const {
+		std::stringstream ss;
+		for (size_t i = 0; i < NStages; i++) {
+			ss << std::left << std::setw(10) << getStageName(i) << " " << histograms[i].toString() << std::endl;
+		}
+		return ss.str();
+	}
+};
+
+#endif /* CCSDSLATENCYINSTRUMENTATION_HH_ */
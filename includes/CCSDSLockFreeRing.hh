@@ -0,0 +1,155 @@
+/*
+ * CCSDSLockFreeRing.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSLOCKFREERING_HH_
+#define CCSDSLOCKFREERING_HH_
+
+#include <atomic>
+#include <cstddef>
+
+#if (defined(__GXX_EXPERIMENTAL_CXX0X) || (__cplusplus >= 201103L))
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+/** A bounded lock-free queue that can be used by multiple producers and consumers.
+ * Each slot has a sequence number that tells whether the slot is ready to be written
+ * or read; producers and consumers claim positions with a compare-and-swap on the
+ * 64-bit tail and head counters, which are padded to separate cache lines.
+ * T should be a small copyable type such as a pointer.
+ *
+ * @par
+ * Example:
+ * @code
+ CCSDSLockFreeRing<Buffer*> ring(1024);
+ if (!ring.tryPush(buffer)) {
+ 	//full
+ }
+ Buffer* received;
+ if (ring.tryPop(received)) {
+ 	...
+ }
+ * @endcode
+ */
+template<typename T>
+class CCSDSLockFreeRing {
+private:
+	class Slot {
+	public:
+		std::atomic<uint64_t> sequence;
+		T value;
+	};
+
+private:
+	static const size_t CacheLineSize = 64;
+
+private:
+	Slot* slots;
+	size_t capacity;
+	uint64_t mask;
+	uint8_t padding0[CacheLineSize];
+	std::atomic<uint64_t> head;
+	uint8_t padding1[CacheLineSize - sizeof(std::atomic<uint64_t>)];
+	std::atomic<uint64_t> tail;
+	uint8_t padding2[CacheLineSize - sizeof(std::atomic<uint64_t>)];
+
+public:
+	/** Constructs a ring.
+	 * @param[in] capacity the maximum number of entries (rounded up to a power of 2).
+	 */
+	CCSDSLockFreeRing(size_t capacity) {
+		this->capacity = 2;
+		while (this->capacity < capacity) {
+			this->capacity *= 2;
+		}
+		mask = this->capacity - 1;
+		slots = new Slot[this->capacity];
+		for (size_t i = 0; i < this->capacity; i++) {
+			slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+		head.store(0, std::memory_order_relaxed);
+		tail.store(0, std::memory_order_relaxed);
+	}
+
+public:
+	~CCSDSLockFreeRing() {
+		delete[] slots;
+	}
+
+private:
+	CCSDSLockFreeRing(const CCSDSLockFreeRing&);
+	CCSDSLockFreeRing& operator=(const CCSDSLockFreeRing&);
+
+public:
+	/** Appends an entry.
+	 * @returns false if the ring is full.
+	 */
+	bool tryPush(const T& value) {
+		uint64_t position = tail.load(std::memory_order_relaxed);
+		while (true) {
+			Slot& slot = slots[position & mask];
+			int64_t difference = (int64_t) slot.sequence.load(std::memory_order_acquire) - (int64_t) position;
+			if (difference == 0) {
+				if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					slot.value = value;
+					slot.sequence.store(position + 1, std::memory_order_release);
+					return true;
+				}
+			} else if (difference < 0) {
+				return false;
+			} else {
+				position = tail.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+public:
+	/** Removes the oldest entry.
+	 * @returns false if the ring is empty.
+	 */
+	bool tryPop(T& value) {
+		uint64_t position = head.load(std::memory_order_relaxed);
+		while (true) {
+			Slot& slot = slots[position & mask];
+			int64_t difference = (int64_t) slot.sequence.load(std::memory_order_acquire) - (int64_t) (position + 1);
+			if (difference == 0) {
+				if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					value = slot.value;
+					slot.sequence.store(position + capacity, std::memory_order_release);
+					return true;
+				}
+			} else if (difference < 0) {
+				return false;
+			} else {
+				position = head.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+public:
+	/** Returns the number of entries (approximate while other threads are active). */
+	size_t size() const {
+		uint64_t h = head.load(std::memory_order_relaxed);
+		uint64_t t = tail.load(std::memory_order_relaxed);
+		return (t > h) ? (size_t) (t - h) : 0;
+	}
+
+public:
+	/** True if the ring is empty (approximate while other threads are active). */
+	bool empty() const {
+		return size() == 0;
+	}
+
+public:
+	/** Returns the capacity. */
+	size_t getCapacity() const {
+		return capacity;
+	}
+};
+
+#endif /* CCSDSLOCKFREERING_HH_ */
@@ -0,0 +1,238 @@
+/*
+ * CCSDSMetrics.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSMETRICS_HH_
+#define CCSDSMETRICS_HH_
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if (defined(__GXX_EXPERIMENTAL_CXX0X) || (__cplusplus >= 201103L))
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+//counters need C++11 (std::atomic and thread_local); otherwise they are compiled out
+#if !defined(CCSDS_DISABLE_METRICS) && (defined(__GXX_EXPERIMENTAL_CXX0X) || (__cplusplus >= 201103L))
+#define CCSDS_METRICS_ENABLED 1
+#include <atomic>
+#include <mutex>
+#endif
+
+/** A set of counter values aggregated over all threads.
+ * @see CCSDSMetrics::snapshot()
+ */
+class CCSDSMetricsSnapshot {
+public:
+	std::vector<int64_t> values;
+
+public:
+	/** Returns the value of a counter (a CCSDSMetrics::Counter). */
+	int64_t get(size_t counter) const {
+		return values.at(counter);
+	}
+
+public:
+	/** Returns "name value" lines. */
+	std::string toString() const;
+
+public:
+	/** Returns a JSON object whose keys are counter names. */
+	std::string toJSON() const;
+};
+
+/** A class that collects library-wide counters with low overhead.
+ * Each thread increments its own block of counters, padded to separate cache lines,
+ * so that the hot path is a plain load and store to thread-local memory without
+ * atomic read-modify-write operations or sharing between cores. Blocks are registered
+ * in a global registry and summed only when snapshot() is called; counts of exited
+ * threads are retained.
+ *
+ * The library updates counters through the CCSDS_METRICS_ADD macro. Defining
+ * CCSDS_DISABLE_METRICS before including the library, or compiling with a
+ * pre-C++11 standard, removes all updates (snapshots then contain zeros).
+ *
+ * @par
+ * Example:
+ * @code
+ CCSDSMetricsSnapshot snapshot = CCSDSMetrics::snapshot();
+ std::cout << snapshot.toJSON() << std::endl;
+ std::cout << snapshot.get(CCSDSMetrics::DecodedPackets) << std::endl;
+ * @endcode
+ */
+class CCSDSMetrics {
+public:
+	enum Counter {
+		DecodedPackets, //packets interpreted by CCSDSSpacePacket::interpret()
+		DecodedBytes, //bytes of interpreted packets
+		NotACCSDSSpacePacketExceptions, //exceptions thrown by CCSDSSpacePacket::interpret()
+		SecondaryHeaderTooShortExceptions,
+		InconsistentPacketLengthExceptions,
+		PacketErrorControlMismatchExceptions,
+		TotalPendingADUSegments, //packets held by all ADUSegments instances together (a gauge; see ADUSegments::getPendingPacketSize() for one instance)
+		CompletedADUs,
+		ADUSegmentCountJumps,
+		ADUSegmentErrors, //all reassembly errors, including segment count jumps
+		NCounters
+	};
+
+	static const size_t CacheLineSize = 64;
+
+#ifdef CCSDS_METRICS_ENABLED
+private:
+	class Block {
+	public:
+		uint8_t paddingBefore[CacheLineSize];
+		std::atomic<int64_t> values[NCounters];
+		uint8_t paddingAfter[CacheLineSize];
+
+		Block() {
+			for (size_t i = 0; i < NCounters; i++) {
+				values[i].store(0, std::memory_order_relaxed);
+			}
+		}
+	};
+
+	class Registry {
+	public:
+		std::mutex mutex;
+		std::vector<Block*> blocks;
+		int64_t retired[NCounters];
+		int64_t baseline[NCounters];
+
+		Registry() {
+			for (size_t i = 0; i < NCounters; i++) {
+				retired[i] = 0;
+				baseline[i] = 0;
+			}
+		}
+	};
+
+	/** Registers the block of a thread, and folds its values into the registry when the thread exits. */
+	class ThreadHandle {
+	public:
+		Block* block;
+
+		ThreadHandle() {
+			block = new Block;
+			Registry& registry = getRegistry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			registry.blocks.push_back(block);
+		}
+
+		~ThreadHandle() {
+			Registry& registry = getRegistry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			for (size_t i = 0; i < NCounters; i++) {
+				registry.retired[i] += block->values[i].load(std::memory_order_relaxed);
+			}
+			for (size_t i = 0; i < registry.blocks.size(); i++) {
+				if (registry.blocks[i] == block) {
+					registry.blocks.erase(registry.blocks.begin() + i);
+					break;
+				}
+			}
+			delete block;
+		}
+	};
+
+private:
+	static Registry& getRegistry() {
+		//never destroyed, so that threads exiting during program termination can still use it
+		static Registry* registry = new Registry;
+		return *registry;
+	}
+
+	static inline Block& getBlock() {
+		static thread_local ThreadHandle handle;
+		return *handle.block;
+	}
+
+public:
+	/** Adds a value to a counter of the calling thread. */
+	static inline void add(Counter counter, int64_t value) {
+		std::atomic<int64_t>& v = getBlock().values[counter];
+		v.store(v.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+	}
+#endif
+
+public:
+	/** Returns counter values summed over all threads (since the last reset()). */
+	static CCSDSMetricsSnapshot snapshot() {
+#ifndef CCSDS_METRICS_ENABLED
+		CCSDSMetricsSnapshot result;
+		result.values.resize(NCounters, 0);
+		return result;
+#else
+		Registry& registry = getRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		CCSDSMetricsSnapshot result;
+		result.values.resize(NCounters);
+		for (size_t i = 0; i < NCounters; i++) {
+			int64_t sum = registry.retired[i];
+			for (size_t j = 0; j < registry.blocks.size(); j++) {
+				sum += registry.blocks[j]->values[i].load(std::memory_order_relaxed);
+			}
+			result.values[i] = sum - registry.baseline[i];
+		}
+		return result;
+#endif
+	}
+
+public:
+	/** Makes subsequent snapshots count from now on.
+	 * Gauges such as TotalPendingADUSegments are also measured relative to this point.
+	 */
+	static void reset() {
+#ifdef CCSDS_METRICS_ENABLED
+		CCSDSMetricsSnapshot current = snapshot();
+		Registry& registry = getRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		for (size_t i = 0; i < NCounters; i++) {
+			registry.baseline[i] += current.values[i];
+		}
+#endif
+	}
+
+public:
+	/** Returns the name of a counter. */
+	static std::string getCounterName(size_t counter) {
+		static const char* names[NCounters] = { "DecodedPackets", "DecodedBytes", "NotACCSDSSpacePacketExceptions",
+				"SecondaryHeaderTooShortExceptions", "InconsistentPacketLengthExceptions",
+				"PacketErrorControlMismatchExceptions", "TotalPendingADUSegments", "CompletedADUs", "ADUSegmentCountJumps",
+				"ADUSegmentErrors" };
+		return (counter < NCounters) ? names[counter] : "Undefined";
+	}
+};
+
+inline std::string CCSDSMetricsSnapshot::toString() const {
+	std::stringstream ss;
+	for (size_t i = 0; i < values.size(); i++) {
+		ss << CCSDSMetrics::getCounterName(i) << " " << values[i] << std::endl;
+	}
+	return ss.str();
+}
+
+inline std::string CCSDSMetricsSnapshot::toJSON() const {
+	std::stringstream ss;
+	ss << "{";
+	for (size_t i = 0; i < values.size(); i++) {
+		ss << ((i == 0) ? "" : ", ") << "\"" << CCSDSMetrics::getCounterName(i) << "\": " << values[i];
+	}
+	ss << "}";
+	return ss.str();
+}
+
+#ifdef CCSDS_METRICS_ENABLED
+#define CCSDS_METRICS_ADD(counter, value) CCSDSMetrics::add(CCSDSMetrics::counter, value)
+#else
+#define CCSDS_METRICS_ADD(counter, value)
+#endif
+
+#endif /* CCSDSMETRICS_HH_ */
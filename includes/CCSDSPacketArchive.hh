@@ -0,0 +1,919 @@
+/*
+ * CCSDSPacketArchive.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSPACKETARCHIVE_HH_
+#define CCSDSPACKETARCHIVE_HH_
+
+#include "CCSDSCRC16.hh"
+#include "CCSDSPacketSource.hh"
+#include "CCSDSSpacePacketView.hh"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class CCSDSPacketArchiveException {
+public:
+	CCSDSPacketArchiveException(std::string str) {
+		message = str;
+	}
+
+public:
+	std::string toString() {
+		return message;
+	}
+
+public:
+	std::string message;
+};
+
+/** Index entry of a block in a CCSDSPacketArchive file.
+ */
+class CCSDSPacketArchiveBlockInfo {
+public:
+	uint64_t offset;
+	uint64_t firstPacketIndex;
+	uint32_t nPackets;
+	/** TI of the first/last packet with Secondary Header (0 if none). */
+	uint32_t firstTI;
+	uint32_t lastTI;
+	/** True if the block has at least one packet with Secondary Header. */
+	bool hasTI;
+};
+
+/** Definitions shared by CCSDSPacketArchiveWriter and CCSDSPacketArchiveReader.
+ *
+ * An archive stores packets in independent blocks (4096 packets by default).
+ * In a block, header fields are split into columns and each column is encoded as
+ * run-length pairs of LEB128 varints (value, run length - 1):
+ * - Primary Header word 0 (Packet Type, Secondary Header Flag, APID), as is
+ * - Packet Sequence Control, as the difference from (previous value of the APID + 1)
+ * - Packet Data Length, as is
+ * - TI, as the difference from the previous packet with Secondary Header
+ * - Category byte, as is
+ * - ADU Count, as the difference from the previous value of the APID
+ * - ADU Channel ID, as is
+ * - ADU Segment Flag/Count, as the difference from the previous value of the APID
+ * Differences are zigzag encoded, so the regular headers of a stream shrink to a few
+ * bytes per run. The rest of each packet (User Data Field and Packet Error Control)
+ * is stored after the columns, either as is (RawPayload) or, when smaller, XORed with
+ * the previous payload of the same APID and length in the block and then coded as
+ * (zero run, literal run) varint pairs followed by the literal bytes (DeltaPayload).
+ * Slowly changing housekeeping payloads are mostly zero runs after XOR.
+ *
+ * File layout (all integers little endian):
+ * - File header (16 bytes): "CCSDSARC", uint32 version, uint32 packets per block
+ * - Blocks: "CCSB", uint32 nPackets, uint32 rawLength, uint16 CRC-16 of the encoded part,
+ *   uint16 payload encoding, uint32 length of each of the 8 columns, uint32 payload length,
+ *   then the columns and the payloads
+ * - Index: one 32-byte entry per block (uint64 offset, uint64 first packet index,
+ *   uint32 nPackets, uint32 first TI, uint32 last TI, uint32 flags (bit 0: the block has TI))
+ * - Trailer (24 bytes): uint64 index offset, uint32 nBlocks, uint32 version, "CCSDSEND"
+ */
+class CCSDSPacketArchive {
+public:
+	static const uint32_t Version = 2;
+	/** Version 1 files have no block flags; a block is assumed to have TI if its TI range is non-zero. */
+	static const uint32_t OldestSupportedVersion = 1;
+	static const uint32_t BlockHasTI = 0x01;
+	static const size_t FileHeaderLength = 16;
+	static const size_t BlockHeaderLength = 52;
+	static const size_t IndexEntryLength = 32;
+	static const size_t TrailerLength = 24;
+	static const size_t DefaultNumberOfPacketsPerBlock = 4096;
+
+	enum Column {
+		PacketIdentification, SequenceControl, PacketDataLength, TimeIndicator, Category, ADUCount,
+		ADUChannelID, ADUSegment, NColumns
+	};
+
+	enum PayloadEncoding {
+		RawPayload, DeltaPayload
+	};
+
+	/** Per-APID state table size (Packet Type bit + 11-bit APID). */
+	static const size_t NStreams = 4096;
+
+public:
+	static inline void appendLittleEndian(std::vector<uint8_t>& output, uint64_t value, size_t nBytes) {
+		for (size_t i = 0; i < nBytes; i++) {
+			output.push_back((value >> (8 * i)) & 0xFF);
+		}
+	}
+
+public:
+	static inline uint64_t readLittleEndian(const uint8_t* data, size_t nBytes) {
+		uint64_t value = 0;
+		for (size_t i = 0; i < nBytes; i++) {
+			value |= (uint64_t) data[i] << (8 * i);
+		}
+		return value;
+	}
+
+public:
+	static inline uint32_t zigzag(int32_t value) {
+		return ((uint32_t) value << 1) ^ (uint32_t) (value >> 31);
+	}
+
+public:
+	static inline int32_t unzigzag(uint32_t value) {
+		return (int32_t) ((value >> 1) ^ (0 - (value & 1)));
+	}
+
+public:
+	/** Returns the state table index of a packet: Packet Type (bit 12) folded down to bit 11, plus APID. */
+	static inline size_t getStreamIndex(uint16_t packetIdentification) {
+		return ((packetIdentification >> 1) & 0x800) | (packetIdentification & 0x7FF);
+	}
+
+public:
+	static inline void appendVarint(std::vector<uint8_t>& output, uint32_t value) {
+		while (value >= 0x80) {
+			output.push_back((value & 0x7F) | 0x80);
+			value >>= 7;
+		}
+		output.push_back(value);
+	}
+
+public:
+	static inline uint32_t readVarint(const uint8_t*& p, const uint8_t* end) {
+		uint32_t value = 0;
+		for (size_t shift = 0; shift < 35; shift += 7) {
+			if (p == end) {
+				throw CCSDSPacketArchiveException("CCSDSPacketArchive: truncated column");
+			}
+			uint8_t byte = *p++;
+			value |= (uint32_t) (byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0) {
+				return value;
+			}
+		}
+		throw CCSDSPacketArchiveException("CCSDSPacketArchive: invalid varint");
+	}
+
+public:
+	/** Appends a payload XORed with a reference (NULL for none) as zero/literal runs. */
+	static void encodeDeltaPayload(const uint8_t* data, const uint8_t* reference, size_t length,
+			std::vector<uint8_t>& output) {
+		size_t i = 0;
+		while (i < length) {
+			size_t zeroStart = i;
+			while (i < length && (data[i] ^ (reference != NULL ? reference[i] : 0)) == 0) {
+				i++;
+			}
+			size_t literalStart = i;
+			//a literal run ends at two consecutive zero bytes
+			while (i < length && ((data[i] ^ (reference != NULL ? reference[i] : 0)) != 0
+					|| (i + 1 < length && (data[i + 1] ^ (reference != NULL ? reference[i + 1] : 0)) != 0))) {
+				i++;
+			}
+			appendVarint(output, literalStart - zeroStart);
+			appendVarint(output, i - literalStart);
+			for (size_t j = literalStart; j < i; j++) {
+				output.push_back(data[j] ^ (reference != NULL ? reference[j] : 0));
+			}
+		}
+	}
+
+public:
+	/** Decodes a payload encoded by encodeDeltaPayload().
+	 * @returns the position after the encoded payload.
+	 */
+	static const uint8_t* decodeDeltaPayload(const uint8_t* p, const uint8_t* end, const uint8_t* reference,
+			uint8_t* output, size_t length) {
+		size_t i = 0;
+		while (i < length) {
+			size_t nZeros = readVarint(p, end);
+			size_t nLiterals = readVarint(p, end);
+			if (nZeros > length - i || nLiterals > length - i - nZeros || nLiterals > (size_t) (end - p)) {
+				throw CCSDSPacketArchiveException("CCSDSPacketArchive: broken payload");
+			}
+			if (reference != NULL) {
+				std::memcpy(output + i, reference + i, nZeros);
+			} else {
+				std::memset(output + i, 0, nZeros);
+			}
+			i += nZeros;
+			if (reference != NULL) {
+				for (size_t j = 0; j < nLiterals; j++) {
+					output[i + j] = p[j] ^ reference[i + j];
+				}
+			} else {
+				std::memcpy(output + i, p, nLiterals);
+			}
+			p += nLiterals;
+			i += nLiterals;
+		}
+		return p;
+	}
+
+public:
+	/** Appends run-length encoded values. */
+	static void encodeColumn(const std::vector<uint32_t>& values, std::vector<uint8_t>& output) {
+		size_t i = 0;
+		while (i < values.size()) {
+			size_t j = i + 1;
+			while (j < values.size() && values[j] == values[i]) {
+				j++;
+			}
+			appendVarint(output, values[i]);
+			appendVarint(output, j - i - 1);
+			i = j;
+		}
+	}
+
+public:
+	/** Decodes exactly nValues run-length encoded values. */
+	static void decodeColumn(const uint8_t* p, const uint8_t* end, size_t nValues, std::vector<uint32_t>& values) {
+		values.resize(nValues);
+		size_t n = 0;
+		while (n < nValues) {
+			uint32_t value = readVarint(p, end);
+			size_t runLength = (size_t) readVarint(p, end) + 1;
+			if (runLength > nValues - n) {
+				throw CCSDSPacketArchiveException("CCSDSPacketArchive: column overrun");
+			}
+			std::fill_n(&values[n], runLength, value);
+			n += runLength;
+		}
+	}
+};
+
+/** A class that writes packets to a block-compressed archive file.
+ * See CCSDSPacketArchive for the format. Packets are buffered until a block is
+ * full, then encoded and written with one fwrite(). close() (or the destructor)
+ * writes the last block and the block index.
+ *
+ * @par
+ * Example:
+ * @code
+ CCSDSPacketArchiveWriter writer("downlink.ccsdsarc");
+ while (source.next(view)) {
+ 	writer.append(view);
+ }
+ writer.close();
+ * @endcode
+ */
+class CCSDSPacketArchiveWriter {
+public:
+	static const size_t MaximumNumberOfPacketsPerBlock = 32768;
+
+private:
+	FILE* file;
+	std::string filename;
+	size_t nPacketsPerBlock;
+	std::vector<uint32_t> columns[CCSDSPacketArchive::NColumns];
+	std::vector<uint8_t> payloads;
+	std::vector<uint8_t> deltaPayloads;
+	std::vector<uint8_t> encoded;
+	std::vector<size_t> lastPayloadOffsets;
+	std::vector<size_t> lastPayloadLengths;
+	std::vector<uint16_t> lastSequenceControls;
+	std::vector<uint8_t> lastADUCounts;
+	std::vector<uint16_t> lastADUSegments;
+	uint32_t lastTI;
+	bool hasTI;
+	CCSDSPacketArchiveBlockInfo currentBlock;
+	size_t blockRawLength;
+	std::vector<CCSDSPacketArchiveBlockInfo> blocks;
+	uint64_t offset;
+	uint64_t nPackets;
+	uint64_t nRawBytes;
+
+public:
+	/** Creates an archive file.
+	 * @param[in] filename output file name (overwritten).
+	 * @param[in] nPacketsPerBlock number of packets per block (the unit of random access).
+	 */
+	CCSDSPacketArchiveWriter(std::string filename,
+			size_t nPacketsPerBlock = CCSDSPacketArchive::DefaultNumberOfPacketsPerBlock) {
+		this->filename = filename;
+		//keeps the raw length of a block within 32 bits
+		this->nPacketsPerBlock = (nPacketsPerBlock == 0) ? 1 :
+				(nPacketsPerBlock > MaximumNumberOfPacketsPerBlock) ? MaximumNumberOfPacketsPerBlock : nPacketsPerBlock;
+		file = fopen(filename.c_str(), "wb");
+		if (file == NULL) {
+			throw CCSDSPacketArchiveException("CCSDSPacketArchiveWriter: cannot open " + filename);
+		}
+		lastSequenceControls.resize(CCSDSPacketArchive::NStreams);
+		lastADUCounts.resize(CCSDSPacketArchive::NStreams);
+		lastADUSegments.resize(CCSDSPacketArchive::NStreams);
+		lastPayloadOffsets.resize(CCSDSPacketArchive::NStreams);
+		lastPayloadLengths.resize(CCSDSPacketArchive::NStreams);
+		nPackets = 0;
+		nRawBytes = 0;
+		offset = 0;
+		std::vector<uint8_t> header;
+		const char* magic = "CCSDSARC";
+		header.insert(header.end(), magic, magic + 8);
+		CCSDSPacketArchive::appendLittleEndian(header, CCSDSPacketArchive::Version, 4);
+		CCSDSPacketArchive::appendLittleEndian(header, this->nPacketsPerBlock, 4);
+		try {
+			writeBytes(header);
+		} catch (...) {
+			fclose(file);
+			file = NULL;
+			throw;
+		}
+		startBlock();
+	}
+
+public:
+	~CCSDSPacketArchiveWriter() {
+		try {
+			close();
+		} catch (...) {
+		}
+	}
+
+private:
+	CCSDSPacketArchiveWriter(const CCSDSPacketArchiveWriter&);
+	CCSDSPacketArchiveWriter& operator=(const CCSDSPacketArchiveWriter&);
+
+private:
+	void writeBytes(const std::vector<uint8_t>& bytes) {
+		if (fwrite(&bytes[0], 1, bytes.size(), file) != bytes.size()) {
+			throw CCSDSPacketArchiveException("CCSDSPacketArchiveWriter: write error in " + filename);
+		}
+		offset += bytes.size();
+	}
+
+private:
+	void startBlock() {
+		for (size_t i = 0; i < CCSDSPacketArchive::NColumns; i++) {
+			columns[i].clear();
+		}
+		payloads.clear();
+		deltaPayloads.clear();
+		std::fill(lastPayloadLengths.begin(), lastPayloadLengths.end(), 0);
+		std::fill(lastSequenceControls.begin(), lastSequenceControls.end(), 0);
+		std::fill(lastADUCounts.begin(), lastADUCounts.end(), 0);
+		std::fill(lastADUSegments.begin(), lastADUSegments.end(), 0);
+		lastTI = 0;
+		hasTI = false;
+		currentBlock.offset = offset;
+		currentBlock.firstPacketIndex = nPackets;
+		currentBlock.nPackets = 0;
+		blockRawLength = 0;
+		currentBlock.firstTI = 0;
+		currentBlock.lastTI = 0;
+		currentBlock.hasTI = false;
+	}
+
+private:
+	void writeBlock() {
+		encoded.clear();
+		encoded.resize(CCSDSPacketArchive::BlockHeaderLength);
+		uint32_t columnLengths[CCSDSPacketArchive::NColumns];
+		for (size_t i = 0; i < CCSDSPacketArchive::NColumns; i++) {
+			size_t before = encoded.size();
+			CCSDSPacketArchive::encodeColumn(columns[i], encoded);
+			columnLengths[i] = encoded.size() - before;
+		}
+		bool delta = deltaPayloads.size() < payloads.size();
+		const std::vector<uint8_t>& payload = delta ? deltaPayloads : payloads;
+		encoded.insert(encoded.end(), payload.begin(), payload.end());
+		std::vector<uint8_t> header;
+		header.insert(header.end(), "CCSB", (const char*) "CCSB" + 4);
+		CCSDSPacketArchive::appendLittleEndian(header, currentBlock.nPackets, 4);
+		CCSDSPacketArchive::appendLittleEndian(header, blockRawLength, 4);
+		uint16_t crc = CCSDSCRC16::calculate(&encoded[CCSDSPacketArchive::BlockHeaderLength],
+				encoded.size() - CCSDSPacketArchive::BlockHeaderLength);
+		CCSDSPacketArchive::appendLittleEndian(header, crc, 2);
+		CCSDSPacketArchive::appendLittleEndian(header,
+				delta ? CCSDSPacketArchive::DeltaPayload : CCSDSPacketArchive::RawPayload, 2);
+		for (size_t i = 0; i < CCSDSPacketArchive::NColumns; i++) {
+			CCSDSPacketArchive::appendLittleEndian(header, columnLengths[i], 4);
+		}
+		CCSDSPacketArchive::appendLittleEndian(header, payload.size(), 4);
+		std::memcpy(&encoded[0], &header[0], header.size());
+		writeBytes(encoded);
+		blocks.push_back(currentBlock);
+		startBlock();
+	}
+
+public:
+	/** Appends a packet.
+	 * @throw CCSDSPacketArchiveException if the bytes are not a plausible packet.
+	 */
+	void append(const uint8_t* data, size_t length) {
+		if (file == NULL) {
+			throw CCSDSPacketArchiveException("CCSDSPacketArchiveWriter: already closed");
+		}
+		if (!CCSDSSpacePacketView::isPlausiblePacket(data, length)
+				|| CCSDSSpacePacketView::peekTotalPacketLength(data) != length) {
+			throw CCSDSPacketArchiveException("CCSDSPacketArchiveWriter: not a valid packet");
+		}
+		CCSDSSpacePacketView view(data, length);
+		uint16_t packetIdentification = ((uint16_t) data[0] << 8) | data[1];
+		size_t stream = CCSDSPacketArchive::getStreamIndex(packetIdentification);
+		uint16_t sequenceControl = ((uint16_t) data[2] << 8) | data[3];
+		columns[CCSDSPacketArchive::PacketIdentification].push_back(packetIdentification);
+		columns[CCSDSPacketArchive::SequenceControl].push_back(
+				CCSDSPacketArchive::zigzag((int16_t) (sequenceControl - lastSequenceControls[stream] - 1)));
+		lastSequenceControls[stream] = sequenceControl;
+		columns[CCSDSPacketArchive::PacketDataLength].push_back(((uint32_t) data[4] << 8) | data[5]);
+		if (view.isSecondaryHeaderPresent()) {
+			uint32_t ti = view.getTimeAsInteger();
+			columns[CCSDSPacketArchive::TimeIndicator].push_back(CCSDSPacketArchive::zigzag((int32_t) (ti - lastTI)));
+			lastTI = ti;
+			if (!hasTI) {
+				currentBlock.firstTI = ti;
+				currentBlock.hasTI = true;
+				hasTI = true;
+			}
+			currentBlock.lastTI = ti;
+			columns[CCSDSPacketArchive::Category].push_back(data[10]);
+			columns[CCSDSPacketArchive::ADUCount].push_back(
+					CCSDSPacketArchive::zigzag((int8_t) (data[11] - lastADUCounts[stream])));
+			lastADUCounts[stream] = data[11];
+			if (view.isADUChannelUsed()) {
+				uint16_t segment = ((uint16_t) data[13] << 8) | data[14];
+				columns[CCSDSPacketArchive::ADUChannelID].push_back(data[12]);
+				columns[CCSDSPacketArchive::ADUSegment].push_back(
+						CCSDSPacketArchive::zigzag((int16_t) (segment - lastADUSegments[stream])));
+				lastADUSegments[stream] = segment;
+			}
+		}
+		size_t headerLength = CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength + view.getSecondaryHeaderLength();
+		size_t payloadLength = length - headerLength;
+		const uint8_t* reference = NULL;
+		if (lastPayloadLengths[stream] == payloadLength && payloadLength != 0) {
+			reference = &payloads[lastPayloadOffsets[stream]];
+		}
+		CCSDSPacketArchive::encodeDeltaPayload(data + headerLength, reference, payloadLength, deltaPayloads);
+		lastPayloadOffsets[stream] = payloads.size();
+		lastPayloadLengths[stream] = payloadLength;
+		payloads.insert(payloads.end(), data + headerLength, data + length);
+		currentBlock.nPackets++;
+		nPackets++;
+		nRawBytes += length;
+		blockRawLength += length;
+		if (currentBlock.nPackets == nPacketsPerBlock) {
+			writeBlock();
+		}
+	}
+
+public:
+	/** Appends a packet view. */
+	void append(const CCSDSSpacePacketView& view) {
+		append(view.data, view.length);
+	}
+
+public:
+	/** Appends a packet instance. */
+	void append(CCSDSSpacePacket* packet) {
+		std::vector<uint8_t> bytes = packet->getAsByteVector();
+		append(&bytes[0], bytes.size());
+	}
+
+public:
+	/** Writes the last block and the index, and closes the file. */
+	void close() {
+		if (file == NULL) {
+			return;
+		}
+		if (currentBlock.nPackets != 0) {
+			writeBlock();
+		}
+		std::vector<uint8_t> index;
+		for (size_t i = 0; i < blocks.size(); i++) {
+			CCSDSPacketArchive::appendLittleEndian(index, blocks[i].offset, 8);
+			CCSDSPacketArchive::appendLittleEndian(index, blocks[i].firstPacketIndex, 8);
+			CCSDSPacketArchive::appendLittleEndian(index, blocks[i].nPackets, 4);
+			CCSDSPacketArchive::appendLittleEndian(index, blocks[i].firstTI, 4);
+			CCSDSPacketArchive::appendLittleEndian(index, blocks[i].lastTI, 4);
+			CCSDSPacketArchive::appendLittleEndian(index, blocks[i].hasTI ? CCSDSPacketArchive::BlockHasTI : 0, 4);
+		}
+		uint64_t indexOffset = offset;
+		CCSDSPacketArchive::appendLittleEndian(index, indexOffset, 8);
+		CCSDSPacketArchive::appendLittleEndian(index, blocks.size(), 4);
+		CCSDSPacketArchive::appendLittleEndian(index, CCSDSPacketArchive::Version, 4);
+		index.insert(index.end(), "CCSDSEND", (const char*) "CCSDSEND" + 8);
+		writeBytes(index);
+		bool failed = (fclose(file) != 0);
+		file = NULL;
+		if (failed) {
+			throw CCSDSPacketArchiveException("CCSDSPacketArchiveWriter: cannot close " + filename);
+		}
+	}
+
+public:
+	uint64_t getNumberOfPackets() const {
+		return nPackets;
+	}
+
+public:
+	uint64_t getNumberOfBlocks() const {
+		return blocks.size();
+	}
+
+public:
+	/** Returns the total length of appended packets. */
+	uint64_t getNumberOfRawBytes() const {
+		return nRawBytes;
+	}
+
+public:
+	/** Returns the number of bytes written to the file so far. */
+	uint64_t getNumberOfWrittenBytes() const {
+		return offset;
+	}
+};
+
+/** A class that reads a CCSDSPacketArchive file.
+ * The file is memory-mapped, and the block index at its end is loaded at construction.
+ * Blocks can be decoded in any order with decodeBlock() (each block is independent, so
+ * several threads may decode different blocks into their own buffers), or packets can
+ * be read sequentially through the CCSDSPacketSource interface.
+ *
+ * @par
+ * Example:
+ * @code
+ CCSDSPacketArchiveReader reader("downlink.ccsdsarc");
+ std::vector<uint8_t> packets;
+ std::vector<CCSDSSpacePacketView> views;
+ size_t block = reader.findBlockByTI(ti);
+ reader.decodeBlock(block, packets, views);
+ * @endcode
+ */
+class CCSDSPacketArchiveReader: public CCSDSPacketSource {
+private:
+	std::string filename;
+	const uint8_t* buffer;
+	size_t bufferSize;
+	void* mappedAddress;
+	uint32_t nPacketsPerBlock;
+	std::vector<CCSDSPacketArchiveBlockInfo> blocks;
+	/** Indices of the blocks that have TI (for findBlockByTI()). */
+	std::vector<size_t> blocksWithTI;
+	bool verificationEnabled;
+
+	//sequential reading
+	size_t nextBlock;
+	size_t nextPacket;
+	std::vector<uint8_t> blockPackets;
+	std::vector<CCSDSSpacePacketView> blockViews;
+
+public:
+	/** Opens an archive file.
+	 * @throw CCSDSPacketArchiveException if the file cannot be read or is not an archive.
+	 */
+	CCSDSPacketArchiveReader(std::string filename) {
+		this->filename = filename;
+		buffer = NULL;
+		bufferSize = 0;
+		mappedAddress = NULL;
+		verificationEnabled = true;
+		nextBlock = 0;
+		nextPacket = 0;
+		int fd = open(filename.c_str(), O_RDONLY);
+		if (fd < 0) {
+			throw CCSDSPacketArchiveException("CCSDSPacketArchiveReader: cannot open " + filename);
+		}
+		struct stat st;
+		if (fstat(fd, &st) != 0) {
+			close(fd);
+			throw CCSDSPacketArchiveException("CCSDSPacketArchiveReader: cannot stat " + filename);
+		}
+		bufferSize = st.st_size;
+		if (bufferSize != 0) {
+			mappedAddress = mmap(NULL, bufferSize, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mappedAddress == MAP_FAILED) {
+				mappedAddress = NULL;
+				close(fd);
+				throw CCSDSPacketArchiveException("CCSDSPacketArchiveReader: cannot map " + filename);
+			}
+			buffer = (const uint8_t*) mappedAddress;
+		}
+		close(fd);
+		try {
+			readIndex();
+		} catch (...) {
+			unmap();
+			throw;
+		}
+	}
+
+public:
+	virtual ~CCSDSPacketArchiveReader() {
+		unmap();
+	}
+
+private:
+	CCSDSPacketArchiveReader(const CCSDSPacketArchiveReader&);
+	CCSDSPacketArchiveReader& operator=(const CCSDSPacketArchiveReader&);
+
+private:
+	void unmap() {
+		if (mappedAddress != NULL) {
+			munmap(mappedAddress, bufferSize);
+			mappedAddress = NULL;
+		}
+	}
+
+private:
+	void readIndex() {
+		if (bufferSize < CCSDSPacketArchive::FileHeaderLength + CCSDSPacketArchive::TrailerLength
+				|| std::memcmp(buffer, "CCSDSARC", 8) != 0
+				|| std::memcmp(buffer + bufferSize - 8, "CCSDSEND", 8) != 0) {
+			throw CCSDSPacketArchiveException("CCSDSPacketArchiveReader: not an archive or not closed " + filename);
+		}
+		uint32_t version = CCSDSPacketArchive::readLittleEndian(buffer + 8, 4);
+		if (version < CCSDSPacketArchive::OldestSupportedVersion || version > CCSDSPacketArchive::Version) {
+			throw CCSDSPacketArchiveException("CCSDSPacketArchiveReader: unsupported version in " + filename);
+		}
+		nPacketsPerBlock = CCSDSPacketArchive::readLittleEndian(buffer + 12, 4);
+		if (nPacketsPerBlock == 0 || nPacketsPerBlock > CCSDSPacketArchiveWriter::MaximumNumberOfPacketsPerBlock) {
+			throw CCSDSPacketArchiveException("CCSDSPacketArchiveReader: broken file header in " + filename);
+		}
+		const uint8_t* trailer = buffer + bufferSize - CCSDSPacketArchive::TrailerLength;
+		uint64_t indexOffset = CCSDSPacketArchive::readLittleEndian(trailer, 8);
+		size_t nBlocks = CCSDSPacketArchive::readLittleEndian(trailer + 8, 4);
+		if (indexOffset + nBlocks * CCSDSPacketArchive::IndexEntryLength
+				!= bufferSize - CCSDSPacketArchive::TrailerLength) {
+			throw CCSDSPacketArchiveException("CCSDSPacketArchiveReader: broken index in " + filename);
+		}
+		blocks.resize(nBlocks);
+		blocksWithTI.clear();
+		for (size_t i = 0; i < nBlocks; i++) {
+			const uint8_t* entry = buffer + indexOffset + i * CCSDSPacketArchive::IndexEntryLength;
+			blocks[i].offset = CCSDSPacketArchive::readLittleEndian(entry, 8);
+			blocks[i].firstPacketIndex = CCSDSPacketArchive::readLittleEndian(entry + 8, 8);
+			blocks[i].nPackets = CCSDSPacketArchive::readLittleEndian(entry + 16, 4);
+			blocks[i].firstTI = CCSDSPacketArchive::readLittleEndian(entry + 20, 4);
+			blocks[i].lastTI = CCSDSPacketArchive::readLittleEndian(entry + 24, 4);
+			if (version == 1) {
+				blocks[i].hasTI = (blocks[i].firstTI != 0 || blocks[i].lastTI != 0);
+			} else {
+				blocks[i].hasTI = (CCSDSPacketArchive::readLittleEndian(entry + 28, 4) & CCSDSPacketArchive::BlockHasTI) != 0;
+			}
+			if (blocks[i].hasTI) {
+				blocksWithTI.push_back(i);
+			}
+			if (blocks[i].offset + CCSDSPacketArchive::BlockHeaderLength > indexOffset
+					|| blocks[i].nPackets > nPacketsPerBlock) {
+				throw CCSDSPacketArchiveException("CCSDSPacketArchiveReader: broken index in " + filename);
+			}
+		}
+	}
+
+public:
+	/** Sets whether the CRC of each block is verified when decoded (default true). */
+	void setVerificationEnabled(bool verificationEnabled) {
+		this->verificationEnabled = verificationEnabled;
+	}
+
+public:
+	size_t getNumberOfBlocks() const {
+		return blocks.size();
+	}
+
+public:
+	uint32_t getNumberOfPacketsPerBlock() const {
+		return nPacketsPerBlock;
+	}
+
+public:
+	const CCSDSPacketArchiveBlockInfo& getBlockInfo(size_t blockIndex) const {
+		return blocks.at(blockIndex);
+	}
+
+public:
+	uint64_t getNumberOfPackets() const {
+		return blocks.empty() ? 0 : blocks.back().firstPacketIndex + blocks.back().nPackets;
+	}
+
+public:
+	/** Returns the first block whose last TI is not earlier than ti (blocks are assumed to be in TI order).
+	 * Blocks without TI (no packet with Secondary Header) are skipped.
+	 * @returns getNumberOfBlocks() if all blocks are earlier or no block has TI.
+	 */
+	size_t findBlockByTI(uint32_t ti) const {
+		size_t low = 0;
+		size_t high = blocksWithTI.size();
+		while (low < high) {
+			size_t middle = (low + high) / 2;
+			if (blocks[blocksWithTI[middle]].lastTI < ti) {
+				low = middle + 1;
+			} else {
+				high = middle;
+			}
+		}
+		return (low == blocksWithTI.size()) ? blocks.size() : blocksWithTI[low];
+	}
+
+public:
+	/** Returns the block that contains a packet (by its index in the archive). */
+	size_t findBlockByPacketIndex(uint64_t packetIndex) const {
+		size_t low = 0;
+		size_t high = blocks.size();
+		while (low < high) {
+			size_t middle = (low + high) / 2;
+			if (blocks[middle].firstPacketIndex + blocks[middle].nPackets <= packetIndex) {
+				low = middle + 1;
+			} else {
+				high = middle;
+			}
+		}
+		return low;
+	}
+
+public:
+	/** Decodes a block.
+	 * @param[in] blockIndex block index.
+	 * @param[out] packets the packets of the block, concatenated.
+	 * @param[out] views views of the packets in packets.
+	 * @throw CCSDSPacketArchiveException if the block is corrupted.
+	 */
+	void decodeBlock(size_t blockIndex, std::vector<uint8_t>& packets, std::vector<CCSDSSpacePacketView>& views) const {
+		const CCSDSPacketArchiveBlockInfo& info = blocks.at(blockIndex);
+		const uint8_t* header = buffer + info.offset;
+		size_t limit = (blockIndex + 1 < blocks.size()) ? blocks[blockIndex + 1].offset :
+				bufferSize - CCSDSPacketArchive::TrailerLength - blocks.size() * CCSDSPacketArchive::IndexEntryLength;
+		if (std::memcmp(header, "CCSB", 4) != 0) {
+			throw CCSDSPacketArchiveException("CCSDSPacketArchiveReader: broken block header");
+		}
+		size_t nPackets = CCSDSPacketArchive::readLittleEndian(header + 4, 4);
+		size_t rawLength = CCSDSPacketArchive::readLittleEndian(header + 8, 4);
+		uint16_t crc = CCSDSPacketArchive::readLittleEndian(header + 12, 2);
+		uint16_t payloadEncoding = CCSDSPacketArchive::readLittleEndian(header + 14, 2);
+		if (payloadEncoding != CCSDSPacketArchive::RawPayload && payloadEncoding != CCSDSPacketArchive::DeltaPayload) {
+			throw CCSDSPacketArchiveException("CCSDSPacketArchiveReader: unknown payload encoding");
+		}
+		size_t lengths[CCSDSPacketArchive::NColumns + 1];
+		size_t encodedLength = 0;
+		for (size_t i = 0; i <= CCSDSPacketArchive::NColumns; i++) {
+			lengths[i] = CCSDSPacketArchive::readLittleEndian(header + 16 + 4 * i, 4);
+			encodedLength += lengths[i];
+		}
+		const uint8_t* p = header + CCSDSPacketArchive::BlockHeaderLength;
+		if (nPackets != info.nPackets || info.offset + CCSDSPacketArchive::BlockHeaderLength + encodedLength > limit) {
+			throw CCSDSPacketArchiveException("CCSDSPacketArchiveReader: broken block header");
+		}
+		if (verificationEnabled && CCSDSCRC16::calculate(p, encodedLength) != crc) {
+			throw CCSDSPacketArchiveException("CCSDSPacketArchiveReader: block CRC mismatch");
+		}
+
+		//the number of values of the Secondary Header columns is known after decoding word 0
+		std::vector<uint32_t> columns[CCSDSPacketArchive::NColumns];
+		const uint8_t* columnStarts[CCSDSPacketArchive::NColumns];
+		for (size_t i = 0; i < CCSDSPacketArchive::NColumns; i++) {
+			columnStarts[i] = p;
+			p += lengths[i];
+		}
+		const uint8_t* payload = p;
+		const uint8_t* payloadEnd = p + lengths[CCSDSPacketArchive::NColumns];
+		CCSDSPacketArchive::decodeColumn(columnStarts[0], columnStarts[0] + lengths[0], nPackets, columns[0]);
+		size_t nWithSecondaryHeader = 0;
+		for (size_t i = 0; i < nPackets; i++) {
+			nWithSecondaryHeader += (columns[0][i] >> 11) & 0x01;
+		}
+		for (size_t i = 1; i < CCSDSPacketArchive::NColumns; i++) {
+			size_t nValues = (i < CCSDSPacketArchive::TimeIndicator) ? nPackets : nWithSecondaryHeader;
+			if (i == CCSDSPacketArchive::ADUChannelID) {
+				nValues = 0;
+				for (size_t j = 0; j < nWithSecondaryHeader; j++) {
+					nValues += (columns[CCSDSPacketArchive::Category][j] >> 7) & 0x01;
+				}
+			} else if (i == CCSDSPacketArchive::ADUSegment) {
+				nValues = columns[CCSDSPacketArchive::ADUChannelID].size();
+			}
+			CCSDSPacketArchive::decodeColumn(columnStarts[i], columnStarts[i] + lengths[i], nValues, columns[i]);
+		}
+
+		//the header is not covered by the CRC, so rawLength is checked against the lengths before allocating
+		size_t expectedRawLength = 0;
+		for (size_t i = 0; i < nPackets; i++) {
+			expectedRawLength += CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength
+					+ (size_t) columns[CCSDSPacketArchive::PacketDataLength][i] + 1;
+		}
+		if (expectedRawLength != rawLength) {
+			throw CCSDSPacketArchiveException("CCSDSPacketArchiveReader: broken block (length)");
+		}
+
+		//rebuilds packets
+		packets.resize(rawLength);
+		views.resize(nPackets);
+		//per-stream state (heap allocated; about 68 kB in total)
+		std::vector<uint16_t> lastSequenceControls(CCSDSPacketArchive::NStreams, 0);
+		std::vector<uint8_t> lastADUCounts(CCSDSPacketArchive::NStreams, 0);
+		std::vector<uint16_t> lastADUSegments(CCSDSPacketArchive::NStreams, 0);
+		std::vector<const uint8_t*> lastPayloads(CCSDSPacketArchive::NStreams, (const uint8_t*) NULL);
+		std::vector<uint32_t> lastPayloadLengths(CCSDSPacketArchive::NStreams, 0);
+		uint32_t lastTI = 0;
+		size_t position = 0;
+		size_t s = 0;
+		size_t a = 0;
+		for (size_t i = 0; i < nPackets; i++) {
+			uint16_t packetIdentification = columns[CCSDSPacketArchive::PacketIdentification][i];
+			size_t stream = CCSDSPacketArchive::getStreamIndex(packetIdentification);
+			uint16_t sequenceControl = lastSequenceControls[stream] + 1
+					+ CCSDSPacketArchive::unzigzag(columns[CCSDSPacketArchive::SequenceControl][i]);
+			lastSequenceControls[stream] = sequenceControl;
+			uint16_t packetDataLength = columns[CCSDSPacketArchive::PacketDataLength][i];
+			size_t totalLength = CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength + (size_t) packetDataLength + 1;
+			if (position + totalLength > rawLength) {
+				throw CCSDSPacketArchiveException("CCSDSPacketArchiveReader: broken block (length)");
+			}
+			uint8_t* out = &packets[position];
+			out[0] = packetIdentification >> 8;
+			out[1] = packetIdentification & 0xFF;
+			out[2] = sequenceControl >> 8;
+			out[3] = sequenceControl & 0xFF;
+			out[4] = packetDataLength >> 8;
+			out[5] = packetDataLength & 0xFF;
+			size_t headerLength = CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength;
+			if ((packetIdentification & 0x0800) != 0) {
+				uint32_t ti = lastTI + CCSDSPacketArchive::unzigzag(columns[CCSDSPacketArchive::TimeIndicator][s]);
+				lastTI = ti;
+				uint8_t category = columns[CCSDSPacketArchive::Category][s];
+				uint8_t aduCount = lastADUCounts[stream]
+						+ CCSDSPacketArchive::unzigzag(columns[CCSDSPacketArchive::ADUCount][s]);
+				lastADUCounts[stream] = aduCount;
+				s++;
+				headerLength += ((category & 0x80) != 0) ?
+						CCSDSSpacePacketSecondaryHeader::SecondaryHeaderLengthWithADUChannel :
+						CCSDSSpacePacketSecondaryHeader::SecondaryHeaderLengthWithoutADUChannel;
+				if (headerLength > totalLength) {
+					throw CCSDSPacketArchiveException("CCSDSPacketArchiveReader: broken block (header)");
+				}
+				out[6] = ti >> 24;
+				out[7] = ti >> 16;
+				out[8] = ti >> 8;
+				out[9] = ti;
+				out[10] = category;
+				out[11] = aduCount;
+				if ((category & 0x80) != 0) {
+					uint16_t segment = lastADUSegments[stream]
+							+ CCSDSPacketArchive::unzigzag(columns[CCSDSPacketArchive::ADUSegment][a]);
+					lastADUSegments[stream] = segment;
+					out[12] = columns[CCSDSPacketArchive::ADUChannelID][a];
+					out[13] = segment >> 8;
+					out[14] = segment & 0xFF;
+					a++;
+				}
+			}
+			size_t payloadLength = totalLength - headerLength;
+			if (payloadEncoding == CCSDSPacketArchive::DeltaPayload) {
+				const uint8_t* reference = NULL;
+				if (lastPayloadLengths[stream] == payloadLength && payloadLength != 0) {
+					reference = lastPayloads[stream];
+				}
+				payload = CCSDSPacketArchive::decodeDeltaPayload(payload, payloadEnd, reference, out + headerLength,
+						payloadLength);
+				lastPayloads[stream] = out + headerLength;
+				lastPayloadLengths[stream] = payloadLength;
+			} else {
+				if (payloadLength > (size_t) (payloadEnd - payload)) {
+					throw CCSDSPacketArchiveException("CCSDSPacketArchiveReader: broken block (payload)");
+				}
+				std::memcpy(out + headerLength, payload, payloadLength);
+				payload += payloadLength;
+			}
+			views[i] = CCSDSSpacePacketView(out, totalLength);
+			position += totalLength;
+		}
+		if (position != rawLength || payload != payloadEnd) {
+			throw CCSDSPacketArchiveException("CCSDSPacketArchiveReader: broken block (length)");
+		}
+	}
+
+public:
+	/** Sets the next packet of next() to the first packet of a block. */
+	void seekBlock(size_t blockIndex) {
+		nextBlock = blockIndex;
+		nextPacket = 0;
+		blockViews.clear();
+	}
+
+public:
+	/** Retrieves the next packet (decoding blocks sequentially).
+	 * The view is valid until the next block is decoded.
+	 */
+	virtual bool next(CCSDSSpacePacketView& view) {
+		while (nextPacket == blockViews.size()) {
+			if (nextBlock >= blocks.size()) {
+				return false;
+			}
+			decodeBlock(nextBlock, blockPackets, blockViews);
+			nextBlock++;
+			nextPacket = 0;
+		}
+		view = blockViews[nextPacket];
+		nextPacket++;
+		return true;
+	}
+};
+
+#endif /* CCSDSPACKETARCHIVE_HH_ */
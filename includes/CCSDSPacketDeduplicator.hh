@@ -0,0 +1,251 @@
+/*
+ * CCSDSPacketDeduplicator.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSPACKETDEDUPLICATOR_HH_
+#define CCSDSPACKETDEDUPLICATOR_HH_
+
+#include "CCSDSPacketSource.hh"
+#include <vector>
+
+/** A class that eliminates duplicate packets delivered by redundant links.
+ * A packet is identified by (Packet Type, APID, Packet Sequence Count, TI), and
+ * optionally by a hash of its Packet Data Field. Identifiers of the last
+ * windowSize unique packets are remembered in a fixed-size hash table, so that
+ * memory usage is bounded and each lookup touches a single 64-byte bucket
+ * of four entries.
+ * When all four entries of a bucket are still within the window, the oldest
+ * one is evicted (counted by getNumberOfEvictions()); a later copy of the
+ * evicted packet would then not be detected as a duplicate.
+ *
+ * @par
+ * Example (placed directly after a packet source):
+ * @code
+ CCSDSPacketDeduplicator deduplicator(100000);
+ CCSDSSpacePacketView view;
+ while (source.next(view)) {
+ 	if (deduplicator.isDuplicate(view)) {
+ 		continue;
+ 	}
+ 	...
+ }
+ * @endcode
+ * @see CCSDSDeduplicatedPacketSource
+ */
+class CCSDSPacketDeduplicator {
+public:
+	static const size_t DefaultWindowSize = 65536;
+	static const size_t NEntriesPerBucket = 4;
+
+private:
+	class Entry {
+	public:
+		uint64_t key;
+		uint32_t payloadHash;
+		uint32_t stamp;
+	};
+
+	static const uint64_t EmptyKey = ~(uint64_t) 0;
+
+private:
+	std::vector<Entry> storage;
+	Entry* entries;
+	size_t bucketMask;
+	uint32_t windowSize;
+	uint32_t nInserted;
+	bool usePayloadHash;
+	uint64_t nPackets;
+	uint64_t nDuplicates;
+	uint64_t nEvictions;
+
+public:
+	/** Constructs an instance.
+	 * @param[in] windowSize number of most recent unique packets remembered (less than 2^31).
+	 * @param[in] usePayloadHash if true, a hash of the Packet Data Field is also compared.
+	 */
+	CCSDSPacketDeduplicator(size_t windowSize = DefaultWindowSize, bool usePayloadHash = false) {
+		this->windowSize = (windowSize == 0) ? 1 : windowSize;
+		this->usePayloadHash = usePayloadHash;
+		//keep the table at most a quarter full with the window, so that buckets rarely overflow
+		size_t nBuckets = 1;
+		while (nBuckets * NEntriesPerBucket < 4 * (size_t) this->windowSize) {
+			nBuckets *= 2;
+		}
+		bucketMask = nBuckets - 1;
+		Entry empty;
+		empty.key = EmptyKey;
+		empty.payloadHash = 0;
+		empty.stamp = 0;
+		//over-allocate so that each bucket starts at a 64-byte boundary
+		storage.assign(nBuckets * NEntriesPerBucket + NEntriesPerBucket - 1, empty);
+		size_t misalignment = ((size_t) &storage[0] % (NEntriesPerBucket * sizeof(Entry))) / sizeof(Entry);
+		entries = &storage[0] + ((misalignment == 0) ? 0 : NEntriesPerBucket - misalignment);
+		nInserted = 0;
+		resetCounters();
+	}
+
+public:
+	/** Checks if a packet was already seen within the window.
+	 * A packet that is not a duplicate is remembered.
+	 * @param[in] view a packet.
+	 * @returns true if the packet is a duplicate.
+	 */
+	bool isDuplicate(const CCSDSSpacePacketView& view) {
+		uint64_t key = calculateKey(view.getPacketType(), view.getAPIDAsInteger(), view.getSequenceCount(),
+				view.isSecondaryHeaderPresent() ? view.getTimeAsInteger() : 0);
+		uint32_t payloadHash = 0;
+		if (usePayloadHash) {
+			payloadHash = calculatePayloadHash(view.data + CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength,
+					view.getTotalPacketLength() - CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength);
+		}
+		return isDuplicate(key, payloadHash);
+	}
+
+public:
+	/** Checks if a packet was already seen within the window.
+	 * @param[in] data a pointer to a packet.
+	 * @param[in] length the length of the packet.
+	 * @returns true if the packet is a duplicate.
+	 */
+	bool isDuplicate(const uint8_t* data, size_t length) {
+		return isDuplicate(CCSDSSpacePacketView(data, length));
+	}
+
+public:
+	/** Copies non-duplicate packets from a batch to a result vector (the batch order is kept).
+	 * @param[in] views input packets.
+	 * @param[out] result non-duplicate packets are appended.
+	 */
+	void filter(const std::vector<CCSDSSpacePacketView>& views, std::vector<CCSDSSpacePacketView>& result) {
+		for (size_t i = 0; i < views.size(); i++) {
+			if (!isDuplicate(views[i])) {
+				result.push_back(views[i]);
+			}
+		}
+	}
+
+public:
+	/** Returns the number of checked packets. */
+	uint64_t getNumberOfPackets() const {
+		return nPackets;
+	}
+
+public:
+	/** Returns the number of packets detected as duplicates. */
+	uint64_t getNumberOfDuplicates() const {
+		return nDuplicates;
+	}
+
+public:
+	/** Returns the number of unique packets. */
+	uint64_t getNumberOfUniquePackets() const {
+		return nPackets - nDuplicates;
+	}
+
+public:
+	/** Returns the number of identifiers forgotten before leaving the window
+	 * because their bucket was full.
+	 */
+	uint64_t getNumberOfEvictions() const {
+		return nEvictions;
+	}
+
+public:
+	/** Resets counters (remembered packets are kept). */
+	void resetCounters() {
+		nPackets = 0;
+		nDuplicates = 0;
+		nEvictions = 0;
+	}
+
+private:
+	static inline uint64_t calculateKey(uint8_t packetType, uint16_t apid, uint16_t sequenceCount, uint32_t ti) {
+		return ((uint64_t) packetType << 57) | ((uint64_t) apid << 46) | ((uint64_t) sequenceCount << 32) | ti;
+	}
+
+private:
+	static inline uint32_t calculatePayloadHash(const uint8_t* data, size_t length) {
+		//FNV-1a
+		uint32_t hash = 2166136261u;
+		for (size_t i = 0; i < length; i++) {
+			hash = (hash ^ data[i]) * 16777619u;
+		}
+		return hash;
+	}
+
+private:
+	static inline uint64_t mix(uint64_t key) {
+		key ^= key >> 33;
+		key *= 0xff51afd7ed558ccdULL;
+		key ^= key >> 33;
+		key *= 0xc4ceb9fe1a85ec53ULL;
+		key ^= key >> 33;
+		return key;
+	}
+
+private:
+	bool isDuplicate(uint64_t key, uint32_t payloadHash) {
+		nPackets++;
+		Entry* bucket = entries + (mix(key) & bucketMask) * NEntriesPerBucket;
+		Entry* victim = NULL;
+		Entry* oldest = bucket;
+		uint32_t oldestAge = 0;
+		for (size_t i = 0; i < NEntriesPerBucket; i++) {
+			//0 for the most recently inserted packet
+			uint32_t age = nInserted - 1 - bucket[i].stamp;
+			bool live = (bucket[i].key != EmptyKey && age < windowSize);
+			if (!live) {
+				if (victim == NULL) {
+					victim = &bucket[i];
+				}
+			} else if (bucket[i].key == key && bucket[i].payloadHash == payloadHash) {
+				nDuplicates++;
+				return true;
+			} else if (age >= oldestAge) {
+				oldest = &bucket[i];
+				oldestAge = age;
+			}
+		}
+		if (victim == NULL) {
+			victim = oldest;
+			nEvictions++;
+		}
+		victim->key = key;
+		victim->payloadHash = payloadHash;
+		victim->stamp = nInserted;
+		nInserted++;
+		return false;
+	}
+};
+
+/** A packet source that passes through packets of another source, skipping duplicates.
+ * @see CCSDSPacketDeduplicator
+ */
+class CCSDSDeduplicatedPacketSource: public CCSDSPacketSource {
+private:
+	CCSDSPacketSource* source;
+	CCSDSPacketDeduplicator* deduplicator;
+
+public:
+	/** Constructs an instance. Neither the source nor the deduplicator is deleted by this class.
+	 */
+	CCSDSDeduplicatedPacketSource(CCSDSPacketSource* source, CCSDSPacketDeduplicator* deduplicator) {
+		this->source = source;
+		this->deduplicator = deduplicator;
+	}
+
+public:
+	virtual bool next(CCSDSSpacePacketView& view) {
+		while (source->next(view)) {
+			if (!deduplicator->isDuplicate(view)) {
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+#endif /* CCSDSPACKETDEDUPLICATOR_HH_ */
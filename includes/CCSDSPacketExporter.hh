@@ -0,0 +1,444 @@
+/*
+ * CCSDSPacketExporter.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSPACKETEXPORTER_HH_
+#define CCSDSPACKETEXPORTER_HH_
+
+#include "CCSDSSpacePacketView.hh"
+#include "CCSDSFormatBuffer.hh"
+#include <string>
+#include <vector>
+#include <fstream>
+
+class CCSDSPacketExporterException {
+public:
+	CCSDSPacketExporterException(std::string str) {
+		message = str;
+	}
+
+public:
+	std::string toString() {
+		return message;
+	}
+
+public:
+	std::string message;
+};
+
+/** Header fields of one packet, as exported by CCSDSPacketExporter.
+ * Secondary Header fields are 0 when the Secondary Header is absent,
+ * and ADU fields are 0 when the ADU Channel is not used.
+ */
+class CCSDSPacketExporterRow {
+public:
+	uint64_t packetOffset;
+	uint16_t apid;
+	uint8_t packetType;
+	uint8_t secondaryHeaderFlag;
+	uint8_t sequenceFlag;
+	uint16_t sequenceCount;
+	uint16_t packetDataLength;
+	uint8_t category;
+	uint8_t aduChannelUsed;
+	uint8_t aduChannelID;
+	uint8_t aduCount;
+	uint8_t aduSegmentFlag;
+	uint16_t aduSegmentCount;
+	uint32_t ti;
+	uint64_t payloadOffset;
+	uint32_t payloadLength;
+
+public:
+	/** Fills fields from a packet view.
+	 * @param[in] view a packet.
+	 * @param[in] packetOffset position of the packet in the exported stream (e.g. file offset).
+	 */
+	void set(const CCSDSSpacePacketView& view, uint64_t packetOffset) {
+		this->packetOffset = packetOffset;
+		apid = view.getAPIDAsInteger();
+		packetType = view.getPacketType();
+		secondaryHeaderFlag = view.isSecondaryHeaderPresent() ? 1 : 0;
+		sequenceFlag = view.getSequenceFlag();
+		sequenceCount = view.getSequenceCount();
+		packetDataLength = view.getPacketDataLength();
+		category = 0;
+		aduChannelUsed = 0;
+		aduChannelID = 0;
+		aduCount = 0;
+		aduSegmentFlag = 0;
+		aduSegmentCount = 0;
+		ti = 0;
+		if (secondaryHeaderFlag) {
+			ti = view.getTimeAsInteger();
+			category = view.getCategory();
+			aduCount = view.getADUCount();
+			if (view.isADUChannelUsed()) {
+				aduChannelUsed = 1;
+				aduChannelID = view.getADUChannelID();
+				aduSegmentFlag = view.getADUSegmentFlag();
+				aduSegmentCount = view.getADUSegmentCount();
+			}
+		}
+		size_t headerLength = CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength + view.getSecondaryHeaderLength();
+		payloadOffset = packetOffset + headerLength;
+		payloadLength = view.getTotalPacketLength() - headerLength;
+	}
+};
+
+/** A base class of streaming exporters that write packet header fields and
+ * payload offsets in a batched manner.
+ * Rows are accumulated in memory and written out every batch (default 65536 rows),
+ * so that the output file receives a small number of large writes.
+ * Subclasses define the output format.
+ * @see CCSDSCSVPacketExporter, CCSDSColumnarPacketExporter
+ */
+class CCSDSPacketExporter {
+public:
+	static const size_t DefaultBatchSize = 65536;
+
+	static const size_t NColumns = 16;
+
+	/** Returns the name of the i-th column. */
+	static const char* getColumnName(size_t i) {
+		static const char* names[NColumns] = { "packet_offset", "apid", "packet_type", "secondary_header_flag",
+				"sequence_flag", "sequence_count", "packet_data_length", "category", "adu_channel_used", "adu_channel_id",
+				"adu_count", "adu_segment_flag", "adu_segment_count", "ti", "payload_offset", "payload_length" };
+		return names[i];
+	}
+
+	/** Returns the byte width of the i-th column in the binary columnar format. */
+	static size_t getColumnWidth(size_t i) {
+		static const size_t widths[NColumns] = { 8, 2, 1, 1, 1, 2, 2, 1, 1, 1, 1, 1, 2, 4, 8, 4 };
+		return widths[i];
+	}
+
+protected:
+	std::ostream* os;
+	std::ofstream* ofs;
+	size_t batchSize;
+	size_t nRowsInBatch;
+	uint64_t nRowsExported;
+	bool headerWritten;
+	bool closed;
+
+public:
+	/** Constructs an instance that writes to a file.
+	 * @param[in] filename output file name.
+	 */
+	CCSDSPacketExporter(std::string filename) {
+		initialize();
+		ofs = new std::ofstream(filename.c_str(), std::ios::binary | std::ios::trunc);
+		if (!ofs->is_open()) {
+			delete ofs;
+			ofs = NULL;
+			throw CCSDSPacketExporterException("CCSDSPacketExporter: cannot open " + filename);
+		}
+		os = ofs;
+	}
+
+public:
+	/** Constructs an instance that writes to an output stream.
+	 * @param[in] os output stream such as fstream or stringstream.
+	 */
+	CCSDSPacketExporter(std::ostream& os) {
+		initialize();
+		this->os = &os;
+	}
+
+public:
+	/** Destructor. Subclasses must call close() in their destructors.
+	 */
+	virtual ~CCSDSPacketExporter() {
+		if (ofs != NULL) {
+			delete ofs;
+		}
+	}
+
+private:
+	void initialize() {
+		os = NULL;
+		ofs = NULL;
+		batchSize = DefaultBatchSize;
+		nRowsInBatch = 0;
+		nRowsExported = 0;
+		headerWritten = false;
+		closed = false;
+	}
+
+public:
+	/** Sets the number of rows accumulated before a batch is written. */
+	void setBatchSize(size_t batchSize) {
+		this->batchSize = (batchSize == 0) ? 1 : batchSize;
+	}
+
+public:
+	/** Returns the number of rows exported so far (including rows not yet flushed). */
+	uint64_t getNumberOfExportedRows() const {
+		return nRowsExported;
+	}
+
+public:
+	/** Exports a packet.
+	 * @param[in] view a packet.
+	 * @param[in] packetOffset position of the packet in its source (e.g. file offset).
+	 */
+	void push(const CCSDSSpacePacketView& view, uint64_t packetOffset) {
+		CCSDSPacketExporterRow row;
+		row.set(view, packetOffset);
+		push(row);
+	}
+
+public:
+	/** Exports a row. */
+	void push(const CCSDSPacketExporterRow& row) {
+		if (!headerWritten) {
+			writeHeader();
+			headerWritten = true;
+		}
+		appendRow(row);
+		nRowsInBatch++;
+		nRowsExported++;
+		if (nRowsInBatch == batchSize) {
+			flush();
+		}
+	}
+
+public:
+	/** Exports packets whose views point into a common buffer.
+	 * Packet offsets are calculated relative to the buffer.
+	 * @param[in] views packet views, e.g. returned by CCSDSParallelFileDecoder::decode().
+	 * @param[in] buffer the beginning of the buffer (e.g. CCSDSParallelFileDecoder::getBuffer()).
+	 */
+	void push(const std::vector<CCSDSSpacePacketView>& views, const uint8_t* buffer) {
+		for (size_t i = 0; i < views.size(); i++) {
+			push(views[i], views[i].data - buffer);
+		}
+	}
+
+public:
+	/** Writes accumulated rows to the output. */
+	void flush() {
+		if (!headerWritten) {
+			writeHeader();
+			headerWritten = true;
+		}
+		if (nRowsInBatch != 0) {
+			writeBatch();
+			nRowsInBatch = 0;
+		}
+		os->flush();
+		if (!os->good()) {
+			throw CCSDSPacketExporterException("CCSDSPacketExporter: write failed");
+		}
+	}
+
+public:
+	/** Flushes accumulated rows and finishes the output. Called by destructors of subclasses.
+	 */
+	void close() {
+		if (closed) {
+			return;
+		}
+		closed = true;
+		flush();
+		if (ofs != NULL) {
+			ofs->close();
+		}
+	}
+
+protected:
+	virtual void writeHeader() = 0;
+	virtual void appendRow(const CCSDSPacketExporterRow& row) = 0;
+	virtual void writeBatch() = 0;
+};
+
+/** An exporter that writes one CSV line per packet with a header line.
+ * Secondary Header fields are left empty when the Secondary Header is absent,
+ * and ADU fields are left empty when the ADU Channel is not used.
+ */
+class CCSDSCSVPacketExporter: public CCSDSPacketExporter {
+private:
+	CCSDSFormatBuffer buffer;
+
+public:
+	CCSDSCSVPacketExporter(std::string filename) :
+			CCSDSPacketExporter(filename), buffer(1024 * 1024) {
+	}
+
+public:
+	CCSDSCSVPacketExporter(std::ostream& os) :
+			CCSDSPacketExporter(os), buffer(1024 * 1024) {
+	}
+
+public:
+	virtual ~CCSDSCSVPacketExporter() {
+		try {
+			close();
+		} catch (...) {
+		}
+	}
+
+protected:
+	virtual void writeHeader() {
+		for (size_t i = 0; i < NColumns; i++) {
+			buffer.append(getColumnName(i));
+			buffer.appendChar((i == NColumns - 1) ? '\n' : ',');
+		}
+	}
+
+protected:
+	virtual void appendRow(const CCSDSPacketExporterRow& row) {
+		buffer.appendDecimal(row.packetOffset).appendChar(',');
+		buffer.appendDecimal(row.apid).appendChar(',');
+		buffer.appendDecimal(row.packetType).appendChar(',');
+		buffer.appendDecimal(row.secondaryHeaderFlag).appendChar(',');
+		buffer.appendDecimal(row.sequenceFlag).appendChar(',');
+		buffer.appendDecimal(row.sequenceCount).appendChar(',');
+		buffer.appendDecimal(row.packetDataLength).appendChar(',');
+		if (row.secondaryHeaderFlag) {
+			buffer.appendDecimal(row.category).appendChar(',');
+			buffer.appendDecimal(row.aduChannelUsed).appendChar(',');
+			if (row.aduChannelUsed) {
+				buffer.appendDecimal(row.aduChannelID).appendChar(',');
+			} else {
+				buffer.appendChar(',');
+			}
+			buffer.appendDecimal(row.aduCount).appendChar(',');
+			if (row.aduChannelUsed) {
+				buffer.appendDecimal(row.aduSegmentFlag).appendChar(',');
+				buffer.appendDecimal(row.aduSegmentCount).appendChar(',');
+			} else {
+				buffer.append(",,");
+			}
+			buffer.appendDecimal(row.ti).appendChar(',');
+		} else {
+			buffer.append(",,,,,,,");
+		}
+		buffer.appendDecimal(row.payloadOffset).appendChar(',');
+		buffer.appendDecimal(row.payloadLength).appendChar('\n');
+	}
+
+protected:
+	virtual void writeBatch() {
+		buffer.writeTo(*os);
+		buffer.clear();
+	}
+};
+
+/** An exporter that writes a simple self-describing binary columnar file.
+ * All integers are little endian.
+ * <pre>
+ * File header:
+ *   char[8]  magic "CCSDSCOL"
+ *   uint32   format version (1)
+ *   uint32   number of columns
+ *   per column:
+ *     uint8  byte width of the column (1, 2, 4, or 8; unsigned integer)
+ *     uint8  length of the column name
+ *     char[] column name (not null-terminated)
+ * Blocks (repeated until the end of file):
+ *   uint64   number of rows in this block (N)
+ *   per column, in header order:
+ *     N values of the column, each of the declared byte width
+ * </pre>
+ * Each block holds one batch, so a reader can load a column of a block with a single read.
+ */
+class CCSDSColumnarPacketExporter: public CCSDSPacketExporter {
+public:
+	static const uint32_t FormatVersion = 1;
+
+private:
+	std::vector<uint8_t> columns[NColumns];
+
+public:
+	CCSDSColumnarPacketExporter(std::string filename) :
+			CCSDSPacketExporter(filename) {
+	}
+
+public:
+	CCSDSColumnarPacketExporter(std::ostream& os) :
+			CCSDSPacketExporter(os) {
+	}
+
+public:
+	virtual ~CCSDSColumnarPacketExporter() {
+		try {
+			close();
+		} catch (...) {
+		}
+	}
+
+private:
+	static inline void appendLittleEndian(std::vector<uint8_t>& column, uint64_t value, size_t width) {
+		for (size_t i = 0; i < width; i++) {
+			column.push_back((uint8_t) (value >> (8 * i)));
+		}
+	}
+
+private:
+	static inline void storeLittleEndian(uint8_t* p, uint64_t value, size_t width) {
+		for (size_t i = 0; i < width; i++) {
+			p[i] = (uint8_t) (value >> (8 * i));
+		}
+	}
+
+protected:
+	virtual void writeHeader() {
+		std::vector<uint8_t> header;
+		const char magic[] = "CCSDSCOL";
+		header.insert(header.end(), magic, magic + 8);
+		appendLittleEndian(header, FormatVersion, 4);
+		appendLittleEndian(header, NColumns, 4);
+		for (size_t i = 0; i < NColumns; i++) {
+			const char* name = getColumnName(i);
+			size_t nameLength = strlen(name);
+			header.push_back((uint8_t) getColumnWidth(i));
+			header.push_back((uint8_t) nameLength);
+			header.insert(header.end(), name, name + nameLength);
+			columns[i].resize(batchSize * getColumnWidth(i));
+		}
+		os->write((const char*) &header[0], header.size());
+	}
+
+protected:
+	virtual void appendRow(const CCSDSPacketExporterRow& row) {
+		size_t i = nRowsInBatch;
+		if (columns[0].size() < (i + 1) * 8) {
+			for (size_t c = 0; c < NColumns; c++) {
+				columns[c].resize((i + 1) * getColumnWidth(c) * 2);
+			}
+		}
+		storeLittleEndian(&columns[0][i * 8], row.packetOffset, 8);
+		storeLittleEndian(&columns[1][i * 2], row.apid, 2);
+		columns[2][i] = row.packetType;
+		columns[3][i] = row.secondaryHeaderFlag;
+		columns[4][i] = row.sequenceFlag;
+		storeLittleEndian(&columns[5][i * 2], row.sequenceCount, 2);
+		storeLittleEndian(&columns[6][i * 2], row.packetDataLength, 2);
+		columns[7][i] = row.category;
+		columns[8][i] = row.aduChannelUsed;
+		columns[9][i] = row.aduChannelID;
+		columns[10][i] = row.aduCount;
+		columns[11][i] = row.aduSegmentFlag;
+		storeLittleEndian(&columns[12][i * 2], row.aduSegmentCount, 2);
+		storeLittleEndian(&columns[13][i * 4], row.ti, 4);
+		storeLittleEndian(&columns[14][i * 8], row.payloadOffset, 8);
+		storeLittleEndian(&columns[15][i * 4], row.payloadLength, 4);
+	}
+
+protected:
+	virtual void writeBatch() {
+		std::vector<uint8_t> blockHeader;
+		appendLittleEndian(blockHeader, nRowsInBatch, 8);
+		os->write((const char*) &blockHeader[0], blockHeader.size());
+		for (size_t i = 0; i < NColumns; i++) {
+			os->write((const char*) &columns[i][0], nRowsInBatch * getColumnWidth(i));
+		}
+	}
+};
+
+#endif /* CCSDSPACKETEXPORTER_HH_ */
@@ -0,0 +1,248 @@
+/*
+ * CCSDSPacketFilter.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSPACKETFILTER_HH_
+#define CCSDSPACKETFILTER_HH_
+
+#include "CCSDSSpacePacketView.hh"
+#include <cstring>
+#include <vector>
+
+/** A packet filter compiled into bitmaps and evaluated on raw header bytes.
+ * Rules are compiled, as they are added, into a 2048-bit APID bitmap and a 128-bit
+ * Category bitmap for each Packet Type (TM/TC). Evaluating a packet is two bit
+ * tests on the first 11 header bytes, so packets can be dropped before they are
+ * decoded. The Category test applies only to packets with Secondary Header.
+ *
+ * A new filter accepts no APID. Category filtering of a Packet Type is enabled
+ * by the first acceptCategory() for that type; until then all Categories (and
+ * packets without Secondary Header) pass. Once enabled, packets without
+ * Secondary Header are rejected unless setPacketsWithoutSecondaryHeaderAccepted()
+ * is called afterwards.
+ *
+ * Evaluation methods are const and can be called from multiple threads.
+ *
+ * @par
+ * Example:
+ * @code
+ CCSDSPacketFilter filter;
+ filter.acceptAPIDRange(0x100, 0x1FF);
+ filter.rejectIdlePackets();
+ filter.acceptCategory(CCSDSSpacePacketPacketType::TelemetryPacket, 2);
+ std::vector<uint32_t> selection;
+ filter.select(views, selection);
+ for (size_t i = 0; i < selection.size(); i++) {
+ 	...views[selection[i]]...
+ }
+ * @endcode
+ */
+class CCSDSPacketFilter {
+public:
+	static const size_t NAPIDs = 2048;
+	static const size_t NCategories = 128;
+	/** Pass as packetType to apply a rule to both TM and TC packets. */
+	static const int AnyPacketType = -1;
+
+private:
+	uint64_t apidBitmaps[2][NAPIDs / 64];
+	uint64_t categoryBitmaps[2][NCategories / 64];
+	bool categoryFilterEnabled[2];
+	bool packetsWithoutSecondaryHeaderAccepted[2];
+	/** Results for packets without Category, indexed by [type][Secondary Header Flag]. */
+	uint64_t resultsWithoutCategory[2][2];
+
+public:
+	CCSDSPacketFilter() {
+		clear();
+	}
+
+public:
+	/** Resets to the initial state (no APID accepted, no Category filtering). */
+	void clear() {
+		std::memset(apidBitmaps, 0, sizeof(apidBitmaps));
+		std::memset(categoryBitmaps, 0xFF, sizeof(categoryBitmaps));
+		for (size_t type = 0; type < 2; type++) {
+			categoryFilterEnabled[type] = false;
+			packetsWithoutSecondaryHeaderAccepted[type] = true;
+		}
+		updateResultsWithoutCategory();
+	}
+
+private:
+	void updateResultsWithoutCategory() {
+		for (size_t type = 0; type < 2; type++) {
+			resultsWithoutCategory[type][0] = packetsWithoutSecondaryHeaderAccepted[type] ? 1 : 0;
+			//Secondary Header present but truncated
+			resultsWithoutCategory[type][1] = categoryFilterEnabled[type] ? 0 : 1;
+		}
+	}
+
+private:
+	void setAPIDs(uint16_t first, uint16_t last, int packetType, bool accepted) {
+		for (size_t type = 0; type < 2; type++) {
+			if (packetType != AnyPacketType && (size_t) packetType != type) {
+				continue;
+			}
+			for (size_t apid = first; apid <= last && apid < NAPIDs; apid++) {
+				if (accepted) {
+					apidBitmaps[type][apid / 64] |= (uint64_t) 1 << (apid % 64);
+				} else {
+					apidBitmaps[type][apid / 64] &= ~((uint64_t) 1 << (apid % 64));
+				}
+			}
+		}
+	}
+
+public:
+	/** Accepts an APID.
+	 * @param[in] apid APID.
+	 * @param[in] packetType CCSDSSpacePacketPacketType::TelemetryPacket, CommandPacket, or AnyPacketType.
+	 */
+	void acceptAPID(uint16_t apid, int packetType = AnyPacketType) {
+		setAPIDs(apid, apid, packetType, true);
+	}
+
+public:
+	/** Accepts APIDs from first to last (inclusive). */
+	void acceptAPIDRange(uint16_t first, uint16_t last, int packetType = AnyPacketType) {
+		setAPIDs(first, last, packetType, true);
+	}
+
+public:
+	/** Accepts all APIDs (including the Idle Packet APID). */
+	void acceptAllAPIDs(int packetType = AnyPacketType) {
+		setAPIDs(0, NAPIDs - 1, packetType, true);
+	}
+
+public:
+	/** Rejects an APID. */
+	void rejectAPID(uint16_t apid, int packetType = AnyPacketType) {
+		setAPIDs(apid, apid, packetType, false);
+	}
+
+public:
+	/** Rejects APIDs from first to last (inclusive). */
+	void rejectAPIDRange(uint16_t first, uint16_t last, int packetType = AnyPacketType) {
+		setAPIDs(first, last, packetType, false);
+	}
+
+public:
+	/** Rejects Idle Packets (APID 0x7FF). */
+	void rejectIdlePackets() {
+		rejectAPID(CCSDSSpacePacket::APIDOfIdlePacket);
+	}
+
+public:
+	/** Accepts a Category of a Packet Type (enables Category filtering of the type). */
+	void acceptCategory(uint8_t packetType, uint8_t category) {
+		size_t type = packetType & 0x01;
+		if (!categoryFilterEnabled[type]) {
+			categoryFilterEnabled[type] = true;
+			packetsWithoutSecondaryHeaderAccepted[type] = false;
+			std::memset(categoryBitmaps[type], 0, sizeof(categoryBitmaps[type]));
+		}
+		category &= 0x7F;
+		categoryBitmaps[type][category / 64] |= (uint64_t) 1 << (category % 64);
+		updateResultsWithoutCategory();
+	}
+
+public:
+	/** Disables Category filtering of a Packet Type. */
+	void acceptAllCategories(uint8_t packetType) {
+		size_t type = packetType & 0x01;
+		categoryFilterEnabled[type] = false;
+		packetsWithoutSecondaryHeaderAccepted[type] = true;
+		std::memset(categoryBitmaps[type], 0xFF, sizeof(categoryBitmaps[type]));
+		updateResultsWithoutCategory();
+	}
+
+public:
+	/** Sets whether packets without Secondary Header pass the Category test. */
+	void setPacketsWithoutSecondaryHeaderAccepted(uint8_t packetType, bool accepted) {
+		packetsWithoutSecondaryHeaderAccepted[packetType & 0x01] = accepted;
+		updateResultsWithoutCategory();
+	}
+
+public:
+	/** Evaluates the filter on raw packet bytes.
+	 * @param[in] data the top of a packet.
+	 * @param[in] length available bytes (at least the Primary Header; 11 bytes if Secondary Header is present).
+	 */
+	inline bool matches(const uint8_t* data, size_t length) const {
+		if (length < CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength) {
+			return false;
+		}
+		//evaluated without data-dependent branches (filter results are unpredictable)
+		size_t type = (data[0] >> 4) & 0x01;
+		size_t apid = ((size_t) (data[0] & 0x07) << 8) | data[1];
+		uint64_t apidBit = (apidBitmaps[type][apid / 64] >> (apid % 64)) & 0x01;
+		uint64_t secondaryHeader = (data[0] >> 3) & 0x01;
+		uint64_t categoryPresent = secondaryHeader & (length > 10);
+		size_t category = data[10 * categoryPresent] & 0x7F;
+		uint64_t categoryBit = (categoryBitmaps[type][category / 64] >> (category % 64)) & 0x01;
+		uint64_t withoutCategory = resultsWithoutCategory[type][secondaryHeader];
+		return (apidBit & ((categoryPresent & categoryBit) | ((categoryPresent ^ 1) & withoutCategory))) != 0;
+	}
+
+public:
+	/** Evaluates the filter on a packet view. */
+	inline bool matches(const CCSDSSpacePacketView& view) const {
+		return matches(view.data, view.length);
+	}
+
+public:
+	/** Writes the indices of accepted packets to a selection vector (without branches on the result).
+	 * @param[in] views packet views.
+	 * @param[in] n number of views.
+	 * @param[out] selection an array of at least n elements.
+	 * @returns the number of accepted packets.
+	 */
+	size_t select(const CCSDSSpacePacketView* views, size_t n, uint32_t* selection) const {
+		size_t nSelected = 0;
+		for (size_t i = 0; i < n; i++) {
+			selection[nSelected] = i;
+			nSelected += matches(views[i]) ? 1 : 0;
+		}
+		return nSelected;
+	}
+
+public:
+	/** Sets the indices of accepted packets to a selection vector.
+	 * @returns the number of accepted packets.
+	 */
+	size_t select(const std::vector<CCSDSSpacePacketView>& views, std::vector<uint32_t>& selection) const {
+		selection.resize(views.size());
+		if (views.empty()) {
+			return 0;
+		}
+		selection.resize(select(&views[0], views.size(), &selection[0]));
+		return selection.size();
+	}
+
+public:
+	/** Walks concatenated packets in a buffer and sets the offsets of accepted packets.
+	 * Walking stops at the end of the buffer or at an implausible or truncated packet.
+	 * @param[in] buffer concatenated packets.
+	 * @param[in] length length of the buffer.
+	 * @param[out] offsets offsets of accepted packets.
+	 * @returns the number of bytes walked (offset of the first byte not consumed).
+	 */
+	size_t select(const uint8_t* buffer, size_t length, std::vector<size_t>& offsets) const {
+		offsets.clear();
+		size_t position = 0;
+		while (CCSDSSpacePacketView::isPlausiblePacket(buffer + position, length - position)) {
+			size_t packetLength = CCSDSSpacePacketView::peekTotalPacketLength(buffer + position);
+			if (matches(buffer + position, packetLength)) {
+				offsets.push_back(position);
+			}
+			position += packetLength;
+		}
+		return position;
+	}
+};
+
+#endif /* CCSDSPACKETFILTER_HH_ */
@@ -0,0 +1,218 @@
+/*
+ * CCSDSPacketLayout.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSPACKETLAYOUT_HH_
+#define CCSDSPACKETLAYOUT_HH_
+
+#include "CCSDSSpacePacketView.hh"
+#include <type_traits>
+
+/** Byte orders of a field in a packet layout. */
+class CCSDSFieldEndianness {
+public:
+	enum {
+		BigEndian, LittleEndian
+	};
+};
+
+/** Selects the smallest integer type that holds a field of a width (in bits). */
+template<size_t Width, bool Signed>
+class CCSDSFieldValueType {
+public:
+	typedef typename std::conditional<(Width <= 8), uint8_t,
+			typename std::conditional<(Width <= 16), uint16_t,
+					typename std::conditional<(Width <= 32), uint32_t, uint64_t>::type>::type>::type UnsignedType;
+	typedef typename std::conditional<Signed, typename std::make_signed<UnsignedType>::type, UnsignedType>::type type;
+};
+
+/** A field of a packet layout, located by bit offset from the top of the User Data Field.
+ * Offsets, widths, masks and shifts are compile-time constants, so extract() compiles
+ * to a fixed number of loads, shifts and masks without branches.
+ * Bits are numbered from the MSB of the first byte (as in CCSDS documents).
+ *
+ * Constraints (checked at compile time):
+ * - 1 <= Width <= 64, and the field spans at most 8 bytes.
+ * - Little-endian fields are byte-aligned and a whole number of bytes wide.
+ *
+ * @tparam BitOffset bit offset from the top of the User Data Field.
+ * @tparam Width width in bits.
+ * @tparam Endianness CCSDSFieldEndianness::BigEndian or LittleEndian.
+ * @tparam Signed true if the field is a two's complement integer.
+ * @see CCSDS_FIELD, CCSDSPacketLayout
+ */
+template<size_t BitOffset, size_t Width, int Endianness = CCSDSFieldEndianness::BigEndian, bool Signed = false>
+class CCSDSField {
+public:
+	typedef typename CCSDSFieldValueType<Width, Signed>::type value_type;
+
+	static const size_t ByteOffset = BitOffset / 8;
+	static const size_t BitOffsetInByte = BitOffset % 8;
+	static const size_t ByteLength = (BitOffsetInByte + Width + 7) / 8;
+	/** Number of bytes of the User Data Field needed to extract this field. */
+	static const size_t RequiredLength = ByteOffset + ByteLength;
+	static const uint64_t Mask = (Width == 64) ? ~(uint64_t) 0 : (((uint64_t) 1 << (Width % 64)) - 1);
+	static const uint64_t SignBit = (uint64_t) 1 << ((Width - 1) % 64);
+
+	static_assert(Width >= 1 && Width <= 64, "CCSDSField: Width must be 1 to 64 bits");
+	static_assert(ByteLength <= 8, "CCSDSField: a field must not span more than 8 bytes");
+	static_assert(Endianness == CCSDSFieldEndianness::BigEndian
+			|| (BitOffsetInByte == 0 && Width % 8 == 0), "CCSDSField: little-endian fields must be byte-aligned");
+
+public:
+	/** Returns the name of the field (overridden by fields declared with CCSDS_FIELD). */
+	static const char* getName() {
+		return "";
+	}
+
+public:
+	/** Extracts the field from a User Data Field. The array must be at least RequiredLength bytes. */
+	static inline value_type extract(const uint8_t* userDataField) {
+		const uint8_t* p = userDataField + ByteOffset;
+		uint64_t raw = 0;
+		if (Endianness == CCSDSFieldEndianness::BigEndian) {
+			for (size_t i = 0; i < ByteLength; i++) {
+				raw = (raw << 8) | p[i];
+			}
+			raw = (raw >> (ByteLength * 8 - BitOffsetInByte - Width)) & Mask;
+		} else {
+			for (size_t i = 0; i < ByteLength; i++) {
+				raw |= (uint64_t) p[i] << (8 * i);
+			}
+		}
+		if (Signed) {
+			raw = (raw ^ SignBit) - SignBit; //sign extension
+		}
+		return (value_type) raw;
+	}
+};
+
+/** Declares a named field class (derived from CCSDSField) in a packet layout.
+ * @code
+ CCSDS_FIELD(BusVoltage, 0, 16, CCSDSFieldEndianness::BigEndian, false);
+ * @endcode
+ */
+#define CCSDS_FIELD(name, bitOffset, width, endianness, isSigned) \
+	class name: public CCSDSField<bitOffset, width, endianness, isSigned> { \
+	public: \
+		static const char* getName() { \
+			return #name; \
+		} \
+	}
+
+/** Compile-time helpers of CCSDSPacketLayout. */
+template<typename ... Fields>
+class CCSDSPacketLayoutFields;
+
+template<>
+class CCSDSPacketLayoutFields<> {
+public:
+	static const size_t RequiredLength = 0;
+
+	template<typename Field>
+	class Contains {
+	public:
+		static const bool value = false;
+	};
+
+	template<typename Visitor>
+	static inline void visit(const uint8_t*, Visitor&) {
+	}
+};
+
+template<typename Head, typename ... Tail>
+class CCSDSPacketLayoutFields<Head, Tail...> {
+public:
+	static const size_t RequiredLength =
+			(Head::RequiredLength > CCSDSPacketLayoutFields<Tail...>::RequiredLength) ?
+					Head::RequiredLength : CCSDSPacketLayoutFields<Tail...>::RequiredLength;
+
+	template<typename Field>
+	class Contains {
+	public:
+		static const bool value = std::is_same<Field, Head>::value
+				|| CCSDSPacketLayoutFields<Tail...>::template Contains<Field>::value;
+	};
+
+	template<typename Visitor>
+	static inline void visit(const uint8_t* userDataField, Visitor& visitor) {
+		visitor(Head::getName(), Head::extract(userDataField));
+		CCSDSPacketLayoutFields<Tail...>::visit(userDataField, visitor);
+	}
+};
+
+/** A compile-time layout of the User Data Field of the packets of an APID.
+ * The length of the User Data Field is declared with the layout, and it is
+ * verified at compile time that every field lies within it. get() only accepts
+ * fields of the layout, and compiles to the extractor of the field.
+ *
+ * @par
+ * Example:
+ * @code
+ CCSDS_FIELD(BusVoltage, 0, 16, CCSDSFieldEndianness::BigEndian, false);
+ CCSDS_FIELD(Temperature, 16, 12, CCSDSFieldEndianness::BigEndian, true);
+ CCSDS_FIELD(HeaterOn, 28, 1, CCSDSFieldEndianness::BigEndian, false);
+ typedef CCSDSPacketLayout<0x123, 8, BusVoltage, Temperature, HeaterOn> HKLayout;
+
+ if (HKLayout::matches(view)) {
+ 	uint16_t voltage = HKLayout::get<BusVoltage>(view);
+ 	int16_t temperature = HKLayout::get<Temperature>(view);
+ }
+ * @endcode
+ *
+ * @tparam APID APID of the packets.
+ * @tparam UserDataFieldLength length of the User Data Field in bytes.
+ * @tparam Fields CCSDSField types (usually declared with CCSDS_FIELD).
+ */
+template<uint16_t APID, size_t UserDataFieldLength, typename ... Fields>
+class CCSDSPacketLayout {
+public:
+	static const uint16_t apid = APID;
+	static const size_t userDataFieldLength = UserDataFieldLength;
+	static const size_t NFields = sizeof...(Fields);
+
+	static_assert(APID <= 0x7FF, "CCSDSPacketLayout: APID must be 11 bits");
+	static_assert(CCSDSPacketLayoutFields<Fields...>::RequiredLength <= UserDataFieldLength,
+			"CCSDSPacketLayout: a field exceeds the User Data Field");
+
+public:
+	/** True if a packet has the APID and a User Data Field long enough for the layout. */
+	static inline bool matches(const CCSDSSpacePacketView& view) {
+		return view.getAPIDAsInteger() == APID && view.getUserDataFieldLength() >= UserDataFieldLength;
+	}
+
+public:
+	/** Extracts a field from a User Data Field of at least UserDataFieldLength bytes. */
+	template<typename Field>
+	static inline typename Field::value_type get(const uint8_t* userDataField) {
+		static_assert(CCSDSPacketLayoutFields<Fields...>::template Contains<Field>::value,
+				"CCSDSPacketLayout: the field does not belong to this layout");
+		return Field::extract(userDataField);
+	}
+
+public:
+	/** Extracts a field from a packet view (check matches() beforehand). */
+	template<typename Field>
+	static inline typename Field::value_type get(const CCSDSSpacePacketView& view) {
+		return get<Field>(view.getUserDataField());
+	}
+
+public:
+	/** Extracts a field from a packet instance (check the User Data Field length beforehand). */
+	template<typename Field>
+	static inline typename Field::value_type get(CCSDSSpacePacket* packet) {
+		return get<Field>(&(*packet->getUserDataField())[0]);
+	}
+
+public:
+	/** Calls visitor(name, value) for every field in declaration order. */
+	template<typename Visitor>
+	static inline void visit(const uint8_t* userDataField, Visitor& visitor) {
+		CCSDSPacketLayoutFields<Fields...>::visit(userDataField, visitor);
+	}
+};
+
+#endif /* CCSDSPACKETLAYOUT_HH_ */
@@ -0,0 +1,422 @@
+/*
+ * CCSDSPacketRange.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSPACKETRANGE_HH_
+#define CCSDSPACKETRANGE_HH_
+
+#include "CCSDSPacketSource.hh"
+#include <algorithm>
+#include <iterator>
+#include <istream>
+#include <vector>
+
+#if (__cplusplus >= 202002L) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#include <exception>
+#define CCSDS_HAS_COROUTINE 1
+#endif
+#endif
+
+/** A set of conditions on packet header fields evaluated on raw bytes.
+ * An empty filter accepts all packets.
+ */
+class CCSDSPacketRangeFilter {
+public:
+	bool apidSpecified;
+	uint16_t apid;
+	bool packetTypeSpecified;
+	uint8_t packetType;
+	bool categorySpecified;
+	uint8_t category;
+
+public:
+	CCSDSPacketRangeFilter() {
+		apidSpecified = false;
+		apid = 0;
+		packetTypeSpecified = false;
+		packetType = 0;
+		categorySpecified = false;
+		category = 0;
+	}
+
+public:
+	/** True if the packet satisfies all conditions.
+	 * Packets without Secondary Header do not match a Category condition.
+	 */
+	inline bool matches(const CCSDSSpacePacketView& view) const {
+		if (apidSpecified && view.getAPIDAsInteger() != apid) {
+			return false;
+		}
+		if (packetTypeSpecified && view.getPacketType() != packetType) {
+			return false;
+		}
+		if (categorySpecified && (!view.isSecondaryHeaderPresent() || view.getCategory() != category)) {
+			return false;
+		}
+		return true;
+	}
+};
+
+/** A forward iterator over concatenated packets in a byte array.
+ * The boundary of the next packet is computed only when the iterator is advanced.
+ * Iteration ends at the end of the array, or at the first implausible or
+ * truncated packet (see CCSDSSpacePacketView::isPlausiblePacket()).
+ */
+class CCSDSPacketIterator {
+public:
+	typedef std::forward_iterator_tag iterator_category;
+	typedef CCSDSSpacePacketView value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef const CCSDSSpacePacketView* pointer;
+	typedef const CCSDSSpacePacketView& reference;
+
+private:
+	const uint8_t* buffer;
+	size_t length;
+	size_t position;
+	CCSDSPacketRangeFilter filter;
+	CCSDSSpacePacketView view;
+	bool atEnd;
+
+public:
+	/** Constructs an end iterator. */
+	CCSDSPacketIterator() {
+		buffer = NULL;
+		length = 0;
+		position = 0;
+		atEnd = true;
+	}
+
+public:
+	/** Constructs an iterator pointing to the first packet that matches a filter. */
+	CCSDSPacketIterator(const uint8_t* buffer, size_t length, const CCSDSPacketRangeFilter& filter) {
+		this->buffer = buffer;
+		this->length = length;
+		this->position = 0;
+		this->filter = filter;
+		this->atEnd = false;
+		findMatchingPacket();
+	}
+
+private:
+	void findMatchingPacket() {
+		while (CCSDSSpacePacketView::isPlausiblePacket(buffer + position, length - position)) {
+			view = CCSDSSpacePacketView(buffer + position, CCSDSSpacePacketView::peekTotalPacketLength(buffer + position));
+			if (filter.matches(view)) {
+				return;
+			}
+			position += view.length;
+		}
+		atEnd = true;
+	}
+
+public:
+	reference operator*() const {
+		return view;
+	}
+
+public:
+	pointer operator->() const {
+		return &view;
+	}
+
+public:
+	CCSDSPacketIterator& operator++() {
+		position += view.length;
+		findMatchingPacket();
+		return *this;
+	}
+
+public:
+	CCSDSPacketIterator operator++(int) {
+		CCSDSPacketIterator previous = *this;
+		++(*this);
+		return previous;
+	}
+
+public:
+	bool operator==(const CCSDSPacketIterator& other) const {
+		if (atEnd || other.atEnd) {
+			return atEnd == other.atEnd;
+		}
+		return buffer + position == other.buffer + other.position;
+	}
+
+public:
+	bool operator!=(const CCSDSPacketIterator& other) const {
+		return !(*this == other);
+	}
+
+public:
+	/** Returns the offset of the current packet (or of the first byte not consumed at the end). */
+	size_t getPosition() const {
+		return position;
+	}
+};
+
+/** A lazy range of packet views over a byte array of concatenated packets.
+ * No packet is decoded or copied until the range is iterated, and filters can
+ * be chained without evaluating anything.
+ *
+ * @par
+ * Example:
+ * @code
+ for (auto packet : ccsds::packets(buffer, length).whereAPID(0x123).whereCategory(2)) {
+ 	std::cout << packet.getTimeAsInteger() << std::endl;
+ }
+ * @endcode
+ * @see ccsds::packets()
+ */
+class CCSDSPacketRange {
+private:
+	const uint8_t* buffer;
+	size_t length;
+	CCSDSPacketRangeFilter filter;
+
+public:
+	/** Constructs a range. The byte array must outlive the range and its iterators. */
+	CCSDSPacketRange(const uint8_t* buffer, size_t length) {
+		this->buffer = buffer;
+		this->length = length;
+	}
+
+public:
+	CCSDSPacketIterator begin() const {
+		return CCSDSPacketIterator(buffer, length, filter);
+	}
+
+public:
+	CCSDSPacketIterator end() const {
+		return CCSDSPacketIterator();
+	}
+
+public:
+	/** Returns a range restricted to an APID. */
+	CCSDSPacketRange whereAPID(uint16_t apid) const {
+		CCSDSPacketRange result = *this;
+		result.filter.apidSpecified = true;
+		result.filter.apid = apid;
+		return result;
+	}
+
+public:
+	/** Returns a range restricted to a Packet Type (CCSDSSpacePacketPacketType::TelemetryPacket or CommandPacket). */
+	CCSDSPacketRange whereType(uint8_t packetType) const {
+		CCSDSPacketRange result = *this;
+		result.filter.packetTypeSpecified = true;
+		result.filter.packetType = packetType;
+		return result;
+	}
+
+public:
+	/** Returns a range restricted to a Category (packets without Secondary Header are excluded). */
+	CCSDSPacketRange whereCategory(uint8_t category) const {
+		CCSDSPacketRange result = *this;
+		result.filter.categorySpecified = true;
+		result.filter.category = category;
+		return result;
+	}
+
+public:
+	/** Returns the number of bytes after the last complete packet (e.g. a truncated trailing packet).
+	 * This walks the whole range.
+	 */
+	size_t getNumberOfRemainingBytes() const {
+		CCSDSPacketRange all(buffer, length);
+		CCSDSPacketIterator it = all.begin();
+		while (it != all.end()) {
+			++it;
+		}
+		return length - it.getPosition();
+	}
+};
+
+#ifdef CCSDS_HAS_COROUTINE
+/** A C++20 coroutine generator of packet views (available when compiled as C++20).
+ * Each view is valid until the generator is resumed.
+ * @see ccsds::packets(std::istream&, size_t)
+ */
+class CCSDSPacketGenerator {
+public:
+	class promise_type {
+	public:
+		const CCSDSSpacePacketView* current;
+		std::exception_ptr exception;
+
+		promise_type() {
+			current = NULL;
+		}
+
+		CCSDSPacketGenerator get_return_object() {
+			return CCSDSPacketGenerator(std::coroutine_handle<promise_type>::from_promise(*this));
+		}
+
+		std::suspend_always initial_suspend() noexcept {
+			return std::suspend_always();
+		}
+
+		std::suspend_always final_suspend() noexcept {
+			return std::suspend_always();
+		}
+
+		std::suspend_always yield_value(const CCSDSSpacePacketView& view) noexcept {
+			current = &view;
+			return std::suspend_always();
+		}
+
+		void return_void() noexcept {
+		}
+
+		void unhandled_exception() {
+			exception = std::current_exception();
+		}
+	};
+
+	class iterator {
+	public:
+		typedef std::input_iterator_tag iterator_category;
+		typedef CCSDSSpacePacketView value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const CCSDSSpacePacketView* pointer;
+		typedef const CCSDSSpacePacketView& reference;
+
+	public:
+		std::coroutine_handle<promise_type> handle;
+
+		reference operator*() const {
+			return *handle.promise().current;
+		}
+
+		pointer operator->() const {
+			return handle.promise().current;
+		}
+
+		iterator& operator++() {
+			resume(handle);
+			return *this;
+		}
+
+		void operator++(int) {
+			++(*this);
+		}
+
+		bool operator==(std::default_sentinel_t) const {
+			return handle.done();
+		}
+	};
+
+private:
+	std::coroutine_handle<promise_type> handle;
+
+public:
+	explicit CCSDSPacketGenerator(std::coroutine_handle<promise_type> handle) {
+		this->handle = handle;
+	}
+
+public:
+	CCSDSPacketGenerator(CCSDSPacketGenerator&& other) noexcept {
+		handle = other.handle;
+		other.handle = nullptr;
+	}
+
+	CCSDSPacketGenerator(const CCSDSPacketGenerator&) = delete;
+	CCSDSPacketGenerator& operator=(const CCSDSPacketGenerator&) = delete;
+
+public:
+	~CCSDSPacketGenerator() {
+		if (handle) {
+			handle.destroy();
+		}
+	}
+
+public:
+	iterator begin() {
+		resume(handle);
+		iterator it;
+		it.handle = handle;
+		return it;
+	}
+
+public:
+	std::default_sentinel_t end() {
+		return std::default_sentinel;
+	}
+
+private:
+	static void resume(std::coroutine_handle<promise_type> handle) {
+		handle.resume();
+		if (handle.done() && handle.promise().exception) {
+			std::rethrow_exception(handle.promise().exception);
+		}
+	}
+};
+#endif
+
+namespace ccsds {
+
+/** Returns a lazy range of views of the packets concatenated in a byte array.
+ * @param[in] buffer a pointer to concatenated CCSDS SpacePackets.
+ * @param[in] length the length of the buffer.
+ */
+inline CCSDSPacketRange packets(const uint8_t* buffer, size_t length) {
+	return CCSDSPacketRange(buffer, length);
+}
+
+/** Returns a lazy range of views of the packets concatenated in a byte vector. */
+inline CCSDSPacketRange packets(const std::vector<uint8_t>& buffer) {
+	return CCSDSPacketRange(buffer.empty() ? NULL : &buffer[0], buffer.size());
+}
+
+#ifdef CCSDS_HAS_COROUTINE
+/** Returns a generator that reads concatenated packets from a stream through a
+ * fixed-size buffer and yields packet views (C++20).
+ * The generator ends at the end of the stream or at an implausible or truncated packet.
+ * @param[in] stream an input stream (must outlive the generator).
+ * @param[in] bufferSize read buffer size (at least CCSDSSpacePacketView::MaximumPacketLength).
+ */
+inline CCSDSPacketGenerator packets(std::istream& stream, size_t bufferSize = 1024 * 1024) {
+	std::vector<uint8_t> buffer(
+			(bufferSize < CCSDSSpacePacketView::MaximumPacketLength) ? CCSDSSpacePacketView::MaximumPacketLength : bufferSize);
+	size_t begin = 0;
+	size_t end = 0;
+	while (true) {
+		if (end - begin < CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength
+				|| end - begin < CCSDSSpacePacketView::peekTotalPacketLength(&buffer[begin])) {
+			if (begin != 0) {
+				std::copy(buffer.begin() + begin, buffer.begin() + end, buffer.begin());
+				end -= begin;
+				begin = 0;
+			}
+			if (stream) {
+				stream.read((char*) &buffer[end], buffer.size() - end);
+				end += stream.gcount();
+			}
+		}
+		if (!CCSDSSpacePacketView::isPlausiblePacket(&buffer[begin], end - begin)) {
+			co_return;
+		}
+		CCSDSSpacePacketView view(&buffer[begin], CCSDSSpacePacketView::peekTotalPacketLength(&buffer[begin]));
+		begin += view.length;
+		co_yield view;
+	}
+}
+
+/** Returns a generator that yields the packets of a packet source (C++20).
+ * @param[in] source a packet source (must outlive the generator).
+ */
+inline CCSDSPacketGenerator packets(CCSDSPacketSource& source) {
+	CCSDSSpacePacketView view;
+	while (source.next(view)) {
+		co_yield view;
+	}
+}
+#endif
+
+}
+
+#endif /* CCSDSPACKETRANGE_HH_ */
@@ -0,0 +1,717 @@
+/*
+ * CCSDSPacketRecorder.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSPACKETRECORDER_HH_
+#define CCSDSPACKETRECORDER_HH_
+
+#include "CCSDSSpacePacketView.hh"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+class CCSDSPacketRecorderException {
+public:
+	CCSDSPacketRecorderException(std::string str) {
+		message = str;
+	}
+
+public:
+	std::string toString() {
+		return message;
+	}
+
+public:
+	std::string message;
+};
+
+/** An append-only packet recorder that writes large buffers from a background thread.
+ * Packets are copied into page-aligned buffers (4 MiB by default). Full buffers are
+ * handed to a writer thread, which writes all queued buffers of a file with one
+ * pwritev() call, so the recording thread performs no system call per packet and
+ * only waits when all buffers are queued (see getNumberOfStalls()).
+ *
+ * Options (set before the first write()):
+ * - O_DIRECT (setDirectIOEnabled()): bypasses the page cache. The final partial buffer of
+ *   a file is written after clearing O_DIRECT. If the file system rejects O_DIRECT, the file
+ *   is written with buffered I/O.
+ * - Rotation by size and/or time (setRotationSize(), setRotationInterval()). A packet is
+ *   never split across files.
+ * - Durability (setDurabilityPolicy()): NoSync (default; files are fdatasync'ed only on close()
+ *   when another policy is selected), PeriodicSync (fdatasync at most every N ms; written data
+ *   is synchronized within N ms even if no more data follows), SyncEveryNBytes (fdatasync
+ *   after every N bytes).
+ * - Sidecar index (setIndexEnabled()): for each data file "<prefix>_NNNNNN.ccsds", an index
+ *   file "<prefix>_NNNNNN.ccsds.idx" is written alongside. It starts with a 16-byte header
+ *   ("CCSDSIDX", uint32 version = 1, uint32 record length = 16) followed by one 16-byte record
+ *   per packet: uint64 file offset, uint16 APID, uint16 Sequence Count, uint32 TI (0 without
+ *   Secondary Header). All integers are little endian.
+ *
+ * write() must be called from one thread.
+ *
+ * @par
+ * Example:
+ * @code
+ CCSDSPacketRecorder recorder("/data/downlink");
+ recorder.setRotationSize(1024 * 1024 * 1024);
+ recorder.setDurabilityPolicy(CCSDSPacketRecorder::PeriodicSync, 1000);
+ recorder.setIndexEnabled(true);
+ while (source.next(view)) {
+ 	recorder.write(view);
+ }
+ recorder.close();
+ * @endcode
+ */
+class CCSDSPacketRecorder {
+public:
+	enum DurabilityPolicy {
+		NoSync, PeriodicSync, SyncEveryNBytes
+	};
+
+	static const size_t DefaultBufferSize = 4 * 1024 * 1024;
+	static const size_t DefaultNumberOfBuffers = 4;
+	static const size_t DirectIOAlignment = 4096;
+	static const size_t IndexHeaderLength = 16;
+	static const size_t IndexRecordLength = 16;
+	static const uint32_t IndexVersion = 1;
+
+private:
+	class Buffer {
+	public:
+		uint8_t* data;
+		size_t length;
+		std::vector<uint8_t> index;
+		size_t fileSequence;
+		uint64_t fileOffset;
+		bool closeFile;
+	};
+
+private:
+	std::string pathPrefix;
+	size_t bufferSize;
+	size_t nBuffers;
+	bool directIOEnabled;
+	uint64_t rotationSize;
+	uint64_t rotationIntervalInMilliseconds;
+	DurabilityPolicy durabilityPolicy;
+	uint64_t durabilityParameter;
+	bool indexEnabled;
+
+	//recording thread
+	bool started;
+	bool closed;
+	Buffer* current;
+	size_t fileSequence;
+	uint64_t fileBytes;
+	std::chrono::steady_clock::time_point fileOpenTime;
+	std::vector<std::string> fileNames;
+	uint64_t nPackets;
+	uint64_t nBytes;
+	uint64_t nStalls;
+
+	//shared
+	std::mutex mutex;
+	std::condition_variable writerCondition;
+	std::condition_variable producerCondition;
+	std::deque<Buffer*> fullBuffers;
+	std::vector<Buffer*> freeBuffers;
+	std::vector<Buffer*> allBuffers;
+	bool writerBusy;
+	bool stopRequested;
+	std::string error;
+	std::thread writer;
+
+	//writer thread
+	int fd;
+	int indexFd;
+	size_t openedSequence;
+	bool directActive;
+	uint64_t indexOffset;
+	uint64_t bytesSinceSync;
+	std::chrono::steady_clock::time_point lastSyncTime;
+	uint64_t nSyncs;
+	uint64_t nWriteCalls;
+
+public:
+	/** Constructs a recorder.
+	 * @param[in] pathPrefix files are named pathPrefix + "_NNNNNN.ccsds".
+	 * @param[in] bufferSize buffer size (rounded up to a multiple of 4096).
+	 * @param[in] nBuffers number of buffers (at least 2).
+	 */
+	CCSDSPacketRecorder(std::string pathPrefix, size_t bufferSize = DefaultBufferSize,
+			size_t nBuffers = DefaultNumberOfBuffers) {
+		this->pathPrefix = pathPrefix;
+		this->bufferSize = (bufferSize + DirectIOAlignment - 1) / DirectIOAlignment * DirectIOAlignment;
+		if (this->bufferSize == 0) {
+			this->bufferSize = DirectIOAlignment;
+		}
+		this->nBuffers = (nBuffers < 2) ? 2 : nBuffers;
+		this->directIOEnabled = false;
+		this->rotationSize = 0;
+		this->rotationIntervalInMilliseconds = 0;
+		this->durabilityPolicy = NoSync;
+		this->durabilityParameter = 0;
+		this->indexEnabled = false;
+		this->started = false;
+		this->closed = false;
+		this->current = NULL;
+		this->fileSequence = 0;
+		this->fileBytes = 0;
+		this->nPackets = 0;
+		this->nBytes = 0;
+		this->nStalls = 0;
+		this->writerBusy = false;
+		this->stopRequested = false;
+		this->fd = -1;
+		this->indexFd = -1;
+		this->openedSequence = 0;
+		this->directActive = false;
+		this->indexOffset = 0;
+		this->bytesSinceSync = 0;
+		this->nSyncs = 0;
+		this->nWriteCalls = 0;
+	}
+
+public:
+	~CCSDSPacketRecorder() {
+		try {
+			close();
+		} catch (...) {
+		}
+		for (size_t i = 0; i < allBuffers.size(); i++) {
+			free(allBuffers[i]->data);
+			delete allBuffers[i];
+		}
+	}
+
+private:
+	CCSDSPacketRecorder(const CCSDSPacketRecorder&);
+	CCSDSPacketRecorder& operator=(const CCSDSPacketRecorder&);
+
+public:
+	/** Enables O_DIRECT. */
+	void setDirectIOEnabled(bool directIOEnabled) {
+		this->directIOEnabled = directIOEnabled;
+	}
+
+public:
+	/** Starts a new file when a file would exceed the size (0 disables). */
+	void setRotationSize(uint64_t rotationSize) {
+		this->rotationSize = rotationSize;
+	}
+
+public:
+	/** Starts a new file when a file has been open for the interval (0 disables). */
+	void setRotationInterval(uint64_t rotationIntervalInMilliseconds) {
+		this->rotationIntervalInMilliseconds = rotationIntervalInMilliseconds;
+	}
+
+public:
+	/** Sets the durability policy.
+	 * @param[in] policy NoSync, PeriodicSync or SyncEveryNBytes.
+	 * @param[in] parameter interval in milliseconds (PeriodicSync) or number of bytes (SyncEveryNBytes).
+	 */
+	void setDurabilityPolicy(DurabilityPolicy policy, uint64_t parameter = 0) {
+		this->durabilityPolicy = policy;
+		this->durabilityParameter = parameter;
+	}
+
+public:
+	/** Enables the sidecar index. */
+	void setIndexEnabled(bool indexEnabled) {
+		this->indexEnabled = indexEnabled;
+	}
+
+private:
+	std::string getFileName(size_t sequence) const {
+		char suffix[32];
+		snprintf(suffix, sizeof(suffix), "_%06zu.ccsds", sequence);
+		return pathPrefix + suffix;
+	}
+
+private:
+	void start() {
+		for (size_t i = 0; i < nBuffers; i++) {
+			Buffer* buffer = new Buffer;
+			void* data = NULL;
+			if (posix_memalign(&data, DirectIOAlignment, bufferSize) != 0) {
+				delete buffer;
+				throw CCSDSPacketRecorderException("CCSDSPacketRecorder: cannot allocate buffers");
+			}
+			buffer->data = (uint8_t*) data;
+			allBuffers.push_back(buffer);
+			freeBuffers.push_back(buffer);
+		}
+		started = true;
+		fileNames.push_back(getFileName(fileSequence));
+		fileOpenTime = std::chrono::steady_clock::now();
+		current = acquire();
+		writer = std::thread(&CCSDSPacketRecorder::runWriter, this);
+	}
+
+private:
+	Buffer* acquire() {
+		std::unique_lock<std::mutex> lock(mutex);
+		if (freeBuffers.empty()) {
+			nStalls++;
+			while (freeBuffers.empty()) {
+				producerCondition.wait(lock);
+			}
+		}
+		Buffer* buffer = freeBuffers.back();
+		freeBuffers.pop_back();
+		buffer->length = 0;
+		buffer->index.clear();
+		buffer->fileSequence = fileSequence;
+		buffer->fileOffset = fileBytes;
+		buffer->closeFile = false;
+		return buffer;
+	}
+
+private:
+	void submit(Buffer* buffer) {
+		std::lock_guard<std::mutex> lock(mutex);
+		fullBuffers.push_back(buffer);
+		writerCondition.notify_one();
+	}
+
+private:
+	void checkError() {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (error.size() != 0) {
+			throw CCSDSPacketRecorderException(error);
+		}
+	}
+
+private:
+	void rotate() {
+		current->closeFile = true;
+		submit(current);
+		fileSequence++;
+		fileBytes = 0;
+		fileNames.push_back(getFileName(fileSequence));
+		fileOpenTime = std::chrono::steady_clock::now();
+		current = acquire();
+	}
+
+private:
+	bool isRotationDue(size_t length) {
+		if (fileBytes == 0) {
+			return false;
+		}
+		if (rotationSize != 0 && fileBytes + length > rotationSize) {
+			return true;
+		}
+		//the clock is read once every 64 packets
+		if (rotationIntervalInMilliseconds != 0 && nPackets % 64 == 0) {
+			std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - fileOpenTime;
+			return (uint64_t) std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()
+					>= rotationIntervalInMilliseconds;
+		}
+		return false;
+	}
+
+private:
+	static inline void appendLittleEndian(std::vector<uint8_t>& output, uint64_t value, size_t nBytes) {
+		for (size_t i = 0; i < nBytes; i++) {
+			output.push_back((value >> (8 * i)) & 0xFF);
+		}
+	}
+
+public:
+	/** Appends a packet. */
+	void write(const uint8_t* data, size_t length) {
+		if (closed) {
+			throw CCSDSPacketRecorderException("CCSDSPacketRecorder: already closed");
+		}
+		if (!started) {
+			start();
+		}
+		if (isRotationDue(length)) {
+			checkError();
+			rotate();
+		}
+		if (indexEnabled) {
+			appendLittleEndian(current->index, fileBytes, 8);
+			uint16_t apid = 0;
+			uint16_t sequenceCount = 0;
+			uint32_t ti = 0;
+			if (length >= CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength) {
+				CCSDSSpacePacketView view(data, length);
+				apid = view.getAPIDAsInteger();
+				sequenceCount = view.getSequenceCount();
+				if (view.isSecondaryHeaderPresent() && length >= 10) {
+					ti = view.getTimeAsInteger();
+				}
+			}
+			appendLittleEndian(current->index, apid, 2);
+			appendLittleEndian(current->index, sequenceCount, 2);
+			appendLittleEndian(current->index, ti, 4);
+		}
+		fileBytes += length;
+		nBytes += length;
+		nPackets++;
+		while (length != 0) {
+			size_t n = bufferSize - current->length;
+			if (n == 0) {
+				checkError();
+				submit(current);
+				current = acquire();
+				current->fileOffset = fileBytes - length;
+				continue;
+			}
+			n = (length < n) ? length : n;
+			std::memcpy(current->data + current->length, data, n);
+			current->length += n;
+			data += n;
+			length -= n;
+		}
+	}
+
+public:
+	/** Appends a packet view. */
+	void write(const CCSDSSpacePacketView& view) {
+		write(view.data, view.length);
+	}
+
+public:
+	/** Appends a packet instance. */
+	void write(CCSDSSpacePacket* packet) {
+		std::vector<uint8_t> bytes = packet->getAsByteVector();
+		write(&bytes[0], bytes.size());
+	}
+
+private:
+	void waitUntilDrained() {
+		std::unique_lock<std::mutex> lock(mutex);
+		while (!fullBuffers.empty() || writerBusy) {
+			producerCondition.wait(lock);
+		}
+	}
+
+public:
+	/** Hands the buffered packets to the OS and waits until they are written. */
+	void flush() {
+		if (!started || closed) {
+			return;
+		}
+		if (current->length != 0) {
+			submit(current);
+			current = acquire();
+		}
+		waitUntilDrained();
+		checkError();
+	}
+
+public:
+	/** Writes the remaining packets, synchronizes (unless NoSync), and closes the files. */
+	void close() {
+		if (!started || closed) {
+			closed = true;
+			return;
+		}
+		closed = true;
+		current->closeFile = true;
+		submit(current);
+		current = NULL;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopRequested = true;
+			writerCondition.notify_one();
+		}
+		writer.join();
+		checkError();
+	}
+
+private:
+	/** Records the first error.
+	 * @param[in] errorNumber errno of the failed call, or 0 if the call did not set errno (e.g. a short write).
+	 */
+	void setError(const std::string& message, int errorNumber) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (error.size() == 0) {
+			error = (errorNumber != 0) ? message + " (" + strerror(errorNumber) + ")" : message;
+		}
+	}
+
+private:
+	void openFile(size_t sequence) {
+		std::string name = getFileName(sequence);
+		fd = -1;
+		directActive = false;
+#ifdef O_DIRECT
+		if (directIOEnabled) {
+			fd = ::open(name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+			directActive = (fd >= 0);
+		}
+#endif
+		if (fd < 0) {
+			fd = ::open(name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		}
+		if (fd < 0) {
+			int errorNumber = errno;
+			setError("CCSDSPacketRecorder: cannot open " + name, errorNumber);
+			return;
+		}
+		openedSequence = sequence;
+		bytesSinceSync = 0;
+		lastSyncTime = std::chrono::steady_clock::now();
+		if (indexEnabled) {
+			indexFd = ::open((name + ".idx").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+			if (indexFd < 0) {
+				int errorNumber = errno;
+				setError("CCSDSPacketRecorder: cannot open " + name + ".idx", errorNumber);
+				return;
+			}
+			std::vector<uint8_t> header;
+			const char* magic = "CCSDSIDX";
+			header.insert(header.end(), magic, magic + 8);
+			appendLittleEndian(header, IndexVersion, 4);
+			appendLittleEndian(header, IndexRecordLength, 4);
+			ssize_t result = pwrite(indexFd, &header[0], header.size(), 0);
+			if (result != (ssize_t) header.size()) {
+				int errorNumber = (result < 0) ? errno : 0;
+				setError("CCSDSPacketRecorder: cannot write " + name + ".idx" + ((result < 0) ? "" : " (short write)"),
+						errorNumber);
+			}
+			indexOffset = IndexHeaderLength;
+		}
+	}
+
+private:
+	void synchronize() {
+		if (fd >= 0) {
+			fdatasync(fd);
+		}
+		if (indexFd >= 0) {
+			fdatasync(indexFd);
+		}
+		nSyncs++;
+		bytesSinceSync = 0;
+		lastSyncTime = std::chrono::steady_clock::now();
+	}
+
+private:
+	void closeFile() {
+		if (durabilityPolicy != NoSync) {
+			synchronize();
+		}
+		if (fd >= 0) {
+			::close(fd);
+			fd = -1;
+		}
+		if (indexFd >= 0) {
+			::close(indexFd);
+			indexFd = -1;
+		}
+	}
+
+private:
+	/** Writes buffers of one file that are contiguous in the file. */
+	void writeBuffers(const std::vector<Buffer*>& buffers) {
+		if (fd < 0 || buffers[0]->fileSequence != openedSequence) {
+			if (fd >= 0) {
+				closeFile();
+			}
+			openFile(buffers[0]->fileSequence);
+			if (fd < 0) {
+				return;
+			}
+		}
+		std::vector<struct iovec> iov;
+		size_t total = 0;
+		for (size_t i = 0; i < buffers.size(); i++) {
+			if (buffers[i]->length != 0) {
+				struct iovec v;
+				v.iov_base = buffers[i]->data;
+				v.iov_len = buffers[i]->length;
+				iov.push_back(v);
+				total += buffers[i]->length;
+			}
+		}
+		uint64_t offset = buffers[0]->fileOffset;
+#ifdef O_DIRECT
+		if (directActive && (total % DirectIOAlignment != 0 || offset % DirectIOAlignment != 0)) {
+			//a partial buffer (end of file or flush()); the rest of the file uses buffered I/O
+			fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_DIRECT);
+			directActive = false;
+		}
+#endif
+		size_t written = 0;
+		size_t first = 0;
+		while (written < total) {
+			struct iovec* vectors = &iov[first];
+			int nVectors = (iov.size() - first < (size_t) IOV_MAX) ? iov.size() - first : IOV_MAX;
+			ssize_t result = pwritev(fd, vectors, nVectors, offset + written);
+			nWriteCalls++;
+			if (result < 0) {
+				int errorNumber = errno;
+				if (errorNumber == EINTR) {
+					continue;
+				}
+				setError("CCSDSPacketRecorder: write error in " + getFileName(openedSequence), errorNumber);
+				return;
+			}
+			if (result == 0) {
+				//no progress (e.g. the file system is full); retrying would loop forever
+				setError("CCSDSPacketRecorder: write error in " + getFileName(openedSequence) + " (no bytes written)", 0);
+				return;
+			}
+			written += result;
+			//skip fully written vectors and advance a partially written one
+			while (first < iov.size() && (size_t) result >= iov[first].iov_len) {
+				result -= iov[first].iov_len;
+				first++;
+			}
+			if (first < iov.size() && result > 0) {
+				iov[first].iov_base = (uint8_t*) iov[first].iov_base + result;
+				iov[first].iov_len -= result;
+			}
+		}
+		if (indexFd >= 0) {
+			for (size_t i = 0; i < buffers.size(); i++) {
+				const std::vector<uint8_t>& index = buffers[i]->index;
+				if (!index.empty()) {
+					ssize_t result = pwrite(indexFd, &index[0], index.size(), indexOffset);
+					if (result != (ssize_t) index.size()) {
+						int errorNumber = (result < 0) ? errno : 0;
+						setError("CCSDSPacketRecorder: index write error in " + getFileName(openedSequence)
+								+ ((result < 0) ? "" : " (short write)"), errorNumber);
+						return;
+					}
+					indexOffset += index.size();
+				}
+			}
+		}
+		bytesSinceSync += total;
+		if (durabilityPolicy == SyncEveryNBytes && bytesSinceSync >= durabilityParameter) {
+			synchronize();
+		} else if (durabilityPolicy == PeriodicSync
+				&& (uint64_t) std::chrono::duration_cast<std::chrono::milliseconds>(
+						std::chrono::steady_clock::now() - lastSyncTime).count() >= durabilityParameter) {
+			synchronize();
+		}
+	}
+
+private:
+	/** True if PeriodicSync is selected and written data has not been synchronized yet. */
+	bool isPeriodicSyncPending() const {
+		return durabilityPolicy == PeriodicSync && fd >= 0 && bytesSinceSync != 0;
+	}
+
+private:
+	void runWriter() {
+		std::vector<Buffer*> batch;
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				while (fullBuffers.empty() && !stopRequested) {
+					if (!isPeriodicSyncPending()) {
+						writerCondition.wait(lock);
+						continue;
+					}
+					//written data must not wait for the next write to be synchronized
+					std::chrono::steady_clock::time_point deadline = lastSyncTime
+							+ std::chrono::milliseconds(durabilityParameter);
+					if (writerCondition.wait_until(lock, deadline) == std::cv_status::timeout && fullBuffers.empty()
+							&& !stopRequested) {
+						writerBusy = true;
+						lock.unlock();
+						synchronize();
+						lock.lock();
+						writerBusy = false;
+						producerCondition.notify_all();
+					}
+				}
+				if (fullBuffers.empty()) {
+					break;
+				}
+				//take consecutive buffers of the same file (up to and including one that closes it)
+				batch.clear();
+				while (!fullBuffers.empty()
+						&& (batch.empty() || (batch[0]->fileSequence == fullBuffers.front()->fileSequence))) {
+					batch.push_back(fullBuffers.front());
+					fullBuffers.pop_front();
+					if (batch.back()->closeFile) {
+						break;
+					}
+				}
+				writerBusy = true;
+			}
+			bool hasError;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				hasError = (error.size() != 0);
+			}
+			if (!hasError) {
+				writeBuffers(batch);
+			}
+			if (batch.back()->closeFile && fd >= 0) {
+				closeFile();
+			}
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				for (size_t i = 0; i < batch.size(); i++) {
+					freeBuffers.push_back(batch[i]);
+				}
+				writerBusy = false;
+				producerCondition.notify_all();
+			}
+		}
+		if (fd >= 0) {
+			closeFile();
+		}
+	}
+
+public:
+	/** Returns the names of the data files written so far. */
+	std::vector<std::string> getFileNames() const {
+		return fileNames;
+	}
+
+public:
+	uint64_t getNumberOfPackets() const {
+		return nPackets;
+	}
+
+public:
+	uint64_t getNumberOfBytes() const {
+		return nBytes;
+	}
+
+public:
+	/** Returns how many times write() waited for a free buffer (the disk did not keep up). */
+	uint64_t getNumberOfStalls() const {
+		return nStalls;
+	}
+
+public:
+	/** Returns the number of pwritev() calls (valid after flush() or close()). */
+	uint64_t getNumberOfWriteCalls() const {
+		return nWriteCalls;
+	}
+
+public:
+	/** Returns the number of fdatasync() rounds (valid after flush() or close()). */
+	uint64_t getNumberOfSyncs() const {
+		return nSyncs;
+	}
+};
+
+#endif /* CCSDSPACKETRECORDER_HH_ */
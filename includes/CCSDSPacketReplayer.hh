@@ -0,0 +1,396 @@
+/*
+ * CCSDSPacketReplayer.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSPACKETREPLAYER_HH_
+#define CCSDSPACKETREPLAYER_HH_
+
+#include "CCSDSLatencyInstrumentation.hh"
+#include "CCSDSSpacePacketView.hh"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class CCSDSPacketReplayerException {
+public:
+	CCSDSPacketReplayerException(std::string str) {
+		message = str;
+	}
+
+public:
+	std::string toString() {
+		return message;
+	}
+
+public:
+	std::string message;
+};
+
+/** An interface that receives packets emitted by CCSDSPacketReplayer.
+ */
+class CCSDSPacketReplayerListener {
+public:
+	virtual ~CCSDSPacketReplayerListener() {
+	}
+
+public:
+	/** Invoked for each batch of packets whose emission time has come.
+	 * The views point into the archive and are valid while the replayer exists.
+	 * @param[in] views packets in archive order.
+	 * @param[in] n number of packets.
+	 */
+	virtual void onPackets(const CCSDSSpacePacketView* views, size_t n) = 0;
+};
+
+/** A class that replays recorded packets with their original timing.
+ * The archive (a file of concatenated packets, memory-mapped, or a byte array) is
+ * walked without copy. The emission time of each packet is computed from the TI
+ * (getTimeAsInteger()) of its Secondary Header relative to the first packet, divided
+ * by the speedup factor. Packets without Secondary Header keep the time of the
+ * preceding packet. Deadlines are measured from the start of replay() rather than
+ * from the previous emission, so late emissions are caught up and do not accumulate
+ * into drift.
+ *
+ * Packets whose emission times fall within the batch window (default 50 us) of the
+ * first packet of a batch are passed to the listener together, at the time of that
+ * packet. Waiting sleeps until shortly before the deadline and then spins (as
+ * CCSDSFramePacer does). The difference between the actual and scheduled emission
+ * time of each batch is recorded as pacing error.
+ *
+ * TI is assumed to count at 64 Hz (setTimeIndicatorFrequency() changes this).
+ * A backward TI step within the reorder tolerance (default 1 s) is treated as no
+ * step; a larger backward step (e.g. TI reset) restarts the time reference.
+ *
+ * @par
+ * Example:
+ * @code
+ class MyListener: public CCSDSPacketReplayerListener {
+ public:
+ 	void onPackets(const CCSDSSpacePacketView* views, size_t n) {
+ 		for (size_t i = 0; i < n; i++) {
+ 			socket.send(views[i].data, views[i].length);
+ 		}
+ 	}
+ };
+ MyListener listener;
+ CCSDSPacketReplayer replayer("downlink.ccsds", &listener);
+ replayer.setSpeed(100);
+ replayer.replay();
+ std::cout << replayer.getPacingErrorHistogram().toString() << std::endl;
+ * @endcode
+ */
+class CCSDSPacketReplayer {
+public:
+	/** Pass to setSpeed() to emit packets without waiting. */
+	static constexpr double AsFastAsPossible = 0;
+	static constexpr double DefaultTimeIndicatorFrequency = 64;
+	static const int64_t DefaultBatchWindowInNanoseconds = 50000;
+	static const size_t DefaultMaximumBatchSize = 256;
+	static const int64_t DefaultSpinDurationInNanoseconds = 200000;
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+private:
+	const uint8_t* buffer;
+	size_t bufferSize;
+	void* mappedAddress;
+	CCSDSPacketReplayerListener* listener;
+
+	double speed;
+	double timeIndicatorFrequency;
+	int64_t batchWindowInNanoseconds;
+	size_t maximumBatchSize;
+	int64_t spinDurationInNanoseconds;
+	double reorderToleranceInSeconds;
+	double maximumGapInSeconds;
+	std::atomic<bool> stopRequested;
+
+	std::vector<CCSDSSpacePacketView> batch;
+	size_t position;
+	uint64_t nPackets;
+	uint64_t nBatches;
+	uint64_t nLateBatches;
+	uint64_t nTimeDiscontinuities;
+	CCSDSLatencyHistogram pacingErrors;
+
+public:
+	/** Constructs an instance that replays a file.
+	 * The file is memory-mapped until this instance is deleted.
+	 * @param[in] filename name of a file that contains concatenated CCSDS SpacePackets.
+	 * @param[in] listener a listener that receives packets (not deleted by this class).
+	 */
+	CCSDSPacketReplayer(std::string filename, CCSDSPacketReplayerListener* listener) {
+		initialize(listener);
+		int fd = open(filename.c_str(), O_RDONLY);
+		if (fd < 0) {
+			throw CCSDSPacketReplayerException("CCSDSPacketReplayer: cannot open " + filename);
+		}
+		struct stat st;
+		if (fstat(fd, &st) != 0) {
+			close(fd);
+			throw CCSDSPacketReplayerException("CCSDSPacketReplayer: cannot stat " + filename);
+		}
+		bufferSize = st.st_size;
+		if (bufferSize != 0) {
+			mappedAddress = mmap(NULL, bufferSize, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mappedAddress == MAP_FAILED) {
+				mappedAddress = NULL;
+				close(fd);
+				throw CCSDSPacketReplayerException("CCSDSPacketReplayer: cannot map " + filename);
+			}
+			madvise(mappedAddress, bufferSize, MADV_SEQUENTIAL);
+			buffer = (const uint8_t*) mappedAddress;
+		}
+		close(fd);
+	}
+
+public:
+	/** Constructs an instance that replays a byte array already in memory.
+	 * The byte array must outlive this instance.
+	 * @param[in] buffer a pointer to concatenated CCSDS SpacePackets.
+	 * @param[in] length the length of the buffer.
+	 * @param[in] listener a listener that receives packets (not deleted by this class).
+	 */
+	CCSDSPacketReplayer(const uint8_t* buffer, size_t length, CCSDSPacketReplayerListener* listener) {
+		initialize(listener);
+		this->buffer = buffer;
+		this->bufferSize = length;
+	}
+
+public:
+	/** Destructor. The mapped file is unmapped.
+	 */
+	virtual ~CCSDSPacketReplayer() {
+		if (mappedAddress != NULL) {
+			munmap(mappedAddress, bufferSize);
+		}
+	}
+
+private:
+	CCSDSPacketReplayer(const CCSDSPacketReplayer&);
+	CCSDSPacketReplayer& operator=(const CCSDSPacketReplayer&);
+
+private:
+	void initialize(CCSDSPacketReplayerListener* listener) {
+		this->buffer = NULL;
+		this->bufferSize = 0;
+		this->mappedAddress = NULL;
+		this->listener = listener;
+		this->speed = 1;
+		this->timeIndicatorFrequency = DefaultTimeIndicatorFrequency;
+		this->batchWindowInNanoseconds = DefaultBatchWindowInNanoseconds;
+		this->maximumBatchSize = DefaultMaximumBatchSize;
+		this->spinDurationInNanoseconds = DefaultSpinDurationInNanoseconds;
+		this->reorderToleranceInSeconds = 1;
+		this->maximumGapInSeconds = 0;
+		this->stopRequested.store(false);
+		this->position = 0;
+		resetCounters();
+	}
+
+public:
+	/** Sets the speedup factor (1 = original timing; AsFastAsPossible disables pacing). */
+	void setSpeed(double speed) {
+		this->speed = (speed < 0) ? 0 : speed;
+	}
+
+public:
+	/** Sets the TI count rate in Hz. */
+	void setTimeIndicatorFrequency(double timeIndicatorFrequency) {
+		this->timeIndicatorFrequency = timeIndicatorFrequency;
+	}
+
+public:
+	/** Sets the time window (after speedup) within which packets are emitted as one batch. */
+	void setBatchWindow(int64_t batchWindowInNanoseconds) {
+		this->batchWindowInNanoseconds = batchWindowInNanoseconds;
+	}
+
+public:
+	/** Sets the maximum number of packets per batch. */
+	void setMaximumBatchSize(size_t maximumBatchSize) {
+		this->maximumBatchSize = (maximumBatchSize == 0) ? 1 : maximumBatchSize;
+	}
+
+public:
+	/** Sets the time before each deadline spent busy waiting. */
+	void setSpinDuration(int64_t spinDurationInNanoseconds) {
+		this->spinDurationInNanoseconds = spinDurationInNanoseconds;
+	}
+
+public:
+	/** Sets the largest backward TI step (in seconds of TI) treated as reordering rather than a reset. */
+	void setReorderTolerance(double reorderToleranceInSeconds) {
+		this->reorderToleranceInSeconds = reorderToleranceInSeconds;
+	}
+
+public:
+	/** Shortens TI gaps longer than this (in seconds of TI) to this length (0 disables). */
+	void setMaximumGap(double maximumGapInSeconds) {
+		this->maximumGapInSeconds = maximumGapInSeconds;
+	}
+
+public:
+	/** Makes replay() return after the current batch (can be called from another thread).
+	 * A stop requested before replay() starts is not lost: replay() then returns immediately.
+	 * The request stays in effect until reset() is called.
+	 */
+	void stop() {
+		stopRequested.store(true);
+	}
+
+public:
+	/** Clears a stop request, so that the next replay() continues from the current position. */
+	void reset() {
+		stopRequested.store(false);
+	}
+
+public:
+	/** Restarts the next replay() from the top of the archive. */
+	void rewind() {
+		position = 0;
+	}
+
+public:
+	void resetCounters() {
+		nPackets = 0;
+		nBatches = 0;
+		nLateBatches = 0;
+		nTimeDiscontinuities = 0;
+		pacingErrors.reset();
+	}
+
+private:
+	void waitUntil(Clock::time_point deadline) {
+		Clock::time_point now = Clock::now();
+		if (now >= deadline) {
+			nLateBatches++;
+			pacingErrors.record(std::chrono::duration_cast<std::chrono::nanoseconds>(now - deadline).count());
+			return;
+		}
+		Clock::time_point spinStart = deadline - std::chrono::nanoseconds(spinDurationInNanoseconds);
+		if (now < spinStart) {
+			std::this_thread::sleep_until(spinStart);
+		}
+		while ((now = Clock::now()) < deadline) {
+		}
+		pacingErrors.record(std::chrono::duration_cast<std::chrono::nanoseconds>(now - deadline).count());
+	}
+
+public:
+	/** Replays packets from the current position until the end of the archive (or the
+	 * first implausible or truncated packet), or until stop() is called (see reset()).
+	 * @returns the number of packets emitted.
+	 */
+	uint64_t replay() {
+		bool paced = (speed != AsFastAsPossible);
+		double nanosecondsPerTick = paced ? 1e9 / (timeIndicatorFrequency * speed) : 0;
+		int64_t reorderToleranceInTicks = (int64_t) (reorderToleranceInSeconds * timeIndicatorFrequency);
+		int64_t maximumGapInTicks = (int64_t) (maximumGapInSeconds * timeIndicatorFrequency);
+		bool hasReference = false;
+		uint32_t referenceTI = 0;
+		uint64_t elapsedTicks = 0;
+		uint64_t nEmitted = 0;
+		batch.reserve(maximumBatchSize);
+		Clock::time_point start = Clock::now();
+		while (!stopRequested.load(std::memory_order_relaxed)) {
+			batch.clear();
+			int64_t batchDeadline = 0;
+			while (batch.size() < maximumBatchSize
+					&& CCSDSSpacePacketView::isPlausiblePacket(buffer + position, bufferSize - position)) {
+				CCSDSSpacePacketView view(buffer + position,
+						CCSDSSpacePacketView::peekTotalPacketLength(buffer + position));
+				uint64_t ticks = elapsedTicks;
+				uint32_t ti = referenceTI;
+				bool discontinuity = false;
+				if (view.isSecondaryHeaderPresent() && view.length >= 10) {
+					ti = view.getTimeAsInteger();
+					if (hasReference) {
+						int64_t step = (int32_t) (ti - referenceTI);
+						if (step > 0) {
+							ticks += (maximumGapInTicks != 0 && step > maximumGapInTicks) ? maximumGapInTicks : step;
+						} else if (-step > reorderToleranceInTicks) {
+							discontinuity = true;
+						} else {
+							//reordered packet; emitted at the current time
+							ti = referenceTI;
+						}
+					}
+				}
+				int64_t deadline = (int64_t) ((double) ticks * nanosecondsPerTick);
+				if (!batch.empty() && deadline > batchDeadline + batchWindowInNanoseconds) {
+					break;
+				}
+				if (batch.empty()) {
+					batchDeadline = deadline;
+				}
+				if (view.isSecondaryHeaderPresent() && view.length >= 10) {
+					hasReference = true;
+				}
+				nTimeDiscontinuities += discontinuity ? 1 : 0;
+				referenceTI = ti;
+				elapsedTicks = ticks;
+				batch.push_back(view);
+				position += view.length;
+			}
+			if (batch.empty()) {
+				break;
+			}
+			if (paced) {
+				waitUntil(start + std::chrono::nanoseconds(batchDeadline));
+			}
+			listener->onPackets(&batch[0], batch.size());
+			nEmitted += batch.size();
+			nPackets += batch.size();
+			nBatches++;
+		}
+		return nEmitted;
+	}
+
+public:
+	/** Returns the distribution of (actual - scheduled) emission time of batches in nanoseconds. */
+	const CCSDSLatencyHistogram& getPacingErrorHistogram() const {
+		return pacingErrors;
+	}
+
+public:
+	uint64_t getNumberOfPackets() const {
+		return nPackets;
+	}
+
+public:
+	uint64_t getNumberOfBatches() const {
+		return nBatches;
+	}
+
+public:
+	/** Returns the number of batches whose deadline had passed before waiting (the listener did not keep up). */
+	uint64_t getNumberOfLateBatches() const {
+		return nLateBatches;
+	}
+
+public:
+	/** Returns the number of backward TI steps beyond the reorder tolerance. */
+	uint64_t getNumberOfTimeDiscontinuities() const {
+		return nTimeDiscontinuities;
+	}
+
+public:
+	/** Returns the read position in the archive. */
+	size_t getPosition() const {
+		return position;
+	}
+};
+
+#endif /* CCSDSPACKETREPLAYER_HH_ */
@@ -0,0 +1,164 @@
+/*
+ * CCSDSPacketSource.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSPACKETSOURCE_HH_
+#define CCSDSPACKETSOURCE_HH_
+
+#include "CCSDSSpacePacketView.hh"
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+
+class CCSDSPacketSourceException {
+public:
+	CCSDSPacketSourceException(std::string str) {
+		message = str;
+	}
+
+public:
+	std::string toString() {
+		return message;
+	}
+
+public:
+	std::string message;
+};
+
+/** An interface of a pull-based stream of CCSDS SpacePackets.
+ * Each call of next() returns a view of the next packet. The view is valid
+ * until the next call of next() on the same source.
+ */
+class CCSDSPacketSource {
+public:
+	virtual ~CCSDSPacketSource() {
+	}
+
+public:
+	/** Retrieves the next packet.
+	 * @param[out] view a view of the next packet.
+	 * @returns false when the stream has ended.
+	 */
+	virtual bool next(CCSDSSpacePacketView& view) = 0;
+};
+
+/** A packet source that walks concatenated packets in a byte array.
+ * The stream ends at the end of the array, or at the first implausible or
+ * truncated packet; getNumberOfRemainingBytes() tells how many bytes were left.
+ */
+class CCSDSBufferPacketSource: public CCSDSPacketSource {
+private:
+	const uint8_t* buffer;
+	size_t length;
+	size_t position;
+
+public:
+	/** Constructs an instance. The byte array must outlive this instance.
+	 * @param[in] buffer a pointer to concatenated CCSDS SpacePackets.
+	 * @param[in] length the length of the buffer.
+	 */
+	CCSDSBufferPacketSource(const uint8_t* buffer, size_t length) {
+		this->buffer = buffer;
+		this->length = length;
+		this->position = 0;
+	}
+
+public:
+	virtual bool next(CCSDSSpacePacketView& view) {
+		if (!CCSDSSpacePacketView::isPlausiblePacket(buffer + position, length - position)) {
+			return false;
+		}
+		size_t totalPacketLength = CCSDSSpacePacketView::peekTotalPacketLength(buffer + position);
+		view = CCSDSSpacePacketView(buffer + position, totalPacketLength);
+		position += totalPacketLength;
+		return true;
+	}
+
+public:
+	/** Returns the current read position in the buffer. */
+	size_t getPosition() const {
+		return position;
+	}
+
+public:
+	/** Returns the number of bytes not consumed as packets. */
+	size_t getNumberOfRemainingBytes() const {
+		return length - position;
+	}
+};
+
+/** A packet source that reads concatenated packets from a file through a
+ * fixed-size buffer, so that memory usage does not depend on the file size.
+ * The stream ends at the end of the file, or at the first implausible or truncated packet.
+ */
+class CCSDSFilePacketSource: public CCSDSPacketSource {
+public:
+	/** The largest possible CCSDS SpacePacket (Primary Header + 65536 bytes). */
+	static const size_t MaximumPacketLength = 6 + 65536;
+	static const size_t DefaultBufferSize = 1024 * 1024;
+
+private:
+	FILE* file;
+	std::vector<uint8_t> buffer;
+	size_t begin;
+	size_t end;
+	bool endOfFile;
+
+public:
+	/** Constructs an instance.
+	 * @param[in] filename name of a file that contains concatenated CCSDS SpacePackets.
+	 * @param[in] bufferSize read buffer size (at least MaximumPacketLength).
+	 */
+	CCSDSFilePacketSource(std::string filename, size_t bufferSize = DefaultBufferSize) {
+		file = fopen(filename.c_str(), "rb");
+		if (file == NULL) {
+			throw CCSDSPacketSourceException("CCSDSFilePacketSource: cannot open " + filename);
+		}
+		buffer.resize((bufferSize < MaximumPacketLength) ? MaximumPacketLength : bufferSize);
+		begin = 0;
+		end = 0;
+		endOfFile = false;
+	}
+
+public:
+	virtual ~CCSDSFilePacketSource() {
+		fclose(file);
+	}
+
+private:
+	void fill() {
+		if (begin != 0) {
+			memmove(&buffer[0], &buffer[begin], end - begin);
+			end -= begin;
+			begin = 0;
+		}
+		while (!endOfFile && end < buffer.size()) {
+			size_t n = fread(&buffer[end], 1, buffer.size() - end, file);
+			end += n;
+			if (n == 0) {
+				endOfFile = true;
+			}
+		}
+	}
+
+public:
+	virtual bool next(CCSDSSpacePacketView& view) {
+		if (end - begin < CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength
+				|| end - begin < CCSDSSpacePacketView::peekTotalPacketLength(&buffer[begin])) {
+			fill();
+		}
+		if (!CCSDSSpacePacketView::isPlausiblePacket(&buffer[begin], end - begin)) {
+			return false;
+		}
+		size_t totalPacketLength = CCSDSSpacePacketView::peekTotalPacketLength(&buffer[begin]);
+		view = CCSDSSpacePacketView(&buffer[begin], totalPacketLength);
+		begin += totalPacketLength;
+		return true;
+	}
+};
+
+#endif /* CCSDSPACKETSOURCE_HH_ */
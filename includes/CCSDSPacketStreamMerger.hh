@@ -0,0 +1,164 @@
+/*
+ * CCSDSPacketStreamMerger.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSPACKETSTREAMMERGER_HH_
+#define CCSDSPACKETSTREAMMERGER_HH_
+
+#include "CCSDSPacketSource.hh"
+#include <vector>
+#include <algorithm>
+
+/** A class that merges multiple time-ordered packet streams into one.
+ * Packets are ordered by the Time field of the Secondary Header (TI), then by APID,
+ * then by Packet Sequence Count, and finally by the order in which sources were added.
+ * A heap holds one pending packet (a zero-copy view) per source, so the memory used
+ * per input is bounded by the buffer of the source itself.
+ *
+ * TI and Packet Sequence Count are compared with serial-number arithmetic, so that
+ * streams crossing the 32-bit TI wrap-around (or the 14-bit sequence count
+ * wrap-around) stay in order as long as pending packets are within half of the
+ * counter range of each other. Packets without Secondary Header inherit the TI of
+ * the preceding packet of the same source.
+ *
+ * @par
+ * Example:
+ * @code
+ CCSDSFilePacketSource station1("station1.ccsds");
+ CCSDSFilePacketSource station2("station2.ccsds");
+ CCSDSPacketStreamMerger merger;
+ merger.addSource(&station1);
+ merger.addSource(&station2);
+ CCSDSSpacePacketView view;
+ while (merger.next(view)) {
+ 	...
+ }
+ * @endcode
+ */
+class CCSDSPacketStreamMerger: public CCSDSPacketSource {
+private:
+	class Head {
+	public:
+		CCSDSSpacePacketView view;
+		uint32_t ti;
+		uint16_t apid;
+		uint16_t sequenceCount;
+		size_t sourceIndex;
+	};
+
+private:
+	/** Comparator for std::push_heap/pop_heap (a max-heap); returns true if a comes after b. */
+	class LaterThan {
+	public:
+		bool operator()(const Head& a, const Head& b) const {
+			return compare(a, b) > 0;
+		}
+	};
+
+private:
+	std::vector<CCSDSPacketSource*> sources;
+	std::vector<uint32_t> lastTIs;
+	std::vector<Head> heap;
+	bool started;
+	bool hasPoppedSource;
+	size_t poppedSourceIndex;
+
+public:
+	/** Constructs an empty merger. */
+	CCSDSPacketStreamMerger() {
+		started = false;
+		hasPoppedSource = false;
+		poppedSourceIndex = 0;
+	}
+
+public:
+	/** Adds a source. Sources must be added before the first call of next().
+	 * The source is not deleted by this class.
+	 */
+	void addSource(CCSDSPacketSource* source) {
+		sources.push_back(source);
+		lastTIs.push_back(0);
+	}
+
+public:
+	/** Compares two TI values with serial-number arithmetic.
+	 * @returns negative if a is earlier than b, 0 if equal, positive otherwise.
+	 */
+	static inline int32_t compareTI(uint32_t a, uint32_t b) {
+		return (int32_t) (a - b);
+	}
+
+public:
+	/** Compares two 14-bit Packet Sequence Counts with serial-number arithmetic.
+	 * @returns negative if a is earlier than b, 0 if equal, positive otherwise.
+	 */
+	static inline int32_t compareSequenceCount(uint16_t a, uint16_t b) {
+		int32_t difference = (a - b) & 0x3FFF;
+		return (difference >= 0x2000) ? difference - 0x4000 : difference;
+	}
+
+private:
+	static int32_t compare(const Head& a, const Head& b) {
+		int32_t result = compareTI(a.ti, b.ti);
+		if (result != 0) {
+			return result;
+		}
+		if (a.apid != b.apid) {
+			return (int32_t) a.apid - (int32_t) b.apid;
+		}
+		result = compareSequenceCount(a.sequenceCount, b.sequenceCount);
+		if (result != 0) {
+			return result;
+		}
+		return (int32_t) a.sourceIndex - (int32_t) b.sourceIndex;
+	}
+
+private:
+	void advance(size_t sourceIndex) {
+		Head head;
+		if (!sources[sourceIndex]->next(head.view)) {
+			return;
+		}
+		if (head.view.isSecondaryHeaderPresent()) {
+			lastTIs[sourceIndex] = head.view.getTimeAsInteger();
+		}
+		head.ti = lastTIs[sourceIndex];
+		head.apid = head.view.getAPIDAsInteger();
+		head.sequenceCount = head.view.getSequenceCount();
+		head.sourceIndex = sourceIndex;
+		heap.push_back(head);
+		std::push_heap(heap.begin(), heap.end(), LaterThan());
+	}
+
+public:
+	/** Retrieves the next packet in merged order.
+	 * The view is valid until the next call of next().
+	 */
+	virtual bool next(CCSDSSpacePacketView& view) {
+		if (!started) {
+			started = true;
+			heap.reserve(sources.size());
+			for (size_t i = 0; i < sources.size(); i++) {
+				advance(i);
+			}
+		} else if (hasPoppedSource) {
+			//the previously returned view is released only now, so the source may reuse its buffer
+			advance(poppedSourceIndex);
+		}
+		hasPoppedSource = false;
+		if (heap.empty()) {
+			return false;
+		}
+		std::pop_heap(heap.begin(), heap.end(), LaterThan());
+		view = heap.back().view;
+		poppedSourceIndex = heap.back().sourceIndex;
+		hasPoppedSource = true;
+		heap.pop_back();
+		return true;
+	}
+};
+
+#endif /* CCSDSPACKETSTREAMMERGER_HH_ */
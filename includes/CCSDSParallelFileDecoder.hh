@@ -0,0 +1,401 @@
+/*
+ * CCSDSParallelFileDecoder.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSPARALLELFILEDECODER_HH_
+#define CCSDSPARALLELFILEDECODER_HH_
+
+#include "CCSDSSpacePacketView.hh"
+#include <string>
+#include <vector>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class CCSDSParallelFileDecoderException {
+public:
+	CCSDSParallelFileDecoderException(std::string str) {
+		message = str;
+	}
+
+public:
+	std::string toString() {
+		return message;
+	}
+
+public:
+	std::string message;
+};
+
+/** A class that decodes a file of concatenated CCSDS SpacePackets using multiple threads.
+ * The file is memory-mapped and split into N byte ranges. Each thread searches
+ * its range for a trustworthy packet boundary (a position from which several
+ * consecutive plausible packet headers chain together), and then walks packets
+ * from there. A packet belongs to the range in which it starts.
+ * When the ranges are merged back in file order, the boundary found by each
+ * range is cross-checked against the position at which the previous range
+ * stopped walking. If the previous chain lands on a different position, the
+ * range is re-walked from that position, so that the result is identical to
+ * a sequential decode.
+ *
+ * @par
+ * Example:
+ * @code
+ CCSDSParallelFileDecoder decoder("archive.ccsds");
+ decoder.setNumberOfThreads(32);
+ std::vector<CCSDSSpacePacketView> views = decoder.decode();
+ for (size_t i = 0; i < views.size(); i++) {
+ 	...views[i].getAPIDAsInteger()...
+ }
+ * @endcode
+ * Views returned by decode() refer to the mapped file and are valid while the decoder instance exists.
+ */
+class CCSDSParallelFileDecoder {
+public:
+	static const size_t DefaultNumberOfChainedPackets = 4;
+	static const size_t DefaultMinimumRangeSize = 1024 * 1024;
+
+private:
+	class Range {
+	public:
+		size_t begin;
+		size_t end;
+		size_t firstPacketPosition;
+		size_t stopPosition;
+		bool stoppedWhileSearching;
+		size_t skippedBytes;
+		size_t nPacketErrorControlFailures;
+		std::vector<CCSDSSpacePacketView> views;
+		std::vector<CCSDSSpacePacket*> packets;
+	};
+
+private:
+	const uint8_t* buffer;
+	size_t bufferSize;
+	void* mappedAddress;
+	size_t nThreads;
+	size_t nChainedPackets;
+	size_t minimumRangeSize;
+	size_t nSkippedBytes;
+	size_t nResynchronizedRanges;
+	bool packetErrorControlUsed;
+	size_t nPacketErrorControlFailures;
+
+public:
+	/** Constructs an instance that decodes a file.
+	 * The file is memory-mapped until this instance is deleted.
+	 * @param[in] filename name of a file that contains concatenated CCSDS SpacePackets.
+	 */
+	CCSDSParallelFileDecoder(std::string filename) {
+		initialize();
+		int fd = open(filename.c_str(), O_RDONLY);
+		if (fd < 0) {
+			throw CCSDSParallelFileDecoderException("CCSDSParallelFileDecoder: cannot open " + filename);
+		}
+		struct stat st;
+		if (fstat(fd, &st) != 0) {
+			close(fd);
+			throw CCSDSParallelFileDecoderException("CCSDSParallelFileDecoder: cannot stat " + filename);
+		}
+		bufferSize = st.st_size;
+		if (bufferSize != 0) {
+			mappedAddress = mmap(NULL, bufferSize, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mappedAddress == MAP_FAILED) {
+				mappedAddress = NULL;
+				close(fd);
+				throw CCSDSParallelFileDecoderException("CCSDSParallelFileDecoder: cannot map " + filename);
+			}
+			madvise(mappedAddress, bufferSize, MADV_SEQUENTIAL);
+			buffer = (const uint8_t*) mappedAddress;
+		}
+		close(fd);
+	}
+
+public:
+	/** Constructs an instance that decodes a byte array already in memory.
+	 * The byte array must outlive this instance.
+	 * @param[in] buffer a pointer to concatenated CCSDS SpacePackets.
+	 * @param[in] length the length of the buffer.
+	 */
+	CCSDSParallelFileDecoder(const uint8_t* buffer, size_t length) {
+		initialize();
+		this->buffer = buffer;
+		this->bufferSize = length;
+	}
+
+public:
+	/** Destructor. The mapped file is unmapped.
+	 */
+	virtual ~CCSDSParallelFileDecoder() {
+		if (mappedAddress != NULL) {
+			munmap(mappedAddress, bufferSize);
+		}
+	}
+
+private:
+	void initialize() {
+		buffer = NULL;
+		bufferSize = 0;
+		mappedAddress = NULL;
+		nThreads = std::thread::hardware_concurrency();
+		if (nThreads == 0) {
+			nThreads = 1;
+		}
+		nChainedPackets = DefaultNumberOfChainedPackets;
+		minimumRangeSize = DefaultMinimumRangeSize;
+		nSkippedBytes = 0;
+		nResynchronizedRanges = 0;
+		packetErrorControlUsed = false;
+		nPacketErrorControlFailures = 0;
+	}
+
+public:
+	/** Sets the number of threads (= the maximum number of byte ranges).
+	 */
+	void setNumberOfThreads(size_t nThreads) {
+		this->nThreads = (nThreads == 0) ? 1 : nThreads;
+	}
+
+public:
+	/** Sets the number of consecutive plausible packets required to accept
+	 * a position as a packet boundary when searching inside a range.
+	 */
+	void setNumberOfChainedPackets(size_t nChainedPackets) {
+		this->nChainedPackets = (nChainedPackets == 0) ? 1 : nChainedPackets;
+	}
+
+public:
+	/** Sets the minimum size of a byte range. Small files are decoded with fewer threads.
+	 */
+	void setMinimumRangeSize(size_t minimumRangeSize) {
+		this->minimumRangeSize = (minimumRangeSize == 0) ? 1 : minimumRangeSize;
+	}
+
+public:
+	/** Sets whether packets carry the Packet Error Control field (CRC-16).
+	 * When set, the CRC of each packet is verified by the decoding threads, packets
+	 * with a mismatching CRC are dropped from the result, and packets produced by
+	 * decodeToPackets() exclude the CRC from their User Data Field.
+	 */
+	void setPacketErrorControlUsed(bool packetErrorControlUsed) {
+		this->packetErrorControlUsed = packetErrorControlUsed;
+	}
+
+public:
+	/** Returns the number of packets dropped in the last decode because of a CRC mismatch.
+	 */
+	size_t getNumberOfPacketErrorControlFailures() const {
+		return nPacketErrorControlFailures;
+	}
+
+public:
+	/** Returns the number of bytes that did not belong to any plausible packet in the last decode.
+	 */
+	size_t getNumberOfSkippedBytes() const {
+		return nSkippedBytes;
+	}
+
+public:
+	/** Returns the number of ranges whose boundary disagreed with the previous range
+	 * and were re-walked during the last decode.
+	 */
+	size_t getNumberOfResynchronizedRanges() const {
+		return nResynchronizedRanges;
+	}
+
+public:
+	/** Returns a pointer to the decoded byte array (the mapped file). */
+	const uint8_t* getBuffer() const {
+		return buffer;
+	}
+
+public:
+	/** Returns the size of the decoded byte array (the file size). */
+	size_t getBufferSize() const {
+		return bufferSize;
+	}
+
+public:
+	/** Splits the input into byte ranges, and finds packets in parallel.
+	 * @returns packet views in file order.
+	 */
+	std::vector<CCSDSSpacePacketView> decode() {
+		std::vector<Range> ranges;
+		run(ranges, false);
+		std::vector<CCSDSSpacePacketView> result;
+		size_t nPackets = 0;
+		for (size_t i = 0; i < ranges.size(); i++) {
+			nPackets += ranges[i].views.size();
+		}
+		result.reserve(nPackets);
+		for (size_t i = 0; i < ranges.size(); i++) {
+			result.insert(result.end(), ranges[i].views.begin(), ranges[i].views.end());
+		}
+		return result;
+	}
+
+public:
+	/** Splits the input into byte ranges, and interprets packets into
+	 * CCSDSSpacePacket instances in parallel.
+	 * Deletion of the returned instances must be taken care in user application.
+	 * @returns newly created packet instances in file order.
+	 */
+	std::vector<CCSDSSpacePacket*> decodeToPackets() {
+		std::vector<Range> ranges;
+		run(ranges, true);
+		std::vector<CCSDSSpacePacket*> result;
+		size_t nPackets = 0;
+		for (size_t i = 0; i < ranges.size(); i++) {
+			nPackets += ranges[i].packets.size();
+		}
+		result.reserve(nPackets);
+		for (size_t i = 0; i < ranges.size(); i++) {
+			result.insert(result.end(), ranges[i].packets.begin(), ranges[i].packets.end());
+		}
+		return result;
+	}
+
+private:
+	void run(std::vector<Range>& ranges, bool interpret) {
+		nSkippedBytes = 0;
+		nResynchronizedRanges = 0;
+		nPacketErrorControlFailures = 0;
+		if (bufferSize == 0) {
+			return;
+		}
+
+		size_t nRanges = bufferSize / minimumRangeSize;
+		if (nRanges > nThreads) {
+			nRanges = nThreads;
+		}
+		if (nRanges == 0) {
+			nRanges = 1;
+		}
+		ranges.resize(nRanges);
+		size_t rangeSize = bufferSize / nRanges;
+		for (size_t i = 0; i < nRanges; i++) {
+			ranges[i].begin = i * rangeSize;
+			ranges[i].end = (i == nRanges - 1) ? bufferSize : (i + 1) * rangeSize;
+		}
+
+		//decode each range independently
+		if (nRanges == 1) {
+			walkRange(ranges[0], findBoundary(0, bufferSize), interpret);
+		} else {
+			std::vector<std::thread> threads;
+			for (size_t i = 0; i < nRanges; i++) {
+				threads.push_back(std::thread(&CCSDSParallelFileDecoder::decodeRange, this, &ranges[i], interpret));
+			}
+			for (size_t i = 0; i < threads.size(); i++) {
+				threads[i].join();
+			}
+		}
+
+		//merge in file order, cross-checking each boundary with the previous range
+		nSkippedBytes += ranges[0].firstPacketPosition - ranges[0].begin + ranges[0].skippedBytes;
+		for (size_t i = 1; i < nRanges; i++) {
+			Range& previous = ranges[i - 1];
+			Range& range = ranges[i];
+			if (previous.stoppedWhileSearching) {
+				//the previous range was still searching for a boundary when it reached its end,
+				//so the boundary found by this range is the one a sequential decode would find
+				nSkippedBytes += range.firstPacketPosition - range.begin;
+			} else if (previous.stopPosition != range.firstPacketPosition) {
+				//this range started from a different boundary; re-walk from the trusted position
+				nResynchronizedRanges++;
+				walkRange(range, previous.stopPosition, interpret);
+			}
+			nSkippedBytes += range.skippedBytes;
+		}
+		for (size_t i = 0; i < nRanges; i++) {
+			nPacketErrorControlFailures += ranges[i].nPacketErrorControlFailures;
+		}
+	}
+
+private:
+	void decodeRange(Range* range, bool interpret) {
+		walkRange(*range, findBoundary(range->begin, range->end), interpret);
+	}
+
+private:
+	/** Walks packets starting at a given position, and records packets that start in the range.
+	 */
+	void walkRange(Range& range, size_t start, bool interpret) {
+		clearRange(range);
+		range.firstPacketPosition = start;
+		range.stoppedWhileSearching = (start == range.end);
+		size_t position = start;
+		while (position < range.end) {
+			if (!CCSDSSpacePacketView::isPlausiblePacket(buffer + position, bufferSize - position)) {
+				size_t next = findBoundary(position + 1, range.end);
+				range.skippedBytes += next - position;
+				range.stoppedWhileSearching = (next == range.end);
+				position = next;
+				continue;
+			}
+			size_t totalPacketLength = CCSDSSpacePacketView::peekTotalPacketLength(buffer + position);
+			CCSDSSpacePacketView view(buffer + position, totalPacketLength);
+			position += totalPacketLength;
+			if (packetErrorControlUsed && !view.isPacketErrorControlValid()) {
+				range.nPacketErrorControlFailures++;
+				continue;
+			}
+			if (interpret) {
+				CCSDSSpacePacket* packet = new CCSDSSpacePacket;
+				packet->setPacketErrorControlUsed(packetErrorControlUsed);
+				view.interpretAs(packet);
+				range.packets.push_back(packet);
+			} else {
+				range.views.push_back(view);
+			}
+		}
+		range.stopPosition = position;
+	}
+
+private:
+	void clearRange(Range& range) {
+		for (size_t i = 0; i < range.packets.size(); i++) {
+			delete range.packets[i];
+		}
+		range.packets.clear();
+		range.views.clear();
+		range.skippedBytes = 0;
+		range.nPacketErrorControlFailures = 0;
+	}
+
+private:
+	/** Returns the first position in [from, to) at which nChainedPackets plausible
+	 * packets chain together (or chain up to the end of the buffer).
+	 * Returns to if there is no such position.
+	 */
+	size_t findBoundary(size_t from, size_t to) const {
+		for (size_t position = from; position < to; position++) {
+			if (isChainPlausible(position)) {
+				return position;
+			}
+		}
+		return to;
+	}
+
+private:
+	bool isChainPlausible(size_t position) const {
+		for (size_t i = 0; i < nChainedPackets; i++) {
+			if (position == bufferSize) {
+				return true;
+			}
+			if (!CCSDSSpacePacketView::isPlausiblePacket(buffer + position, bufferSize - position)) {
+				return false;
+			}
+			position += CCSDSSpacePacketView::peekTotalPacketLength(buffer + position);
+		}
+		return true;
+	}
+};
+
+#endif /* CCSDSPARALLELFILEDECODER_HH_ */
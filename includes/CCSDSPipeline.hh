@@ -0,0 +1,750 @@
+/*
+ * CCSDSPipeline.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSPIPELINE_HH_
+#define CCSDSPIPELINE_HH_
+
+#include "CCSDSPacketSource.hh"
+#include "CCSDSLockFreeRing.hh"
+#include "CCSDSThreadAffinity.hh"
+#include "CCSDSLatencyInstrumentation.hh"
+#include "ADUUnsegmenter.hh"
+#include <atomic>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+class CCSDSPipelineException {
+public:
+	CCSDSPipelineException(std::string str) {
+		message = str;
+	}
+
+public:
+	std::string toString() {
+		return message;
+	}
+
+public:
+	std::string message;
+};
+
+/** An interface that receives the products of CCSDSPipeline.
+ * Methods are invoked from the sink thread only.
+ */
+class CCSDSPipelineSink {
+public:
+	virtual ~CCSDSPipelineSink() {
+	}
+
+public:
+	/** Invoked for each ADU completed by the reassembly stage.
+	 * The ADU is deleted after this method returns.
+	 */
+	virtual void onADU(const ADU& adu) = 0;
+
+public:
+	/** Invoked for each packet that does not use the ADU Channel (or for all packets
+	 * when reassembly is disabled). The packet is recycled after this method returns.
+	 */
+	virtual void onPacket(const CCSDSSpacePacket&) {
+	}
+};
+
+/** Statistics of a queue between two pipeline stages. */
+class CCSDSPipelineQueueStatistics {
+public:
+	std::string name;
+	size_t depth;
+	size_t maximumDepth;
+	size_t capacity;
+	uint64_t nPushed;
+	uint64_t nDropped;
+};
+
+/** A class that runs the ingest, decode, reassemble, and sink stages on separate threads.
+ * Stages are connected by bounded lock-free rings (CCSDSLockFreeRing), and byte buffers
+ * and CCSDSSpacePacket instances are recycled through free rings, so that no allocation
+ * happens per packet except inside ADUUnsegmenter.
+ *
+ * Decoding and reassembly are split into lanes: a packet goes to lane
+ * (lower 8 bits of APID) % nLanes, and each lane has its own decode thread and
+ * reassemble thread. Packets of an APID therefore stay in order, and throughput
+ * scales with the number of lanes as long as traffic is spread over APIDs.
+ *
+ * @code
+ ingest --> [lane 0] decode --> reassemble --+
+        --> [lane 1] decode --> reassemble --+--> sink
+ * @endcode
+ *
+ * Backpressure is applied where packets enter the pipeline; the queues between later
+ * stages never drop, so a slow sink eventually fills the ingest queues:
+ * - Block: the ingest thread waits until the lane queue has room.
+ * - DropOldest: the oldest queued packet of the lane is dropped.
+ * - DropByAPIDPriority: a packet with priority p (0 to NPriorityLevels - 1, see
+ *   setAPIDPriority()) is dropped when the lane queue is filled to
+ *   (p + 1) / NPriorityLevels of its capacity; the highest priority is never dropped
+ *   and blocks instead.
+ *
+ * Per-stage latency histograms and sampled packet traces are recorded when a
+ * CCSDSLatencyInstrumentation is set (see setLatencyInstrumentation()).
+ *
+ * @par
+ * Example:
+ * @code
+ CCSDSUDPPacketSource source(10000);
+ MySink sink;
+ CCSDSPipeline pipeline(&source, &sink, 2);
+ pipeline.setBackpressurePolicy(CCSDSPipeline::DropByAPIDPriority);
+ pipeline.setAPIDPriority(0x123, CCSDSPipeline::NPriorityLevels - 1);
+ pipeline.setCoreAffinity(CCSDSPipeline::Ingest, 0, 1);
+ pipeline.start();
+ ...
+ pipeline.stop();
+ * @endcode
+ */
+class CCSDSPipeline {
+public:
+	enum BackpressurePolicy {
+		Block, DropOldest, DropByAPIDPriority
+	};
+
+	enum Stage {
+		Ingest, Decode, Reassemble, Sink
+	};
+
+	static const size_t DefaultQueueCapacity = 4096;
+	static const size_t NPriorityLevels = 4;
+	static const size_t NAPIDs = 2048;
+
+private:
+	/** Timestamps carried with a packet when latency instrumentation is enabled (all zero otherwise). */
+	class Timing {
+	public:
+		uint64_t ingestTime;
+		uint64_t framedTime;
+		uint64_t decodedTime;
+		uint64_t reassembledTime;
+		bool traced;
+
+		Timing() {
+			ingestTime = 0;
+			framedTime = 0;
+			decodedTime = 0;
+			reassembledTime = 0;
+			traced = false;
+		}
+	};
+
+	class Buffer {
+	public:
+		std::vector<uint8_t> data;
+		size_t length;
+		uint16_t apid;
+		Timing timing;
+	};
+
+	class Decoded {
+	public:
+		CCSDSSpacePacket* packet;
+		Timing timing;
+	};
+
+	class Output {
+	public:
+		ADU* adu;
+		CCSDSSpacePacket* packet;
+		size_t lane;
+		Timing timing;
+	};
+
+	class Queue {
+	public:
+		std::string name;
+		std::atomic<uint64_t> nPushed;
+		std::atomic<uint64_t> nDropped;
+		std::atomic<size_t> maximumDepth;
+
+		Queue() {
+			nPushed.store(0);
+			nDropped.store(0);
+			maximumDepth.store(0);
+		}
+
+		void recordPush(size_t depth) {
+			nPushed.fetch_add(1, std::memory_order_relaxed);
+			size_t maximum = maximumDepth.load(std::memory_order_relaxed);
+			while (depth > maximum && !maximumDepth.compare_exchange_weak(maximum, depth, std::memory_order_relaxed)) {
+			}
+		}
+	};
+
+	class Lane {
+	public:
+		size_t index;
+		CCSDSLockFreeRing<Buffer*>* decodeRing;
+		CCSDSLockFreeRing<Decoded>* reassembleRing;
+		CCSDSLockFreeRing<CCSDSSpacePacket*>* freePackets;
+		std::vector<CCSDSSpacePacket*> packets;
+		std::map<uint16_t, ADUUnsegmenter*> unsegmenters;
+		std::map<uint32_t, Timing> pendingADUTimings; //timing of the first segment, keyed by getADUKey()
+		Queue decodeQueue;
+		Queue reassembleQueue;
+		std::atomic<bool> decodeFinished;
+		int decodeCore;
+		int reassembleCore;
+	};
+
+private:
+	CCSDSPacketSource* source;
+	CCSDSPipelineSink* sink;
+	size_t nLanes;
+	size_t queueCapacity;
+	BackpressurePolicy policy;
+	bool reassemblyEnabled;
+	CCSDSLatencyInstrumentation* instrumentation;
+	uint8_t apidPriorities[NAPIDs];
+	std::vector<Lane*> lanes;
+	std::vector<Buffer*> buffers;
+	CCSDSLockFreeRing<Buffer*>* freeBuffers;
+	CCSDSLockFreeRing<Output>* sinkRing;
+	Queue sinkQueue;
+	std::vector<std::thread> threads;
+	std::atomic<bool> stopRequested;
+	std::atomic<bool> ingestFinished;
+	std::atomic<size_t> nReassembleFinished;
+	int ingestCore;
+	int sinkCore;
+	bool started;
+	std::atomic<uint64_t> nIngestedPackets;
+	std::atomic<uint64_t> nDecodedPackets;
+	std::atomic<uint64_t> nDecodeErrors;
+	std::atomic<uint64_t> nReassemblyErrors;
+	std::atomic<uint64_t> nADUs;
+	std::atomic<uint64_t> nSinkPackets;
+
+public:
+	/** Constructs a pipeline. The source and the sink are not deleted by this class.
+	 * @param[in] source a packet source read by the ingest thread.
+	 * @param[in] sink a sink invoked by the sink thread.
+	 * @param[in] nLanes number of decode/reassemble lanes.
+	 * @param[in] queueCapacity capacity of each queue between stages.
+	 */
+	CCSDSPipeline(CCSDSPacketSource* source, CCSDSPipelineSink* sink, size_t nLanes = 1, size_t queueCapacity =
+			DefaultQueueCapacity) {
+		this->source = source;
+		this->sink = sink;
+		this->nLanes = (nLanes == 0) ? 1 : nLanes;
+		this->policy = Block;
+		this->reassemblyEnabled = true;
+		this->instrumentation = NULL;
+		for (size_t i = 0; i < NAPIDs; i++) {
+			apidPriorities[i] = 0;
+		}
+		sinkRing = new CCSDSLockFreeRing<Output>(queueCapacity);
+		this->queueCapacity = sinkRing->getCapacity();
+		sinkQueue.name = "sink";
+		for (size_t i = 0; i < this->nLanes; i++) {
+			Lane* lane = new Lane;
+			lane->index = i;
+			lane->decodeRing = new CCSDSLockFreeRing<Buffer*>(this->queueCapacity);
+			lane->reassembleRing = new CCSDSLockFreeRing<Decoded>(this->queueCapacity);
+			//packets can be held by the reassemble queue, the sink queue, and one per stage
+			size_t nPackets = 2 * this->queueCapacity + 3;
+			lane->freePackets = new CCSDSLockFreeRing<CCSDSSpacePacket*>(nPackets);
+			for (size_t j = 0; j < nPackets; j++) {
+				lane->packets.push_back(new CCSDSSpacePacket);
+				lane->freePackets->tryPush(lane->packets.back());
+			}
+			std::stringstream ss;
+			ss << i;
+			lane->decodeQueue.name = "decode[" + ss.str() + "]";
+			lane->reassembleQueue.name = "reassemble[" + ss.str() + "]";
+			lane->decodeFinished.store(false);
+			lane->decodeCore = -1;
+			lane->reassembleCore = -1;
+			lanes.push_back(lane);
+		}
+		//buffers can be held by the decode queues, one per decode thread, and the ingest thread
+		size_t nBuffers = this->nLanes * (this->queueCapacity + 1) + 1;
+		freeBuffers = new CCSDSLockFreeRing<Buffer*>(nBuffers);
+		for (size_t i = 0; i < nBuffers; i++) {
+			buffers.push_back(new Buffer);
+			freeBuffers->tryPush(buffers.back());
+		}
+		ingestCore = -1;
+		sinkCore = -1;
+		started = false;
+		stopRequested.store(false);
+		ingestFinished.store(false);
+		nReassembleFinished.store(0);
+		nIngestedPackets.store(0);
+		nDecodedPackets.store(0);
+		nDecodeErrors.store(0);
+		nReassemblyErrors.store(0);
+		nADUs.store(0);
+		nSinkPackets.store(0);
+	}
+
+public:
+	~CCSDSPipeline() {
+		stop();
+		for (size_t i = 0; i < lanes.size(); i++) {
+			for (std::map<uint16_t, ADUUnsegmenter*>::iterator it = lanes[i]->unsegmenters.begin();
+					it != lanes[i]->unsegmenters.end(); it++) {
+				delete it->second;
+			}
+			for (size_t j = 0; j < lanes[i]->packets.size(); j++) {
+				delete lanes[i]->packets[j];
+			}
+			delete lanes[i]->decodeRing;
+			delete lanes[i]->reassembleRing;
+			delete lanes[i]->freePackets;
+			delete lanes[i];
+		}
+		for (size_t i = 0; i < buffers.size(); i++) {
+			delete buffers[i];
+		}
+		delete freeBuffers;
+		delete sinkRing;
+	}
+
+public:
+	/** Sets the backpressure policy applied when a lane queue is full. */
+	void setBackpressurePolicy(BackpressurePolicy policy) {
+		this->policy = policy;
+	}
+
+public:
+	/** Sets the priority of an APID used by DropByAPIDPriority (0 to NPriorityLevels - 1; default 0). */
+	void setAPIDPriority(uint16_t apid, size_t priority) {
+		apidPriorities[apid % NAPIDs] = (priority < NPriorityLevels) ? priority : NPriorityLevels - 1;
+	}
+
+public:
+	/** Enables or disables ADU reassembly (enabled by default).
+	 * When disabled, all packets are passed to CCSDSPipelineSink::onPacket().
+	 */
+	void setReassemblyEnabled(bool reassemblyEnabled) {
+		this->reassemblyEnabled = reassemblyEnabled;
+	}
+
+public:
+	/** Enables per-stage latency histograms and packet tracing. Must be called before start().
+	 * Framing is measured in the ingest stage, from the return of CCSDSPacketSource::next()
+	 * until the packet is validated (Primary Header and packet length) and copied into a
+	 * pipeline buffer; packets that fail the validation are counted as decode errors and not
+	 * measured. The latencies of an ADU are measured from the arrival of its first segment.
+	 * The instrumentation is not deleted by this class.
+	 * @param[in] instrumentation an instance, or NULL to disable.
+	 */
+	void setLatencyInstrumentation(CCSDSLatencyInstrumentation* instrumentation) {
+		this->instrumentation = instrumentation;
+	}
+
+public:
+	/** Pins the thread of a stage to a core. Must be called before start().
+	 * @param[in] stage a stage.
+	 * @param[in] lane lane index (ignored for Ingest and Sink).
+	 * @param[in] core a core index.
+	 */
+	void setCoreAffinity(Stage stage, size_t lane, int core) {
+		switch (stage) {
+		case Ingest:
+			ingestCore = core;
+			break;
+		case Decode:
+			lanes.at(lane)->decodeCore = core;
+			break;
+		case Reassemble:
+			lanes.at(lane)->reassembleCore = core;
+			break;
+		case Sink:
+			sinkCore = core;
+			break;
+		}
+	}
+
+public:
+	/** Starts the stage threads. */
+	void start() {
+		if (started) {
+			throw CCSDSPipelineException("CCSDSPipeline: already started");
+		}
+		started = true;
+		threads.push_back(std::thread(&CCSDSPipeline::runSink, this));
+		for (size_t i = 0; i < nLanes; i++) {
+			threads.push_back(std::thread(&CCSDSPipeline::runReassemble, this, lanes[i]));
+			threads.push_back(std::thread(&CCSDSPipeline::runDecode, this, lanes[i]));
+		}
+		threads.push_back(std::thread(&CCSDSPipeline::runIngest, this));
+	}
+
+public:
+	/** Waits until the source ends and all queued packets are processed. */
+	void join() {
+		for (size_t i = 0; i < threads.size(); i++) {
+			threads[i].join();
+		}
+		threads.clear();
+	}
+
+public:
+	/** Stops reading the source, then waits until queued packets are processed.
+	 * The source is checked between packets, so a blocking source should use a timeout.
+	 */
+	void stop() {
+		stopRequested.store(true);
+		join();
+	}
+
+public:
+	/** Returns statistics of all queues. */
+	std::vector<CCSDSPipelineQueueStatistics> getQueueStatistics() {
+		std::vector<CCSDSPipelineQueueStatistics> result;
+		for (size_t i = 0; i < nLanes; i++) {
+			result.push_back(getQueueStatistics(lanes[i]->decodeQueue, lanes[i]->decodeRing->size()));
+			result.push_back(getQueueStatistics(lanes[i]->reassembleQueue, lanes[i]->reassembleRing->size()));
+		}
+		result.push_back(getQueueStatistics(sinkQueue, sinkRing->size()));
+		return result;
+	}
+
+private:
+	CCSDSPipelineQueueStatistics getQueueStatistics(Queue& queue, size_t depth) {
+		CCSDSPipelineQueueStatistics statistics;
+		statistics.name = queue.name;
+		statistics.depth = depth;
+		statistics.maximumDepth = queue.maximumDepth.load();
+		statistics.capacity = queueCapacity;
+		statistics.nPushed = queue.nPushed.load();
+		statistics.nDropped = queue.nDropped.load();
+		return statistics;
+	}
+
+public:
+	/** Returns the number of packets read from the source. */
+	uint64_t getNumberOfIngestedPackets() const {
+		return nIngestedPackets.load();
+	}
+
+public:
+	/** Returns the number of packets interpreted successfully. */
+	uint64_t getNumberOfDecodedPackets() const {
+		return nDecodedPackets.load();
+	}
+
+public:
+	/** Returns the number of packets rejected by the ingest validation or CCSDSSpacePacket::interpret(). */
+	uint64_t getNumberOfDecodeErrors() const {
+		return nDecodeErrors.load();
+	}
+
+public:
+	/** Returns the number of packets rejected by ADUUnsegmenter. */
+	uint64_t getNumberOfReassemblyErrors() const {
+		return nReassemblyErrors.load();
+	}
+
+public:
+	/** Returns the number of ADUs passed to the sink. */
+	uint64_t getNumberOfADUs() const {
+		return nADUs.load();
+	}
+
+public:
+	/** Returns the number of packets passed to the sink. */
+	uint64_t getNumberOfSinkPackets() const {
+		return nSinkPackets.load();
+	}
+
+public:
+	/** Returns the number of packets dropped by the backpressure policy. */
+	uint64_t getNumberOfDroppedPackets() const {
+		uint64_t nDropped = 0;
+		for (size_t i = 0; i < nLanes; i++) {
+			nDropped += lanes[i]->decodeQueue.nDropped.load();
+		}
+		return nDropped;
+	}
+
+private:
+	static inline void backoff(size_t& nTrials) {
+		nTrials++;
+		if (nTrials > 16) {
+			std::this_thread::yield();
+		}
+	}
+
+private:
+	/** Checks that a packet has a complete Primary Header and is not shorter than its Packet Data Length. */
+	static inline bool isFramed(const CCSDSSpacePacketView& view) {
+		return view.length >= CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength
+				&& view.length >= view.getTotalPacketLength();
+	}
+
+private:
+	void runIngest() {
+		CCSDSThreadAffinity::pinCurrentThread(ingestCore);
+		CCSDSSpacePacketView view;
+		while (!stopRequested.load(std::memory_order_relaxed) && source->next(view)) {
+			uint64_t ingestTime = (instrumentation != NULL) ? CCSDSLatencyInstrumentation::now() : 0;
+			nIngestedPackets.fetch_add(1, std::memory_order_relaxed);
+			if (!isFramed(view)) {
+				nDecodeErrors.fetch_add(1, std::memory_order_relaxed);
+				continue;
+			}
+			Buffer* buffer;
+			size_t nTrials = 0;
+			while (!freeBuffers->tryPop(buffer)) {
+				backoff(nTrials);
+			}
+			buffer->data.assign(view.data, view.data + view.length);
+			buffer->length = view.length;
+			buffer->apid = view.getAPIDAsInteger();
+			buffer->timing = Timing();
+			if (instrumentation != NULL) {
+				buffer->timing.ingestTime = ingestTime;
+				buffer->timing.framedTime = instrumentation->recordSince(CCSDSLatencyInstrumentation::Framing,
+						ingestTime);
+				buffer->timing.traced = instrumentation->shouldSample();
+			}
+			enqueue(lanes[(buffer->apid & 0xFF) % nLanes], buffer);
+		}
+		ingestFinished.store(true, std::memory_order_release);
+	}
+
+private:
+	void enqueue(Lane* lane, Buffer* buffer) {
+		size_t nTrials = 0;
+		if (policy == DropByAPIDPriority) {
+			size_t priority = apidPriorities[buffer->apid % NAPIDs];
+			if (priority + 1 < NPriorityLevels
+					&& lane->decodeRing->size() >= lane->decodeRing->getCapacity() * (priority + 1) / NPriorityLevels) {
+				lane->decodeQueue.nDropped.fetch_add(1, std::memory_order_relaxed);
+				freeBuffers->tryPush(buffer);
+				return;
+			}
+		}
+		while (!lane->decodeRing->tryPush(buffer)) {
+			if (policy == DropOldest) {
+				Buffer* oldest;
+				if (lane->decodeRing->tryPop(oldest)) {
+					lane->decodeQueue.nDropped.fetch_add(1, std::memory_order_relaxed);
+					freeBuffers->tryPush(oldest);
+				}
+			} else {
+				backoff(nTrials);
+			}
+		}
+		lane->decodeQueue.recordPush(lane->decodeRing->size());
+	}
+
+private:
+	void runDecode(Lane* lane) {
+		CCSDSThreadAffinity::pinCurrentThread(lane->decodeCore);
+		while (true) {
+			bool finished = ingestFinished.load(std::memory_order_acquire);
+			Buffer* buffer;
+			if (!lane->decodeRing->tryPop(buffer)) {
+				if (finished) {
+					break;
+				}
+				std::this_thread::yield();
+				continue;
+			}
+			CCSDSSpacePacket* packet;
+			size_t nTrials = 0;
+			while (!lane->freePackets->tryPop(packet)) {
+				backoff(nTrials);
+			}
+			bool decoded = true;
+			try {
+				packet->interpret(&buffer->data[0], buffer->length);
+			} catch (...) {
+				decoded = false;
+			}
+			Decoded item;
+			item.packet = packet;
+			item.timing = buffer->timing;
+			freeBuffers->tryPush(buffer);
+			if (!decoded) {
+				nDecodeErrors.fetch_add(1, std::memory_order_relaxed);
+				lane->freePackets->tryPush(packet);
+				continue;
+			}
+			nDecodedPackets.fetch_add(1, std::memory_order_relaxed);
+			if (instrumentation != NULL) {
+				item.timing.decodedTime = instrumentation->recordSince(CCSDSLatencyInstrumentation::Decode,
+						item.timing.framedTime);
+			}
+			nTrials = 0;
+			while (!lane->reassembleRing->tryPush(item)) {
+				backoff(nTrials);
+			}
+			lane->reassembleQueue.recordPush(lane->reassembleRing->size());
+		}
+		lane->decodeFinished.store(true, std::memory_order_release);
+	}
+
+private:
+	void runReassemble(Lane* lane) {
+		CCSDSThreadAffinity::pinCurrentThread(lane->reassembleCore);
+		while (true) {
+			bool finished = lane->decodeFinished.load(std::memory_order_acquire);
+			Decoded item;
+			if (!lane->reassembleRing->tryPop(item)) {
+				if (finished) {
+					break;
+				}
+				std::this_thread::yield();
+				continue;
+			}
+			CCSDSSpacePacket* packet = item.packet;
+			Output output;
+			output.lane = lane->index;
+			output.timing = item.timing;
+			if (!reassemblyEnabled
+					|| packet->getPrimaryHeader()->getSecondaryHeaderFlag().to_ulong()
+							== CCSDSSpacePacketSecondaryHeaderFlag::NotPresent
+					|| !packet->getSecondaryHeader()->isADUChannelUsed()) {
+				output.adu = NULL;
+				output.packet = packet;
+				pushToSink(output);
+				continue;
+			}
+			uint16_t lowerAPID = packet->getPrimaryHeader()->getAPIDAsInteger() & 0xFF;
+			if (instrumentation != NULL) {
+				recordSegmentTiming(lane, packet, output.timing);
+			}
+			ADUUnsegmenter* unsegmenter = getUnsegmenter(lane, lowerAPID);
+			try {
+				unsegmenter->push(packet);
+			} catch (...) {
+				nReassemblyErrors.fetch_add(1, std::memory_order_relaxed);
+			}
+			lane->freePackets->tryPush(packet);
+			while (unsegmenter->hasCompleteADU()) {
+				output.adu = unsegmenter->popCompletedADU();
+				output.packet = NULL;
+				if (instrumentation != NULL) {
+					std::map<uint32_t, Timing>::iterator it = lane->pendingADUTimings.find(
+							getADUKey(output.adu->lowerAPID, output.adu->ADUChannelID));
+					if (it != lane->pendingADUTimings.end()) {
+						output.timing = it->second;
+						lane->pendingADUTimings.erase(it);
+					}
+				}
+				pushToSink(output);
+			}
+		}
+		nReassembleFinished.fetch_add(1, std::memory_order_release);
+	}
+
+private:
+	static inline uint32_t getADUKey(uint16_t lowerAPID, uint16_t aduChannelID) {
+		return ((uint32_t) lowerAPID << 16) | aduChannelID;
+	}
+
+private:
+	/** Keeps the timing of the first segment of an ADU; a traced segment marks the whole ADU as traced. */
+	void recordSegmentTiming(Lane* lane, CCSDSSpacePacket* packet, const Timing& timing) {
+		uint32_t key = getADUKey(packet->getPrimaryHeader()->getAPIDAsInteger() & 0xFF,
+				packet->getSecondaryHeader()->getADUChannelID());
+		unsigned long segmentFlag = packet->getSecondaryHeader()->getADUSegmentFlag().to_ulong();
+		std::map<uint32_t, Timing>::iterator it = lane->pendingADUTimings.find(key);
+		if (it == lane->pendingADUTimings.end() || segmentFlag == CCSDSSpacePacketADUSegmentFlag::TheFirstSegment
+				|| segmentFlag == CCSDSSpacePacketADUSegmentFlag::UnsegmentedADU) {
+			//a new ADU starts (a pending one, if any, was abandoned)
+			lane->pendingADUTimings[key] = timing;
+		} else if (timing.traced) {
+			it->second.traced = true;
+		}
+	}
+
+private:
+	ADUUnsegmenter* getUnsegmenter(Lane* lane, uint16_t lowerAPID) {
+		std::map<uint16_t, ADUUnsegmenter*>::iterator it = lane->unsegmenters.find(lowerAPID);
+		if (it != lane->unsegmenters.end()) {
+			return it->second;
+		}
+		ADUUnsegmenter* unsegmenter = new ADUUnsegmenter(lowerAPID);
+		lane->unsegmenters[lowerAPID] = unsegmenter;
+		return unsegmenter;
+	}
+
+private:
+	void pushToSink(Output& output) {
+		if (instrumentation != NULL) {
+			output.timing.reassembledTime = instrumentation->recordSince(CCSDSLatencyInstrumentation::Reassembly,
+					output.timing.decodedTime);
+		}
+		size_t nTrials = 0;
+		while (!sinkRing->tryPush(output)) {
+			backoff(nTrials);
+		}
+		sinkQueue.recordPush(sinkRing->size());
+	}
+
+private:
+	void runSink() {
+		CCSDSThreadAffinity::pinCurrentThread(sinkCore);
+		while (true) {
+			bool finished = (nReassembleFinished.load(std::memory_order_acquire) == nLanes);
+			Output output;
+			if (!sinkRing->tryPop(output)) {
+				if (finished) {
+					break;
+				}
+				std::this_thread::yield();
+				continue;
+			}
+			if (output.adu != NULL) {
+				nADUs.fetch_add(1, std::memory_order_relaxed);
+				sink->onADU(*output.adu);
+			} else {
+				nSinkPackets.fetch_add(1, std::memory_order_relaxed);
+				sink->onPacket(*output.packet);
+			}
+			if (instrumentation != NULL) {
+				recordDelivery(output);
+			}
+			if (output.adu != NULL) {
+				delete output.adu;
+			} else {
+				lanes[output.lane]->freePackets->tryPush(output.packet);
+			}
+		}
+	}
+
+private:
+	void recordDelivery(const Output& output) {
+		const Timing& timing = output.timing;
+		uint64_t deliveredTime = instrumentation->recordSince(CCSDSLatencyInstrumentation::Sink, timing.reassembledTime);
+		instrumentation->record(CCSDSLatencyInstrumentation::EndToEnd, deliveredTime - timing.ingestTime);
+		if (timing.traced) {
+			CCSDSPacketTrace trace;
+			if (output.adu != NULL) {
+				trace.apid = (output.adu->upperAPID << 8) | output.adu->lowerAPID;
+				trace.sequenceCount = output.adu->ADUCount;
+			} else {
+				trace.apid = output.packet->getPrimaryHeader()->getAPIDAsInteger();
+				trace.sequenceCount = output.packet->getPrimaryHeader()->getSequenceCount().to_ulong();
+			}
+			trace.ingestTime = timing.ingestTime;
+			trace.framedTime = timing.framedTime;
+			trace.decodedTime = timing.decodedTime;
+			trace.reassembledTime = timing.reassembledTime;
+			trace.deliveredTime = deliveredTime;
+			instrumentation->recordTrace(trace);
+		}
+	}
+};
+
+#endif /* CCSDSPIPELINE_HH_ */
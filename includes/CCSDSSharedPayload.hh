@@ -0,0 +1,122 @@
+/*
+ * CCSDSSharedPayload.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSSHAREDPAYLOAD_HH_
+#define CCSDSSHAREDPAYLOAD_HH_
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#if (defined(__GXX_EXPERIMENTAL_CXX0X) || (__cplusplus >= 201103L))
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+/** An immutable, reference-counted byte buffer.
+ * Copying an instance only increments a reference count, so one payload (e.g. the
+ * data of a completed ADU) can be handed to several consumers without copying the
+ * bytes. A payload is built by moving a vector in, and its bytes cannot be modified
+ * afterwards, so instances can be shared between threads.
+ *
+ * @par
+ * Example:
+ * @code
+ ADU* adu = unsegmenter.popCompletedADU();
+ CCSDSSharedPayload payload = adu->sharePayload(); //moves adu->data, no copy
+ archiver.push(payload);
+ display.push(payload);
+ * @endcode
+ */
+class CCSDSSharedPayload {
+private:
+	std::shared_ptr<const std::vector<uint8_t> > buffer;
+
+public:
+	/** Constructs an empty payload. */
+	CCSDSSharedPayload() {
+	}
+
+public:
+	/** Constructs a payload by taking over a vector (no copy). */
+	explicit CCSDSSharedPayload(std::vector<uint8_t>&& data) {
+		if (!data.empty()) {
+			buffer = std::make_shared<const std::vector<uint8_t> >(std::move(data));
+		}
+	}
+
+public:
+	/** Constructs a payload by copying bytes. */
+	CCSDSSharedPayload(const uint8_t* data, size_t length) {
+		if (length != 0) {
+			buffer = std::make_shared<const std::vector<uint8_t> >(data, data + length);
+		}
+	}
+
+public:
+	/** Returns a payload holding a copy of a vector. */
+	static CCSDSSharedPayload copyOf(const std::vector<uint8_t>& data) {
+		return CCSDSSharedPayload(data.empty() ? NULL : &data[0], data.size());
+	}
+
+public:
+	inline const uint8_t* data() const {
+		return buffer ? &(*buffer)[0] : NULL;
+	}
+
+public:
+	inline size_t size() const {
+		return buffer ? buffer->size() : 0;
+	}
+
+public:
+	inline bool empty() const {
+		return !buffer;
+	}
+
+public:
+	inline uint8_t operator[](size_t index) const {
+		return (*buffer)[index];
+	}
+
+public:
+	inline const uint8_t* begin() const {
+		return data();
+	}
+
+public:
+	inline const uint8_t* end() const {
+		return data() + size();
+	}
+
+public:
+	/** Returns a copy of the bytes as a mutable vector. */
+	std::vector<uint8_t> toVector() const {
+		return buffer ? *buffer : std::vector<uint8_t>();
+	}
+
+public:
+	/** Returns the number of instances sharing the bytes (0 if empty). */
+	long getUseCount() const {
+		return buffer.use_count();
+	}
+
+public:
+	/** True if both instances share the same bytes. */
+	bool isSharedWith(const CCSDSSharedPayload& other) const {
+		return buffer && buffer == other.buffer;
+	}
+
+public:
+	/** Releases the reference (the bytes are freed when the last instance releases them). */
+	void reset() {
+		buffer.reset();
+	}
+};
+
+#endif /* CCSDSSHAREDPAYLOAD_HH_ */
@@ -11,6 +11,9 @@
 #include "CCSDSSpacePacketPrimaryHeader.hh"
 #include "CCSDSSpacePacketSecondaryHeader.hh"
 #include "CCSDSSpacePacketException.hh"
+#include "CCSDSMetrics.hh"
+#include "CCSDSFormatBuffer.hh"
+#include "CCSDSCRC16.hh"
 #include <vector>
 #include <iomanip>
 #include <sstream>
@@ -182,26 +185,42 @@
  std::cout << ccsdsPacket->toString() << std::endl;
  * @endcode
  *
+ * The class is a template over the Secondary Header class (the secondary-header policy),
+ * so that the size and parsing of the Secondary Header are resolved at compile time.
+ * CCSDSSpacePacket is derived from the instantiation with CCSDSSpacePacketSecondaryHeader
+ * (JAXA/ISAS layout, ADU Channel presence decided per packet). Other policies are provided in
+ * CCSDSSpacePacketSecondaryHeaderPolicies.hh. A policy class provides getLength(),
+ * interpret(data, length), getAsByteVector(), format(buffer), and formatCompact(buffer).
+ *
  * @see CCSDSSpacePacketPrimaryHeader, CCSDSSpacePacketSecondaryHeader
  */
-class CCSDSSpacePacket {
+template<class SecondaryHeaderPolicy>
+class CCSDSSpacePacketT {
 public:
 	static const uint32_t APIDOfIdlePacket = 0x7FF; //111 1111 1111
+	static const size_t PacketErrorControlLength = 2;
+
+public:
+	typedef SecondaryHeaderPolicy SecondaryHeaderType;
 
 public:
 	CCSDSSpacePacketPrimaryHeader* primaryHeader;
-	CCSDSSpacePacketSecondaryHeader* secondaryHeader;
+	SecondaryHeaderPolicy* secondaryHeader;
 	std::vector<uint8_t>* userDataField;
 
+private:
+	bool packetErrorControlUsed;
+
 public:
 	/** Constructs an instance.
 	 * Internal instances of the primary header, the secondary header,
 	 * and the user data field are constructed.
 	 */
-	CCSDSSpacePacket() {
+	CCSDSSpacePacketT() {
 		primaryHeader = new CCSDSSpacePacketPrimaryHeader();
-		secondaryHeader = new CCSDSSpacePacketSecondaryHeader();
+		secondaryHeader = new SecondaryHeaderPolicy();
 		userDataField = new std::vector<uint8_t>();
+		packetErrorControlUsed = false;
 		//primaryHeader->setPacketVersionNum(CCSDSSpacePacketPacketVersionNumber::Version1);
 	}
 
@@ -210,7 +229,7 @@ public:
 	 * Internal instances of the primary header, the secondary header,
 	 * and the user data field are deleted.
 	 */
-	virtual ~CCSDSSpacePacket() {
+	virtual ~CCSDSSpacePacketT() {
 		delete primaryHeader;
 		delete secondaryHeader;
 		delete userDataField;
@@ -219,26 +238,28 @@ public:
 public:
 	/** Copy constructor.
 	 */
-	CCSDSSpacePacket(const CCSDSSpacePacket& obj) {
+	CCSDSSpacePacketT(const CCSDSSpacePacketT& obj) {
 		using namespace std;
 		this->primaryHeader = new CCSDSSpacePacketPrimaryHeader();
-		this->secondaryHeader = new CCSDSSpacePacketSecondaryHeader();
+		this->secondaryHeader = new SecondaryHeaderPolicy();
 		this->userDataField = new std::vector<uint8_t>();
 
 		*this->primaryHeader = *(obj.primaryHeader);
 		*this->secondaryHeader = *(obj.secondaryHeader);
 		*this->userDataField = *(obj.userDataField);
+		this->packetErrorControlUsed = obj.packetErrorControlUsed;
 	}
 
 public:
 	/** Constructs and returns a new instance that has the same information as the current instance.
 	 * @return a pointer of the newly created instance
 	 */
-	CCSDSSpacePacket* clone(){
-		CCSDSSpacePacket* result=new CCSDSSpacePacket;
+	CCSDSSpacePacketT* clone(){
+		CCSDSSpacePacketT* result=new CCSDSSpacePacketT;
 		*(result->primaryHeader) = *(this->primaryHeader);
 		*(result->secondaryHeader) = *(this->secondaryHeader);
 		*(result->userDataField) = *(this->userDataField);
+		result->packetErrorControlUsed = this->packetErrorControlUsed;
 		return result;
 }
 
@@ -246,6 +267,7 @@ public:
 	/** Returns packet content as a vector of uint8_t.
 	 * Packet content will be dynamically generated every time
 	 * when this method is invoked.
+	 * If Packet Error Control is used, a CRC-16 of the packet is appended.
 	 * @return a uint8_t vector that contains packet content
 	 */
 	std::vector<uint8_t> getAsByteVector() {
@@ -258,6 +280,11 @@ public:
 			result.insert(result.end(), secondaryHeaderVector.begin(), secondaryHeaderVector.end());
 		}
 		result.insert(result.end(), userDataField->begin(), userDataField->end());
+		if (packetErrorControlUsed) {
+			uint16_t crc = CCSDSCRC16::calculate(&result[0], result.size());
+			result.push_back(crc >> 8);
+			result.push_back(crc & 0xFF);
+		}
 		return result;
 	}
 
@@ -265,13 +292,17 @@ public:
 	/** Interprets a uint8_t array into this instance.
 	 * When the array does not contain a valid CCSDS SpacePacket, an exception may
 	 * be thrown.
+	 * If Packet Error Control is used, the CRC-16 at the end of the packet is verified
+	 * (CCSDSSpacePacketException::PacketErrorControlMismatch is thrown on mismatch)
+	 * and excluded from the User Data Field.
 	 * @param[in] buffer a pointer to a uint8_t array that contains a CCSDS SpacePacket.
 	 * @param[in] length the length of the data contained in buffer.
 	 */
-	void interpret(const uint8_t *buffer, size_t length) throw (CCSDSSpacePacketException) {
+	void interpret(const uint8_t *buffer, size_t length) CCSDS_THROWS(CCSDSSpacePacketException) {
 		using namespace std;
 
 		if (length < 6) {
+			CCSDS_METRICS_ADD(NotACCSDSSpacePacketExceptions, 1);
 			throw CCSDSSpacePacketException(CCSDSSpacePacketException::NotACCSDSSpacePacket);
 		}
 		//primary header
@@ -280,27 +311,43 @@ public:
 		size_t totalPacketLength = packetDataLengthCorrected1 + CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength;
 
 		if (length < totalPacketLength) {
+			CCSDS_METRICS_ADD(InconsistentPacketLengthExceptions, 1);
 			throw CCSDSSpacePacketException(CCSDSSpacePacketException::InconsistentPacketLength);
 		}
 
+		size_t userDataFieldEnd = totalPacketLength;
+		if (packetErrorControlUsed) {
+			if (!CCSDSCRC16::verify(buffer, totalPacketLength)) {
+				CCSDS_METRICS_ADD(PacketErrorControlMismatchExceptions, 1);
+				throw CCSDSSpacePacketException(CCSDSSpacePacketException::PacketErrorControlMismatch);
+			}
+			userDataFieldEnd -= PacketErrorControlLength;
+		}
+
 		if (primaryHeader->getSecondaryHeaderFlag().to_ulong() == CCSDSSpacePacketSecondaryHeaderFlag::NotPresent) {
 			//buffer field
 			userDataField->clear();
-			for (size_t i = CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength; i < totalPacketLength; i++) {
+			for (size_t i = CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength; i < userDataFieldEnd; i++) {
 				userDataField->push_back(buffer[i]);
 			}
 		} else {
 			//secondary header
-			secondaryHeader->interpret(buffer + CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength, //
-			length - CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength);
+			try {
+				secondaryHeader->interpret(buffer + CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength, //
+				length - CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength);
+			} catch (CCSDSSpacePacketException&) {
+				CCSDS_METRICS_ADD(SecondaryHeaderTooShortExceptions, 1);
+				throw;
+			}
 			//buffer field
 			userDataField->clear();
 			for (size_t i = CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength + secondaryHeader->getLength();
-					i < totalPacketLength; i++) {
+					i < userDataFieldEnd; i++) {
 				userDataField->push_back(buffer[i]);
 			}
 		}
-
+		CCSDS_METRICS_ADD(DecodedPackets, 1);
+		CCSDS_METRICS_ADD(DecodedBytes, totalPacketLength);
 	}
 
 public:
@@ -325,13 +372,32 @@ public:
 
 private:
 	void calcPacketDataLength() {
+		size_t packetErrorControlLength = packetErrorControlUsed ? PacketErrorControlLength : 0;
 		if (primaryHeader->getSecondaryHeaderFlag().to_ulong() == CCSDSSpacePacketSecondaryHeaderFlag::Present) {
-			primaryHeader->setPacketDataLength(secondaryHeader->getAsByteVector().size() + userDataField->size() - 1);
+			primaryHeader->setPacketDataLength(
+					secondaryHeader->getLength() + userDataField->size() + packetErrorControlLength - 1);
 		} else {
-			primaryHeader->setPacketDataLength(userDataField->size() - 1);
+			primaryHeader->setPacketDataLength(userDataField->size() + packetErrorControlLength - 1);
 		}
 	}
 
+public:
+	/** Sets whether the optional Packet Error Control field (CRC-16) is used.
+	 * When used, getAsByteVector() appends the CRC and interpret() verifies it.
+	 * Packet Data Length is updated accordingly.
+	 * @param[in] packetErrorControlUsed true if Packet Error Control is used.
+	 */
+	void setPacketErrorControlUsed(bool packetErrorControlUsed) {
+		this->packetErrorControlUsed = packetErrorControlUsed;
+		calcPacketDataLength();
+	}
+
+public:
+	/** True if the Packet Error Control field is used. */
+	bool isPacketErrorControlUsed() const {
+		return packetErrorControlUsed;
+	}
+
 public:
 	/** Fill Packet Data Length field with an appropriate number
 	 * which is automatically calculated by this class.
@@ -361,31 +427,62 @@ public:
 	 * @returns string dump of this packet.
 	 */
 	virtual std::string toString() {
+		CCSDSFormatBuffer buffer(2048);
+		format(buffer);
+		return buffer.str();
+	}
+
+public:
+	/** Appends a multi-line dump of this packet (the toString() format) to a buffer.
+	 * The buffer can be reused across packets to avoid allocation.
+	 * @param[in] buffer a buffer to which the dump is appended.
+	 */
+	virtual void format(CCSDSFormatBuffer& buffer) {
 		const size_t maxBytesToBeDumped = 32;
-		std::stringstream ss;
-		using std::endl;
-		ss << "---------------------------------" << endl;
-		ss << "CCSDSSpacePacket" << endl;
-		ss << "---------------------------------" << endl;
-		ss << primaryHeader->toString();
+		buffer.append("---------------------------------\n");
+		buffer.append("CCSDSSpacePacket\n");
+		buffer.append("---------------------------------\n");
+		primaryHeader->format(buffer);
 		if (primaryHeader->getSecondaryHeaderFlag().to_ulong() == CCSDSSpacePacketSecondaryHeaderFlag::Present) {
-			ss << secondaryHeader->toString();
+			secondaryHeader->format(buffer);
 		} else {
-			ss << "No secondary header" << endl;
+			buffer.append("No secondary header\n");
 		}
 		if (userDataField->size() != 0) {
-			ss << "User data field has " << std::dec << userDataField->size();
+			buffer.append("User data field has ").appendDecimal(userDataField->size());
 			if (userDataField->size() < 2) {
-				ss << " byte" << endl;
+				buffer.append(" byte\n");
 			} else {
-				ss << " bytes" << endl;
+				buffer.append(" bytes\n");
 			}
-			ss << arrayToString(userDataField, "hex", maxBytesToBeDumped) << endl;
+			buffer.appendArray(&((*userDataField)[0]), userDataField->size(), CCSDSFormatBuffer::Hexadecimal,
+					maxBytesToBeDumped);
+			buffer.appendChar('\n');
 		} else {
-			ss << "No user data field" << endl;
+			buffer.append("No user data field\n");
+		}
+		buffer.appendChar('\n');
+	}
+
+public:
+	/** Appends a one-line summary of this packet to a buffer.
+	 * @param[in] buffer a buffer to which the summary is appended.
+	 * @param[in] maxBytesToBeDumped number of User Data Field bytes to be shown.
+	 */
+	virtual void formatCompact(CCSDSFormatBuffer& buffer, size_t maxBytesToBeDumped = 8) {
+		primaryHeader->formatCompact(buffer);
+		if (primaryHeader->getSecondaryHeaderFlag().to_ulong() == CCSDSSpacePacketSecondaryHeaderFlag::Present) {
+			buffer.appendChar(' ');
+			secondaryHeader->formatCompact(buffer);
 		}
-		ss << endl;
-		return ss.str();
+		buffer.append(" UserData=").appendDecimal(userDataField->size()).append("B");
+		if (userDataField->size() != 0 && maxBytesToBeDumped != 0) {
+			buffer.append(" [");
+			buffer.appendArray(&((*userDataField)[0]), userDataField->size(), CCSDSFormatBuffer::Hexadecimal,
+					maxBytesToBeDumped);
+			buffer.appendChar(']');
+		}
+		buffer.appendChar('\n');
 	}
 
 public:
@@ -414,40 +511,23 @@ public:
 public:
 	/** A utility method which converts std::vector<uint8_t> to
 	 * std::string.
+	 * @param[in] mode "dec", "hex", or otherwise raw characters.
 	 */
 	static std::string arrayToString(std::vector<uint8_t> *data, std::string mode = "dec", size_t maxBytesToBeDumped = 8) {
-		//copied from CxxUtilities::Array
-		using namespace std;
-
-		stringstream ss;
-		size_t maxSize;
-		if (data->size() < maxBytesToBeDumped) {
-			maxSize = data->size();
+		int formatMode;
+		if (mode == "dec") {
+			formatMode = CCSDSFormatBuffer::Decimal;
+		} else if (mode == "hex") {
+			formatMode = CCSDSFormatBuffer::Hexadecimal;
 		} else {
-			maxSize = maxBytesToBeDumped;
+			formatMode = CCSDSFormatBuffer::Character;
 		}
-		for (size_t i = 0; i < maxSize; i++) {
-			if (mode == "dec") {
-				ss << dec << left << (uint32_t) (data->at(i));
-			} else if (mode == "hex") {
-				ss << hex << "0x" << setw(2) << setfill('0') << right << (uint32_t) (data->at(i));
-			} else {
-				ss << data->at(i);
-			}
-			if (i != maxSize - 1) {
-				ss << " ";
-			}
+		size_t maxSize = (data->size() < maxBytesToBeDumped) ? data->size() : maxBytesToBeDumped;
+		CCSDSFormatBuffer buffer(maxSize * 5 + 40);
+		if (data->size() != 0) {
+			buffer.appendArray(&((*data)[0]), data->size(), formatMode, maxBytesToBeDumped);
 		}
-		ss << dec;
-		if (maxSize < data->size()) {
-			ss << " ... (total size = " << dec << data->size();
-			if (data->size() == 1) {
-				ss << " entry)";
-			} else {
-				ss << " entries)";
-			}
-		}
-		return ss.str();
+		return buffer.str();
 	}
 
 public:
@@ -487,7 +567,7 @@ public:
 	/** Returns a Secondary Header instance.
 	 * @returns a pointer to the Secondary Header of this packet.
 	 */
-	inline CCSDSSpacePacketSecondaryHeader* getSecondaryHeader() const {
+	inline SecondaryHeaderPolicy* getSecondaryHeader() const {
 		return secondaryHeader;
 	}
 
@@ -550,4 +630,37 @@ public:
 
 };
 
+template<class SecondaryHeaderPolicy>
+const uint32_t CCSDSSpacePacketT<SecondaryHeaderPolicy>::APIDOfIdlePacket;
+
+template<class SecondaryHeaderPolicy>
+const size_t CCSDSSpacePacketT<SecondaryHeaderPolicy>::PacketErrorControlLength;
+
+/** CCSDS SpacePacket with the JAXA/ISAS Secondary Header (ADU Channel presence decided per packet).
+ * This is a class rather than a typedef of CCSDSSpacePacketT so that existing
+ * forward declarations (class CCSDSSpacePacket;) keep compiling.
+ */
+class CCSDSSpacePacket: public CCSDSSpacePacketT<CCSDSSpacePacketSecondaryHeader> {
+public:
+	/** Constructs an instance.
+	 */
+	CCSDSSpacePacket() {
+	}
+
+public:
+	/** Copy constructor.
+	 */
+	CCSDSSpacePacket(const CCSDSSpacePacket& obj) :
+			CCSDSSpacePacketT<CCSDSSpacePacketSecondaryHeader>(obj) {
+	}
+
+public:
+	/** Constructs and returns a new instance that has the same information as the current instance.
+	 * @return a pointer of the newly created instance
+	 */
+	CCSDSSpacePacket* clone() {
+		return new CCSDSSpacePacket(*this);
+	}
+};
+
 #endif /* CCSDSSPACEPACKET_HH_ */
@@ -14,6 +14,16 @@
 #include <stdint.h>
 #endif
 
+/** Declares exceptions thrown by a method.
+ * Dynamic exception specifications were removed in C++17, so the macro expands
+ * to nothing there (allowing the library to be used with C++17/20 features).
+ */
+#if (__cplusplus >= 201703L)
+#define CCSDS_THROWS(...)
+#else
+#define CCSDS_THROWS(...) throw (__VA_ARGS__)
+#endif
+
 /** An exception class used by the CCSDSSpacePacket class.
  */
 class CCSDSSpacePacketException {
@@ -21,7 +31,8 @@ public:
 	enum {
 		NotACCSDSSpacePacket = 0x01, //
 		SecondaryHeaderTooShort = 0x10,
-		InconsistentPacketLength
+		InconsistentPacketLength,
+		PacketErrorControlMismatch
 	};
 public:
 	uint32_t status;
@@ -65,6 +76,9 @@ public:
 		case InconsistentPacketLength:
 			result = "InconsistentPacketLength";
 			break;
+		case PacketErrorControlMismatch:
+			result = "PacketErrorControlMismatch";
+			break;
 		default:
 			result = "Undefined status";
 			break;
@@ -14,6 +14,8 @@
 #include <iomanip>
 #include <iostream>
 
+#include "CCSDSFormatBuffer.hh"
+
 #if (defined(__GXX_EXPERIMENTAL_CXX0X) || (__cplusplus >= 201103L))
 #include <cstdint>
 #else
@@ -391,33 +393,44 @@ public:
 	 * @returns string dump of this instance.
 	 */
 	virtual std::string toString() {
-		using namespace std;
-		std::stringstream ss;
-		ss << "PrimaryHeader" << endl;
-		ss << "PacketVersionNum    : " << packetVersionNum.to_string() << endl;
-		ss << "PacketType          : " << packetType.to_string() << endl;
-		ss << "SecondaryHeaderFlag : " << secondaryHeaderFlag.to_string() << endl;
-		ss << "APID                : " << apid.to_ulong();
-		ss << " (0x" << hex << setw(2) << setfill('0') << right << apid.to_ulong() << ")" << left << endl;
-		ss << "SequenceFlag        : " << sequenceFlag.to_string();
-		switch (sequenceFlag.to_ulong()) {
-		case 0:
-			ss << " (Continuation segment of user data)" << endl;
-			break;
-		case 1:
-			ss << " (First segment of user data)" << endl;
-			break;
-		case 2:
-			ss << " (Last segment of user data)" << endl;
-			break;
-		case 3:
-			ss << " (Unsegmented user data)" << endl;
-			break;
-		}
-		ss << "SequenceCount       : " << sequenceCount.to_ulong() << endl;
-		ss << "PacketDataLength    : " << dec << packetDataLength.to_ulong() << " (0x" << hex << right << setw(4) << setfill('0')  << packetDataLength.to_ulong()<<")" ;
-		ss << " (Packet Data Field has " << dec << packetDataLength.to_ulong() + 1 << " bytes)" << endl;
-		return ss.str();
+		CCSDSFormatBuffer buffer;
+		format(buffer);
+		return buffer.str();
+	}
+
+public:
+	/** Appends a multi-line dump of this instance (the toString() format) to a buffer.
+	 * @param[in] buffer a buffer to which the dump is appended.
+	 */
+	void format(CCSDSFormatBuffer& buffer) const {
+		static const char* sequenceFlagDescriptions[] = { " (Continuation segment of user data)\n",
+				" (First segment of user data)\n", " (Last segment of user data)\n", " (Unsegmented user data)\n" };
+		size_t length = packetDataLength.to_ulong();
+		buffer.append("PrimaryHeader\n");
+		buffer.append("PacketVersionNum    : ").appendBits(packetVersionNum.to_ulong(), 3).appendChar('\n');
+		buffer.append("PacketType          : ").appendBits(packetType.to_ulong(), 1).appendChar('\n');
+		buffer.append("SecondaryHeaderFlag : ").appendBits(secondaryHeaderFlag.to_ulong(), 1).appendChar('\n');
+		buffer.append("APID                : ").appendDecimal(apid.to_ulong());
+		buffer.append(" (0x").appendHex(apid.to_ulong(), 2).append(")\n");
+		buffer.append("SequenceFlag        : ").appendBits(sequenceFlag.to_ulong(), 2);
+		buffer.append(sequenceFlagDescriptions[sequenceFlag.to_ulong()]);
+		//printed in hexadecimal without prefix (the stream was left in hex mode in the original dump)
+		buffer.append("SequenceCount       : ").appendHex(sequenceCount.to_ulong()).appendChar('\n');
+		buffer.append("PacketDataLength    : ").appendDecimal(length).append(" (0x").appendHex(length, 4).append(")");
+		buffer.append(" (Packet Data Field has ").appendDecimal(length + 1).append(" bytes)\n");
+	}
+
+public:
+	/** Appends a one-line summary of this instance to a buffer.
+	 * @param[in] buffer a buffer to which the summary is appended.
+	 */
+	void formatCompact(CCSDSFormatBuffer& buffer) const {
+		buffer.append((packetType.to_ulong() == CCSDSSpacePacketPacketType::TelemetryPacket) ? "TM" : "TC");
+		buffer.append(" APID=0x").appendHex(apid.to_ulong(), 3);
+		buffer.append(" SH=").appendBits(secondaryHeaderFlag.to_ulong(), 1);
+		buffer.append(" SeqFlag=").appendBits(sequenceFlag.to_ulong(), 2);
+		buffer.append(" SeqCount=").appendDecimal(sequenceCount.to_ulong());
+		buffer.append(" Length=").appendDecimal(packetDataLength.to_ulong());
 	}
 };
 
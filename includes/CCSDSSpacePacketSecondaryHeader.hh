@@ -21,6 +21,7 @@
 #endif
 
 #include "CCSDSSpacePacketException.hh"
+#include "CCSDSFormatBuffer.hh"
 
 class CCSDSSpacePacketSecondaryHeaderType {
 public:
@@ -104,7 +105,7 @@ public:
 	 * @param[in] data a byte array that contains CCSDS SpacePacket Secondary Header.
 	 * @param[in] length of the byte array.
 	 */
-	void interpret(const uint8_t* data, size_t length) throw (CCSDSSpacePacketException) {
+	void interpret(const uint8_t* data, size_t length) CCSDS_THROWS(CCSDSSpacePacketException) {
 		using namespace std;
 		if (length < 6) {
 			throw CCSDSSpacePacketException(CCSDSSpacePacketException::SecondaryHeaderTooShort);
@@ -224,6 +225,16 @@ public:
 		return result;
 	}
 
+public:
+	/** Copies the Time field to a buffer without allocation.
+	 * @param[out] time a buffer of (at least) 4 bytes.
+	 */
+	void getTime(uint8_t* time) const {
+		for (size_t i = 0; i < 4; i++) {
+			time[i] = this->time[i];
+		}
+	}
+
 public:
 	/** Sets ADU Channel ID.
 	 * @param[in] aduChannelID ADU Channel ID.
@@ -326,14 +337,11 @@ public:
 	}
 
 public:
-	uint32_t getTimeAsInteger() {
-		uint64_t time_integer = 0;
-		uint64_t factor = 1;
-		for (int i = 0; i < 4; i++) {
-			time_integer += factor * time[3 - i];
-			factor *= 0x100;
-		}
-		return time_integer;
+	/** Returns the Time field as an integer.
+	 * @returns 32-bit Time field value.
+	 */
+	uint32_t getTimeAsInteger() const {
+		return ((uint32_t) time[0] << 24) | ((uint32_t) time[1] << 16) | ((uint32_t) time[2] << 8) | time[3];
 	}
 
 public:
@@ -341,31 +349,50 @@ public:
 	 * @returns string dump of this instance.
 	 */
 	std::string toString() {
-		using namespace std;
-		stringstream ss;
+		CCSDSFormatBuffer buffer;
+		format(buffer);
+		return buffer.str();
+	}
 
+public:
+	/** Appends a multi-line dump of this instance (the toString() format) to a buffer.
+	 * @param[in] buffer a buffer to which the dump is appended.
+	 */
+	void format(CCSDSFormatBuffer& buffer) {
 		uint32_t time_integer = getTimeAsInteger();
 
-		ss << "SecondaryHeader (" << dec << this->getLength() << " bytes)" << endl;
-		ss << "Time                : " << time_integer << " (0x" << hex << right << setw(8) << setfill('0')
-				<< (uint32_t) time_integer << ")" << dec << endl;
-		ss << "SecondaryHeaderType : " << secondaryHeaderType.to_string()
-				<< ((secondaryHeaderType.to_ulong() == 1) ? "(SecondaryHeader present)" : "(SecondaryHeader not present)")
-				<< endl;
-		ss << "Category            : " << "0x" << hex << right << setw(2) << setfill('0') << (uint32_t) category.to_ulong()
-				<< endl;
-		ss << "ADUCount            : " << dec << (uint32_t) aduCount << " (0x" << hex << right << setw(2) << setfill('0')
-				<< (uint32_t) aduCount << ")" << dec << endl;
+		buffer.append("SecondaryHeader (").appendDecimal(this->getLength()).append(" bytes)\n");
+		buffer.append("Time                : ").appendDecimal(time_integer);
+		buffer.append(" (0x").appendHex(time_integer, 8).append(")\n");
+		buffer.append("SecondaryHeaderType : ").appendBits(secondaryHeaderType.to_ulong(), 1);
+		buffer.append((secondaryHeaderType.to_ulong() == 1) ? "(SecondaryHeader present)\n" : "(SecondaryHeader not present)\n");
+		buffer.append("Category            : 0x").appendHex(category.to_ulong(), 2).appendChar('\n');
+		buffer.append("ADUCount            : ").appendDecimal(aduCount);
+		buffer.append(" (0x").appendHex(aduCount, 2).append(")\n");
 
 		if (isADUChannelUsed()) {
-			ss << "ADUChannelID        : " << (uint32_t) aduChannelID << " (0x" << hex << right << setw(2) << setfill('0')
-					<< (uint32_t) aduChannelID << ")" << endl;
-			ss << "ADUSegmentFlag      : " << dec << aduSegmentFlag.to_string() << " (" << this->getADUSegmentFlagAsString()
-					<< ")" << endl;
-			ss << "ADUSegmentCount     : " << dec << aduSegmentCount.to_ulong() << " (0x" << hex << right << setw(4)
-					<< setfill('0') << aduSegmentCount.to_ulong() << ")" << hex << endl;
+			buffer.append("ADUChannelID        : ").appendDecimal(aduChannelID);
+			buffer.append(" (0x").appendHex(aduChannelID, 2).append(")\n");
+			buffer.append("ADUSegmentFlag      : ").appendBits(aduSegmentFlag.to_ulong(), 2);
+			buffer.append(" (").append(this->getADUSegmentFlagAsString()).append(")\n");
+			buffer.append("ADUSegmentCount     : ").appendDecimal(aduSegmentCount.to_ulong());
+			buffer.append(" (0x").appendHex(aduSegmentCount.to_ulong(), 4).append(")\n");
+		}
+	}
+
+public:
+	/** Appends a one-line summary of this instance to a buffer.
+	 * @param[in] buffer a buffer to which the summary is appended.
+	 */
+	void formatCompact(CCSDSFormatBuffer& buffer) {
+		buffer.append("TI=0x").appendHex(getTimeAsInteger(), 8);
+		buffer.append(" Cat=0x").appendHex(category.to_ulong(), 2);
+		buffer.append(" ADUCount=").appendDecimal(aduCount);
+		if (isADUChannelUsed()) {
+			buffer.append(" ADUCh=0x").appendHex(aduChannelID, 2);
+			buffer.append(" ADUSegFlag=").appendBits(aduSegmentFlag.to_ulong(), 2);
+			buffer.append(" ADUSegCount=").appendDecimal(aduSegmentCount.to_ulong());
 		}
-		return ss.str();
 	}
 
 public:
@@ -0,0 +1,640 @@
+/*
+ * CCSDSSpacePacketSecondaryHeaderPolicies.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSSPACEPACKETSECONDARYHEADERPOLICIES_HH_
+#define CCSDSSPACEPACKETSECONDARYHEADERPOLICIES_HH_
+
+#include "CCSDSSpacePacket.hh"
+#include <cstring>
+
+/** JAXA/ISAS Secondary Header with ADU Channel presence fixed at compile time.
+ * Unlike CCSDSSpacePacketSecondaryHeader, the Secondary Header Type bit is not
+ * consulted when interpreting a packet; the length is always Length bytes.
+ * Use this when every packet of a mission (or of an APID) uses the same layout.
+ * ADU Channel accessors are available only when ADUChannelUsed is true
+ * (checked at compile time).
+ *
+ * @par Example:
+ * @code
+ CCSDSSpacePacketWithADUChannel packet;
+ packet.interpret(data, length);
+ if (packet.getSecondaryHeader()->isADUFirstSegment()) {
+ ...
+ }
+ * @endcode
+ *
+ * @tparam ADUChannelUsed true for the 9-byte layout, false for the 6-byte layout.
+ */
+template<bool ADUChannelUsed>
+class CCSDSISASSecondaryHeader {
+public:
+	static const size_t Length = ADUChannelUsed ? CCSDSSpacePacketSecondaryHeader::SecondaryHeaderLengthWithADUChannel
+			: CCSDSSpacePacketSecondaryHeader::SecondaryHeaderLengthWithoutADUChannel;
+
+private:
+	uint8_t data[Length];
+
+public:
+	/** Constructs an instance with all fields zero (except for the Secondary Header Type bit). */
+	CCSDSISASSecondaryHeader() {
+		memset(data, 0, Length);
+		data[4] = ADUChannelUsed ? 0x80 : 0x00;
+	}
+
+public:
+	/** Returns a byte vector that contains the Secondary Header. */
+	std::vector<uint8_t> getAsByteVector() const {
+		return std::vector<uint8_t>(data, data + Length);
+	}
+
+public:
+	/** Interprets an input byte array as Secondary Header.
+	 * @param[in] data a byte array that contains CCSDS SpacePacket Secondary Header.
+	 * @param[in] length of the byte array.
+	 */
+	void interpret(const uint8_t* data, size_t length) CCSDS_THROWS(CCSDSSpacePacketException) {
+		if (length < Length) {
+			throw CCSDSSpacePacketException(CCSDSSpacePacketException::SecondaryHeaderTooShort);
+		}
+		memcpy(this->data, data, Length);
+	}
+
+public:
+	/** Returns Length of the Secondary Header part. */
+	size_t getLength() const {
+		return Length;
+	}
+
+public:
+	/** True if ADU Channel is used. */
+	bool isADUChannelUsed() const {
+		return ADUChannelUsed;
+	}
+
+public:
+	/** Returns the Time field as an integer. */
+	uint32_t getTimeAsInteger() const {
+		return ((uint32_t) data[0] << 24) | ((uint32_t) data[1] << 16) | ((uint32_t) data[2] << 8) | data[3];
+	}
+
+public:
+	/** Returns Time.
+	 * @returns 32-bit Time field value.
+	 */
+	std::vector<uint8_t> getTime() const {
+		return std::vector<uint8_t>(data, data + 4);
+	}
+
+public:
+	/** Copies the Time field to a buffer without allocation.
+	 * @param[out] time a buffer of (at least) 4 bytes.
+	 */
+	void getTime(uint8_t* time) const {
+		memcpy(time, data, 4);
+	}
+
+public:
+	/** Sets the Time field.
+	 * @param[in] time 32-bit Time field value.
+	 */
+	void setTime(const uint8_t* time) {
+		memcpy(data, time, 4);
+	}
+
+public:
+	/** Sets the Time field.
+	 * @param[in] time 32-bit Time field value.
+	 */
+	void setTime(uint32_t time) {
+		data[0] = time >> 24;
+		data[1] = time >> 16;
+		data[2] = time >> 8;
+		data[3] = time;
+	}
+
+public:
+	/** Returns the Category field value.
+	 * @return 7-bit Category of this packet.
+	 */
+	std::bitset<7> getCategory() const {
+		return std::bitset<7>(data[4] & 0x7F);
+	}
+
+public:
+	/** Sets the Category field.
+	 * @param[in] 7-bit category field value.
+	 */
+	void setCategory(uint8_t category) {
+		data[4] = (data[4] & 0x80) | (category & 0x7F);
+	}
+
+public:
+	/** Returns ADU Count. */
+	uint8_t getADUCount() const {
+		return data[5];
+	}
+
+public:
+	/** Sets ADU Count. */
+	void setADUCount(uint8_t aduCount) {
+		data[5] = aduCount;
+	}
+
+public:
+	/** Returns ADU Channel ID. */
+	uint8_t getADUChannelID() const {
+		static_assert(ADUChannelUsed, "CCSDSISASSecondaryHeader: ADU Channel is not used in this layout");
+		return data[6];
+	}
+
+public:
+	/** Sets ADU Channel ID. */
+	void setADUChannelID(uint8_t aduChannelID) {
+		static_assert(ADUChannelUsed, "CCSDSISASSecondaryHeader: ADU Channel is not used in this layout");
+		data[6] = aduChannelID;
+	}
+
+public:
+	/** Returns ADU Segment Flag (see CCSDSSpacePacketADUSegmentFlag). */
+	std::bitset<2> getADUSegmentFlag() const {
+		static_assert(ADUChannelUsed, "CCSDSISASSecondaryHeader: ADU Channel is not used in this layout");
+		return std::bitset<2>(data[7] >> 6);
+	}
+
+public:
+	/** Sets ADU Segment Flag (see CCSDSSpacePacketADUSegmentFlag). */
+	void setADUSegmentFlag(uint32_t aduSegmentFlag) {
+		static_assert(ADUChannelUsed, "CCSDSISASSecondaryHeader: ADU Channel is not used in this layout");
+		data[7] = ((aduSegmentFlag & 0x03) << 6) | (data[7] & 0x3F);
+	}
+
+public:
+	/** Returns ADU Segment Count. */
+	std::bitset<14> getADUSegmentCount() const {
+		static_assert(ADUChannelUsed, "CCSDSISASSecondaryHeader: ADU Channel is not used in this layout");
+		return std::bitset<14>(((data[7] & 0x3F) << 8) | data[8]);
+	}
+
+public:
+	/** Sets ADU Segment Count. */
+	void setADUSegmentCount(size_t aduSegmentCount) {
+		static_assert(ADUChannelUsed, "CCSDSISASSecondaryHeader: ADU Channel is not used in this layout");
+		data[7] = (data[7] & 0xC0) | ((aduSegmentCount >> 8) & 0x3F);
+		data[8] = aduSegmentCount & 0xFF;
+	}
+
+public:
+	/** True if this instance is a continuation ADU segment. */
+	bool isADUContinuationSegment() const {
+		return getADUSegmentFlag().to_ulong() == CCSDSSpacePacketADUSegmentFlag::ContinuationSegument;
+	}
+
+public:
+	/** True if this instance is the first ADU segment. */
+	bool isADUFirstSegment() const {
+		return getADUSegmentFlag().to_ulong() == CCSDSSpacePacketADUSegmentFlag::TheFirstSegment;
+	}
+
+public:
+	/** True if this instance is the last ADU segment. */
+	bool isADULastSegment() const {
+		return getADUSegmentFlag().to_ulong() == CCSDSSpacePacketADUSegmentFlag::TheLastSegment;
+	}
+
+public:
+	/** True if this instance is an unsegmented ADU. */
+	bool isADUUnsegmented() const {
+		return getADUSegmentFlag().to_ulong() == CCSDSSpacePacketADUSegmentFlag::UnsegmentedADU;
+	}
+
+public:
+	/** Appends a multi-line dump of this instance to a buffer. */
+	void format(CCSDSFormatBuffer& buffer) const {
+		uint32_t time_integer = getTimeAsInteger();
+		buffer.append("SecondaryHeader (").appendDecimal(Length).append(" bytes)\n");
+		buffer.append("Time                : ").appendDecimal(time_integer);
+		buffer.append(" (0x").appendHex(time_integer, 8).append(")\n");
+		buffer.append("Category            : 0x").appendHex(data[4] & 0x7F, 2).appendChar('\n');
+		buffer.append("ADUCount            : ").appendDecimal(data[5]);
+		buffer.append(" (0x").appendHex(data[5], 2).append(")\n");
+		if (ADUChannelUsed) {
+			buffer.append("ADUChannelID        : ").appendDecimal(data[6]);
+			buffer.append(" (0x").appendHex(data[6], 2).append(")\n");
+			buffer.append("ADUSegmentFlag      : ").appendBits(data[7] >> 6, 2).appendChar('\n');
+			uint32_t aduSegmentCount = ((data[7] & 0x3F) << 8) | data[8];
+			buffer.append("ADUSegmentCount     : ").appendDecimal(aduSegmentCount);
+			buffer.append(" (0x").appendHex(aduSegmentCount, 4).append(")\n");
+		}
+	}
+
+public:
+	/** Appends a one-line summary of this instance to a buffer. */
+	void formatCompact(CCSDSFormatBuffer& buffer) const {
+		buffer.append("TI=0x").appendHex(getTimeAsInteger(), 8);
+		buffer.append(" Cat=0x").appendHex(data[4] & 0x7F, 2);
+		buffer.append(" ADUCount=").appendDecimal(data[5]);
+		if (ADUChannelUsed) {
+			buffer.append(" ADUCh=0x").appendHex(data[6], 2);
+			buffer.append(" ADUSegFlag=").appendBits(data[7] >> 6, 2);
+			buffer.append(" ADUSegCount=").appendDecimal(((data[7] & 0x3F) << 8) | data[8]);
+		}
+	}
+};
+
+template<bool ADUChannelUsed>
+const size_t CCSDSISASSecondaryHeader<ADUChannelUsed>::Length;
+
+/** JAXA/ISAS Secondary Header which always has the ADU Channel (9 bytes). */
+typedef CCSDSISASSecondaryHeader<true> CCSDSISASSecondaryHeaderWithADUChannel;
+
+/** JAXA/ISAS Secondary Header which never has the ADU Channel (6 bytes). */
+typedef CCSDSISASSecondaryHeader<false> CCSDSISASSecondaryHeaderWithoutADUChannel;
+
+/** Secondary Header consisting of a CCSDS Unsegmented Time Code (CUC, CCSDS 301.0-B).
+ * The T-field is Coarse Time (NCoarseBytes octets, big endian) followed by Fine Time
+ * (NFineBytes octets). The P-field is optional; when it is not present in packets,
+ * it is implied by the template parameters.
+ *
+ * @par Example:
+ * @code
+ //4-byte coarse time, 2-byte fine time, no P-field
+ typedef CCSDSSpacePacketT<CCSDSCUCSecondaryHeader<4, 2> > MissionPacket;
+ MissionPacket packet;
+ packet.interpret(data, length);
+ double t = packet.getSecondaryHeader()->getTimeInSeconds();
+ * @endcode
+ *
+ * @tparam NCoarseBytes number of Coarse Time octets (1 to 4).
+ * @tparam NFineBytes number of Fine Time octets (0 to 3).
+ * @tparam PFieldPresent true if the P-field (1 octet) precedes the T-field.
+ */
+template<size_t NCoarseBytes, size_t NFineBytes, bool PFieldPresent = false>
+class CCSDSCUCSecondaryHeader {
+	static_assert(NCoarseBytes >= 1 && NCoarseBytes <= 4, "CCSDSCUCSecondaryHeader: Coarse Time must be 1 to 4 octets");
+	static_assert(NFineBytes <= 3, "CCSDSCUCSecondaryHeader: Fine Time must be 0 to 3 octets");
+
+public:
+	static const size_t Length = (PFieldPresent ? 1 : 0) + NCoarseBytes + NFineBytes;
+
+	/** P-field implied by the template parameters (Agency-defined epoch, no extension). */
+	static const uint8_t DefaultPField = 0x20 | ((NCoarseBytes - 1) << 2) | NFineBytes;
+
+private:
+	uint8_t pField;
+	uint32_t coarseTime;
+	uint32_t fineTime;
+
+public:
+	/** Constructs an instance with zero time. */
+	CCSDSCUCSecondaryHeader() {
+		pField = DefaultPField;
+		coarseTime = 0;
+		fineTime = 0;
+	}
+
+public:
+	/** Returns a byte vector that contains the Secondary Header. */
+	std::vector<uint8_t> getAsByteVector() const {
+		std::vector<uint8_t> result;
+		result.reserve(Length);
+		if (PFieldPresent) {
+			result.push_back(pField);
+		}
+		for (size_t i = NCoarseBytes; i != 0; i--) {
+			result.push_back(coarseTime >> (8 * (i - 1)));
+		}
+		for (size_t i = NFineBytes; i != 0; i--) {
+			result.push_back(fineTime >> (8 * (i - 1)));
+		}
+		return result;
+	}
+
+public:
+	/** Interprets an input byte array as Secondary Header.
+	 * @param[in] data a byte array that contains CCSDS SpacePacket Secondary Header.
+	 * @param[in] length of the byte array.
+	 */
+	void interpret(const uint8_t* data, size_t length) CCSDS_THROWS(CCSDSSpacePacketException) {
+		if (length < Length) {
+			throw CCSDSSpacePacketException(CCSDSSpacePacketException::SecondaryHeaderTooShort);
+		}
+		if (PFieldPresent) {
+			pField = *data++;
+		}
+		coarseTime = 0;
+		for (size_t i = 0; i < NCoarseBytes; i++) {
+			coarseTime = (coarseTime << 8) | *data++;
+		}
+		fineTime = 0;
+		for (size_t i = 0; i < NFineBytes; i++) {
+			fineTime = (fineTime << 8) | *data++;
+		}
+	}
+
+public:
+	/** Returns Length of the Secondary Header part. */
+	size_t getLength() const {
+		return Length;
+	}
+
+public:
+	/** Returns the P-field (DefaultPField if the P-field is not present in packets). */
+	uint8_t getPField() const {
+		return pField;
+	}
+
+public:
+	/** Sets the P-field. Ignored in getAsByteVector() if the P-field is not present. */
+	void setPField(uint8_t pField) {
+		this->pField = pField;
+	}
+
+public:
+	/** Returns Coarse Time (seconds from the epoch). */
+	uint32_t getCoarseTime() const {
+		return coarseTime;
+	}
+
+public:
+	/** Sets Coarse Time (seconds from the epoch). */
+	void setCoarseTime(uint32_t coarseTime) {
+		this->coarseTime = coarseTime;
+	}
+
+public:
+	/** Returns Fine Time (in units of 2^(-8*NFineBytes) seconds). */
+	uint32_t getFineTime() const {
+		return fineTime;
+	}
+
+public:
+	/** Sets Fine Time (in units of 2^(-8*NFineBytes) seconds). */
+	void setFineTime(uint32_t fineTime) {
+		this->fineTime = fineTime;
+	}
+
+public:
+	/** Returns Coarse Time as an integer (for compatibility with the ISAS Time field). */
+	uint32_t getTimeAsInteger() const {
+		return coarseTime;
+	}
+
+public:
+	/** Returns time from the epoch in seconds. */
+	double getTimeInSeconds() const {
+		return coarseTime + fineTime / (double) (1ULL << (8 * NFineBytes));
+	}
+
+public:
+	/** Appends a multi-line dump of this instance to a buffer. */
+	void format(CCSDSFormatBuffer& buffer) const {
+		buffer.append("SecondaryHeader (").appendDecimal(Length).append(" bytes, CUC)\n");
+		if (PFieldPresent) {
+			buffer.append("PField              : ").appendBits(pField, 8).appendChar('\n');
+		}
+		buffer.append("CoarseTime          : ").appendDecimal(coarseTime);
+		buffer.append(" (0x").appendHex(coarseTime, 2 * NCoarseBytes).append(")\n");
+		if (NFineBytes != 0) {
+			buffer.append("FineTime            : ").appendDecimal(fineTime);
+			buffer.append(" (0x").appendHex(fineTime, 2 * NFineBytes).append(")\n");
+		}
+	}
+
+public:
+	/** Appends a one-line summary of this instance to a buffer. */
+	void formatCompact(CCSDSFormatBuffer& buffer) const {
+		buffer.append("CUC=0x").appendHex(coarseTime, 2 * NCoarseBytes);
+		if (NFineBytes != 0) {
+			buffer.appendChar('.').appendHex(fineTime, 2 * NFineBytes);
+		}
+	}
+};
+
+template<size_t NCoarseBytes, size_t NFineBytes, bool PFieldPresent>
+const size_t CCSDSCUCSecondaryHeader<NCoarseBytes, NFineBytes, PFieldPresent>::Length;
+
+template<size_t NCoarseBytes, size_t NFineBytes, bool PFieldPresent>
+const uint8_t CCSDSCUCSecondaryHeader<NCoarseBytes, NFineBytes, PFieldPresent>::DefaultPField;
+
+/** Secondary Header consisting of a CCSDS Day Segmented Time Code (CDS, CCSDS 301.0-B).
+ * The T-field is Day (16 or 24 bits), Milliseconds of Day (32 bits), and optional
+ * Submilliseconds (16 bits in microseconds, or 32 bits in picoseconds).
+ *
+ * @tparam NDayBytes number of Day octets (2 or 3).
+ * @tparam NSubmillisecondBytes 0, 2 (microseconds), or 4 (picoseconds).
+ * @tparam PFieldPresent true if the P-field (1 octet) precedes the T-field.
+ */
+template<size_t NDayBytes = 2, size_t NSubmillisecondBytes = 0, bool PFieldPresent = false>
+class CCSDSCDSSecondaryHeader {
+	static_assert(NDayBytes == 2 || NDayBytes == 3, "CCSDSCDSSecondaryHeader: Day must be 2 or 3 octets");
+	static_assert(NSubmillisecondBytes == 0 || NSubmillisecondBytes == 2 || NSubmillisecondBytes == 4,
+			"CCSDSCDSSecondaryHeader: Submilliseconds must be 0, 2, or 4 octets");
+
+public:
+	static const size_t Length = (PFieldPresent ? 1 : 0) + NDayBytes + 4 + NSubmillisecondBytes;
+
+	/** P-field implied by the template parameters (Agency-defined epoch). */
+	static const uint8_t DefaultPField = 0x48 | ((NDayBytes == 3) ? 0x04 : 0x00) | (NSubmillisecondBytes / 2);
+
+private:
+	uint8_t pField;
+	uint32_t day;
+	uint32_t millisecondsOfDay;
+	uint32_t submilliseconds;
+
+public:
+	/** Constructs an instance with zero time. */
+	CCSDSCDSSecondaryHeader() {
+		pField = DefaultPField;
+		day = 0;
+		millisecondsOfDay = 0;
+		submilliseconds = 0;
+	}
+
+public:
+	/** Returns a byte vector that contains the Secondary Header. */
+	std::vector<uint8_t> getAsByteVector() const {
+		std::vector<uint8_t> result;
+		result.reserve(Length);
+		if (PFieldPresent) {
+			result.push_back(pField);
+		}
+		for (size_t i = NDayBytes; i != 0; i--) {
+			result.push_back(day >> (8 * (i - 1)));
+		}
+		for (size_t i = 4; i != 0; i--) {
+			result.push_back(millisecondsOfDay >> (8 * (i - 1)));
+		}
+		for (size_t i = NSubmillisecondBytes; i != 0; i--) {
+			result.push_back(submilliseconds >> (8 * (i - 1)));
+		}
+		return result;
+	}
+
+public:
+	/** Interprets an input byte array as Secondary Header.
+	 * @param[in] data a byte array that contains CCSDS SpacePacket Secondary Header.
+	 * @param[in] length of the byte array.
+	 */
+	void interpret(const uint8_t* data, size_t length) CCSDS_THROWS(CCSDSSpacePacketException) {
+		if (length < Length) {
+			throw CCSDSSpacePacketException(CCSDSSpacePacketException::SecondaryHeaderTooShort);
+		}
+		if (PFieldPresent) {
+			pField = *data++;
+		}
+		day = 0;
+		for (size_t i = 0; i < NDayBytes; i++) {
+			day = (day << 8) | *data++;
+		}
+		millisecondsOfDay = 0;
+		for (size_t i = 0; i < 4; i++) {
+			millisecondsOfDay = (millisecondsOfDay << 8) | *data++;
+		}
+		submilliseconds = 0;
+		for (size_t i = 0; i < NSubmillisecondBytes; i++) {
+			submilliseconds = (submilliseconds << 8) | *data++;
+		}
+	}
+
+public:
+	/** Returns Length of the Secondary Header part. */
+	size_t getLength() const {
+		return Length;
+	}
+
+public:
+	/** Returns the P-field (DefaultPField if the P-field is not present in packets). */
+	uint8_t getPField() const {
+		return pField;
+	}
+
+public:
+	/** Sets the P-field. Ignored in getAsByteVector() if the P-field is not present. */
+	void setPField(uint8_t pField) {
+		this->pField = pField;
+	}
+
+public:
+	/** Returns Day (days from the epoch). */
+	uint32_t getDay() const {
+		return day;
+	}
+
+public:
+	/** Sets Day (days from the epoch). */
+	void setDay(uint32_t day) {
+		this->day = day;
+	}
+
+public:
+	/** Returns Milliseconds of Day. */
+	uint32_t getMillisecondsOfDay() const {
+		return millisecondsOfDay;
+	}
+
+public:
+	/** Sets Milliseconds of Day. */
+	void setMillisecondsOfDay(uint32_t millisecondsOfDay) {
+		this->millisecondsOfDay = millisecondsOfDay;
+	}
+
+public:
+	/** Returns Submilliseconds (microseconds or picoseconds depending on NSubmillisecondBytes). */
+	uint32_t getSubmilliseconds() const {
+		return submilliseconds;
+	}
+
+public:
+	/** Sets Submilliseconds (microseconds or picoseconds depending on NSubmillisecondBytes). */
+	void setSubmilliseconds(uint32_t submilliseconds) {
+		this->submilliseconds = submilliseconds;
+	}
+
+public:
+	/** Returns time from the epoch in seconds. */
+	double getTimeInSeconds() const {
+		double result = day * 86400.0 + millisecondsOfDay / 1e3;
+		if (NSubmillisecondBytes == 2) {
+			result += submilliseconds / 1e6;
+		} else if (NSubmillisecondBytes == 4) {
+			result += submilliseconds / 1e12;
+		}
+		return result;
+	}
+
+public:
+	/** Appends a multi-line dump of this instance to a buffer. */
+	void format(CCSDSFormatBuffer& buffer) const {
+		buffer.append("SecondaryHeader (").appendDecimal(Length).append(" bytes, CDS)\n");
+		if (PFieldPresent) {
+			buffer.append("PField              : ").appendBits(pField, 8).appendChar('\n');
+		}
+		buffer.append("Day                 : ").appendDecimal(day).appendChar('\n');
+		buffer.append("MillisecondsOfDay   : ").appendDecimal(millisecondsOfDay).appendChar('\n');
+		if (NSubmillisecondBytes != 0) {
+			buffer.append("Submilliseconds     : ").appendDecimal(submilliseconds).appendChar('\n');
+		}
+	}
+
+public:
+	/** Appends a one-line summary of this instance to a buffer. */
+	void formatCompact(CCSDSFormatBuffer& buffer) const {
+		buffer.append("CDS=").appendDecimal(day).appendChar('/').appendDecimal(millisecondsOfDay);
+		if (NSubmillisecondBytes != 0) {
+			buffer.appendChar('.').appendDecimal(submilliseconds);
+		}
+	}
+};
+
+template<size_t NDayBytes, size_t NSubmillisecondBytes, bool PFieldPresent>
+const size_t CCSDSCDSSecondaryHeader<NDayBytes, NSubmillisecondBytes, PFieldPresent>::Length;
+
+template<size_t NDayBytes, size_t NSubmillisecondBytes, bool PFieldPresent>
+const uint8_t CCSDSCDSSecondaryHeader<NDayBytes, NSubmillisecondBytes, PFieldPresent>::DefaultPField;
+
+/** Secondary Header policy for missions without a Secondary Header (0 bytes).
+ * If a packet has the Secondary Header Flag set, its whole Packet Data Field
+ * is stored in the User Data Field.
+ */
+class CCSDSNoSecondaryHeader {
+public:
+	static const size_t Length = 0;
+
+public:
+	std::vector<uint8_t> getAsByteVector() const {
+		return std::vector<uint8_t>();
+	}
+
+public:
+	void interpret(const uint8_t* /*data*/, size_t /*length*/) {
+	}
+
+public:
+	size_t getLength() const {
+		return Length;
+	}
+
+public:
+	void format(CCSDSFormatBuffer& /*buffer*/) const {
+	}
+
+public:
+	void formatCompact(CCSDSFormatBuffer& /*buffer*/) const {
+	}
+};
+
+/** CCSDS SpacePacket whose Secondary Header always has the ADU Channel. */
+typedef CCSDSSpacePacketT<CCSDSISASSecondaryHeaderWithADUChannel> CCSDSSpacePacketWithADUChannel;
+
+/** CCSDS SpacePacket whose Secondary Header never has the ADU Channel. */
+typedef CCSDSSpacePacketT<CCSDSISASSecondaryHeaderWithoutADUChannel> CCSDSSpacePacketWithoutADUChannel;
+
+/** CCSDS SpacePacket without Secondary Header. */
+typedef CCSDSSpacePacketT<CCSDSNoSecondaryHeader> CCSDSSpacePacketWithoutSecondaryHeader;
+
+#endif /* CCSDSSPACEPACKETSECONDARYHEADERPOLICIES_HH_ */
@@ -0,0 +1,280 @@
+/*
+ * CCSDSSpacePacketView.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSSPACEPACKETVIEW_HH_
+#define CCSDSSPACEPACKETVIEW_HH_
+
+#include "CCSDSSpacePacket.hh"
+#include <vector>
+
+#if (defined(__GXX_EXPERIMENTAL_CXX0X) || (__cplusplus >= 201103L))
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+/** A class that represents a read-only view of a CCSDS SpacePacket
+ * held in an external byte array.
+ * Unlike CCSDSSpacePacket, this class does not copy packet content;
+ * header fields are decoded directly from the raw bytes on each access.
+ * The referenced byte array must outlive the view.
+ *
+ * @par
+ * Example:
+ * @code
+ CCSDSSpacePacketView view(data, length);
+ if (view.isTMPacket() && view.getAPIDAsInteger() == apid) {
+ 	std::cout << view.getTimeAsInteger() << std::endl;
+ }
+ * @endcode
+ * @see CCSDSSpacePacket
+ */
+class CCSDSSpacePacketView {
+public:
+	/** The largest possible CCSDS SpacePacket (Primary Header + 65536 bytes). */
+	static const size_t MaximumPacketLength = 6 + 65536;
+
+public:
+	const uint8_t* data;
+	size_t length;
+
+public:
+	/** Constructs an empty view.
+	 */
+	CCSDSSpacePacketView() {
+		this->data = NULL;
+		this->length = 0;
+	}
+
+public:
+	/** Constructs a view of a packet.
+	 * @param[in] data a pointer to the first byte of the Primary Header.
+	 * @param[in] length total packet length (Primary Header + Packet Data Field).
+	 */
+	CCSDSSpacePacketView(const uint8_t* data, size_t length) {
+		this->data = data;
+		this->length = length;
+	}
+
+public:
+	/** Returns the total packet length recorded in a raw Primary Header.
+	 * @param[in] data a pointer to at least 6 bytes of a Primary Header.
+	 * @returns Primary Header length + Packet Data Length + 1.
+	 */
+	static inline size_t peekTotalPacketLength(const uint8_t* data) {
+		return CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength + ((size_t) data[4] << 8) + data[5] + 1;
+	}
+
+public:
+	/** Checks if a byte array plausibly starts with a CCSDS SpacePacket that
+	 * CCSDSSpacePacket::interpret() can accept.
+	 * The Packet Version Number, the declared packet length, and the size of
+	 * the Secondary Header (if present) are checked against the available bytes.
+	 * @param[in] data a pointer to a candidate Primary Header.
+	 * @param[in] length number of bytes available from data.
+	 * @returns true if a complete, plausible packet starts at data.
+	 */
+	static bool isPlausiblePacket(const uint8_t* data, size_t length) {
+		if (length < CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength) {
+			return false;
+		}
+		if ((data[0] & 0xe0) != 0x00 /* Packet Version Number 000b */) {
+			return false;
+		}
+		size_t totalPacketLength = peekTotalPacketLength(data);
+		if (length < totalPacketLength) {
+			return false;
+		}
+		if ((data[0] & 0x08) != 0x00 /* Secondary Header present */) {
+			size_t dataFieldLength = totalPacketLength - CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength;
+			if (dataFieldLength < CCSDSSpacePacketSecondaryHeader::SecondaryHeaderLengthWithoutADUChannel) {
+				return false;
+			}
+			if ((data[10] & 0x80) != 0x00
+					&& dataFieldLength < CCSDSSpacePacketSecondaryHeader::SecondaryHeaderLengthWithADUChannel) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+public:
+	/** Returns APID as an integer. */
+	inline uint16_t getAPIDAsInteger() const {
+		return ((uint16_t) (data[0] & 0x07) << 8) + data[1];
+	}
+
+public:
+	/** Returns Packet Type.
+	 * @retval 0 Telemetry Packet.
+	 * @retval 1 Command packet.
+	 */
+	inline uint8_t getPacketType() const {
+		return (data[0] & 0x10) >> 4;
+	}
+
+public:
+	/** True if TM Packet. */
+	inline bool isTMPacket() const {
+		return getPacketType() == CCSDSSpacePacketPacketType::TelemetryPacket;
+	}
+
+public:
+	/** True if TC Packet. */
+	inline bool isTCPacket() const {
+		return getPacketType() == CCSDSSpacePacketPacketType::CommandPacket;
+	}
+
+public:
+	/** True if this packet is an Idle Packet. */
+	inline bool isIdlePacket() const {
+		return getAPIDAsInteger() == CCSDSSpacePacket::APIDOfIdlePacket;
+	}
+
+public:
+	/** Checks if Secondary Header is present. */
+	inline bool isSecondaryHeaderPresent() const {
+		return (data[0] & 0x08) != 0x00;
+	}
+
+public:
+	/** Returns Packet Sequence Flag.
+	 * @retval 00 Continuation segment of user data.
+	 * @retval 01 First segment of user data.
+	 * @retval 10 Last segment of user data.
+	 * @retval 11 Unsegmented user data.
+	 */
+	inline uint8_t getSequenceFlag() const {
+		return (data[2] & 0xc0) >> 6;
+	}
+
+public:
+	/** Returns Packet Sequence Count. */
+	inline uint16_t getSequenceCount() const {
+		return ((uint16_t) (data[2] & 0x3F) << 8) + data[3];
+	}
+
+public:
+	/** Returns Packet Data Length.
+	 * @returns (Total number of bytes in the Packet Data field - 1).
+	 */
+	inline size_t getPacketDataLength() const {
+		return ((size_t) data[4] << 8) + data[5];
+	}
+
+public:
+	/** Returns the total packet length (Primary Header + Secondary Header + User Data Field). */
+	inline size_t getTotalPacketLength() const {
+		return peekTotalPacketLength(data);
+	}
+
+public:
+	/** True if ADU Channel is used. Valid only when Secondary Header is present. */
+	inline bool isADUChannelUsed() const {
+		return (data[10] & 0x80) != 0x00;
+	}
+
+public:
+	/** Returns Length of the Secondary Header part (0 if not present). */
+	inline size_t getSecondaryHeaderLength() const {
+		if (!isSecondaryHeaderPresent()) {
+			return 0;
+		} else if (isADUChannelUsed()) {
+			return CCSDSSpacePacketSecondaryHeader::SecondaryHeaderLengthWithADUChannel;
+		} else {
+			return CCSDSSpacePacketSecondaryHeader::SecondaryHeaderLengthWithoutADUChannel;
+		}
+	}
+
+public:
+	/** Returns the 32-bit Time field. Valid only when Secondary Header is present. */
+	inline uint32_t getTimeAsInteger() const {
+		return ((uint32_t) data[6] << 24) + ((uint32_t) data[7] << 16) + ((uint32_t) data[8] << 8) + data[9];
+	}
+
+public:
+	/** Returns the 7-bit Category. Valid only when Secondary Header is present. */
+	inline uint8_t getCategory() const {
+		return data[10] & 0x7F;
+	}
+
+public:
+	/** Returns ADU Count. Valid only when Secondary Header is present. */
+	inline uint8_t getADUCount() const {
+		return data[11];
+	}
+
+public:
+	/** Returns ADU Channel ID. Valid only when ADU Channel is used. */
+	inline uint8_t getADUChannelID() const {
+		return data[12];
+	}
+
+public:
+	/** Returns ADU Segment Flag. Valid only when ADU Channel is used. */
+	inline uint8_t getADUSegmentFlag() const {
+		return (data[13] & 0xc0) >> 6;
+	}
+
+public:
+	/** Returns ADU Segment Count. Valid only when ADU Channel is used. */
+	inline uint16_t getADUSegmentCount() const {
+		return ((uint16_t) (data[13] & 0x3F) << 8) + data[14];
+	}
+
+public:
+	/** Returns a pointer to the User Data Field. */
+	inline const uint8_t* getUserDataField() const {
+		return data + CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength + getSecondaryHeaderLength();
+	}
+
+public:
+	/** Returns the length of the User Data Field. */
+	inline size_t getUserDataFieldLength() const {
+		return getTotalPacketLength() - CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength - getSecondaryHeaderLength();
+	}
+
+public:
+	/** Checks the Packet Error Control field (CRC-16 in the last 2 bytes of the packet).
+	 * @returns true if the CRC matches.
+	 */
+	inline bool isPacketErrorControlValid() const {
+		return CCSDSCRC16::verify(data, length);
+	}
+
+public:
+	/** Checks the Packet Error Control field of a batch of packets.
+	 * @param[in] views packets that carry Packet Error Control.
+	 * @param[out] results results[i] is set to 1 if the CRC of views[i] matches, 0 otherwise.
+	 * @returns the number of packets whose CRC did not match.
+	 */
+	static size_t verifyPacketErrorControl(const std::vector<CCSDSSpacePacketView>& views, std::vector<uint8_t>& results) {
+		size_t nErrors = 0;
+		results.resize(views.size());
+		for (size_t i = 0; i < views.size(); i++) {
+			results[i] = views[i].isPacketErrorControlValid() ? 1 : 0;
+			nErrors += 1 - results[i];
+		}
+		return nErrors;
+	}
+
+public:
+	/** Returns packet content as a vector of uint8_t (copied). */
+	std::vector<uint8_t> getAsByteVector() const {
+		return std::vector<uint8_t>(data, data + length);
+	}
+
+public:
+	/** Interprets the viewed bytes into a CCSDSSpacePacket instance.
+	 * @param[in] packet a packet instance to be filled.
+	 */
+	void interpretAs(CCSDSSpacePacket* packet) const {
+		packet->interpret(data, length);
+	}
+};
+
+#endif /* CCSDSSPACEPACKETVIEW_HH_ */
@@ -0,0 +1,37 @@
+/*
+ * CCSDSThreadAffinity.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSTHREADAFFINITY_HH_
+#define CCSDSTHREADAFFINITY_HH_
+
+#include <pthread.h>
+#include <sched.h>
+
+/** A helper class that pins threads to CPU cores (Linux).
+ */
+class CCSDSThreadAffinity {
+public:
+	/** Pins the calling thread to a core.
+	 * @param[in] core a core index (negative values are ignored).
+	 * @returns true if the affinity was set.
+	 */
+	static bool pinCurrentThread(int core) {
+		if (core < 0) {
+			return false;
+		}
+#ifdef __linux__
+		cpu_set_t cpuSet;
+		CPU_ZERO(&cpuSet);
+		CPU_SET(core, &cpuSet);
+		return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet) == 0;
+#else
+		return false;
+#endif
+	}
+};
+
+#endif /* CCSDSTHREADAFFINITY_HH_ */
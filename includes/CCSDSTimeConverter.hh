@@ -0,0 +1,429 @@
+/*
+ * CCSDSTimeConverter.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSTIMECONVERTER_HH_
+#define CCSDSTIMECONVERTER_HH_
+
+#if !(defined(__GXX_EXPERIMENTAL_CXX0X) || (__cplusplus >= 201103L))
+#error "CCSDSTimeConverter.hh requires C++11 (constexpr, std::fma, std::llrint)"
+#endif
+
+#include "CCSDSSpacePacketView.hh"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#if !defined(CCSDS_DISABLE_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CCSDS_TIMECONVERTER_HAS_AVX2 1
+#endif
+
+class CCSDSTimeConverterException {
+public:
+	CCSDSTimeConverterException(std::string str) {
+		message = str;
+	}
+
+public:
+	std::string toString() {
+		return message;
+	}
+
+public:
+	std::string message;
+};
+
+/** Converts the Time Indicator (TI, the 32-bit Time field of the Secondary Header)
+ * of packet batches into epoch times.
+ *
+ * The TI-to-UTC correlation is a piecewise linear table of (TI, UTC) points.
+ * Between two points, UTC is interpolated linearly; outside the table, the first or
+ * the last segment is extrapolated. With a single point, the TI frequency
+ * (64 Hz by default) gives the slope. Without points, the result is TI divided by
+ * the TI frequency. TI is not unwrapped; a table spans one TI cycle.
+ *
+ * Batch conversion uses AVX2/FMA kernels (4 packets per step) when the CPU supports
+ * them, and a scalar loop otherwise; the results are identical.
+ * Define CCSDS_DISABLE_SIMD to build without the SIMD kernels.
+ * This class requires C++11.
+ *
+ * @par Example:
+ * @code
+ CCSDSTimeConverter converter;
+ converter.addCorrelationPoint(0x10000000, 1791590400.0); //TI, UTC (UNIX seconds)
+ converter.addCorrelationPoint(0x10540000, 1791676800.0);
+
+ std::vector<uint32_t> ti(nPackets);
+ std::vector<int64_t> utc(nPackets);
+ CCSDSTimeConverter::extractTI(views, nPackets, &ti[0]);
+ converter.convertToNanoseconds(&ti[0], nPackets, &utc[0]);
+ * @endcode
+ */
+class CCSDSTimeConverter {
+public:
+	static constexpr double DefaultTimeIndicatorFrequency = 64;
+
+	/** Offset of the Time field from the top of a packet. */
+	static const size_t TimeFieldOffset = CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength;
+
+public:
+	/** A point of the TI-to-UTC correlation table. */
+	class CorrelationPoint {
+	public:
+		uint32_t ti;
+		double utc;
+
+	public:
+		bool operator<(const CorrelationPoint& other) const {
+			return ti < other.ti;
+		}
+	};
+
+private:
+	/** A linear segment: utc = utcBase + (ti - tiBase) * secondsPerTick, for tiBegin <= ti < tiEnd. */
+	class Segment {
+	public:
+		double tiBegin;
+		double tiEnd;
+		double tiBase;
+		double utcBase;
+		double secondsPerTick;
+		int64_t nanosecondsBase;
+		double nanosecondsPerTick;
+	};
+
+private:
+	double timeIndicatorFrequency;
+	std::vector<CorrelationPoint> points;
+	std::vector<Segment> segments;
+	bool simdEnabled;
+
+public:
+	/** Constructs an instance without correlation points.
+	 * @param[in] timeIndicatorFrequency TI frequency in Hz.
+	 */
+	CCSDSTimeConverter(double timeIndicatorFrequency = DefaultTimeIndicatorFrequency) {
+		if (!(timeIndicatorFrequency > 0)) {
+			throw CCSDSTimeConverterException("CCSDSTimeConverter: TI frequency should be positive");
+		}
+		this->timeIndicatorFrequency = timeIndicatorFrequency;
+		this->simdEnabled = true;
+		buildSegments();
+	}
+
+public:
+	/** Adds a correlation point. A point with the same TI replaces the existing one.
+	 * @param[in] ti TI value.
+	 * @param[in] utc UTC (or any epoch time) in seconds that corresponds to ti.
+	 */
+	void addCorrelationPoint(uint32_t ti, double utc) {
+		CorrelationPoint point;
+		point.ti = ti;
+		point.utc = utc;
+		std::vector<CorrelationPoint>::iterator it = std::lower_bound(points.begin(), points.end(), point);
+		if (it != points.end() && it->ti == ti) {
+			it->utc = utc;
+		} else {
+			points.insert(it, point);
+		}
+		buildSegments();
+	}
+
+public:
+	/** Replaces the correlation table.
+	 * @param[in] points correlation points (in any order; TI must be unique).
+	 */
+	void setCorrelationPoints(const std::vector<CorrelationPoint>& points) {
+		std::vector<CorrelationPoint> sorted = points;
+		std::sort(sorted.begin(), sorted.end());
+		for (size_t i = 1; i < sorted.size(); i++) {
+			if (sorted[i].ti == sorted[i - 1].ti) {
+				throw CCSDSTimeConverterException("CCSDSTimeConverter: duplicated TI in the correlation table");
+			}
+		}
+		this->points = sorted;
+		buildSegments();
+	}
+
+public:
+	/** Removes all correlation points. */
+	void clearCorrelationPoints() {
+		points.clear();
+		buildSegments();
+	}
+
+public:
+	const std::vector<CorrelationPoint>& getCorrelationPoints() const {
+		return points;
+	}
+
+public:
+	double getTimeIndicatorFrequency() const {
+		return timeIndicatorFrequency;
+	}
+
+public:
+	/** Enables or disables the SIMD kernels (enabled by default when available). */
+	void setSIMDEnabled(bool simdEnabled) {
+		this->simdEnabled = simdEnabled;
+	}
+
+public:
+	/** True if the AVX2/FMA kernels can be used on this CPU. */
+	static bool isAVX2Available() {
+#ifdef CCSDS_TIMECONVERTER_HAS_AVX2
+		static const bool available = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+		return available;
+#else
+		return false;
+#endif
+	}
+
+public:
+	/** Converts a TI value to UTC in seconds. */
+	double convertToSeconds(uint32_t ti) const {
+		const Segment& segment = segments[findSegment(ti)];
+		return std::fma(ti - segment.tiBase, segment.secondsPerTick, segment.utcBase);
+	}
+
+public:
+	/** Converts a TI value to UTC in nanoseconds. */
+	int64_t convertToNanoseconds(uint32_t ti) const {
+		const Segment& segment = segments[findSegment(ti)];
+		return segment.nanosecondsBase + std::llrint((ti - segment.tiBase) * segment.nanosecondsPerTick);
+	}
+
+public:
+	/** Converts TI values to UTC in seconds.
+	 * @param[in] ti TI values.
+	 * @param[in] n the number of values.
+	 * @param[out] seconds converted values (n entries).
+	 */
+	void convertToSeconds(const uint32_t* ti, size_t n, double* seconds) const {
+		size_t done = 0;
+#ifdef CCSDS_TIMECONVERTER_HAS_AVX2
+		if (simdEnabled && isAVX2Available()) {
+			done = convertToSecondsAVX2(ti, n, seconds);
+		}
+#endif
+		size_t s = 0;
+		for (size_t i = done; i < n; i++) {
+			s = findSegment(ti[i], s);
+			const Segment& segment = segments[s];
+			seconds[i] = std::fma(ti[i] - segment.tiBase, segment.secondsPerTick, segment.utcBase);
+		}
+	}
+
+public:
+	/** Converts TI values to UTC in nanoseconds.
+	 * @param[in] ti TI values.
+	 * @param[in] n the number of values.
+	 * @param[out] nanoseconds converted values (n entries).
+	 */
+	void convertToNanoseconds(const uint32_t* ti, size_t n, int64_t* nanoseconds) const {
+		size_t done = 0;
+#ifdef CCSDS_TIMECONVERTER_HAS_AVX2
+		if (simdEnabled && isAVX2Available()) {
+			done = convertToNanosecondsAVX2(ti, n, nanoseconds);
+		}
+#endif
+		size_t s = 0;
+		for (size_t i = done; i < n; i++) {
+			s = findSegment(ti[i], s);
+			const Segment& segment = segments[s];
+			nanoseconds[i] = segment.nanosecondsBase + std::llrint((ti[i] - segment.tiBase) * segment.nanosecondsPerTick);
+		}
+	}
+
+public:
+	/** Extracts TI values of packets.
+	 * Valid only for packets that have the Secondary Header.
+	 * @param[in] views packets.
+	 * @param[in] n the number of packets.
+	 * @param[out] ti TI values (n entries).
+	 */
+	static void extractTI(const CCSDSSpacePacketView* views, size_t n, uint32_t* ti) {
+		for (size_t i = 0; i < n; i++) {
+			ti[i] = loadTI(views[i].data);
+		}
+	}
+
+public:
+	/** Extracts TI values of packets.
+	 * Valid only for packets that have the Secondary Header.
+	 * @param[in] packets pointers to the first byte of the Primary Header of packets.
+	 * @param[in] n the number of packets.
+	 * @param[out] ti TI values (n entries).
+	 */
+	static void extractTI(const uint8_t* const * packets, size_t n, uint32_t* ti) {
+		for (size_t i = 0; i < n; i++) {
+			ti[i] = loadTI(packets[i]);
+		}
+	}
+
+private:
+	static inline uint32_t loadTI(const uint8_t* packet) {
+		uint32_t raw;
+		std::memcpy(&raw, packet + TimeFieldOffset, sizeof(raw));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+		raw = __builtin_bswap32(raw);
+#endif
+		return raw;
+	}
+
+private:
+	/** Returns the index of the segment that contains ti, starting the search from a hint. */
+	inline size_t findSegment(uint32_t ti, size_t hint = 0) const {
+		const Segment& segment = segments[hint];
+		if (segment.tiBegin <= ti && ti < segment.tiEnd) {
+			return hint;
+		}
+		//segments[i].tiBegin == points[i-1].ti for i >= 1
+		size_t lower = 0, upper = segments.size() - 1;
+		while (lower < upper) {
+			size_t middle = (lower + upper + 1) / 2;
+			if (segments[middle].tiBegin <= ti) {
+				lower = middle;
+			} else {
+				upper = middle - 1;
+			}
+		}
+		return lower;
+	}
+
+private:
+	void buildSegments() {
+		const double infinity = std::numeric_limits<double>::infinity();
+		segments.clear();
+		if (points.size() < 2) {
+			Segment segment;
+			segment.tiBegin = -infinity;
+			segment.tiEnd = infinity;
+			segment.tiBase = points.empty() ? 0 : points[0].ti;
+			segment.utcBase = points.empty() ? 0 : points[0].utc;
+			segment.secondsPerTick = 1 / timeIndicatorFrequency;
+			setNanosecondFields(segment);
+			segments.push_back(segment);
+			return;
+		}
+		//segments[0] extrapolates the first pair, segments[i] (1 <= i <= n-1) covers [points[i-1], points[i]),
+		//and the last one extrapolates the last pair beyond points[n-1]
+		for (size_t i = 0; i <= points.size(); i++) {
+			size_t left = (i == 0) ? 0 : ((i == points.size()) ? i - 2 : i - 1);
+			Segment segment;
+			segment.tiBegin = (i == 0) ? -infinity : points[i - 1].ti;
+			segment.tiEnd = (i == points.size()) ? infinity : points[i].ti;
+			segment.tiBase = points[left].ti;
+			segment.utcBase = points[left].utc;
+			segment.secondsPerTick = (points[left + 1].utc - points[left].utc)
+					/ ((double) points[left + 1].ti - points[left].ti);
+			setNanosecondFields(segment);
+			segments.push_back(segment);
+		}
+	}
+
+private:
+	static void setNanosecondFields(Segment& segment) {
+		segment.nanosecondsBase = std::llrint(segment.utcBase * 1e9);
+		segment.nanosecondsPerTick = segment.secondsPerTick * 1e9;
+	}
+
+#ifdef CCSDS_TIMECONVERTER_HAS_AVX2
+private:
+	/** Converts 4 TI values to exact doubles (AVX2 has no unsigned conversion). */
+	__attribute__((target("avx2,fma")))
+	static inline __m256d loadTIAsDouble(const uint32_t* ti) {
+		const __m128i signBit = _mm_set1_epi32((int) 0x80000000);
+		__m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i*) ti), signBit);
+		return _mm256_add_pd(_mm256_cvtepi32_pd(v), _mm256_set1_pd(2147483648.0));
+	}
+
+private:
+	/** Processes groups of 4 values whose TIs lie in one segment; a group that crosses
+	 * a segment boundary is converted by the scalar path.
+	 * @returns the first index not processed (the remainder is left to the scalar loop).
+	 */
+	__attribute__((target("avx2,fma")))
+	size_t convertToSecondsAVX2(const uint32_t* ti, size_t n, double* seconds) const {
+		size_t n4 = n / 4 * 4;
+		size_t s = 0;
+		for (size_t i = 0; i < n4; i += 4) {
+			__m256d t = loadTIAsDouble(ti + i);
+			const Segment* segment = &segments[s];
+			if (!inSegment(t, *segment)) {
+				s = findSegment(ti[i], s);
+				segment = &segments[s];
+				if (!inSegment(t, *segment)) {
+					for (size_t j = i; j < i + 4; j++) {
+						seconds[j] = convertToSeconds(ti[j]);
+					}
+					continue;
+				}
+			}
+			__m256d d = _mm256_sub_pd(t, _mm256_set1_pd(segment->tiBase));
+			__m256d v = _mm256_fmadd_pd(d, _mm256_set1_pd(segment->secondsPerTick), _mm256_set1_pd(segment->utcBase));
+			_mm256_storeu_pd(seconds + i, v);
+		}
+		return n4;
+	}
+
+private:
+	/** Same as convertToSecondsAVX2() for nanoseconds. AVX2 has no double-to-int64 conversion,
+	 * so the product is split at 2^32 and the lower part is rounded with the 2^52 magic-number
+	 * trick (round half to even, as llrint()). Exact while |product| < 2^62 ns.
+	 */
+	__attribute__((target("avx2,fma")))
+	size_t convertToNanosecondsAVX2(const uint32_t* ti, size_t n, int64_t* nanoseconds) const {
+		const __m256d magic = _mm256_set1_pd(6755399441055744.0); //2^52 + 2^51
+		const __m256d twoTo32 = _mm256_set1_pd(4294967296.0);
+		const __m256d twoToMinus32 = _mm256_set1_pd(1.0 / 4294967296.0);
+		const __m256d limit = _mm256_set1_pd(4611686018427387904.0); //2^62
+		const __m256d absoluteMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+		size_t n4 = n / 4 * 4;
+		size_t s = 0;
+		for (size_t i = 0; i < n4; i += 4) {
+			__m256d t = loadTIAsDouble(ti + i);
+			const Segment* segment = &segments[s];
+			if (!inSegment(t, *segment)) {
+				s = findSegment(ti[i], s);
+				segment = &segments[s];
+			}
+			__m256d product = _mm256_mul_pd(_mm256_sub_pd(t, _mm256_set1_pd(segment->tiBase)),
+					_mm256_set1_pd(segment->nanosecondsPerTick));
+			__m256d tooLarge = _mm256_cmp_pd(_mm256_and_pd(product, absoluteMask), limit, _CMP_GE_OQ);
+			if (!inSegment(t, *segment) || _mm256_movemask_pd(tooLarge) != 0) {
+				for (size_t j = i; j < i + 4; j++) {
+					nanoseconds[j] = convertToNanoseconds(ti[j]);
+				}
+				continue;
+			}
+			//product = upper * 2^32 + lower (0 <= lower < 2^32); both parts are exact
+			__m256d upper = _mm256_floor_pd(_mm256_mul_pd(product, twoToMinus32));
+			__m256d lower = _mm256_fnmadd_pd(upper, twoTo32, product);
+			__m256i upper64 = _mm256_slli_epi64(_mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(upper)), 32);
+			__m256i lower64 = _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(lower, magic)),
+					_mm256_castpd_si256(magic));
+			__m256i v = _mm256_add_epi64(_mm256_add_epi64(upper64, lower64), _mm256_set1_epi64x(segment->nanosecondsBase));
+			_mm256_storeu_si256((__m256i*) (nanoseconds + i), v);
+		}
+		return n4;
+	}
+
+private:
+	__attribute__((target("avx2,fma")))
+	static inline bool inSegment(__m256d t, const Segment& segment) {
+		__m256d ge = _mm256_cmp_pd(t, _mm256_set1_pd(segment.tiBegin), _CMP_GE_OQ);
+		__m256d lt = _mm256_cmp_pd(t, _mm256_set1_pd(segment.tiEnd), _CMP_LT_OQ);
+		return _mm256_movemask_pd(_mm256_and_pd(ge, lt)) == 0xF;
+	}
+#endif
+};
+
+#endif /* CCSDSTIMECONVERTER_HH_ */
@@ -0,0 +1,447 @@
+/*
+ * CCSDSTransferFrameDecoder.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSTRANSFERFRAMEDECODER_HH_
+#define CCSDSTRANSFERFRAMEDECODER_HH_
+
+#include "CCSDSSpacePacketView.hh"
+#include "CCSDSCRC16.hh"
+#include <vector>
+
+/** A class that represents a read-only view of a CCSDS TM Transfer Frame
+ * held in an external byte array (without the Attached Sync Marker).
+ */
+class CCSDSTransferFrameView {
+public:
+	static const size_t PrimaryHeaderLength = 6;
+	static const size_t OperationalControlFieldLength = 4;
+	static const size_t FrameErrorControlFieldLength = 2;
+	static const uint16_t FirstHeaderPointerNoPacketStart = 0x7FF;
+	static const uint16_t FirstHeaderPointerIdleData = 0x7FE;
+	static const size_t NVirtualChannels = 8;
+
+public:
+	const uint8_t* data;
+	size_t length;
+
+public:
+	CCSDSTransferFrameView(const uint8_t* data, size_t length) {
+		this->data = data;
+		this->length = length;
+	}
+
+public:
+	/** Returns Transfer Frame Version Number (00b for TM). */
+	inline uint8_t getVersionNumber() const {
+		return (data[0] & 0xc0) >> 6;
+	}
+
+public:
+	/** Returns Spacecraft ID. */
+	inline uint16_t getSpacecraftID() const {
+		return ((uint16_t) (data[0] & 0x3F) << 4) + (data[1] >> 4);
+	}
+
+public:
+	/** Returns Virtual Channel ID. */
+	inline uint8_t getVirtualChannelID() const {
+		return (data[1] & 0x0e) >> 1;
+	}
+
+public:
+	/** True if the Operational Control Field is present. */
+	inline bool isOperationalControlFieldPresent() const {
+		return (data[1] & 0x01) != 0x00;
+	}
+
+public:
+	/** Returns Master Channel Frame Count. */
+	inline uint8_t getMasterChannelFrameCount() const {
+		return data[2];
+	}
+
+public:
+	/** Returns Virtual Channel Frame Count. */
+	inline uint8_t getVirtualChannelFrameCount() const {
+		return data[3];
+	}
+
+public:
+	/** True if the Transfer Frame Secondary Header is present. */
+	inline bool isSecondaryHeaderPresent() const {
+		return (data[4] & 0x80) != 0x00;
+	}
+
+public:
+	/** Returns Synchronization Flag (0 for packet data). */
+	inline uint8_t getSynchronizationFlag() const {
+		return (data[4] & 0x40) >> 6;
+	}
+
+public:
+	/** Returns First Header Pointer. */
+	inline uint16_t getFirstHeaderPointer() const {
+		return ((uint16_t) (data[4] & 0x07) << 8) + data[5];
+	}
+
+public:
+	/** Returns the length of the Transfer Frame Secondary Header (0 if absent). */
+	inline size_t getSecondaryHeaderLength() const {
+		return isSecondaryHeaderPresent() ? (size_t) (data[6] & 0x3F) + 1 : 0;
+	}
+
+public:
+	/** Returns the offset of the Transfer Frame Data Field. */
+	inline size_t getDataFieldOffset() const {
+		return PrimaryHeaderLength + getSecondaryHeaderLength();
+	}
+
+public:
+	/** Returns the total length of the Operational Control Field and the Frame Error Control Field.
+	 * @param[in] frameErrorControlFieldPresent true if the frame ends with a 2-byte FECF.
+	 */
+	inline size_t getTrailerLength(bool frameErrorControlFieldPresent) const {
+		return (isOperationalControlFieldPresent() ? OperationalControlFieldLength : 0)
+				+ (frameErrorControlFieldPresent ? FrameErrorControlFieldLength : 0);
+	}
+
+public:
+	/** Checks that the frame is long enough for its headers and trailer.
+	 * The other accessors may be used only when this returns true.
+	 * @param[in] frameErrorControlFieldPresent true if the frame ends with a 2-byte FECF.
+	 */
+	inline bool isLengthValid(bool frameErrorControlFieldPresent) const {
+		if (length < PrimaryHeaderLength + (frameErrorControlFieldPresent ? FrameErrorControlFieldLength : 0)) {
+			return false;
+		}
+		if (isSecondaryHeaderPresent() && length <= PrimaryHeaderLength) {
+			return false;
+		}
+		return getDataFieldOffset() + getTrailerLength(frameErrorControlFieldPresent) <= length;
+	}
+
+public:
+	/** Returns the length of the Transfer Frame Data Field (0 if isLengthValid() is false).
+	 * @param[in] frameErrorControlFieldPresent true if the frame ends with a 2-byte FECF.
+	 */
+	inline size_t getDataFieldLength(bool frameErrorControlFieldPresent) const {
+		if (!isLengthValid(frameErrorControlFieldPresent)) {
+			return 0;
+		}
+		return length - getDataFieldOffset() - getTrailerLength(frameErrorControlFieldPresent);
+	}
+};
+
+/** An interface that receives packets extracted by CCSDSTransferFrameDecoder.
+ */
+class CCSDSTransferFrameDecoderListener {
+public:
+	virtual ~CCSDSTransferFrameDecoderListener() {
+	}
+
+public:
+	/** Invoked for each extracted packet.
+	 * The view is valid only during this call; it points into the frame when the packet
+	 * fits in a single frame, or into the reassembly buffer of the Virtual Channel otherwise.
+	 * @param[in] virtualChannelID Virtual Channel ID of the frame(s) that carried the packet.
+	 * @param[in] view the packet.
+	 */
+	virtual void onPacket(uint8_t virtualChannelID, const CCSDSSpacePacketView& view) = 0;
+};
+
+/** A class that extracts CCSDS SpacePackets from fixed-length CCSDS TM Transfer Frames.
+ * Packets are reassembled per Virtual Channel across frame boundaries using the
+ * First Header Pointer. Frames that carry only idle data, and Idle Packets
+ * (APID 0x7FF), are skipped. When a Virtual Channel Frame Count jump or an invalid
+ * packet header is found, the partial packet of the Virtual Channel is discarded
+ * and extraction restarts at the next First Header Pointer (in the same frame when
+ * the invalid header belonged to a packet continued from a previous frame).
+ * Frames too short for their headers and trailer are counted as frame errors.
+ * Packets contained in one frame are passed to the listener without copy.
+ *
+ * @par
+ * Example:
+ * @code
+ class MyListener: public CCSDSTransferFrameDecoderListener {
+ public:
+ 	void onPacket(uint8_t virtualChannelID, const CCSDSSpacePacketView& view) {
+ 		...
+ 	}
+ };
+ MyListener listener;
+ CCSDSTransferFrameDecoder decoder(1115, &listener);
+ decoder.setFrameErrorControlFieldPresent(true);
+ decoder.decode(frames, nFrames);
+ * @endcode
+ */
+class CCSDSTransferFrameDecoder {
+private:
+	class VirtualChannel {
+	public:
+		bool synchronized;
+		bool hasFrameCount;
+		uint8_t lastFrameCount;
+		std::vector<uint8_t> partialPacket;
+	};
+
+private:
+	size_t frameLength;
+	bool frameErrorControlFieldPresent;
+	CCSDSTransferFrameDecoderListener* listener;
+	VirtualChannel virtualChannels[CCSDSTransferFrameView::NVirtualChannels];
+	uint64_t nFrames;
+	uint64_t nIdleFrames;
+	uint64_t nFrameErrors;
+	uint64_t nPackets;
+	uint64_t nIdlePackets;
+	uint64_t nFrameCountJumps;
+	uint64_t nDiscardedPartialPackets;
+
+public:
+	/** Constructs an instance.
+	 * @param[in] frameLength fixed length of Transfer Frames in bytes.
+	 * @param[in] listener a listener that receives extracted packets (not deleted by this class).
+	 */
+	CCSDSTransferFrameDecoder(size_t frameLength, CCSDSTransferFrameDecoderListener* listener) {
+		this->frameLength = frameLength;
+		this->listener = listener;
+		this->frameErrorControlFieldPresent = false;
+		for (size_t i = 0; i < CCSDSTransferFrameView::NVirtualChannels; i++) {
+			virtualChannels[i].synchronized = false;
+			virtualChannels[i].hasFrameCount = false;
+			virtualChannels[i].lastFrameCount = 0;
+			virtualChannels[i].partialPacket.reserve(CCSDSSpacePacketView::MaximumPacketLength);
+		}
+		resetCounters();
+	}
+
+public:
+	/** Sets whether frames end with a Frame Error Control Field (CRC-16).
+	 * When set, frames with a mismatching CRC are discarded.
+	 */
+	void setFrameErrorControlFieldPresent(bool frameErrorControlFieldPresent) {
+		this->frameErrorControlFieldPresent = frameErrorControlFieldPresent;
+	}
+
+public:
+	/** Returns the fixed frame length. */
+	size_t getFrameLength() const {
+		return frameLength;
+	}
+
+public:
+	/** Decodes consecutive frames stored back to back.
+	 * @param[in] frames a pointer to the first frame.
+	 * @param[in] nFrames number of frames.
+	 */
+	void decode(const uint8_t* frames, size_t nFrames) {
+		for (size_t i = 0; i < nFrames; i++) {
+			decode(frames + i * frameLength);
+		}
+	}
+
+public:
+	/** Decodes a frame of the fixed frame length. */
+	void decode(const uint8_t* frameData) {
+		CCSDSTransferFrameView frame(frameData, frameLength);
+		nFrames++;
+		if (frameLength < CCSDSTransferFrameView::PrimaryHeaderLength
+				+ (frameErrorControlFieldPresent ? CCSDSTransferFrameView::FrameErrorControlFieldLength : 0)) {
+			nFrameErrors++;
+			return;
+		}
+		if (frameErrorControlFieldPresent && !CCSDSCRC16::verify(frameData, frameLength)) {
+			nFrameErrors++;
+			return;
+		}
+		VirtualChannel& vc = virtualChannels[frame.getVirtualChannelID()];
+		uint8_t frameCount = frame.getVirtualChannelFrameCount();
+		if (vc.hasFrameCount && frameCount != (uint8_t) (vc.lastFrameCount + 1)) {
+			nFrameCountJumps++;
+			loseSynchronization(vc);
+		}
+		vc.hasFrameCount = true;
+		vc.lastFrameCount = frameCount;
+
+		uint16_t firstHeaderPointer = frame.getFirstHeaderPointer();
+		if (firstHeaderPointer == CCSDSTransferFrameView::FirstHeaderPointerIdleData) {
+			nIdleFrames++;
+			return;
+		}
+		if (!frame.isLengthValid(frameErrorControlFieldPresent)) {
+			//e.g. a corrupted Secondary Header length
+			nFrameErrors++;
+			loseSynchronization(vc);
+			return;
+		}
+		const uint8_t* dataField = frameData + frame.getDataFieldOffset();
+		size_t dataFieldLength = frame.getDataFieldLength(frameErrorControlFieldPresent);
+		if (firstHeaderPointer != CCSDSTransferFrameView::FirstHeaderPointerNoPacketStart
+				&& firstHeaderPointer >= dataFieldLength) {
+			//inconsistent pointer
+			nFrameErrors++;
+			loseSynchronization(vc);
+			return;
+		}
+		uint8_t vcid = frame.getVirtualChannelID();
+
+		//continue a packet started in a previous frame
+		size_t position = 0;
+		if (vc.synchronized && !vc.partialPacket.empty()) {
+			size_t end = (firstHeaderPointer == CCSDSTransferFrameView::FirstHeaderPointerNoPacketStart) ?
+					dataFieldLength : firstHeaderPointer;
+			position = appendToPartialPacket(vcid, vc, dataField, end);
+		}
+
+		//start at the First Header Pointer if not synchronized (also when the continued packet was invalid)
+		if (firstHeaderPointer == CCSDSTransferFrameView::FirstHeaderPointerNoPacketStart) {
+			return;
+		}
+		if (!vc.synchronized) {
+			vc.synchronized = true;
+			position = firstHeaderPointer;
+		} else if (position != firstHeaderPointer || !vc.partialPacket.empty()) {
+			//the previous packet did not end where the First Header Pointer says
+			if (!vc.partialPacket.empty()) {
+				nDiscardedPartialPackets++;
+				vc.partialPacket.clear();
+			}
+			position = firstHeaderPointer;
+		}
+
+		//packets starting in this frame
+		while (position < dataFieldLength) {
+			size_t remaining = dataFieldLength - position;
+			const uint8_t* packet = dataField + position;
+			if (remaining < CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength) {
+				vc.partialPacket.assign(packet, packet + remaining);
+				return;
+			}
+			if ((packet[0] & 0xe0) != 0x00) {
+				nFrameErrors++;
+				loseSynchronization(vc);
+				return;
+			}
+			size_t totalPacketLength = CCSDSSpacePacketView::peekTotalPacketLength(packet);
+			if (totalPacketLength > remaining) {
+				vc.partialPacket.assign(packet, packet + remaining);
+				return;
+			}
+			emit(vcid, CCSDSSpacePacketView(packet, totalPacketLength));
+			position += totalPacketLength;
+		}
+	}
+
+private:
+	/** Appends data to the partial packet until it is complete or the data end.
+	 * @returns the number of bytes consumed.
+	 */
+	size_t appendToPartialPacket(uint8_t vcid, VirtualChannel& vc, const uint8_t* data, size_t length) {
+		size_t position = 0;
+		if (vc.partialPacket.size() < CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength) {
+			size_t n = CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength - vc.partialPacket.size();
+			n = (n < length) ? n : length;
+			vc.partialPacket.insert(vc.partialPacket.end(), data, data + n);
+			position = n;
+			if (vc.partialPacket.size() < CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength) {
+				return position;
+			}
+			if ((vc.partialPacket[0] & 0xe0) != 0x00) {
+				nFrameErrors++;
+				loseSynchronization(vc);
+				return position;
+			}
+		}
+		size_t totalPacketLength = CCSDSSpacePacketView::peekTotalPacketLength(&vc.partialPacket[0]);
+		size_t n = totalPacketLength - vc.partialPacket.size();
+		n = (n < length - position) ? n : length - position;
+		vc.partialPacket.insert(vc.partialPacket.end(), data + position, data + position + n);
+		position += n;
+		if (vc.partialPacket.size() == totalPacketLength) {
+			emit(vcid, CCSDSSpacePacketView(&vc.partialPacket[0], totalPacketLength));
+			vc.partialPacket.clear();
+		}
+		return position;
+	}
+
+private:
+	void loseSynchronization(VirtualChannel& vc) {
+		if (!vc.partialPacket.empty()) {
+			nDiscardedPartialPackets++;
+			vc.partialPacket.clear();
+		}
+		vc.synchronized = false;
+	}
+
+private:
+	inline void emit(uint8_t vcid, const CCSDSSpacePacketView& view) {
+		if (view.isIdlePacket()) {
+			nIdlePackets++;
+			return;
+		}
+		nPackets++;
+		listener->onPacket(vcid, view);
+	}
+
+public:
+	/** Returns the number of decoded frames. */
+	uint64_t getNumberOfFrames() const {
+		return nFrames;
+	}
+
+public:
+	/** Returns the number of frames that carried only idle data. */
+	uint64_t getNumberOfIdleFrames() const {
+		return nIdleFrames;
+	}
+
+public:
+	/** Returns the number of frames with a CRC mismatch, an invalid First Header Pointer,
+	 * or an invalid packet header.
+	 */
+	uint64_t getNumberOfFrameErrors() const {
+		return nFrameErrors;
+	}
+
+public:
+	/** Returns the number of packets passed to the listener. */
+	uint64_t getNumberOfPackets() const {
+		return nPackets;
+	}
+
+public:
+	/** Returns the number of skipped Idle Packets. */
+	uint64_t getNumberOfIdlePackets() const {
+		return nIdlePackets;
+	}
+
+public:
+	/** Returns the number of Virtual Channel Frame Count discontinuities. */
+	uint64_t getNumberOfFrameCountJumps() const {
+		return nFrameCountJumps;
+	}
+
+public:
+	/** Returns the number of partially received packets that were discarded. */
+	uint64_t getNumberOfDiscardedPartialPackets() const {
+		return nDiscardedPartialPackets;
+	}
+
+public:
+	/** Resets counters. */
+	void resetCounters() {
+		nFrames = 0;
+		nIdleFrames = 0;
+		nFrameErrors = 0;
+		nPackets = 0;
+		nIdlePackets = 0;
+		nFrameCountJumps = 0;
+		nDiscardedPartialPackets = 0;
+	}
+};
+
+#endif /* CCSDSTRANSFERFRAMEDECODER_HH_ */
@@ -0,0 +1,575 @@
+/*
+ * CCSDSTransferFrameMultiplexer.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSTRANSFERFRAMEMULTIPLEXER_HH_
+#define CCSDSTRANSFERFRAMEMULTIPLEXER_HH_
+
+#include "CCSDSTransferFrameDecoder.hh"
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+
+class CCSDSTransferFrameMultiplexerException {
+public:
+	CCSDSTransferFrameMultiplexerException(std::string str) {
+		message = str;
+	}
+
+public:
+	std::string toString() {
+		return message;
+	}
+
+public:
+	std::string message;
+};
+
+/** A class that packs CCSDS SpacePackets into fixed-length CCSDS TM Transfer Frames.
+ * Packets are queued per Virtual Channel in preallocated ring buffers, and each frame
+ * is built in place in a caller-supplied (or internal) buffer without allocation.
+ *
+ * Virtual Channels are scheduled frame by frame: among channels that have queued data,
+ * those with the highest priority are served first, and channels of the same priority
+ * share frames in proportion to their weights (smooth weighted round robin).
+ * When the selected channel runs out of packets in the middle of a frame, the rest of
+ * the frame is filled with an Idle Packet (APID 0x7FF) sized to end with the frame;
+ * when no channel has data, an Idle Frame (First Header Pointer 0x7FE) is generated.
+ * Only when fewer bytes than the smallest Idle Packet remain does the Idle Packet
+ * continue into the channel's next frame; those few bytes do not count as queued data,
+ * so they never cause a frame to be scheduled on their own.
+ *
+ * This class is not thread safe; push() and buildFrame() must be called from one thread.
+ *
+ * @par
+ * Example:
+ * @code
+ CCSDSTransferFrameMultiplexer multiplexer(1115, 0x123);
+ multiplexer.setFrameErrorControlFieldPresent(true);
+ multiplexer.addVirtualChannel(0, 1, 1); //VCID 0, high priority (e.g. housekeeping)
+ multiplexer.addVirtualChannel(1, 0, 3); //VCID 1 and 2 share the rest 3:1
+ multiplexer.addVirtualChannel(2, 0, 1);
+ multiplexer.push(1, packet);
+ CCSDSFramePacer pacer(8000); //8000 frames/s
+ while (running) {
+ 	const uint8_t* frame = multiplexer.buildFrame();
+ 	pacer.wait();
+ 	send(frame, multiplexer.getFrameLength());
+ }
+ * @endcode
+ * @see CCSDSTransferFrameDecoder
+ */
+class CCSDSTransferFrameMultiplexer {
+public:
+	static const size_t DefaultQueueSize = 1024 * 1024;
+	static const uint8_t DefaultIdleFrameVirtualChannelID = 7;
+
+	/** The smallest Idle Packet (Primary Header + 1 byte). */
+	static const size_t MinimumIdlePacketLength = CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength + 1;
+
+	/** The largest TM Transfer Frame (keeps First Header Pointers below 0x7FE and Idle Packet lengths in 16 bits). */
+	static const size_t MaximumFrameLength = 2048;
+
+private:
+	class VirtualChannel {
+	public:
+		bool enabled;
+		int priority;
+		int64_t weight;
+		int64_t currentWeight;
+		uint8_t frameCount;
+		std::vector<uint8_t> queue;
+		size_t queueCapacity;
+		size_t head;
+		size_t size;
+		size_t remainingBytesOfCurrentPacket;
+		bool currentPacketIsIdle;
+		uint64_t nPackets;
+		uint64_t nRejectedPackets;
+		uint64_t nFrames;
+	};
+
+private:
+	size_t frameLength;
+	uint16_t spacecraftID;
+	bool frameErrorControlFieldPresent;
+	bool operationalControlFieldPresent;
+	uint32_t operationalControlField;
+	uint8_t idleFrameVirtualChannelID;
+	uint8_t masterChannelFrameCount;
+	uint16_t idlePacketSequenceCount;
+	VirtualChannel virtualChannels[CCSDSTransferFrameView::NVirtualChannels];
+	std::vector<uint8_t> frameBuffer;
+	uint64_t nFrames;
+	uint64_t nIdleFrames;
+	uint64_t nIdlePackets;
+
+public:
+	/** Constructs an instance.
+	 * @param[in] frameLength fixed length of Transfer Frames in bytes (up to MaximumFrameLength).
+	 * @param[in] spacecraftID 10-bit Spacecraft ID.
+	 */
+	CCSDSTransferFrameMultiplexer(size_t frameLength, uint16_t spacecraftID) {
+		if (frameLength < CCSDSTransferFrameView::PrimaryHeaderLength + CCSDSTransferFrameView::OperationalControlFieldLength
+				+ CCSDSTransferFrameView::FrameErrorControlFieldLength + MinimumIdlePacketLength) {
+			throw CCSDSTransferFrameMultiplexerException("CCSDSTransferFrameMultiplexer: frame length too short");
+		}
+		if (frameLength > MaximumFrameLength) {
+			throw CCSDSTransferFrameMultiplexerException("CCSDSTransferFrameMultiplexer: frame length too long");
+		}
+		this->frameLength = frameLength;
+		this->spacecraftID = spacecraftID & 0x3FF;
+		this->frameErrorControlFieldPresent = false;
+		this->operationalControlFieldPresent = false;
+		this->operationalControlField = 0;
+		this->idleFrameVirtualChannelID = DefaultIdleFrameVirtualChannelID;
+		this->masterChannelFrameCount = 0;
+		this->idlePacketSequenceCount = 0;
+		for (size_t i = 0; i < CCSDSTransferFrameView::NVirtualChannels; i++) {
+			VirtualChannel& vc = virtualChannels[i];
+			vc.enabled = false;
+			vc.priority = 0;
+			vc.weight = 1;
+			vc.currentWeight = 0;
+			vc.frameCount = 0;
+			vc.queueCapacity = 0;
+			vc.head = 0;
+			vc.size = 0;
+			vc.remainingBytesOfCurrentPacket = 0;
+			vc.currentPacketIsIdle = false;
+			vc.nPackets = 0;
+			vc.nRejectedPackets = 0;
+			vc.nFrames = 0;
+		}
+		frameBuffer.resize(frameLength);
+		nFrames = 0;
+		nIdleFrames = 0;
+		nIdlePackets = 0;
+	}
+
+public:
+	/** Enables a Virtual Channel.
+	 * @param[in] virtualChannelID 0-7.
+	 * @param[in] priority channels with larger priority are served first.
+	 * @param[in] weight share of frames among channels of the same priority (1 or larger).
+	 * @param[in] queueSize capacity of the packet queue in bytes (allocated here).
+	 */
+	void addVirtualChannel(uint8_t virtualChannelID, int priority = 0, uint32_t weight = 1,
+			size_t queueSize = DefaultQueueSize) {
+		if (virtualChannelID >= CCSDSTransferFrameView::NVirtualChannels) {
+			throw CCSDSTransferFrameMultiplexerException("CCSDSTransferFrameMultiplexer: invalid Virtual Channel ID");
+		}
+		VirtualChannel& vc = virtualChannels[virtualChannelID];
+		vc.enabled = true;
+		vc.priority = priority;
+		vc.weight = (weight == 0) ? 1 : weight;
+		vc.currentWeight = 0;
+		vc.queueCapacity = queueSize;
+		//room for an Idle Packet that fills the rest of a frame is added on top of the capacity
+		vc.queue.assign(queueSize + frameLength + MinimumIdlePacketLength, 0);
+		vc.head = 0;
+		vc.size = 0;
+		vc.remainingBytesOfCurrentPacket = 0;
+		vc.currentPacketIsIdle = false;
+	}
+
+public:
+	/** Sets whether frames end with a Frame Error Control Field (CRC-16). */
+	void setFrameErrorControlFieldPresent(bool frameErrorControlFieldPresent) {
+		this->frameErrorControlFieldPresent = frameErrorControlFieldPresent;
+	}
+
+public:
+	/** Sets whether frames carry an Operational Control Field.
+	 * @param[in] operationalControlFieldPresent true to add the 4-byte field.
+	 * @param[in] operationalControlField the content (e.g. CLCW) written to every frame.
+	 */
+	void setOperationalControlField(bool operationalControlFieldPresent, uint32_t operationalControlField = 0) {
+		this->operationalControlFieldPresent = operationalControlFieldPresent;
+		this->operationalControlField = operationalControlField;
+	}
+
+public:
+	/** Sets the Virtual Channel ID used for Idle Frames (default 7). */
+	void setIdleFrameVirtualChannelID(uint8_t virtualChannelID) {
+		this->idleFrameVirtualChannelID = virtualChannelID & 0x07;
+	}
+
+public:
+	/** Returns the fixed frame length. */
+	size_t getFrameLength() const {
+		return frameLength;
+	}
+
+public:
+	/** Returns the length of the Transfer Frame Data Field. */
+	size_t getDataFieldLength() const {
+		return frameLength - CCSDSTransferFrameView::PrimaryHeaderLength
+				- (operationalControlFieldPresent ? CCSDSTransferFrameView::OperationalControlFieldLength : 0)
+				- (frameErrorControlFieldPresent ? CCSDSTransferFrameView::FrameErrorControlFieldLength : 0);
+	}
+
+public:
+	/** Queues a packet to a Virtual Channel (copied).
+	 * @param[in] virtualChannelID an enabled Virtual Channel.
+	 * @param[in] data a pointer to a whole packet.
+	 * @param[in] length the length of the packet.
+	 * @returns false if the queue does not have room for the packet (the packet is not queued).
+	 */
+	bool push(uint8_t virtualChannelID, const uint8_t* data, size_t length) {
+		VirtualChannel& vc = getVirtualChannel(virtualChannelID);
+		if (length < CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength
+				|| CCSDSSpacePacketView::peekTotalPacketLength(data) != length) {
+			throw CCSDSTransferFrameMultiplexerException("CCSDSTransferFrameMultiplexer: inconsistent packet length");
+		}
+		if (vc.size + length > vc.queueCapacity) {
+			vc.nRejectedPackets++;
+			return false;
+		}
+		enqueue(vc, data, length);
+		vc.nPackets++;
+		return true;
+	}
+
+public:
+	/** Queues a packet to a Virtual Channel (copied). */
+	bool push(uint8_t virtualChannelID, const CCSDSSpacePacketView& view) {
+		return push(virtualChannelID, view.data, view.length);
+	}
+
+public:
+	/** Queues a packet to a Virtual Channel (serialized with getAsByteVector()). */
+	bool push(uint8_t virtualChannelID, CCSDSSpacePacket* packet) {
+		std::vector<uint8_t> data = packet->getAsByteVector();
+		return push(virtualChannelID, &data[0], data.size());
+	}
+
+public:
+	/** Returns the number of bytes queued to a Virtual Channel. */
+	size_t getQueuedBytes(uint8_t virtualChannelID) {
+		return getVirtualChannel(virtualChannelID).size;
+	}
+
+public:
+	/** Builds the next frame in the internal buffer.
+	 * @returns a pointer to the frame, valid until the next call.
+	 */
+	const uint8_t* buildFrame() {
+		buildFrame(&frameBuffer[0]);
+		return &frameBuffer[0];
+	}
+
+public:
+	/** Builds the next frame in place.
+	 * @param[out] frame a buffer of at least getFrameLength() bytes.
+	 * @returns Virtual Channel ID of the built frame.
+	 */
+	uint8_t buildFrame(uint8_t* frame) {
+		int selected = selectVirtualChannel();
+		size_t dataFieldLength = getDataFieldLength();
+		uint8_t* dataField = frame + CCSDSTransferFrameView::PrimaryHeaderLength;
+		uint8_t virtualChannelID;
+		uint16_t firstHeaderPointer;
+		uint8_t virtualChannelFrameCount;
+		if (selected < 0) {
+			virtualChannelID = idleFrameVirtualChannelID;
+			firstHeaderPointer = CCSDSTransferFrameView::FirstHeaderPointerIdleData;
+			virtualChannelFrameCount = virtualChannels[virtualChannelID].frameCount++;
+			memset(dataField, 0x55, dataFieldLength);
+			nIdleFrames++;
+		} else {
+			VirtualChannel& vc = virtualChannels[selected];
+			virtualChannelID = selected;
+			firstHeaderPointer = fillDataField(vc, dataField, dataFieldLength);
+			virtualChannelFrameCount = vc.frameCount++;
+			vc.nFrames++;
+		}
+
+		//Primary Header (Version 00b, no Secondary Header, Segment Length ID 11b)
+		frame[0] = (spacecraftID >> 4) & 0x3F;
+		frame[1] = ((spacecraftID & 0x0F) << 4) | (virtualChannelID << 1) | (operationalControlFieldPresent ? 0x01 : 0x00);
+		frame[2] = masterChannelFrameCount++;
+		frame[3] = virtualChannelFrameCount;
+		frame[4] = 0x18 | ((firstHeaderPointer >> 8) & 0x07);
+		frame[5] = firstHeaderPointer & 0xFF;
+
+		uint8_t* trailer = dataField + dataFieldLength;
+		if (operationalControlFieldPresent) {
+			trailer[0] = operationalControlField >> 24;
+			trailer[1] = operationalControlField >> 16;
+			trailer[2] = operationalControlField >> 8;
+			trailer[3] = operationalControlField;
+			trailer += CCSDSTransferFrameView::OperationalControlFieldLength;
+		}
+		if (frameErrorControlFieldPresent) {
+			uint16_t crc = CCSDSCRC16::calculate(frame, frameLength - CCSDSTransferFrameView::FrameErrorControlFieldLength);
+			trailer[0] = crc >> 8;
+			trailer[1] = crc & 0xFF;
+		}
+		nFrames++;
+		return virtualChannelID;
+	}
+
+public:
+	/** Builds consecutive frames stored back to back.
+	 * @param[out] frames a buffer of at least nFrames * getFrameLength() bytes.
+	 * @param[in] nFrames number of frames.
+	 */
+	void buildFrames(uint8_t* frames, size_t nFrames) {
+		for (size_t i = 0; i < nFrames; i++) {
+			buildFrame(frames + i * frameLength);
+		}
+	}
+
+private:
+	VirtualChannel& getVirtualChannel(uint8_t virtualChannelID) {
+		if (virtualChannelID >= CCSDSTransferFrameView::NVirtualChannels || !virtualChannels[virtualChannelID].enabled) {
+			throw CCSDSTransferFrameMultiplexerException("CCSDSTransferFrameMultiplexer: Virtual Channel not enabled");
+		}
+		return virtualChannels[virtualChannelID];
+	}
+
+private:
+	/** True if a Virtual Channel has queued bytes other than the rest of a started Idle Packet. */
+	inline bool hasPacketData(const VirtualChannel& vc) const {
+		return vc.size > (vc.currentPacketIsIdle ? vc.remainingBytesOfCurrentPacket : 0);
+	}
+
+private:
+	/** Selects the Virtual Channel of the next frame, or returns -1 for an Idle Frame. */
+	int selectVirtualChannel() {
+		bool found = false;
+		int highestPriority = 0;
+		for (size_t i = 0; i < CCSDSTransferFrameView::NVirtualChannels; i++) {
+			const VirtualChannel& vc = virtualChannels[i];
+			if (vc.enabled && hasPacketData(vc) && (!found || vc.priority > highestPriority)) {
+				highestPriority = vc.priority;
+				found = true;
+			}
+		}
+		if (!found) {
+			return -1;
+		}
+		//smooth weighted round robin among channels of the highest priority
+		int selected = -1;
+		int64_t totalWeight = 0;
+		for (size_t i = 0; i < CCSDSTransferFrameView::NVirtualChannels; i++) {
+			VirtualChannel& vc = virtualChannels[i];
+			if (vc.enabled && hasPacketData(vc) && vc.priority == highestPriority) {
+				vc.currentWeight += vc.weight;
+				totalWeight += vc.weight;
+				if (selected < 0 || vc.currentWeight > virtualChannels[selected].currentWeight) {
+					selected = i;
+				}
+			}
+		}
+		virtualChannels[selected].currentWeight -= totalWeight;
+		return selected;
+	}
+
+private:
+	/** Moves queued bytes of a Virtual Channel to a Transfer Frame Data Field.
+	 * @returns First Header Pointer.
+	 */
+	uint16_t fillDataField(VirtualChannel& vc, uint8_t* dataField, size_t dataFieldLength) {
+		uint16_t firstHeaderPointer = CCSDSTransferFrameView::FirstHeaderPointerNoPacketStart;
+		size_t position = 0;
+		while (position < dataFieldLength) {
+			if (vc.size == 0) {
+				//fill the rest of the frame (a few bytes continue into the next frame if less than the minimum)
+				size_t idlePacketLength = dataFieldLength - position;
+				enqueueIdlePacket(vc,
+						(idlePacketLength < MinimumIdlePacketLength) ? MinimumIdlePacketLength : idlePacketLength);
+			}
+			if (vc.remainingBytesOfCurrentPacket == 0) {
+				if (firstHeaderPointer == CCSDSTransferFrameView::FirstHeaderPointerNoPacketStart) {
+					firstHeaderPointer = position;
+				}
+				vc.remainingBytesOfCurrentPacket = CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength
+						+ ((size_t) peekQueue(vc, 4) << 8) + peekQueue(vc, 5) + 1;
+				vc.currentPacketIsIdle = ((peekQueue(vc, 0) & 0x07) == (CCSDSSpacePacket::APIDOfIdlePacket >> 8)
+						&& peekQueue(vc, 1) == (CCSDSSpacePacket::APIDOfIdlePacket & 0xFF));
+			}
+			size_t n = dataFieldLength - position;
+			n = (n < vc.remainingBytesOfCurrentPacket) ? n : vc.remainingBytesOfCurrentPacket;
+			dequeue(vc, dataField + position, n);
+			position += n;
+			vc.remainingBytesOfCurrentPacket -= n;
+		}
+		return firstHeaderPointer;
+	}
+
+private:
+	void enqueueIdlePacket(VirtualChannel& vc, size_t length) {
+		uint8_t header[CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength];
+		size_t packetDataLength = length - CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength - 1;
+		header[0] = (CCSDSSpacePacket::APIDOfIdlePacket >> 8) & 0x07;
+		header[1] = CCSDSSpacePacket::APIDOfIdlePacket & 0xFF;
+		header[2] = 0xC0 | ((idlePacketSequenceCount >> 8) & 0x3F);
+		header[3] = idlePacketSequenceCount & 0xFF;
+		header[4] = packetDataLength >> 8;
+		header[5] = packetDataLength & 0xFF;
+		idlePacketSequenceCount = (idlePacketSequenceCount + 1) & 0x3FFF;
+		enqueue(vc, header, sizeof(header));
+		//the queue has been emptied, so the idle pattern can be written contiguously or in two parts
+		size_t tail = (vc.head + vc.size) % vc.queue.size();
+		size_t n = length - sizeof(header);
+		size_t first = vc.queue.size() - tail;
+		first = (first < n) ? first : n;
+		memset(&vc.queue[tail], 0x55, first);
+		memset(&vc.queue[0], 0x55, n - first);
+		vc.size += n;
+		nIdlePackets++;
+	}
+
+private:
+	inline uint8_t peekQueue(const VirtualChannel& vc, size_t offset) const {
+		size_t index = vc.head + offset;
+		return vc.queue[(index < vc.queue.size()) ? index : index - vc.queue.size()];
+	}
+
+private:
+	void enqueue(VirtualChannel& vc, const uint8_t* data, size_t length) {
+		size_t tail = (vc.head + vc.size) % vc.queue.size();
+		size_t first = vc.queue.size() - tail;
+		first = (first < length) ? first : length;
+		memcpy(&vc.queue[tail], data, first);
+		memcpy(&vc.queue[0], data + first, length - first);
+		vc.size += length;
+	}
+
+private:
+	void dequeue(VirtualChannel& vc, uint8_t* destination, size_t length) {
+		size_t first = vc.queue.size() - vc.head;
+		first = (first < length) ? first : length;
+		memcpy(destination, &vc.queue[vc.head], first);
+		memcpy(destination + first, &vc.queue[0], length - first);
+		vc.head = (vc.head + length) % vc.queue.size();
+		vc.size -= length;
+	}
+
+public:
+	/** Returns the number of built frames. */
+	uint64_t getNumberOfFrames() const {
+		return nFrames;
+	}
+
+public:
+	/** Returns the number of built Idle Frames. */
+	uint64_t getNumberOfIdleFrames() const {
+		return nIdleFrames;
+	}
+
+public:
+	/** Returns the number of inserted Idle Packets. */
+	uint64_t getNumberOfIdlePackets() const {
+		return nIdlePackets;
+	}
+
+public:
+	/** Returns the number of frames built for a Virtual Channel (Idle Frames excluded). */
+	uint64_t getNumberOfFrames(uint8_t virtualChannelID) {
+		return getVirtualChannel(virtualChannelID).nFrames;
+	}
+
+public:
+	/** Returns the number of packets queued to a Virtual Channel. */
+	uint64_t getNumberOfPackets(uint8_t virtualChannelID) {
+		return getVirtualChannel(virtualChannelID).nPackets;
+	}
+
+public:
+	/** Returns the number of packets rejected because the queue was full. */
+	uint64_t getNumberOfRejectedPackets(uint8_t virtualChannelID) {
+		return getVirtualChannel(virtualChannelID).nRejectedPackets;
+	}
+};
+
+/** A class that paces a loop at a constant rate (e.g. frames per second).
+ * Deadlines are computed from the start time, so errors do not accumulate.
+ * wait() sleeps until shortly before the deadline and then spins,
+ * trading CPU time for low jitter.
+ */
+class CCSDSFramePacer {
+public:
+	static const int64_t DefaultSpinDurationInNanoseconds = 200000;
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+private:
+	Clock::time_point start;
+	double periodInNanoseconds;
+	int64_t spinDurationInNanoseconds;
+	uint64_t nTicks;
+	uint64_t nLateTicks;
+	int64_t maximumLatenessInNanoseconds;
+	bool started;
+
+public:
+	/** Constructs an instance.
+	 * @param[in] rate number of wait() returns per second.
+	 * @param[in] spinDurationInNanoseconds time before each deadline spent busy waiting.
+	 */
+	CCSDSFramePacer(double rate, int64_t spinDurationInNanoseconds = DefaultSpinDurationInNanoseconds) {
+		this->periodInNanoseconds = 1e9 / rate;
+		this->spinDurationInNanoseconds = spinDurationInNanoseconds;
+		restart();
+	}
+
+public:
+	/** Restarts pacing; the next wait() returns immediately. */
+	void restart() {
+		started = false;
+		nTicks = 0;
+		nLateTicks = 0;
+		maximumLatenessInNanoseconds = 0;
+	}
+
+public:
+	/** Blocks until the next deadline. */
+	void wait() {
+		if (!started) {
+			started = true;
+			start = Clock::now();
+			nTicks = 1;
+			return;
+		}
+		Clock::time_point deadline = start
+				+ std::chrono::nanoseconds((int64_t) (periodInNanoseconds * (double) nTicks));
+		nTicks++;
+		Clock::time_point now = Clock::now();
+		if (now >= deadline) {
+			int64_t lateness = std::chrono::duration_cast<std::chrono::nanoseconds>(now - deadline).count();
+			nLateTicks++;
+			if (lateness > maximumLatenessInNanoseconds) {
+				maximumLatenessInNanoseconds = lateness;
+			}
+			return;
+		}
+		Clock::time_point spinStart = deadline - std::chrono::nanoseconds(spinDurationInNanoseconds);
+		if (now < spinStart) {
+			std::this_thread::sleep_until(spinStart);
+		}
+		while (Clock::now() < deadline) {
+		}
+	}
+
+public:
+	/** Returns the number of wait() calls that found the deadline already passed. */
+	uint64_t getNumberOfLateTicks() const {
+		return nLateTicks;
+	}
+
+public:
+	/** Returns the largest delay of a late wait() call in nanoseconds. */
+	int64_t getMaximumLatenessInNanoseconds() const {
+		return maximumLatenessInNanoseconds;
+	}
+};
+
+#endif /* CCSDSTRANSFERFRAMEMULTIPLEXER_HH_ */
@@ -0,0 +1,361 @@
+/*
+ * CCSDSUDPPacketSource.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSUDPPACKETSOURCE_HH_
+#define CCSDSUDPPACKETSOURCE_HH_
+
+#include "CCSDSPacketSource.hh"
+#include "CCSDSThreadAffinity.hh"
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+class CCSDSUDPPacketSourceException {
+public:
+	CCSDSUDPPacketSourceException(std::string str) {
+		message = str;
+	}
+
+public:
+	std::string toString() {
+		return message;
+	}
+
+public:
+	std::string message;
+};
+
+/** A packet source that receives CCSDS SpacePackets from a UDP socket (Linux).
+ * Datagrams are received in batches with recvmmsg() directly into a preallocated
+ * ring of slots, and all datagrams of a batch are validated at once. A datagram
+ * may carry one or more concatenated packets; trailing bytes that do not form
+ * a plausible packet are counted and ignored. Packets are handed out as views
+ * into the ring, without copy.
+ *
+ * The ring holds nBatches batches. Views returned by receiveBatch() (or next())
+ * stay valid until nBatches - 1 further batches have been received.
+ *
+ * Counters:
+ * - drops: datagrams dropped by the kernel because the socket buffer was full (SO_RXQ_OVFL).
+ * - overruns: batches that were filled completely, i.e. datagrams were waiting in
+ *   the socket buffer when the batch was received (the consumer is falling behind).
+ * - truncated datagrams: datagrams larger than a slot.
+ *
+ * @par
+ * Example:
+ * @code
+ CCSDSUDPPacketSource source(10000);
+ source.setCoreAffinity(2);
+ std::vector<CCSDSSpacePacketView> views;
+ while (source.receiveBatch(views)) {
+ 	for (size_t i = 0; i < views.size(); i++) {
+ 		...
+ 	}
+ }
+ * @endcode
+ */
+class CCSDSUDPPacketSource: public CCSDSPacketSource {
+public:
+	static const size_t DefaultBatchSize = 64;
+	static const size_t DefaultNumberOfBatches = 4;
+	static const size_t DefaultSlotSize = 2048;
+
+private:
+	int socketDescriptor;
+	size_t batchSize;
+	size_t nBatches;
+	size_t slotSize;
+	size_t currentBatch;
+	std::vector<uint8_t> ring;
+	std::vector<uint8_t> controlBuffers;
+	size_t controlBufferSize;
+	std::vector<struct mmsghdr> messages;
+	std::vector<struct iovec> iovecs;
+	std::vector<CCSDSSpacePacketView> pendingViews;
+	size_t pendingPosition;
+	int core;
+	bool affinityApplied;
+	uint32_t lastKernelDropCount;
+	bool hasKernelDropCount;
+	uint64_t nDatagrams;
+	uint64_t nPackets;
+	uint64_t nBytes;
+	uint64_t nInvalidBytes;
+	uint64_t nTruncatedDatagrams;
+	uint64_t nDrops;
+	uint64_t nOverruns;
+	uint64_t nBatchesReceived;
+
+public:
+	/** Constructs an instance and binds a UDP socket.
+	 * @param[in] port UDP port number (0 to let the kernel choose one; see getPort()).
+	 * @param[in] address IPv4 address to bind to.
+	 * @param[in] batchSize maximum number of datagrams received per recvmmsg() call.
+	 * @param[in] nBatches number of batches held in the ring (2 or more).
+	 * @param[in] slotSize maximum datagram size in bytes.
+	 */
+	CCSDSUDPPacketSource(uint16_t port, std::string address = "0.0.0.0", size_t batchSize = DefaultBatchSize,
+			size_t nBatches = DefaultNumberOfBatches, size_t slotSize = DefaultSlotSize) {
+		this->batchSize = (batchSize == 0) ? 1 : batchSize;
+		this->nBatches = (nBatches < 2) ? 2 : nBatches;
+		this->slotSize = (slotSize < CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength) ?
+				CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength : slotSize;
+		socketDescriptor = socket(AF_INET, SOCK_DGRAM, 0);
+		if (socketDescriptor < 0) {
+			throw CCSDSUDPPacketSourceException("CCSDSUDPPacketSource: cannot create a socket");
+		}
+		struct sockaddr_in socketAddress;
+		memset(&socketAddress, 0, sizeof(socketAddress));
+		socketAddress.sin_family = AF_INET;
+		socketAddress.sin_port = htons(port);
+		if (inet_pton(AF_INET, address.c_str(), &socketAddress.sin_addr) != 1) {
+			close(socketDescriptor);
+			throw CCSDSUDPPacketSourceException("CCSDSUDPPacketSource: invalid address " + address);
+		}
+		if (bind(socketDescriptor, (struct sockaddr*) &socketAddress, sizeof(socketAddress)) != 0) {
+			close(socketDescriptor);
+			throw CCSDSUDPPacketSourceException("CCSDSUDPPacketSource: cannot bind to " + address);
+		}
+#ifdef SO_RXQ_OVFL
+		int enable = 1;
+		setsockopt(socketDescriptor, SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable));
+#endif
+
+		//preallocate the ring and the message headers that point into it
+		ring.resize(this->batchSize * this->nBatches * this->slotSize);
+		controlBufferSize = CMSG_SPACE(sizeof(uint32_t));
+		controlBuffers.resize(this->batchSize * this->nBatches * controlBufferSize);
+		messages.resize(this->batchSize * this->nBatches);
+		iovecs.resize(this->batchSize * this->nBatches);
+		for (size_t i = 0; i < messages.size(); i++) {
+			iovecs[i].iov_base = &ring[i * this->slotSize];
+			iovecs[i].iov_len = this->slotSize;
+		}
+		pendingViews.reserve(this->batchSize);
+		pendingPosition = 0;
+		currentBatch = 0;
+		core = -1;
+		affinityApplied = false;
+		lastKernelDropCount = 0;
+		hasKernelDropCount = false;
+		resetCounters();
+	}
+
+public:
+	virtual ~CCSDSUDPPacketSource() {
+		close(socketDescriptor);
+	}
+
+public:
+	/** Returns the bound UDP port number. */
+	uint16_t getPort() const {
+		struct sockaddr_in socketAddress;
+		socklen_t length = sizeof(socketAddress);
+		getsockname(socketDescriptor, (struct sockaddr*) &socketAddress, &length);
+		return ntohs(socketAddress.sin_port);
+	}
+
+public:
+	/** Returns the socket descriptor (e.g. for poll()). */
+	int getSocketDescriptor() const {
+		return socketDescriptor;
+	}
+
+public:
+	/** Sets the kernel receive buffer size (SO_RCVBUF). */
+	void setReceiveBufferSize(int size) {
+		setsockopt(socketDescriptor, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+	}
+
+public:
+	/** Sets a receive timeout; receiveBatch() and next() return false on timeout.
+	 * @param[in] timeoutInMilliseconds 0 to block indefinitely.
+	 */
+	void setReceiveTimeout(size_t timeoutInMilliseconds) {
+		struct timeval timeout;
+		timeout.tv_sec = timeoutInMilliseconds / 1000;
+		timeout.tv_usec = (timeoutInMilliseconds % 1000) * 1000;
+		setsockopt(socketDescriptor, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	}
+
+public:
+	/** Pins the receiving thread to a core.
+	 * The affinity is applied by the thread that next calls receiveBatch() or next().
+	 * @param[in] core a core index (negative to leave the affinity unchanged).
+	 */
+	void setCoreAffinity(int core) {
+		this->core = core;
+		this->affinityApplied = false;
+	}
+
+public:
+	/** Receives a batch of datagrams and returns the packets they contain.
+	 * Blocks until at least one datagram arrives.
+	 * @param[out] views packets of the batch (cleared first).
+	 * @returns false on timeout or error.
+	 */
+	bool receiveBatch(std::vector<CCSDSSpacePacketView>& views) {
+		views.clear();
+		if (!affinityApplied) {
+			CCSDSThreadAffinity::pinCurrentThread(core);
+			affinityApplied = true;
+		}
+		struct mmsghdr* batch = &messages[currentBatch * batchSize];
+		for (size_t i = 0; i < batchSize; i++) {
+			size_t index = currentBatch * batchSize + i;
+			memset(&batch[i].msg_hdr, 0, sizeof(batch[i].msg_hdr));
+			batch[i].msg_hdr.msg_iov = &iovecs[index];
+			batch[i].msg_hdr.msg_iovlen = 1;
+			batch[i].msg_hdr.msg_control = &controlBuffers[index * controlBufferSize];
+			batch[i].msg_hdr.msg_controllen = controlBufferSize;
+		}
+		int n;
+		do {
+			n = recvmmsg(socketDescriptor, batch, batchSize, MSG_WAITFORONE, NULL);
+		} while (n < 0 && errno == EINTR);
+		if (n <= 0) {
+			return false;
+		}
+		nBatchesReceived++;
+		if ((size_t) n == batchSize) {
+			nOverruns++;
+		}
+		for (int i = 0; i < n; i++) {
+			validateDatagram(batch[i], views);
+		}
+		currentBatch = (currentBatch + 1) % nBatches;
+		return true;
+	}
+
+public:
+	/** Retrieves the next packet, receiving a new batch when the current one is consumed.
+	 * @returns false on timeout or error.
+	 */
+	virtual bool next(CCSDSSpacePacketView& view) {
+		while (pendingPosition == pendingViews.size()) {
+			pendingPosition = 0;
+			if (!receiveBatch(pendingViews)) {
+				return false;
+			}
+		}
+		view = pendingViews[pendingPosition];
+		pendingPosition++;
+		return true;
+	}
+
+private:
+	void validateDatagram(struct mmsghdr& message, std::vector<CCSDSSpacePacketView>& views) {
+		nDatagrams++;
+		nBytes += message.msg_len;
+		updateDropCount(message.msg_hdr);
+		if ((message.msg_hdr.msg_flags & MSG_TRUNC) != 0) {
+			nTruncatedDatagrams++;
+			nInvalidBytes += message.msg_len;
+			return;
+		}
+		const uint8_t* data = (const uint8_t*) message.msg_hdr.msg_iov->iov_base;
+		size_t length = message.msg_len;
+		size_t position = 0;
+		while (CCSDSSpacePacketView::isPlausiblePacket(data + position, length - position)) {
+			size_t totalPacketLength = CCSDSSpacePacketView::peekTotalPacketLength(data + position);
+			views.push_back(CCSDSSpacePacketView(data + position, totalPacketLength));
+			position += totalPacketLength;
+			nPackets++;
+		}
+		nInvalidBytes += length - position;
+	}
+
+private:
+	void updateDropCount(struct msghdr& header) {
+#ifdef SO_RXQ_OVFL
+		for (struct cmsghdr* c = CMSG_FIRSTHDR(&header); c != NULL; c = CMSG_NXTHDR(&header, c)) {
+			if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SO_RXQ_OVFL) {
+				uint32_t dropCount;
+				memcpy(&dropCount, CMSG_DATA(c), sizeof(dropCount));
+				//the kernel reports a cumulative count since the socket was created
+				nDrops += hasKernelDropCount ? (uint32_t) (dropCount - lastKernelDropCount) : dropCount;
+				lastKernelDropCount = dropCount;
+				hasKernelDropCount = true;
+			}
+		}
+#else
+		(void) header;
+#endif
+	}
+
+public:
+	/** Returns the number of received datagrams. */
+	uint64_t getNumberOfDatagrams() const {
+		return nDatagrams;
+	}
+
+public:
+	/** Returns the number of packets extracted from datagrams. */
+	uint64_t getNumberOfPackets() const {
+		return nPackets;
+	}
+
+public:
+	/** Returns the number of received bytes. */
+	uint64_t getNumberOfBytes() const {
+		return nBytes;
+	}
+
+public:
+	/** Returns the number of bytes that did not form plausible packets. */
+	uint64_t getNumberOfInvalidBytes() const {
+		return nInvalidBytes;
+	}
+
+public:
+	/** Returns the number of datagrams larger than a slot (discarded). */
+	uint64_t getNumberOfTruncatedDatagrams() const {
+		return nTruncatedDatagrams;
+	}
+
+public:
+	/** Returns the number of datagrams dropped by the kernel (0 if SO_RXQ_OVFL is not supported).
+	 * Drops become visible when a datagram queued after them is received.
+	 */
+	uint64_t getNumberOfDrops() const {
+		return nDrops;
+	}
+
+public:
+	/** Returns the number of batches that were filled completely. */
+	uint64_t getNumberOfOverruns() const {
+		return nOverruns;
+	}
+
+public:
+	/** Returns the number of received batches. */
+	uint64_t getNumberOfBatches() const {
+		return nBatchesReceived;
+	}
+
+public:
+	/** Resets counters. */
+	void resetCounters() {
+		nDatagrams = 0;
+		nPackets = 0;
+		nBytes = 0;
+		nInvalidBytes = 0;
+		nTruncatedDatagrams = 0;
+		nDrops = 0;
+		nOverruns = 0;
+		nBatchesReceived = 0;
+	}
+};
+
+#endif /* CCSDSUDPPACKETSOURCE_HH_ */
@@ -11,6 +11,14 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <functional>
+
+#if (defined(__GXX_EXPERIMENTAL_CXX0X) || (__cplusplus >= 201103L))
+#include <cstdint>
+#include "CCSDSSharedPayload.hh"
+#else
+#include <stdint.h>
+#endif
 
 namespace sib2 {
 
@@ -40,13 +48,27 @@ struct ID{
 	void dump(std::ostream& ost){
 		ost<<std::hex<<"LowerAPID="<<lowerAPID<<", LowerFOID="<<lowerFOID<<", AttributeID="<<attributeID<<", ADUChannelID="<<ADUChannelID<<", ADUCount="<<ADUCount<<", TI="<<TI<<std::endl;
 	}
-	bool operator ==(ID id){
+	bool operator ==(const ID& id) const{
 		return (upperAPID==id.upperAPID&&lowerAPID==id.lowerAPID&&lowerFOID==id.lowerFOID&&attributeID==id.attributeID
 				&&ADUChannelID==id.ADUChannelID && ADUCount==id.ADUCount);
 	}
-	bool operator !=(ID id){
-		return (upperAPID!=id.upperAPID||lowerAPID!=id.lowerAPID||lowerFOID!=id.lowerFOID||attributeID!=id.attributeID
-				||ADUChannelID!=id.ADUChannelID || ADUCount!=id.ADUCount);
+	bool operator !=(const ID& id) const{
+		return !(*this==id);
+	}
+	/** Returns a hash of the fields compared by operator== (TI is not included). */
+	size_t hash() const{
+		uint64_t a = ((uint64_t)upperAPID<<48) | ((uint64_t)lowerAPID<<32) | ((uint64_t)lowerFOID<<16) | attributeID;
+		uint64_t b = ((uint64_t)ADUChannelID<<8) | ADUCount;
+		return (size_t)mix(a ^ mix(b + 0x9e3779b97f4a7c15ULL));
+	}
+	/** 64-bit finalizer of MurmurHash3. */
+	static uint64_t mix(uint64_t x){
+		x ^= x>>33;
+		x *= 0xff51afd7ed558ccdULL;
+		x ^= x>>33;
+		x *= 0xc4ceb9fe1a85ec53ULL;
+		x ^= x>>33;
+		return x;
 	}
 	static const ID& NA(){
 		static const ID NAID;
@@ -78,6 +100,31 @@ public:
 		return packettype==1;
 	}
 	std::vector<uint8_t> data;
+#if (defined(__GXX_EXPERIMENTAL_CXX0X) || (__cplusplus >= 201103L))
+	/** Shared payload; used instead of data when data is empty (see sharePayload()). */
+	CCSDSSharedPayload payload;
+	/** Moves data into the shared payload (once) and returns the payload. */
+	const CCSDSSharedPayload& sharePayload(){
+		if(payload.empty() && !data.empty()){
+			payload = CCSDSSharedPayload(std::move(data));
+			data.clear();
+		}
+		return payload;
+	}
+	const uint8_t* getPayloadData() const{
+		return data.empty() ? payload.data() : &data[0];
+	}
+	size_t getPayloadSize() const{
+		return data.empty() ? payload.size() : data.size();
+	}
+#else
+	const uint8_t* getPayloadData() const{
+		return data.empty() ? NULL : &data[0];
+	}
+	size_t getPayloadSize() const{
+		return data.size();
+	}
+#endif
 };
 
 
@@ -88,6 +135,10 @@ struct UserData{
 //	uint16_t attributeID;
 	ID id;
 	std::vector<uint8_t> data;
+#if (defined(__GXX_EXPERIMENTAL_CXX0X) || (__cplusplus >= 201103L))
+	/** Shared payload; used instead of data when data is empty (see sharePayload()). */
+	CCSDSSharedPayload payload;
+#endif
 	void clear(){
 		id.upperAPID = 0;
 		id.lowerAPID = 0;
@@ -96,12 +147,59 @@ struct UserData{
 		id.ADUChannelID = 0;
 		id.ADUCount = 0;
 		data.clear();
+#if (defined(__GXX_EXPERIMENTAL_CXX0X) || (__cplusplus >= 201103L))
+		payload.reset();
+#endif
 	}
-	void operator =(std::vector<uint8_t>& val){
+	UserData& operator =(const std::vector<uint8_t>& val){
 		data = val;
+#if (defined(__GXX_EXPERIMENTAL_CXX0X) || (__cplusplus >= 201103L))
+		payload.reset();
+#endif
+		return *this;
+	}
+#if (defined(__GXX_EXPERIMENTAL_CXX0X) || (__cplusplus >= 201103L))
+	UserData& operator =(std::vector<uint8_t>&& val){
+		data = std::move(val);
+		payload.reset();
+		return *this;
 	}
+	/** Moves data into the shared payload (once) and returns the payload. */
+	const CCSDSSharedPayload& sharePayload(){
+		if(payload.empty() && !data.empty()){
+			payload = CCSDSSharedPayload(std::move(data));
+			data.clear();
+		}
+		return payload;
+	}
+	const uint8_t* getPayloadData() const{
+		return data.empty() ? payload.data() : &data[0];
+	}
+	size_t getPayloadSize() const{
+		return data.empty() ? payload.size() : data.size();
+	}
+#else
+	const uint8_t* getPayloadData() const{
+		return data.empty() ? NULL : &data[0];
+	}
+	size_t getPayloadSize() const{
+		return data.size();
+	}
+#endif
 };
 
 }
 
+#if (defined(__GXX_EXPERIMENTAL_CXX0X) || (__cplusplus >= 201103L))
+namespace std {
+/** Allows sib2::ID as a key of std::unordered_map. */
+template<>
+struct hash<sib2::ID>{
+	size_t operator()(const sib2::ID& id) const{
+		return id.hash();
+	}
+};
+}
+#endif
+
 #endif /* TELEMETRYDATASTRUCT_HPP_ */
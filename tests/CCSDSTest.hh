@@ -0,0 +1,23 @@
+/*
+ * CCSDSTest.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#ifndef CCSDSTEST_HH_
+#define CCSDSTEST_HH_
+
+#include <cstdio>
+#include <cstdlib>
+
+/** Minimal check macro for the tests (a failed check exits with status 1). */
+#define CCSDS_CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			std::exit(1); \
+		} \
+	} while (0)
+
+#endif /* CCSDSTEST_HH_ */
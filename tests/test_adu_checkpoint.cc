@@ -0,0 +1,105 @@
+/*
+ * test_adu_checkpoint.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "ADUUnsegmenter.hh"
+#include "CCSDSTest.hh"
+#include <cstdio>
+#include <vector>
+
+static CCSDSSpacePacket* makeSegment(uint16_t apid, uint8_t aduChannelID, uint32_t segmentFlag, size_t segmentCount,
+		const std::vector<uint8_t>& data, bool packetErrorControlUsed) {
+	CCSDSSpacePacket* packet = new CCSDSSpacePacket();
+	packet->getPrimaryHeader()->setAPID(apid);
+	packet->getPrimaryHeader()->setPacketType(CCSDSSpacePacketPacketType::TelemetryPacket);
+	packet->getPrimaryHeader()->setSecondaryHeaderFlag(CCSDSSpacePacketSecondaryHeaderFlag::Present);
+	packet->getPrimaryHeader()->setSequenceFlag(CCSDSSpacePacketSequenceFlag::UnsegmentedUserData);
+	packet->getSecondaryHeader()->setSecondaryHeaderType(CCSDSSpacePacketSecondaryHeaderType::ADUChannelIsUsed);
+	packet->getSecondaryHeader()->setADUChannelID(aduChannelID);
+	packet->getSecondaryHeader()->setADUSegmentFlag(segmentFlag);
+	packet->getSecondaryHeader()->setADUSegmentCount(segmentCount);
+	packet->getSecondaryHeader()->setADUCount(7);
+	packet->getSecondaryHeader()->setTime((uint32_t) 0x12345678);
+	packet->setUserDataField(data);
+	packet->setPacketErrorControlUsed(packetErrorControlUsed);
+	packet->setPacketDataLength();
+	return packet;
+}
+
+int main() {
+	const uint16_t apid = 0x123;
+	std::vector<uint8_t> data[3];
+	std::vector<uint8_t> expected;
+	for (size_t i = 0; i < 3; i++) {
+		for (size_t j = 0; j < 20; j++) {
+			data[i].push_back(i * 20 + j);
+		}
+		expected.insert(expected.end(), data[i].begin(), data[i].end());
+	}
+	for (int pec = 0; pec < 2; pec++) {
+		CCSDSSpacePacket* first = makeSegment(apid, 1, CCSDSSpacePacketADUSegmentFlag::TheFirstSegment, 0, data[0], pec);
+		CCSDSSpacePacket* middle = makeSegment(apid, 1, CCSDSSpacePacketADUSegmentFlag::ContinuationSegument, 1,
+				data[1], pec);
+		CCSDSSpacePacket* last = makeSegment(apid, 1, CCSDSSpacePacketADUSegmentFlag::TheLastSegment, 2, data[2], pec);
+		CCSDSSpacePacket* unsegmented = makeSegment(apid, 2, CCSDSSpacePacketADUSegmentFlag::UnsegmentedADU, 0,
+				data[0], pec);
+
+		ADUUnsegmenter unsegmenter(apid & 0xFF);
+		unsegmenter.push(first);
+		unsegmenter.push(middle);
+		unsegmenter.push(unsegmented);
+		std::vector<uint8_t> checkpoint = unsegmenter.checkpoint();
+
+		//restores into another instance and completes the pending ADU there
+		ADUUnsegmenter restored(apid & 0xFF);
+		restored.restore(checkpoint);
+		CCSDS_CHECK(restored.checkpoint() == checkpoint);
+
+		//round trip through a file
+		unsegmenter.saveCheckpoint("test_adu_checkpoint.ckpt");
+		ADUUnsegmenter loaded(apid & 0xFF);
+		loaded.loadCheckpoint("test_adu_checkpoint.ckpt");
+		CCSDS_CHECK(loaded.checkpoint() == checkpoint);
+		std::remove("test_adu_checkpoint.ckpt");
+		restored.push(last);
+		CCSDS_CHECK(restored.hasCompleteADU());
+		ADU* adu = restored.popCompletedADU();
+		CCSDS_CHECK(adu->ADUChannelID == 2 && adu->data == data[0]);
+		delete adu;
+		CCSDS_CHECK(restored.hasCompleteADU());
+		adu = restored.popCompletedADU();
+		CCSDS_CHECK(adu->ADUChannelID == 1 && adu->ADUCount == 7 && adu->TI == 0x12345678);
+		CCSDS_CHECK(adu->data == expected);
+
+		//toUserData() copies and leaves data intact; moveToUserData() shares the bytes
+		sib2::UserData copied = adu->toUserData(3, 4);
+		CCSDS_CHECK(copied.data == expected && adu->data == expected);
+		CCSDS_CHECK(copied.id.lowerAPID == (apid & 0xFF) && copied.id.lowerFOID == 3 && copied.id.attributeID == 4);
+		sib2::UserData moved = adu->moveToUserData();
+		CCSDS_CHECK(adu->data.empty() && adu->getPayloadSize() == expected.size());
+		CCSDS_CHECK(moved.getPayloadSize() == expected.size() && moved.payload.isSharedWith(adu->payload));
+		sib2::SMCPPacketData smcp = adu->toSMCPPacketData();
+		CCSDS_CHECK(smcp.payload.isSharedWith(adu->payload) && smcp.ADUChannelID == 1);
+		delete adu;
+		CCSDS_CHECK(!restored.hasCompleteADU());
+
+		//a broken checkpoint is rejected and leaves the state empty
+		checkpoint[checkpoint.size() / 2] ^= 0x01;
+		bool thrown = false;
+		try {
+			restored.restore(checkpoint);
+		} catch (ADUUnsegmenterException& e) {
+			thrown = true;
+		}
+		CCSDS_CHECK(thrown && !restored.hasCompleteADU());
+
+		delete first;
+		delete middle;
+		delete last;
+		delete unsegmented;
+	}
+	return 0;
+}
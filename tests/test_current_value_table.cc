@@ -0,0 +1,126 @@
+/*
+ * test_current_value_table.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "CCSDSCurrentValueTable.hh"
+#include "CCSDSTest.hh"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+static sib2::ID makeID(size_t i) {
+	sib2::ID id;
+	id.upperAPID = 1;
+	id.lowerAPID = i & 0xFF;
+	id.lowerFOID = i >> 8;
+	id.attributeID = i * 7;
+	id.ADUChannelID = 0;
+	id.ADUCount = 0;
+	id.TI = 0;
+	return id;
+}
+
+/** Value written for an update: length and bytes are derived from the TI. */
+static std::vector<uint8_t> makeValue(uint32_t ti) {
+	return std::vector<uint8_t>(ti % 100, (uint8_t) ti);
+}
+
+static bool isConsistent(const sib2::UserData& userData) {
+	if (userData.data != makeValue(userData.id.TI)) {
+		return false;
+	}
+	return userData.id.ADUCount == (uint8_t) userData.id.TI;
+}
+
+int main() {
+	//single thread: update, get, overwrite, snapshot and rejections
+	{
+		CCSDSCurrentValueTable table(4, 16);
+		sib2::UserData userData;
+		CCSDS_CHECK(!table.get(makeID(0), userData));
+
+		sib2::ID id = makeID(0);
+		id.TI = 10;
+		id.ADUCount = 10;
+		std::vector<uint8_t> value = makeValue(10);
+		CCSDS_CHECK(table.update(id, &value[0], value.size()));
+		uint64_t updateCount = 0;
+		CCSDS_CHECK(table.get(makeID(0), userData, &updateCount));
+		CCSDS_CHECK(isConsistent(userData) && updateCount == 1);
+
+		id.TI = 12;
+		id.ADUCount = 12;
+		value = makeValue(12);
+		CCSDS_CHECK(table.update(id, &value[0], value.size()));
+		CCSDS_CHECK(table.get(makeID(0), userData, &updateCount));
+		CCSDS_CHECK(userData.id.TI == 12 && isConsistent(userData) && updateCount == 2);
+		CCSDS_CHECK(table.getNumberOfItems() == 1);
+
+		//too large a value and a full table are rejected
+		std::vector<uint8_t> large(17);
+		CCSDS_CHECK(!table.update(makeID(1), &large[0], large.size()));
+		for (size_t i = 1; i < 4; i++) {
+			CCSDS_CHECK(table.update(makeID(i), &value[0], value.size()));
+		}
+		CCSDS_CHECK(!table.update(makeID(4), &value[0], value.size()));
+		CCSDS_CHECK(table.getNumberOfItems() == 4 && table.getNumberOfRejectedUpdates() == 2);
+		CCSDS_CHECK(!table.get(makeID(4), userData));
+		CCSDS_CHECK(table.snapshot().size() == 4);
+	}
+
+	//one writer and several readers: readers never see a partial or an empty new item
+	{
+		const size_t nItems = 500;
+		const uint32_t nRounds = 200;
+		CCSDSCurrentValueTable table(nItems, 100);
+		std::atomic<bool> stop(false);
+		std::atomic<size_t> nInconsistent(0);
+		std::atomic<size_t> nReads(0);
+		std::vector<std::thread> readers;
+		for (size_t r = 0; r < 2; r++) {
+			readers.push_back(std::thread([&]() {
+				sib2::UserData userData;
+				uint64_t updateCount;
+				while (!stop.load()) {
+					for (size_t i = 0; i < nItems; i += 7) {
+						if (table.get(makeID(i), userData, &updateCount)) {
+							nReads++;
+							if (!isConsistent(userData) || updateCount == 0 || userData.id.TI == 0) {
+								nInconsistent++;
+							}
+						}
+					}
+					std::vector<sib2::UserData> snapshot = table.snapshot();
+					for (size_t i = 0; i < snapshot.size(); i++) {
+						if (!isConsistent(snapshot[i]) || snapshot[i].id.TI == 0) {
+							nInconsistent++;
+						}
+					}
+				}
+			}));
+		}
+		for (uint32_t ti = 1; ti <= nRounds; ti++) {
+			//items are added one by one in the first rounds, while readers are running
+			size_t n = (ti * 10 < nItems) ? ti * 10 : nItems;
+			for (size_t i = 0; i < n; i++) {
+				sib2::ID id = makeID(i);
+				id.TI = ti;
+				id.ADUCount = (uint8_t) ti;
+				std::vector<uint8_t> value = makeValue(ti);
+				CCSDS_CHECK(table.update(id, value.empty() ? NULL : &value[0], value.size()));
+			}
+		}
+		stop.store(true);
+		for (size_t r = 0; r < readers.size(); r++) {
+			readers[r].join();
+		}
+		CCSDS_CHECK(nInconsistent.load() == 0);
+		CCSDS_CHECK(table.getNumberOfItems() == nItems);
+		sib2::UserData userData;
+		CCSDS_CHECK(table.get(makeID(nItems - 1), userData) && userData.id.TI == nRounds);
+	}
+	return 0;
+}
@@ -0,0 +1,105 @@
+/*
+ * test_decommutator.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "CCSDSDecommutator.hh"
+#include "CCSDSTest.hh"
+#include <random>
+
+/** Extracts a field bit by bit (reference implementation). */
+static uint64_t extract(const uint8_t* data, const CCSDSParameterDefinition& parameter) {
+	uint64_t value = 0;
+	if (parameter.endianness == CCSDSFieldEndianness::LittleEndian) {
+		for (size_t i = 0; i < parameter.width / 8; i++) {
+			value |= (uint64_t) data[parameter.bitOffset / 8 + i] << (8 * i);
+		}
+	} else {
+		for (size_t i = 0; i < parameter.width; i++) {
+			size_t bit = parameter.bitOffset + i;
+			value = (value << 1) | ((data[bit / 8] >> (7 - bit % 8)) & 1);
+		}
+	}
+	if (parameter.isSigned && parameter.width < 64 && ((value >> (parameter.width - 1)) & 1) != 0) {
+		value |= ~(uint64_t) 0 << parameter.width;
+	}
+	return value;
+}
+
+int main() {
+	std::mt19937_64 random(1);
+	CCSDSDecommutator decommutator;
+	std::vector<CCSDSParameterDefinition> definitions;
+	//APID 0x100: 64-byte packets with random big- and little-endian fields
+	for (size_t i = 0; i < 40; i++) {
+		size_t width = 1 + random() % 57;
+		size_t bitOffset = random() % (64 * 8 - width - 7);
+		int endianness = CCSDSFieldEndianness::BigEndian;
+		if (i % 7 == 0) {
+			width = 8 * (1 + random() % 8);
+			bitOffset = 8 * (random() % (64 - width / 8 + 1));
+			endianness = CCSDSFieldEndianness::LittleEndian;
+		}
+		definitions.push_back(CCSDSParameterDefinition("p", 0x100, bitOffset, width, endianness, (random() & 1) != 0));
+	}
+	//APID 0x101: 20-byte packets with fields near the end (byte loop) and 64-bit-wide fields
+	definitions.push_back(CCSDSParameterDefinition("w64", 0x101, 8, 64));
+	definitions.push_back(CCSDSParameterDefinition("w57", 0x101, 7, 57, CCSDSFieldEndianness::BigEndian, true));
+	definitions.push_back(CCSDSParameterDefinition("tail", 0x101, 150, 10));
+	for (size_t i = 0; i < definitions.size(); i++) {
+		decommutator.addParameter(definitions[i]);
+	}
+
+	//fields that do not fit in one 8-byte load are rejected
+	bool thrown = false;
+	try {
+		decommutator.addParameter(CCSDSParameterDefinition("wide", 0x100, 1, 64));
+	} catch (CCSDSDecommutatorException& e) {
+		thrown = true;
+	}
+	CCSDS_CHECK(thrown);
+
+	//packets of both APIDs, an unknown APID, and some short packets
+	const size_t nPackets = 5000;
+	std::vector<std::vector<uint8_t> > packets;
+	for (size_t i = 0; i < nPackets; i++) {
+		CCSDSSpacePacket packet;
+		uint16_t apid = (i % 10 == 9) ? 0x101 : ((i % 10 == 8) ? 0x200 : 0x100);
+		packet.getPrimaryHeader()->setAPID(apid);
+		std::vector<uint8_t> userData((apid == 0x101) ? 20 : 64);
+		if (i % 100 == 5) {
+			userData.resize(10);
+		}
+		for (size_t k = 0; k < userData.size(); k++) {
+			userData[k] = (uint8_t) random();
+		}
+		packet.setUserDataField(userData);
+		packets.push_back(packet.getAsByteVector());
+	}
+	std::vector<CCSDSSpacePacketView> views;
+	for (size_t i = 0; i < nPackets; i++) {
+		views.push_back(CCSDSSpacePacketView(&packets[i][0], packets[i].size()));
+	}
+
+	//the SIMD path (when available) and the scalar path give identical results, which match the reference
+	CCSDSDecommutationResult scalar, simd;
+	decommutator.setSIMDEnabled(false);
+	decommutator.decommutate(views, scalar);
+	decommutator.setSIMDEnabled(true);
+	decommutator.decommutate(views, simd);
+	for (size_t p = 0; p < definitions.size(); p++) {
+		const std::vector<uint32_t>& rows = simd.getRows(p);
+		CCSDS_CHECK(rows == scalar.getRows(p));
+		CCSDS_CHECK(simd.getValues(p) == scalar.getValues(p));
+		CCSDS_CHECK(!rows.empty());
+		for (size_t k = 0; k < rows.size(); k++) {
+			uint64_t expected = extract(views[rows[k]].getUserDataField(), definitions[p]);
+			CCSDS_CHECK((uint64_t) simd.getValues(p)[k] == expected);
+		}
+	}
+	CCSDS_CHECK(decommutator.getNumberOfSkippedPackets() == 2 * nPackets / 10);
+	CCSDS_CHECK(decommutator.getNumberOfShortPackets() == 2 * nPackets / 100);
+	return 0;
+}
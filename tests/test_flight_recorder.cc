@@ -0,0 +1,114 @@
+/*
+ * test_flight_recorder.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "ADUUnsegmenter.hh"
+#include "CCSDSFlightRecorder.hh"
+#include "CCSDSTest.hh"
+#include <sstream>
+
+static CCSDSSpacePacket* createPacket(bool secondaryHeader, bool aduChannel, bool packetErrorControl, size_t length) {
+	CCSDSSpacePacket* packet = new CCSDSSpacePacket;
+	packet->getPrimaryHeader()->setAPID(0x123);
+	packet->getPrimaryHeader()->setSequenceFlag(CCSDSSpacePacketSequenceFlag::UnsegmentedUserData);
+	packet->getPrimaryHeader()->setSequenceCount(0x1234);
+	if (secondaryHeader) {
+		packet->getPrimaryHeader()->setSecondaryHeaderFlag(CCSDSSpacePacketSecondaryHeaderFlag::Present);
+		packet->getSecondaryHeader()->setTime(0x89ABCDEF);
+		packet->getSecondaryHeader()->setCategory(0x55);
+		packet->getSecondaryHeader()->setADUCount(0x42);
+		if (aduChannel) {
+			packet->getSecondaryHeader()->setSecondaryHeaderType(CCSDSSpacePacketSecondaryHeaderType::ADUChannelIsUsed);
+			packet->getSecondaryHeader()->setADUChannelID(0x07);
+			packet->getSecondaryHeader()->setADUSegmentFlag(CCSDSSpacePacketADUSegmentFlag::UnsegmentedADU);
+			packet->getSecondaryHeader()->setADUSegmentCount(0x2345);
+		}
+	}
+	packet->setPacketErrorControlUsed(packetErrorControl);
+	std::vector<uint8_t> data;
+	for (size_t i = 0; i < length; i++) {
+		data.push_back((uint8_t) (i * 7));
+	}
+	packet->setUserDataField(data);
+	return packet;
+}
+
+int main() {
+	//a recorded packet instance is identical to its serialized form (also when truncated)
+	const size_t slotSize = 64;
+	for (int variant = 0; variant < 16; variant++) {
+		bool secondaryHeader = (variant & 1) != 0;
+		bool aduChannel = (variant & 2) != 0;
+		bool packetErrorControl = (variant & 4) != 0;
+		size_t length = (variant & 8) ? 200 : 10;
+		CCSDSFlightRecorder recorder(CCSDSFlightRecorder::PerADUChannel, 4, slotSize);
+		CCSDSSpacePacket* packet = createPacket(secondaryHeader, aduChannel, packetErrorControl, length);
+		recorder.record(packet);
+		std::vector<uint8_t> expected = packet->getAsByteVector();
+		uint32_t key = recorder.getKey(&expected[0], expected.size());
+		CCSDS_CHECK(recorder.getKey(packet) == key);
+		std::vector<CCSDSFlightRecorderEntry> entries = recorder.getEntries(key);
+		CCSDS_CHECK(entries.size() == 1);
+		CCSDS_CHECK(entries[0].length == expected.size());
+		size_t n = (expected.size() < slotSize) ? expected.size() : slotSize;
+		CCSDS_CHECK(entries[0].data == std::vector<uint8_t>(expected.begin(), expected.begin() + n));
+		delete packet;
+	}
+
+	//an uninterpretable packet pushed as a byte array triggers a dump
+	CCSDSFlightRecorder recorder(CCSDSFlightRecorder::PerAPID, 4, slotSize);
+	std::stringstream dumpStream;
+	recorder.setDumpStream(&dumpStream);
+	ADUUnsegmenter unsegmenter(0x23);
+	unsegmenter.setFlightRecorder(&recorder);
+	CCSDSSpacePacket* packet = createPacket(true, true, false, 10);
+	std::vector<uint8_t> bytes = packet->getAsByteVector();
+	delete packet;
+	bytes.pop_back();
+	bool thrown = false;
+	try {
+		unsegmenter.push(bytes);
+	} catch (CCSDSSpacePacketException& e) {
+		thrown = true;
+	}
+	CCSDS_CHECK(thrown);
+	CCSDS_CHECK(recorder.getNumberOfRecordedPackets() == 1);
+	CCSDS_CHECK(recorder.getNumberOfErrors() == 1);
+	CCSDS_CHECK(dumpStream.str().find("APID=0x0123") != std::string::npos);
+
+	//TC packets are recorded whether pushed as a byte array or as an instance
+	{
+		CCSDSFlightRecorder tcRecorder(CCSDSFlightRecorder::PerAPID, 4, slotSize);
+		ADUUnsegmenter tcUnsegmenter(0x23);
+		tcUnsegmenter.setFlightRecorder(&tcRecorder);
+		CCSDSSpacePacket* tc = createPacket(false, false, false, 10);
+		tc->getPrimaryHeader()->setPacketType(CCSDSSpacePacketPacketType::CommandPacket);
+		tc->setPacketDataLength();
+		tcUnsegmenter.push(tc->getAsByteVector());
+		tcUnsegmenter.push(tc);
+		CCSDS_CHECK(tcRecorder.getNumberOfRecordedPackets() == 2);
+		CCSDS_CHECK(!tcUnsegmenter.hasCompleteADU());
+		delete tc;
+	}
+
+	//channels beyond the maximum share the overflow ring
+	{
+		CCSDSFlightRecorder capped(CCSDSFlightRecorder::PerADUChannel, 2, slotSize, 3);
+		std::vector<uint8_t> data(10, 0xAB);
+		for (uint32_t key = 0; key < 1000; key++) {
+			capped.record(key, &data[0], data.size());
+		}
+		std::vector<uint32_t> keys = capped.getKeys();
+		CCSDS_CHECK(keys.size() == 4 && keys.back() == CCSDSFlightRecorder::OverflowKey);
+		CCSDS_CHECK(capped.getEntries(0).size() == 1);
+		std::vector<CCSDSFlightRecorderEntry> overflow = capped.getEntries(500);
+		CCSDS_CHECK(overflow.size() == 2 && overflow.back().index == 999);
+		CCSDS_CHECK(capped.getKeyName(500).find("(overflow)") != std::string::npos);
+		CCSDS_CHECK(capped.getKeyName(1).find("(overflow)") == std::string::npos);
+		CCSDS_CHECK(capped.getNumberOfRecordedPackets() == 1000);
+	}
+	return 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * test_format_buffer.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "CCSDS.hh"
+#include "CCSDSTest.hh"
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+int main() {
+	//numbers are formatted as std::stringstream does
+	{
+		const uint64_t values[] = { 0, 1, 9, 10, 255, 4096, 65535, 1000000007ULL, 0xFFFFFFFFFFFFFFFFULL };
+		for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+			CCSDSFormatBuffer buffer;
+			buffer.appendDecimal(values[i]).appendChar(' ').appendHex(values[i]).appendChar(' ').appendHex(values[i], 8);
+			std::stringstream ss;
+			ss << std::dec << values[i] << ' ' << std::hex << values[i] << ' ';
+			ss << std::setw(8) << std::setfill('0') << values[i];
+			CCSDS_CHECK(buffer.str() == ss.str());
+		}
+		CCSDSFormatBuffer buffer;
+		buffer.appendHexByte(0x0A).appendChar(' ').appendBits(5, 3).appendChar(' ').appendBits(1, 1);
+		CCSDS_CHECK(buffer.str() == "0a 101 1");
+		CCSDS_CHECK(buffer.size() == 8 && std::string(buffer.data(), buffer.size()) == "0a 101 1");
+	}
+
+	//arrays are formatted as CCSDSSpacePacket::arrayToString() did
+	{
+		const uint8_t bytes[] = { 0x41, 0x00, 0xff, 0x42 };
+		CCSDSFormatBuffer buffer;
+		buffer.appendArray(bytes, 4, CCSDSFormatBuffer::Hexadecimal, 8);
+		CCSDS_CHECK(buffer.str() == "0x41 0x00 0xff 0x42");
+		buffer.clear();
+		buffer.appendArray(bytes, 4, CCSDSFormatBuffer::Decimal, 3);
+		CCSDS_CHECK(buffer.str() == "65 0 255 ... (total size = 4 entries)");
+		buffer.clear();
+		buffer.appendArray(bytes, 1, CCSDSFormatBuffer::Character, 0);
+		CCSDS_CHECK(buffer.str() == " ... (total size = 1 entry)");
+		std::vector<uint8_t> vector(bytes, bytes + 4);
+		CCSDS_CHECK(CCSDSSpacePacket::arrayToString(&vector, "hex", 2) == "0x41 0x00 ... (total size = 4 entries)");
+		CCSDS_CHECK(CCSDSSpacePacket::arrayToString(&vector, "dec") == "65 0 255 66");
+	}
+
+	//clear() keeps the capacity so that a reused buffer does not allocate
+	{
+		CCSDSFormatBuffer buffer(16);
+		for (size_t i = 0; i < 100; i++) {
+			buffer.append("0123456789");
+		}
+		size_t capacity = buffer.str().capacity();
+		buffer.clear();
+		CCSDS_CHECK(buffer.size() == 0 && buffer.str().capacity() == capacity);
+	}
+
+	//packet dumps
+	{
+		CCSDSSpacePacket packet;
+		packet.getPrimaryHeader()->setAPID(0x123);
+		packet.getPrimaryHeader()->setSequenceCount((size_t) 0x2A);
+		packet.getPrimaryHeader()->setSecondaryHeaderFlag(CCSDSSpacePacketSecondaryHeaderFlag::Present);
+		packet.getSecondaryHeader()->setSecondaryHeaderType(CCSDSSpacePacketSecondaryHeaderType::ADUChannelIsUsed);
+		packet.getSecondaryHeader()->setTime((uint32_t) 1000);
+		packet.getSecondaryHeader()->setCategory(3);
+		packet.getSecondaryHeader()->setADUChannelID(2);
+		packet.getSecondaryHeader()->setADUCount(4);
+		packet.getSecondaryHeader()->setADUSegmentFlag(CCSDSSpacePacketADUSegmentFlag::TheFirstSegment);
+		packet.getSecondaryHeader()->setADUSegmentCount((size_t) 5);
+		std::vector<uint8_t> data;
+		for (size_t i = 0; i < 40; i++) {
+			data.push_back((uint8_t) (i * 7));
+		}
+		packet.setUserDataField(data);
+		packet.setPacketDataLength();
+
+		//same as the stringstream-based toString() of earlier versions
+		const std::string expected = "---------------------------------\n"
+				"CCSDSSpacePacket\n"
+				"---------------------------------\n"
+				"PrimaryHeader\n"
+				"PacketVersionNum    : 000\n"
+				"PacketType          : 0\n"
+				"SecondaryHeaderFlag : 1\n"
+				"APID                : 291 (0x123)\n"
+				"SequenceFlag        : 00 (Continuation segment of user data)\n"
+				"SequenceCount       : 2a\n"
+				"PacketDataLength    : 48 (0x0030) (Packet Data Field has 49 bytes)\n"
+				"SecondaryHeader (9 bytes)\n"
+				"Time                : 1000 (0x000003e8)\n"
+				"SecondaryHeaderType : 1(SecondaryHeader present)\n"
+				"Category            : 0x03\n"
+				"ADUCount            : 4 (0x04)\n"
+				"ADUChannelID        : 2 (0x02)\n"
+				"ADUSegmentFlag      : 01 (FirstSegment)\n"
+				"ADUSegmentCount     : 5 (0x0005)\n"
+				"User data field has 40 bytes\n"
+				"0x00 0x07 0x0e 0x15 0x1c 0x23 0x2a 0x31 0x38 0x3f 0x46 0x4d 0x54 0x5b 0x62 0x69 0x70 0x77 0x7e 0x85 "
+				"0x8c 0x93 0x9a 0xa1 0xa8 0xaf 0xb6 0xbd 0xc4 0xcb 0xd2 0xd9 ... (total size = 40 entries)\n"
+				"\n";
+		CCSDS_CHECK(packet.toString() == expected);
+		CCSDSFormatBuffer buffer;
+		packet.format(buffer);
+		packet.format(buffer);
+		CCSDS_CHECK(buffer.str() == expected + expected);
+		std::stringstream ss;
+		buffer.writeTo(ss);
+		CCSDS_CHECK(ss.str() == buffer.str());
+
+		buffer.clear();
+		packet.formatCompact(buffer);
+		CCSDS_CHECK(buffer.str() == "TM APID=0x123 SH=1 SeqFlag=00 SeqCount=42 Length=48 TI=0x000003e8 Cat=0x03 ADUCount=4 "
+				"ADUCh=0x02 ADUSegFlag=01 ADUSegCount=5 "
+				"UserData=40B [0x00 0x07 0x0e 0x15 0x1c 0x23 0x2a 0x31 ... (total size = 40 entries)]\n");
+	}
+	return 0;
+}
@@ -0,0 +1,163 @@
+/*
+ * test_latency_instrumentation.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "CCSDSPipeline.hh"
+#include "CCSDSTest.hh"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+static std::vector<uint8_t> createSegment(uint8_t aduChannelID, uint32_t segmentFlag, uint8_t aduCount,
+		size_t segmentCount) {
+	CCSDSSpacePacket packet;
+	packet.getPrimaryHeader()->setAPID(0x123);
+	packet.getPrimaryHeader()->setSecondaryHeaderFlag(CCSDSSpacePacketSecondaryHeaderFlag::Present);
+	packet.getSecondaryHeader()->setSecondaryHeaderType(CCSDSSpacePacketSecondaryHeaderType::ADUChannelIsUsed);
+	packet.getSecondaryHeader()->setADUChannelID(aduChannelID);
+	packet.getSecondaryHeader()->setADUSegmentFlag(segmentFlag);
+	packet.getSecondaryHeader()->setADUCount(aduCount);
+	packet.getSecondaryHeader()->setADUSegmentCount(segmentCount);
+	std::vector<uint8_t> data(16, aduChannelID);
+	packet.setUserDataField(data);
+	packet.setPacketDataLength();
+	return packet.getAsByteVector();
+}
+
+/** Returns packets one by one, sleeping before one of them. */
+class DelayedPacketSource: public CCSDSPacketSource {
+public:
+	std::vector<std::vector<uint8_t> > packets;
+	size_t index;
+	size_t delayedIndex;
+
+	DelayedPacketSource(size_t delayedIndex) {
+		this->index = 0;
+		this->delayedIndex = delayedIndex;
+	}
+
+	virtual bool next(CCSDSSpacePacketView& view) {
+		if (index == packets.size()) {
+			return false;
+		}
+		if (index == delayedIndex) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		}
+		view = CCSDSSpacePacketView(&packets[index][0], packets[index].size());
+		index++;
+		return true;
+	}
+};
+
+class ADUCounter: public CCSDSPipelineSink {
+public:
+	size_t nADUs;
+
+	ADUCounter() {
+		nADUs = 0;
+	}
+
+	virtual void onADU(const ADU&) {
+		nADUs++;
+	}
+};
+
+int main() {
+	//bucket edges: each value falls in [lower bound of its bucket, lower bound of the next bucket)
+	{
+		for (uint64_t v = 0; v < CCSDSLatencyHistogram::NSubBuckets; v++) {
+			CCSDS_CHECK(CCSDSLatencyHistogram::getBucketIndex(v) == v);
+		}
+		for (size_t i = 1; i + 1 < CCSDSLatencyHistogram::NBuckets; i++) {
+			uint64_t lower = CCSDSLatencyHistogram::getBucketLowerBound(i);
+			uint64_t next = CCSDSLatencyHistogram::getBucketLowerBound(i + 1);
+			CCSDS_CHECK(lower < next);
+			CCSDS_CHECK(CCSDSLatencyHistogram::getBucketIndex(lower) == i);
+			CCSDS_CHECK(CCSDSLatencyHistogram::getBucketIndex(next - 1) == i);
+		}
+		CCSDS_CHECK(CCSDSLatencyHistogram::getBucketIndex(~0ULL) == CCSDSLatencyHistogram::NBuckets - 1);
+
+		CCSDSLatencyHistogram histogram;
+		CCSDS_CHECK(histogram.getPercentile(50) == 0);
+		for (uint64_t i = 1; i <= 1000; i++) {
+			histogram.record(i * 1000);
+		}
+		CCSDS_CHECK(histogram.getNumberOfSamples() == 1000 && histogram.getMaximum() == 1000000);
+		CCSDS_CHECK(histogram.getMean() == 500500);
+		//percentiles are resolved within 1/16
+		uint64_t p50 = histogram.getPercentile(50);
+		CCSDS_CHECK(p50 >= 500000 * 15 / 16 && p50 <= 500000 * 17 / 16);
+		CCSDS_CHECK(histogram.getPercentile(100) <= histogram.getMaximum());
+		histogram.reset();
+		CCSDS_CHECK(histogram.getNumberOfSamples() == 0 && histogram.getMaximum() == 0);
+	}
+
+	//the trace ring keeps the most recent traces, oldest first, and readers never see torn records
+	{
+		CCSDSLatencyInstrumentation instrumentation(1, 8);
+		CCSDS_CHECK(instrumentation.getTraces().empty());
+		std::atomic<bool> stop(false);
+		std::atomic<size_t> nTorn(0);
+		std::thread reader([&]() {
+			while (!stop.load()) {
+				std::vector<CCSDSPacketTrace> traces = instrumentation.getTraces();
+				for (size_t i = 0; i < traces.size(); i++) {
+					const CCSDSPacketTrace& trace = traces[i];
+					if (trace.apid != (trace.traceID & 0x7FF) || trace.ingestTime != trace.traceID
+							|| trace.deliveredTime != trace.traceID * 5) {
+						nTorn++;
+					}
+					if (i != 0 && traces[i - 1].traceID >= trace.traceID) {
+						nTorn++;
+					}
+				}
+			}
+		});
+		const uint64_t nTraces = 200000;
+		for (uint64_t i = 0; i < nTraces; i++) {
+			CCSDSPacketTrace trace;
+			trace.apid = i & 0x7FF;
+			trace.sequenceCount = 0;
+			trace.ingestTime = i;
+			trace.framedTime = i * 2;
+			trace.decodedTime = i * 3;
+			trace.reassembledTime = i * 4;
+			trace.deliveredTime = i * 5;
+			instrumentation.recordTrace(trace);
+		}
+		stop.store(true);
+		reader.join();
+		CCSDS_CHECK(nTorn.load() == 0);
+		std::vector<CCSDSPacketTrace> traces = instrumentation.getTraces();
+		CCSDS_CHECK(traces.size() == 8);
+		CCSDS_CHECK(traces.front().traceID == nTraces - 8 && traces.back().traceID == nTraces - 1);
+	}
+
+	//ADU latencies start at the first segment, and tracing follows the (APID, ADU Channel) of the segment
+	{
+		//packets 0 and 3 are traced (1 in 3); the ADU of channel 2 completes in between
+		DelayedPacketSource source(3);
+		source.packets.push_back(createSegment(1, CCSDSSpacePacketADUSegmentFlag::TheFirstSegment, 5, 0));
+		source.packets.push_back(createSegment(2, CCSDSSpacePacketADUSegmentFlag::TheFirstSegment, 9, 0));
+		source.packets.push_back(createSegment(2, CCSDSSpacePacketADUSegmentFlag::TheLastSegment, 9, 1));
+		source.packets.push_back(createSegment(1, CCSDSSpacePacketADUSegmentFlag::TheLastSegment, 5, 1));
+		ADUCounter sink;
+		CCSDSPipeline pipeline(&source, &sink, 1, 16);
+		CCSDSLatencyInstrumentation instrumentation(3);
+		pipeline.setLatencyInstrumentation(&instrumentation);
+		pipeline.start();
+		pipeline.join();
+		CCSDS_CHECK(sink.nADUs == 2);
+		std::vector<CCSDSPacketTrace> traces = instrumentation.getTraces();
+		CCSDS_CHECK(traces.size() == 1 && traces[0].sequenceCount == 5);
+		const uint64_t delay = 20 * 1000 * 1000;
+		CCSDS_CHECK(traces[0].reassembledTime - traces[0].ingestTime >= delay);
+		CCSDS_CHECK(instrumentation.getHistogram(CCSDSLatencyInstrumentation::EndToEnd).getNumberOfSamples() == 2);
+		CCSDS_CHECK(instrumentation.getHistogram(CCSDSLatencyInstrumentation::Framing).getNumberOfSamples() == 4);
+	}
+	return 0;
+}
@@ -0,0 +1,60 @@
+/*
+ * test_metrics.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "CCSDSSpacePacket.hh"
+#include "CCSDSTest.hh"
+#include <thread>
+#include <vector>
+
+int main() {
+	CCSDSMetrics::reset();
+	std::vector<uint8_t> bytes;
+	{
+		CCSDSSpacePacket packet;
+		packet.getPrimaryHeader()->setAPID(0x10);
+		std::vector<uint8_t> data(10, 0xAA);
+		packet.setUserDataField(data);
+		bytes = packet.getAsByteVector();
+	}
+
+	//counts from several threads are summed, including those of exited threads
+	const size_t nThreads = 4;
+	const size_t nPacketsPerThread = 1000;
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < nThreads; t++) {
+		threads.push_back(std::thread([&bytes]() {
+			CCSDSSpacePacket packet;
+			for (size_t i = 0; i < nPacketsPerThread; i++) {
+				packet.interpret(&bytes[0], bytes.size());
+			}
+		}));
+	}
+	for (size_t t = 0; t < nThreads; t++) {
+		threads[t].join();
+	}
+	CCSDSMetricsSnapshot snapshot = CCSDSMetrics::snapshot();
+#ifndef CCSDS_METRICS_ENABLED
+	//built with CCSDS_DISABLE_METRICS: nothing is counted
+	CCSDS_CHECK(snapshot.get(CCSDSMetrics::DecodedPackets) == 0);
+	return 0;
+#endif
+	CCSDS_CHECK(snapshot.get(CCSDSMetrics::DecodedPackets) == (int64_t) (nThreads * nPacketsPerThread));
+	CCSDS_CHECK(snapshot.get(CCSDSMetrics::DecodedBytes) == (int64_t) (nThreads * nPacketsPerThread * bytes.size()));
+
+	//exceptions of interpret() are counted
+	CCSDSSpacePacket packet;
+	try {
+		packet.interpret(&bytes[0], bytes.size() - 1);
+	} catch (CCSDSSpacePacketException&) {
+	}
+	snapshot = CCSDSMetrics::snapshot();
+	CCSDS_CHECK(snapshot.get(CCSDSMetrics::InconsistentPacketLengthExceptions) == 1);
+
+	CCSDSMetrics::reset();
+	CCSDS_CHECK(CCSDSMetrics::snapshot().get(CCSDSMetrics::DecodedPackets) == 0);
+	return 0;
+}
@@ -0,0 +1,129 @@
+/*
+ * test_packet_archive.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "CCSDSPacketArchive.hh"
+#include "CCSDSTest.hh"
+#include <cstdlib>
+#include <vector>
+
+//builds a packet with a 6- or 9-byte Secondary Header (or none) and a slowly changing payload
+static std::vector<uint8_t> makePacket(bool tc, uint16_t apid, uint16_t sequenceCount, bool secondaryHeader,
+		bool aduChannel, uint32_t ti, size_t payloadLength, uint32_t seed) {
+	std::vector<uint8_t> packet;
+	packet.push_back((tc ? 0x10 : 0x00) | (secondaryHeader ? 0x08 : 0x00) | (apid >> 8));
+	packet.push_back(apid & 0xFF);
+	packet.push_back(0xC0 | ((sequenceCount >> 8) & 0x3F));
+	packet.push_back(sequenceCount & 0xFF);
+	packet.push_back(0);
+	packet.push_back(0);
+	if (secondaryHeader) {
+		packet.push_back(ti >> 24);
+		packet.push_back(ti >> 16);
+		packet.push_back(ti >> 8);
+		packet.push_back(ti);
+		packet.push_back((aduChannel ? 0x80 : 0x00) | 0x05);
+		packet.push_back(sequenceCount & 0xFF);
+		if (aduChannel) {
+			packet.push_back(0x03);
+			packet.push_back(0xC0);
+			packet.push_back(sequenceCount & 0xFF);
+		}
+	}
+	for (size_t i = 0; i < payloadLength; i++) {
+		packet.push_back((i < 4) ? (seed >> (8 * i)) : (uint8_t) (i * 7 + apid));
+	}
+	size_t packetDataLength = packet.size() - CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength - 1;
+	packet[4] = packetDataLength >> 8;
+	packet[5] = packetDataLength & 0xFF;
+	return packet;
+}
+
+int main() {
+	const char* filename = "test_packet_archive.arc";
+	std::vector<std::vector<uint8_t> > packets;
+	uint16_t sequenceCounts[8] = { 0 };
+	srand(1);
+	//mixed TM/TC, with and without Secondary Header; packets 5000-7999 have no Secondary Header
+	for (size_t i = 0; i < 10000; i++) {
+		size_t stream = rand() % 8;
+		bool tc = (stream >= 4);
+		uint16_t apid = (stream % 4 == 3) ? 0x7FF - 1 : 0x100 + stream % 4;
+		bool secondaryHeader = (i < 5000 || i >= 8000) && (stream % 4 != 2);
+		packets.push_back(makePacket(tc, apid, sequenceCounts[stream]++, secondaryHeader, stream % 2 == 0,
+				0x1000 + i, 16 + stream * 4, i / 16));
+	}
+
+	CCSDSPacketArchiveWriter writer(filename, 1000);
+	for (size_t i = 0; i < packets.size(); i++) {
+		writer.append(&packets[i][0], packets[i].size());
+	}
+	writer.close();
+
+	CCSDSPacketArchiveReader reader(filename);
+	CCSDS_CHECK(reader.getNumberOfPackets() == packets.size());
+	CCSDS_CHECK(reader.getNumberOfBlocks() == 10);
+	CCSDSSpacePacketView view;
+	size_t n = 0;
+	while (reader.next(view)) {
+		CCSDS_CHECK(n < packets.size());
+		CCSDS_CHECK(view.length == packets[n].size());
+		CCSDS_CHECK(std::memcmp(view.data, &packets[n][0], view.length) == 0);
+		n++;
+	}
+	CCSDS_CHECK(n == packets.size());
+
+	//blocks 5-7 have no TI
+	for (size_t i = 5; i < 8; i++) {
+		CCSDS_CHECK(!reader.getBlockInfo(i).hasTI);
+	}
+	CCSDS_CHECK(reader.getBlockInfo(4).hasTI && reader.getBlockInfo(8).hasTI);
+	CCSDS_CHECK(reader.findBlockByTI(0) == 0);
+	CCSDS_CHECK(reader.findBlockByTI(0x1000 + 4500) == 4);
+	CCSDS_CHECK(reader.findBlockByTI(0x1000 + 6000) == 8);
+	CCSDS_CHECK(reader.findBlockByTI(0x1000 + 8500) == 8);
+	CCSDS_CHECK(reader.findBlockByTI(0x1000 + 20000) == reader.getNumberOfBlocks());
+	CCSDS_CHECK(reader.findBlockByPacketIndex(2500) == 2);
+
+	//random access
+	std::vector<uint8_t> blockPackets;
+	std::vector<CCSDSSpacePacketView> views;
+	reader.decodeBlock(7, blockPackets, views);
+	CCSDS_CHECK(views.size() == 1000);
+	CCSDS_CHECK(std::memcmp(views[0].data, &packets[7000][0], views[0].length) == 0);
+
+	//a corrupted raw length in a block header is rejected before allocating, even without CRC verification
+	{
+		std::vector<uint8_t> bytes;
+		FILE* file = fopen(filename, "rb");
+		int c;
+		while ((c = fgetc(file)) != EOF) {
+			bytes.push_back((uint8_t) c);
+		}
+		fclose(file);
+		size_t rawLengthOffset = CCSDSPacketArchive::FileHeaderLength + 8;
+		bytes[rawLengthOffset + 3] = 0x7F;
+		const char* corruptedFilename = "test_packet_archive_corrupted.arc";
+		file = fopen(corruptedFilename, "wb");
+		fwrite(&bytes[0], 1, bytes.size(), file);
+		fclose(file);
+		CCSDSPacketArchiveReader corrupted(corruptedFilename);
+		corrupted.setVerificationEnabled(false);
+		bool thrown = false;
+		try {
+			corrupted.decodeBlock(0, blockPackets, views);
+		} catch (CCSDSPacketArchiveException& e) {
+			thrown = true;
+		}
+		CCSDS_CHECK(thrown);
+		corrupted.decodeBlock(1, blockPackets, views);
+		CCSDS_CHECK(views.size() == 1000);
+		std::remove(corruptedFilename);
+	}
+
+	std::remove(filename);
+	return 0;
+}
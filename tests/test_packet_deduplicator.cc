@@ -0,0 +1,99 @@
+/*
+ * test_packet_deduplicator.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "CCSDSPacketDeduplicator.hh"
+#include "CCSDSTest.hh"
+#include <cstdlib>
+#include <vector>
+
+static std::vector<uint8_t> createPacket(uint16_t apid, uint16_t sequenceCount, uint32_t ti, uint8_t fill) {
+	CCSDSSpacePacket packet;
+	packet.getPrimaryHeader()->setAPID(apid);
+	packet.getPrimaryHeader()->setSequenceCount((size_t) sequenceCount);
+	packet.getPrimaryHeader()->setSecondaryHeaderFlag(CCSDSSpacePacketSecondaryHeaderFlag::Present);
+	packet.getSecondaryHeader()->setTime(ti);
+	packet.setUserDataField(std::vector<uint8_t>(10, fill));
+	packet.setPacketDataLength();
+	return packet.getAsByteVector();
+}
+
+int main() {
+	srand(1);
+	std::vector<std::vector<uint8_t> > packets;
+	for (size_t i = 0; i < 20000; i++) {
+		packets.push_back(createPacket(i % 7, i % 16384, (uint32_t) i, (uint8_t) i));
+	}
+
+	//copies delayed by up to 50 packets are removed, and the order of unique packets is kept
+	{
+		std::vector<CCSDSSpacePacketView> stream;
+		for (size_t i = 0; i < packets.size(); i++) {
+			stream.push_back(CCSDSSpacePacketView(&packets[i][0], packets[i].size()));
+			if (i >= 50 && i % 3 == 0) {
+				size_t j = i - rand() % 50;
+				stream.push_back(CCSDSSpacePacketView(&packets[j][0], packets[j].size()));
+			}
+		}
+		CCSDSPacketDeduplicator deduplicator(1000, true);
+		std::vector<CCSDSSpacePacketView> result;
+		deduplicator.filter(stream, result);
+		CCSDS_CHECK(result.size() == packets.size());
+		for (size_t i = 0; i < result.size() && i < packets.size(); i++) {
+			CCSDS_CHECK(result[i].data == &packets[i][0]);
+		}
+		CCSDS_CHECK(deduplicator.getNumberOfPackets() == stream.size());
+		CCSDS_CHECK(deduplicator.getNumberOfDuplicates() == stream.size() - packets.size());
+		CCSDS_CHECK(deduplicator.getNumberOfUniquePackets() == packets.size());
+		deduplicator.resetCounters();
+		CCSDS_CHECK(deduplicator.getNumberOfPackets() == 0 && deduplicator.getNumberOfDuplicates() == 0);
+	}
+
+	//the Packet Data Field is compared only when the payload hash is enabled
+	{
+		std::vector<uint8_t> original = createPacket(1, 2, 3, 0xAA);
+		std::vector<uint8_t> corrupted = createPacket(1, 2, 3, 0xAB);
+		CCSDSPacketDeduplicator withoutHash;
+		CCSDS_CHECK(!withoutHash.isDuplicate(&original[0], original.size()));
+		CCSDS_CHECK(withoutHash.isDuplicate(&corrupted[0], corrupted.size()));
+		CCSDSPacketDeduplicator withHash(100, true);
+		CCSDS_CHECK(!withHash.isDuplicate(&original[0], original.size()));
+		CCSDS_CHECK(!withHash.isDuplicate(&corrupted[0], corrupted.size()));
+		CCSDS_CHECK(withHash.isDuplicate(&original[0], original.size()));
+	}
+
+	//a copy arriving after the window has passed is not detected
+	{
+		CCSDSPacketDeduplicator deduplicator(10);
+		for (size_t i = 0; i < 10; i++) {
+			CCSDS_CHECK(!deduplicator.isDuplicate(&packets[i][0], packets[i].size()));
+		}
+		CCSDS_CHECK(deduplicator.isDuplicate(&packets[0][0], packets[0].size()));
+		CCSDS_CHECK(!deduplicator.isDuplicate(&packets[10][0], packets[10].size()));
+		CCSDS_CHECK(!deduplicator.isDuplicate(&packets[0][0], packets[0].size()));
+		CCSDS_CHECK(deduplicator.getNumberOfEvictions() == 0);
+	}
+
+	//deduplicated packet source
+	{
+		std::vector<uint8_t> stream;
+		for (size_t i = 0; i < 100; i++) {
+			stream.insert(stream.end(), packets[i].begin(), packets[i].end());
+			stream.insert(stream.end(), packets[i].begin(), packets[i].end());
+		}
+		CCSDSBufferPacketSource bufferSource(&stream[0], stream.size());
+		CCSDSPacketDeduplicator deduplicator;
+		CCSDSDeduplicatedPacketSource source(&bufferSource, &deduplicator);
+		CCSDSSpacePacketView view;
+		size_t nPackets = 0;
+		while (source.next(view)) {
+			CCSDS_CHECK(view.getTimeAsInteger() == nPackets);
+			nPackets++;
+		}
+		CCSDS_CHECK(nPackets == 100 && deduplicator.getNumberOfDuplicates() == 100);
+	}
+	return 0;
+}
@@ -0,0 +1,75 @@
+/*
+ * test_packet_error_control.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "CCSDSSpacePacket.hh"
+#include "CCSDSTest.hh"
+#include <cstring>
+#include <vector>
+
+int main() {
+	//CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) check value
+	{
+		const char* check = "123456789";
+		const uint8_t* data = (const uint8_t*) check;
+		CCSDS_CHECK(CCSDSCRC16::calculate(data, std::strlen(check)) == 0x29B1);
+		CCSDS_CHECK(CCSDSCRC16::calculateSlicingBy8(data, std::strlen(check)) == 0x29B1);
+		//calculation can be continued over split data
+		uint16_t crc = CCSDSCRC16::calculate(data, 4);
+		CCSDS_CHECK(CCSDSCRC16::calculate(data + 4, std::strlen(check) - 4, crc) == 0x29B1);
+	}
+
+	//all kernels agree on long data (the CLMUL kernel is used above MinimumLengthForCLMUL bytes)
+	{
+		std::vector<uint8_t> data(4099);
+		for (size_t i = 0; i < data.size(); i++) {
+			data[i] = (uint8_t) (i * 131 + 7);
+		}
+		for (size_t length = 0; length < data.size(); length += 97) {
+			CCSDS_CHECK(CCSDSCRC16::calculate(&data[0], length) == CCSDSCRC16::calculateSlicingBy8(&data[0], length));
+		}
+	}
+
+	//a packet with Packet Error Control survives a round trip and is rejected when corrupted
+	{
+		CCSDSSpacePacket packet;
+		packet.getPrimaryHeader()->setAPID(0x123);
+		packet.getPrimaryHeader()->setSecondaryHeaderFlag(CCSDSSpacePacketSecondaryHeaderFlag::Present);
+		packet.getSecondaryHeader()->setTime((uint32_t) 0x12345678);
+		std::vector<uint8_t> userData;
+		for (size_t i = 0; i < 100; i++) {
+			userData.push_back((uint8_t) i);
+		}
+		packet.setUserDataField(userData);
+		packet.setPacketErrorControlUsed(true);
+		packet.setPacketDataLength();
+		std::vector<uint8_t> bytes = packet.getAsByteVector();
+		uint16_t crc = CCSDSCRC16::calculate(&bytes[0], bytes.size() - 2);
+		CCSDS_CHECK(bytes[bytes.size() - 2] == (crc >> 8) && bytes[bytes.size() - 1] == (crc & 0xFF));
+		CCSDS_CHECK(CCSDSCRC16::verify(&bytes[0], bytes.size()));
+
+		CCSDSSpacePacket decoded;
+		decoded.setPacketErrorControlUsed(true);
+		decoded.interpret(&bytes[0], bytes.size());
+		CCSDS_CHECK(*decoded.getUserDataField() == userData);
+		CCSDS_CHECK(decoded.getSecondaryHeader()->getTimeAsInteger() == 0x12345678);
+		CCSDS_CHECK(decoded.getAsByteVector() == bytes);
+
+		for (size_t position = 0; position < bytes.size(); position += 17) {
+			std::vector<uint8_t> corrupted = bytes;
+			corrupted[position] ^= 0x10;
+			uint32_t status = 0;
+			try {
+				decoded.interpret(&corrupted[0], corrupted.size());
+			} catch (CCSDSSpacePacketException& e) {
+				status = e.getStatus();
+			}
+			CCSDS_CHECK(status == CCSDSSpacePacketException::PacketErrorControlMismatch
+					|| (position >= 4 && position < 6 && status == CCSDSSpacePacketException::InconsistentPacketLength));
+		}
+	}
+	return 0;
+}
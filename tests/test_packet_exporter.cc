@@ -0,0 +1,128 @@
+/*
+ * test_packet_exporter.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "CCSDSPacketExporter.hh"
+#include "CCSDSTest.hh"
+#include <sstream>
+#include <string>
+#include <vector>
+
+static void appendPacket(std::vector<uint8_t>& stream, uint16_t apid, bool secondaryHeaderPresent, bool aduChannelUsed,
+		size_t userDataLength) {
+	CCSDSSpacePacket packet;
+	packet.getPrimaryHeader()->setAPID(apid);
+	packet.getPrimaryHeader()->setSequenceFlag(CCSDSSpacePacketSequenceFlag::UnsegmentedUserData);
+	packet.getPrimaryHeader()->setSequenceCount((size_t) apid);
+	if (secondaryHeaderPresent) {
+		packet.getPrimaryHeader()->setSecondaryHeaderFlag(CCSDSSpacePacketSecondaryHeaderFlag::Present);
+		packet.getSecondaryHeader()->setTime((uint32_t) 100000 + apid);
+		packet.getSecondaryHeader()->setCategory(7);
+		packet.getSecondaryHeader()->setADUCount(3);
+		if (aduChannelUsed) {
+			packet.getSecondaryHeader()->setSecondaryHeaderType(CCSDSSpacePacketSecondaryHeaderType::ADUChannelIsUsed);
+			packet.getSecondaryHeader()->setADUChannelID(9);
+			packet.getSecondaryHeader()->setADUSegmentFlag(CCSDSSpacePacketADUSegmentFlag::TheLastSegment);
+			packet.getSecondaryHeader()->setADUSegmentCount((size_t) 300);
+		} else {
+			packet.getSecondaryHeader()->setSecondaryHeaderType(CCSDSSpacePacketSecondaryHeaderType::ADUChannelIsNotUsed);
+		}
+	}
+	packet.setUserDataField(std::vector<uint8_t>(userDataLength, 0x00));
+	packet.setPacketDataLength();
+	std::vector<uint8_t> bytes = packet.getAsByteVector();
+	stream.insert(stream.end(), bytes.begin(), bytes.end());
+}
+
+static uint64_t readLittleEndian(const std::string& str, size_t& position, size_t width) {
+	uint64_t value = 0;
+	for (size_t i = 0; i < width; i++) {
+		value |= (uint64_t) (uint8_t) str[position + i] << (8 * i);
+	}
+	position += width;
+	return value;
+}
+
+int main() {
+	//packets with the ADU Channel (25 bytes), without the ADU Channel (16 bytes), and without the Secondary Header (14 bytes)
+	std::vector<uint8_t> stream;
+	appendPacket(stream, 0x10, true, true, 10);
+	appendPacket(stream, 0x20, true, false, 4);
+	appendPacket(stream, 0x30, false, false, 8);
+	std::vector<CCSDSSpacePacketView> views;
+	views.push_back(CCSDSSpacePacketView(&stream[0], 25));
+	views.push_back(CCSDSSpacePacketView(&stream[25], 16));
+	views.push_back(CCSDSSpacePacketView(&stream[41], 14));
+
+	//CSV: empty fields for absent Secondary Header and ADU Channel
+	{
+		std::stringstream ss;
+		{
+			CCSDSCSVPacketExporter exporter(ss);
+			exporter.setBatchSize(2);
+			exporter.push(views, &stream[0]);
+			CCSDS_CHECK(exporter.getNumberOfExportedRows() == 3);
+		}
+		std::string expected = "packet_offset,apid,packet_type,secondary_header_flag,sequence_flag,sequence_count,"
+				"packet_data_length,category,adu_channel_used,adu_channel_id,adu_count,adu_segment_flag,adu_segment_count,"
+				"ti,payload_offset,payload_length\n"
+				"0,16,0,1,3,16,18,7,1,9,3,2,300,100016,15,10\n"
+				"25,32,0,1,3,32,9,7,0,,3,,,100032,37,4\n"
+				"41,48,0,0,3,48,7,,,,,,,,47,8\n";
+		CCSDS_CHECK(ss.str() == expected);
+	}
+
+	//columnar: a header and one block per batch
+	{
+		std::stringstream ss;
+		{
+			CCSDSColumnarPacketExporter exporter(ss);
+			exporter.setBatchSize(2);
+			exporter.push(views, &stream[0]);
+		}
+		std::string output = ss.str();
+		CCSDS_CHECK(output.substr(0, 8) == "CCSDSCOL");
+		size_t position = 8;
+		CCSDS_CHECK(readLittleEndian(output, position, 4) == CCSDSColumnarPacketExporter::FormatVersion);
+		CCSDS_CHECK(readLittleEndian(output, position, 4) == CCSDSPacketExporter::NColumns);
+		for (size_t i = 0; i < CCSDSPacketExporter::NColumns; i++) {
+			CCSDS_CHECK(readLittleEndian(output, position, 1) == CCSDSPacketExporter::getColumnWidth(i));
+			size_t nameLength = readLittleEndian(output, position, 1);
+			CCSDS_CHECK(output.substr(position, nameLength) == CCSDSPacketExporter::getColumnName(i));
+			position += nameLength;
+		}
+
+		const uint64_t expected[3][CCSDSPacketExporter::NColumns] = {
+				{ 0, 16, 0, 1, 3, 16, 18, 7, 1, 9, 3, 2, 300, 100016, 15, 10 },
+				{ 25, 32, 0, 1, 3, 32, 9, 7, 0, 0, 3, 0, 0, 100032, 37, 4 },
+				{ 41, 48, 0, 0, 3, 48, 7, 0, 0, 0, 0, 0, 0, 0, 47, 8 } };
+		size_t row = 0;
+		const size_t nRowsPerBlock[] = { 2, 1 };
+		for (size_t block = 0; block < 2; block++) {
+			CCSDS_CHECK(readLittleEndian(output, position, 8) == nRowsPerBlock[block]);
+			for (size_t i = 0; i < CCSDSPacketExporter::NColumns; i++) {
+				for (size_t r = 0; r < nRowsPerBlock[block]; r++) {
+					size_t width = CCSDSPacketExporter::getColumnWidth(i);
+					CCSDS_CHECK(readLittleEndian(output, position, width) == expected[row + r][i]);
+				}
+			}
+			row += nRowsPerBlock[block];
+		}
+		CCSDS_CHECK(position == output.size());
+	}
+
+	//an output file that cannot be opened
+	{
+		bool thrown = false;
+		try {
+			CCSDSCSVPacketExporter exporter("/nonexistent/directory/out.csv");
+		} catch (CCSDSPacketExporterException& e) {
+			thrown = true;
+		}
+		CCSDS_CHECK(thrown);
+	}
+	return 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * test_packet_filter.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "CCSDSPacketFilter.hh"
+#include "CCSDSTest.hh"
+#include <vector>
+
+/** Builds a packet; category < 0 means no Secondary Header. */
+static std::vector<uint8_t> createPacket(uint32_t packetType, uint16_t apid, int category) {
+	CCSDSSpacePacket packet;
+	packet.getPrimaryHeader()->setPacketType(packetType);
+	packet.getPrimaryHeader()->setAPID(apid);
+	if (category >= 0) {
+		packet.getPrimaryHeader()->setSecondaryHeaderFlag(CCSDSSpacePacketSecondaryHeaderFlag::Present);
+		packet.getSecondaryHeader()->setCategory((uint8_t) category);
+	}
+	std::vector<uint8_t> data(8, 0x00);
+	packet.setUserDataField(data);
+	packet.setPacketDataLength();
+	return packet.getAsByteVector();
+}
+
+static bool matches(const CCSDSPacketFilter& filter, const std::vector<uint8_t>& packet) {
+	return filter.matches(&packet[0], packet.size());
+}
+
+int main() {
+	const uint32_t TM = CCSDSSpacePacketPacketType::TelemetryPacket;
+	const uint32_t TC = CCSDSSpacePacketPacketType::CommandPacket;
+
+	//APID ranges are inclusive; rejections override earlier acceptances; a new filter accepts nothing
+	{
+		CCSDSPacketFilter filter;
+		CCSDS_CHECK(!matches(filter, createPacket(TM, 0x100, -1)));
+		filter.acceptAPIDRange(0x100, 0x1FF);
+		filter.rejectAPIDRange(0x180, 0x18F);
+		filter.acceptAPID(0x300, TC);
+		CCSDS_CHECK(matches(filter, createPacket(TM, 0x100, -1)));
+		CCSDS_CHECK(matches(filter, createPacket(TC, 0x1FF, -1)));
+		CCSDS_CHECK(!matches(filter, createPacket(TM, 0x0FF, -1)));
+		CCSDS_CHECK(!matches(filter, createPacket(TM, 0x200, -1)));
+		CCSDS_CHECK(!matches(filter, createPacket(TM, 0x180, -1)));
+		CCSDS_CHECK(!matches(filter, createPacket(TM, 0x18F, -1)));
+		CCSDS_CHECK(matches(filter, createPacket(TM, 0x190, -1)));
+		CCSDS_CHECK(matches(filter, createPacket(TC, 0x300, -1)));
+		CCSDS_CHECK(!matches(filter, createPacket(TM, 0x300, -1)));
+	}
+
+	//Category filtering applies per Packet Type and only to packets with Secondary Header
+	{
+		CCSDSPacketFilter filter;
+		filter.acceptAllAPIDs();
+		filter.acceptCategory(TM, 2);
+		filter.acceptCategory(TM, 100);
+		CCSDS_CHECK(matches(filter, createPacket(TM, 0x10, 2)));
+		CCSDS_CHECK(matches(filter, createPacket(TM, 0x10, 100)));
+		CCSDS_CHECK(!matches(filter, createPacket(TM, 0x10, 3)));
+		CCSDS_CHECK(!matches(filter, createPacket(TM, 0x10, -1)));
+		CCSDS_CHECK(matches(filter, createPacket(TC, 0x10, 3)));
+		CCSDS_CHECK(matches(filter, createPacket(TC, 0x10, -1)));
+		filter.setPacketsWithoutSecondaryHeaderAccepted(TM, true);
+		CCSDS_CHECK(matches(filter, createPacket(TM, 0x10, -1)));
+		//a truncated Secondary Header cannot pass an enabled Category filter
+		std::vector<uint8_t> packet = createPacket(TM, 0x10, 2);
+		CCSDS_CHECK(!filter.matches(&packet[0], 10));
+		filter.acceptAllCategories(TM);
+		CCSDS_CHECK(matches(filter, createPacket(TM, 0x10, 3)));
+	}
+
+	//Idle Packets pass acceptAllAPIDs() and are removed by rejectIdlePackets()
+	{
+		CCSDSPacketFilter filter;
+		filter.acceptAllAPIDs();
+		std::vector<uint8_t> idle = createPacket(TM, CCSDSSpacePacket::APIDOfIdlePacket, -1);
+		CCSDS_CHECK(matches(filter, idle));
+		filter.rejectIdlePackets();
+		CCSDS_CHECK(!matches(filter, idle));
+		CCSDS_CHECK(matches(filter, createPacket(TM, 0x7FE, -1)));
+	}
+
+	//selection on views and on concatenated packets
+	{
+		CCSDSPacketFilter filter;
+		filter.acceptAllAPIDs();
+		filter.rejectIdlePackets();
+		std::vector<std::vector<uint8_t> > packets;
+		packets.push_back(createPacket(TM, 0x10, -1));
+		packets.push_back(createPacket(TM, CCSDSSpacePacket::APIDOfIdlePacket, -1));
+		packets.push_back(createPacket(TM, 0x11, 5));
+		std::vector<uint8_t> buffer;
+		std::vector<CCSDSSpacePacketView> views;
+		for (size_t i = 0; i < packets.size(); i++) {
+			buffer.insert(buffer.end(), packets[i].begin(), packets[i].end());
+			views.push_back(CCSDSSpacePacketView(&packets[i][0], packets[i].size()));
+		}
+		std::vector<uint32_t> selection;
+		CCSDS_CHECK(filter.select(views, selection) == 2);
+		CCSDS_CHECK(selection[0] == 0 && selection[1] == 2);
+
+		//a truncated packet at the end stops the walk
+		buffer.push_back(0x00);
+		std::vector<size_t> offsets;
+		CCSDS_CHECK(filter.select(&buffer[0], buffer.size(), offsets) == buffer.size() - 1);
+		CCSDS_CHECK(offsets.size() == 2);
+		CCSDS_CHECK(offsets[0] == 0 && offsets[1] == packets[0].size() + packets[1].size());
+	}
+	return 0;
+}
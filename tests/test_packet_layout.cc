@@ -0,0 +1,120 @@
+/*
+ * test_packet_layout.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "CCSDSPacketLayout.hh"
+#include "CCSDSTest.hh"
+#include <string>
+#include <vector>
+
+CCSDS_FIELD(BusVoltage, 0, 16, CCSDSFieldEndianness::BigEndian, false);
+CCSDS_FIELD(Temperature, 16, 12, CCSDSFieldEndianness::BigEndian, true);
+CCSDS_FIELD(HeaterOn, 28, 1, CCSDSFieldEndianness::BigEndian, false);
+CCSDS_FIELD(Counter, 32, 32, CCSDSFieldEndianness::LittleEndian, false);
+CCSDS_FIELD(Unaligned, 37, 57, CCSDSFieldEndianness::BigEndian, true);
+CCSDS_FIELD(Wide, 64, 64, CCSDSFieldEndianness::BigEndian, false);
+typedef CCSDSPacketLayout<0x123, 16, BusVoltage, Temperature, HeaterOn, Counter, Unaligned, Wide> Layout;
+
+static_assert(std::is_same<BusVoltage::value_type, uint16_t>::value, "16-bit unsigned field");
+static_assert(std::is_same<Temperature::value_type, int16_t>::value, "12-bit signed field");
+static_assert(std::is_same<HeaterOn::value_type, uint8_t>::value, "1-bit field");
+static_assert(std::is_same<Unaligned::value_type, int64_t>::value, "57-bit signed field");
+static_assert(Layout::NFields == 6 && Unaligned::RequiredLength == 12, "layout constants");
+
+/** Reference extractor that reads a big-endian field bit by bit. */
+static uint64_t extractBits(const uint8_t* data, size_t bitOffset, size_t width, bool isSigned) {
+	uint64_t value = 0;
+	for (size_t i = 0; i < width; i++) {
+		size_t bit = bitOffset + i;
+		value = (value << 1) | ((data[bit / 8] >> (7 - bit % 8)) & 0x01);
+	}
+	if (isSigned && width < 64 && ((value >> (width - 1)) & 0x01)) {
+		value |= ~(uint64_t) 0 << width;
+	}
+	return value;
+}
+
+class NameValueVisitor {
+public:
+	std::vector<std::string> names;
+	std::vector<int64_t> values;
+
+	template<typename T>
+	void operator()(const char* name, T value) {
+		names.push_back(name);
+		values.push_back((int64_t) value);
+	}
+};
+
+int main() {
+	//a hand-made User Data Field
+	{
+		const uint8_t data[16] = { 0x12, 0x34, 0xFF, 0xE8, 0x78, 0x56, 0x34, 0x12, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+				0x07, 0x08 };
+		CCSDS_CHECK(Layout::get<BusVoltage>(data) == 0x1234);
+		CCSDS_CHECK(Layout::get<Temperature>(data) == -2);
+		CCSDS_CHECK(Layout::get<HeaterOn>(data) == 1);
+		CCSDS_CHECK(Layout::get<Counter>(data) == 0x12345678);
+		CCSDS_CHECK(Layout::get<Wide>(data) == 0x0102030405060708ULL);
+
+		NameValueVisitor visitor;
+		Layout::visit(data, visitor);
+		CCSDS_CHECK(visitor.names.size() == 6 && visitor.names[0] == "BusVoltage" && visitor.names[5] == "Wide");
+		CCSDS_CHECK(visitor.values.size() == 6 && visitor.values[1] == -2 && visitor.values[3] == 0x12345678);
+	}
+
+	//extractors agree with a bit-by-bit reference on pseudo-random data
+	{
+		uint64_t state = 88172645463325252ULL;
+		uint8_t data[16];
+		size_t nMismatches = 0;
+		for (size_t trial = 0; trial < 10000; trial++) {
+			for (size_t i = 0; i < sizeof(data); i++) {
+				state ^= state << 13;
+				state ^= state >> 7;
+				state ^= state << 17;
+				data[i] = (uint8_t) state;
+			}
+			uint32_t counter = data[4] | (data[5] << 8) | (data[6] << 16) | ((uint32_t) data[7] << 24);
+			if (Layout::get<BusVoltage>(data) != (uint16_t) extractBits(data, 0, 16, false)
+					|| (int64_t) Layout::get<Temperature>(data) != (int64_t) extractBits(data, 16, 12, true)
+					|| Layout::get<HeaterOn>(data) != extractBits(data, 28, 1, false) || Layout::get<Counter>(data) != counter
+					|| (uint64_t) Layout::get<Unaligned>(data) != extractBits(data, 37, 57, true)
+					|| Layout::get<Wide>(data) != extractBits(data, 64, 64, false)) {
+				nMismatches++;
+			}
+		}
+		CCSDS_CHECK(nMismatches == 0);
+	}
+
+	//views and packet instances
+	{
+		std::vector<uint8_t> userData(16);
+		for (size_t i = 0; i < userData.size(); i++) {
+			userData[i] = (uint8_t) (i * 17 + 3);
+		}
+		CCSDSSpacePacket packet;
+		packet.getPrimaryHeader()->setAPID(0x123);
+		packet.setUserDataField(userData);
+		packet.setPacketDataLength();
+		std::vector<uint8_t> bytes = packet.getAsByteVector();
+		CCSDSSpacePacketView view(&bytes[0], bytes.size());
+		CCSDS_CHECK(Layout::matches(view));
+		CCSDS_CHECK(Layout::get<Wide>(view) == Layout::get<Wide>(&userData[0]));
+		CCSDS_CHECK(Layout::get<Unaligned>(&packet) == Layout::get<Unaligned>(&userData[0]));
+
+		//another APID, or a User Data Field shorter than the layout
+		packet.getPrimaryHeader()->setAPID(0x124);
+		bytes = packet.getAsByteVector();
+		CCSDS_CHECK(!Layout::matches(CCSDSSpacePacketView(&bytes[0], bytes.size())));
+		packet.getPrimaryHeader()->setAPID(0x123);
+		packet.setUserDataField(std::vector<uint8_t>(15));
+		packet.setPacketDataLength();
+		bytes = packet.getAsByteVector();
+		CCSDS_CHECK(!Layout::matches(CCSDSSpacePacketView(&bytes[0], bytes.size())));
+	}
+	return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * test_packet_range.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "CCSDSPacketRange.hh"
+#include "CCSDSTest.hh"
+#include <sstream>
+#include <string>
+#include <vector>
+
+int main() {
+	//APIDs 0x120 to 0x124; every 7th packet is a telecommand, and odd packets have a Secondary Header with Category i % 3
+	std::vector<uint8_t> stream;
+	size_t nPackets = 0;
+	size_t nAPID123 = 0;
+	size_t nAPID123Category2 = 0;
+	size_t nCommands = 0;
+	for (size_t i = 0; i < 1000; i++) {
+		CCSDSSpacePacket packet;
+		uint16_t apid = 0x120 + i % 5;
+		packet.getPrimaryHeader()->setAPID(apid);
+		if (i % 7 == 0) {
+			packet.getPrimaryHeader()->setPacketType(CCSDSSpacePacketPacketType::CommandPacket);
+			nCommands++;
+		}
+		if (i % 2 == 1) {
+			packet.getPrimaryHeader()->setSecondaryHeaderFlag(CCSDSSpacePacketSecondaryHeaderFlag::Present);
+			packet.getSecondaryHeader()->setCategory((uint8_t) (i % 3));
+			if (i % 3 == 2 && apid == 0x123) {
+				nAPID123Category2++;
+			}
+		}
+		if (apid == 0x123) {
+			nAPID123++;
+		}
+		nPackets++;
+		packet.setUserDataField(std::vector<uint8_t>(20 + i % 50, 0x01));
+		packet.setPacketDataLength();
+		std::vector<uint8_t> bytes = packet.getAsByteVector();
+		stream.insert(stream.end(), bytes.begin(), bytes.end());
+	}
+	size_t streamLength = stream.size();
+	//a truncated trailing packet
+	stream.push_back(0x00);
+	stream.push_back(0x01);
+	stream.push_back(0x02);
+
+	//iteration and chained filters
+	{
+		size_t n = 0;
+		size_t offset = 0;
+		bool contiguous = true;
+		for (auto packet : ccsds::packets(&stream[0], stream.size())) {
+			if (packet.data != &stream[offset]) {
+				contiguous = false;
+			}
+			offset += packet.length;
+			n++;
+		}
+		CCSDS_CHECK(n == nPackets && contiguous && offset == streamLength);
+
+		n = 0;
+		for (auto packet : ccsds::packets(stream).whereAPID(0x123)) {
+			CCSDS_CHECK(packet.getAPIDAsInteger() == 0x123);
+			n++;
+		}
+		CCSDS_CHECK(n == nAPID123);
+
+		n = 0;
+		for (auto packet : ccsds::packets(stream).whereAPID(0x123).whereCategory(2)) {
+			CCSDS_CHECK(packet.isSecondaryHeaderPresent() && packet.getCategory() == 2);
+			n++;
+		}
+		CCSDS_CHECK(n == nAPID123Category2);
+
+		n = 0;
+		for (auto packet : ccsds::packets(stream).whereType(CCSDSSpacePacketPacketType::CommandPacket)) {
+			CCSDS_CHECK(packet.isTCPacket());
+			n++;
+		}
+		CCSDS_CHECK(n == nCommands);
+		CCSDS_CHECK(ccsds::packets(stream).getNumberOfRemainingBytes() == 3);
+	}
+
+	//iterator semantics
+	{
+		CCSDSPacketRange range = ccsds::packets(stream);
+		CCSDSPacketIterator it = range.begin();
+		CCSDSPacketIterator previous = it++;
+		CCSDS_CHECK(previous == range.begin() && it != previous);
+		CCSDS_CHECK(it.getPosition() == previous->length && (*it).data == &stream[previous->length]);
+		CCSDS_CHECK(std::distance(range.begin(), range.end()) == (std::ptrdiff_t) nPackets);
+		CCSDS_CHECK(ccsds::packets(&stream[0], 3).begin() == ccsds::packets(&stream[0], 3).end());
+		CCSDS_CHECK(ccsds::packets(stream).whereAPID(0x7FF).begin() == range.end());
+	}
+
+#ifdef CCSDS_HAS_COROUTINE
+	//generators over a stream and a packet source
+	{
+		std::istringstream is(std::string((const char*) &stream[0], stream.size()));
+		size_t n = 0;
+		for (auto packet : ccsds::packets(is, 70000)) {
+			CCSDS_CHECK(packet.length == packet.getTotalPacketLength());
+			n++;
+		}
+		CCSDS_CHECK(n == nPackets);
+		CCSDSBufferPacketSource source(&stream[0], stream.size());
+		n = 0;
+		for (auto packet : ccsds::packets(source)) {
+			(void) packet;
+			n++;
+		}
+		CCSDS_CHECK(n == nPackets);
+	}
+#endif
+	return 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * test_packet_recorder.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "CCSDSPacketRecorder.hh"
+#include "CCSDSTest.hh"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+static std::vector<uint8_t> readFile(const std::string& name) {
+	std::ifstream file(name.c_str(), std::ios::binary);
+	return std::vector<uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+int main() {
+	std::vector<uint8_t> packet(1034, 0x00);
+	packet[0] = 0x09;
+	packet[1] = 0x23;
+	packet[2] = 0xC0;
+	packet[4] = (packet.size() - 7) >> 8;
+	packet[5] = (packet.size() - 7) & 0xFF;
+
+	//packets and index records survive rotation
+	{
+		CCSDSPacketRecorder recorder("test_packet_recorder_rotation", 64 * 1024, 4);
+		recorder.setRotationSize(1000000);
+		recorder.setIndexEnabled(true);
+		const size_t nPackets = 3000;
+		for (size_t i = 0; i < nPackets; i++) {
+			packet[3] = i & 0xFF;
+			packet[9] = i & 0xFF;
+			recorder.write(&packet[0], packet.size());
+		}
+		recorder.close();
+		std::vector<std::string> fileNames = recorder.getFileNames();
+		CCSDS_CHECK(fileNames.size() == 4);
+		size_t n = 0;
+		for (size_t f = 0; f < fileNames.size(); f++) {
+			std::vector<uint8_t> data = readFile(fileNames[f]);
+			std::vector<uint8_t> index = readFile(fileNames[f] + ".idx");
+			CCSDS_CHECK(index.size() >= CCSDSPacketRecorder::IndexHeaderLength);
+			CCSDS_CHECK(std::memcmp(&index[0], "CCSDSIDX", 8) == 0);
+			size_t nRecords = (index.size() - CCSDSPacketRecorder::IndexHeaderLength) / CCSDSPacketRecorder::IndexRecordLength;
+			CCSDS_CHECK(data.size() == nRecords * packet.size());
+			for (size_t i = 0; i < nRecords; i++, n++) {
+				CCSDS_CHECK(data[i * packet.size() + 9] == (n & 0xFF));
+				CCSDS_CHECK(index[CCSDSPacketRecorder::IndexHeaderLength + i * CCSDSPacketRecorder::IndexRecordLength + 12]
+						== (n & 0xFF));
+			}
+			std::remove(fileNames[f].c_str());
+			std::remove((fileNames[f] + ".idx").c_str());
+		}
+		CCSDS_CHECK(n == nPackets);
+	}
+
+	//PeriodicSync synchronizes written data even if no more data follows
+	{
+		CCSDSPacketRecorder recorder("test_packet_recorder_sync");
+		recorder.setDurabilityPolicy(CCSDSPacketRecorder::PeriodicSync, 20);
+		recorder.write(&packet[0], packet.size());
+		recorder.flush();
+		uint64_t nSyncs = recorder.getNumberOfSyncs();
+		std::this_thread::sleep_for(std::chrono::milliseconds(200));
+		recorder.flush();
+		CCSDS_CHECK(recorder.getNumberOfSyncs() == nSyncs + 1);
+		recorder.close();
+		std::remove(recorder.getFileNames()[0].c_str());
+	}
+
+	//errors carry the reason of the failed call
+	{
+		CCSDSPacketRecorder recorder("test_packet_recorder_no_such_directory/data");
+		recorder.write(&packet[0], packet.size());
+		bool thrown = false;
+		try {
+			recorder.flush();
+		} catch (CCSDSPacketRecorderException& e) {
+			thrown = true;
+			CCSDS_CHECK(e.toString().find("No such file or directory") != std::string::npos);
+		}
+		CCSDS_CHECK(thrown);
+	}
+	return 0;
+}
@@ -0,0 +1,68 @@
+/*
+ * test_packet_replayer.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "CCSDSPacketReplayer.hh"
+#include "CCSDSTest.hh"
+
+class Listener: public CCSDSPacketReplayerListener {
+public:
+	CCSDSPacketReplayer* replayer;
+	size_t nPackets;
+	size_t stopAfter;
+
+public:
+	Listener() {
+		replayer = NULL;
+		nPackets = 0;
+		stopAfter = 0;
+	}
+
+public:
+	void onPackets(const CCSDSSpacePacketView*, size_t n) {
+		nPackets += n;
+		if (stopAfter != 0 && nPackets >= stopAfter) {
+			replayer->stop();
+		}
+	}
+};
+
+int main() {
+	//100 packets with a Secondary Header, one TI tick apart
+	const size_t nPackets = 100;
+	std::vector<uint8_t> archive;
+	for (size_t i = 0; i < nPackets; i++) {
+		CCSDSSpacePacket packet;
+		packet.getPrimaryHeader()->setAPID(0x123);
+		packet.getPrimaryHeader()->setSecondaryHeaderFlag(CCSDSSpacePacketSecondaryHeaderFlag::Present);
+		packet.getSecondaryHeader()->setTime((uint32_t) i);
+		packet.setUserDataField(std::vector<uint8_t>(16, (uint8_t) i));
+		std::vector<uint8_t> bytes = packet.getAsByteVector();
+		archive.insert(archive.end(), bytes.begin(), bytes.end());
+	}
+
+	Listener listener;
+	CCSDSPacketReplayer replayer(&archive[0], archive.size(), &listener);
+	listener.replayer = &replayer;
+	replayer.setSpeed(CCSDSPacketReplayer::AsFastAsPossible);
+	replayer.setMaximumBatchSize(1);
+
+	//a stop requested before replay() is not lost
+	replayer.stop();
+	CCSDS_CHECK(replayer.replay() == 0);
+	CCSDS_CHECK(listener.nPackets == 0);
+	CCSDS_CHECK(replayer.replay() == 0);
+
+	//after reset(), replay() runs until stopped from the listener, and then continues from there
+	replayer.reset();
+	listener.stopAfter = 30;
+	CCSDS_CHECK(replayer.replay() == 30);
+	listener.stopAfter = 0;
+	replayer.reset();
+	CCSDS_CHECK(replayer.replay() == nPackets - 30);
+	CCSDS_CHECK(listener.nPackets == nPackets);
+	return 0;
+}
@@ -0,0 +1,131 @@
+/*
+ * test_packet_stream_merger.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "CCSDSPacketStreamMerger.hh"
+#include "CCSDSTest.hh"
+#include <cstdio>
+#include <vector>
+
+static void appendPacket(std::vector<uint8_t>& stream, uint16_t apid, uint16_t sequenceCount, bool secondaryHeaderPresent,
+		uint32_t ti, size_t userDataLength) {
+	CCSDSSpacePacket packet;
+	packet.getPrimaryHeader()->setAPID(apid);
+	packet.getPrimaryHeader()->setSequenceCount((size_t) sequenceCount);
+	if (secondaryHeaderPresent) {
+		packet.getPrimaryHeader()->setSecondaryHeaderFlag(CCSDSSpacePacketSecondaryHeaderFlag::Present);
+		packet.getSecondaryHeader()->setTime(ti);
+	}
+	packet.setUserDataField(std::vector<uint8_t>(userDataLength, (uint8_t) apid));
+	packet.setPacketDataLength();
+	std::vector<uint8_t> bytes = packet.getAsByteVector();
+	stream.insert(stream.end(), bytes.begin(), bytes.end());
+}
+
+/** Packets whose TI increases by step from firstTI, with sequence counts crossing the 14-bit wrap-around. */
+static std::vector<uint8_t> createStream(uint16_t apid, uint32_t firstTI, uint32_t step, size_t nPackets) {
+	std::vector<uint8_t> stream;
+	for (size_t i = 0; i < nPackets; i++) {
+		appendPacket(stream, apid, (16380 + i) % 16384, true, firstTI + (uint32_t) i * step, 1 + (i * 37) % 2000);
+	}
+	return stream;
+}
+
+int main() {
+	//serial-number comparison
+	{
+		CCSDS_CHECK(CCSDSPacketStreamMerger::compareTI(1, 2) < 0);
+		CCSDS_CHECK(CCSDSPacketStreamMerger::compareTI(0xFFFFFFF0, 0x10) < 0);
+		CCSDS_CHECK(CCSDSPacketStreamMerger::compareTI(0x10, 0xFFFFFFF0) > 0);
+		CCSDS_CHECK(CCSDSPacketStreamMerger::compareSequenceCount(16383, 0) < 0);
+		CCSDS_CHECK(CCSDSPacketStreamMerger::compareSequenceCount(2, 16380) > 0);
+		CCSDS_CHECK(CCSDSPacketStreamMerger::compareSequenceCount(5, 5) == 0);
+	}
+
+	//buffer source stops at a truncated packet
+	{
+		std::vector<uint8_t> stream;
+		appendPacket(stream, 1, 0, true, 0, 10);
+		appendPacket(stream, 1, 1, true, 0, 10);
+		stream.resize(stream.size() - 1);
+		CCSDSBufferPacketSource source(&stream[0], stream.size());
+		CCSDSSpacePacketView view;
+		CCSDS_CHECK(source.next(view) && view.getSequenceCount() == 0);
+		CCSDS_CHECK(!source.next(view));
+		CCSDS_CHECK(source.getPosition() == 22 && source.getNumberOfRemainingBytes() == 21);
+	}
+
+	//three streams crossing the TI wrap-around, one read from a file through a small buffer
+	{
+		const uint32_t firstTI = 0xFFFFFF00;
+		std::vector<uint8_t> a = createStream(1, firstTI, 1, 500);
+		std::vector<uint8_t> b = createStream(2, firstTI + 100, 2, 500);
+		std::vector<uint8_t> c = createStream(3, firstTI, 1, 500);
+		const char* filename = "test_packet_stream_merger.bin";
+		FILE* file = fopen(filename, "wb");
+		fwrite(&b[0], 1, b.size(), file);
+		fclose(file);
+		{
+			CCSDSBufferPacketSource sourceA(&a[0], a.size());
+			CCSDSFilePacketSource sourceB(filename, 1);
+			CCSDSBufferPacketSource sourceC(&c[0], c.size());
+			CCSDSPacketStreamMerger merger;
+			merger.addSource(&sourceA);
+			merger.addSource(&sourceB);
+			merger.addSource(&sourceC);
+			CCSDSSpacePacketView view;
+			size_t nPackets = 0;
+			size_t nOutOfOrder = 0;
+			uint32_t lastTI = firstTI;
+			uint16_t lastAPID = 0;
+			while (merger.next(view)) {
+				uint32_t ti = view.getTimeAsInteger();
+				if (CCSDSPacketStreamMerger::compareTI(ti, lastTI) < 0 || (ti == lastTI && view.getAPIDAsInteger() < lastAPID)) {
+					nOutOfOrder++;
+				}
+				//the view must still point to an intact packet
+				if (view.getUserDataField()[0] != view.getAPIDAsInteger()) {
+					nOutOfOrder++;
+				}
+				lastTI = ti;
+				lastAPID = view.getAPIDAsInteger();
+				nPackets++;
+			}
+			CCSDS_CHECK(nPackets == 1500 && nOutOfOrder == 0);
+			CCSDS_CHECK(lastTI == firstTI + 100 + 499 * 2);
+		}
+		std::remove(filename);
+	}
+
+	//ties are broken by APID, then Sequence Count, then source order; packets without Secondary Header inherit the TI
+	{
+		std::vector<uint8_t> a, b;
+		appendPacket(a, 5, 16383, true, 10, 1);
+		appendPacket(a, 5, 0, false, 0, 1);
+		appendPacket(a, 1, 1, true, 20, 1);
+		appendPacket(b, 3, 7, true, 10, 1);
+		appendPacket(b, 5, 16383, true, 10, 1);
+		CCSDSBufferPacketSource sourceA(&a[0], a.size());
+		CCSDSBufferPacketSource sourceB(&b[0], b.size());
+		CCSDSPacketStreamMerger merger;
+		merger.addSource(&sourceA);
+		merger.addSource(&sourceB);
+		CCSDSSpacePacketView view;
+		std::vector<const uint8_t*> order;
+		while (merger.next(view)) {
+			order.push_back(view.data);
+		}
+		CCSDS_CHECK(order.size() == 5);
+		if (order.size() == 5) {
+			CCSDS_CHECK(order[0] == &b[0]); //APID 3
+			CCSDS_CHECK(order[1] == &a[0]); //APID 5, count 16383, source 0
+			CCSDS_CHECK(order[2] == &b[13]); //APID 5, count 16383, source 1
+			CCSDS_CHECK(order[3] == &a[13]); //APID 5, count 0 (after 16383), TI 10 inherited
+			CCSDS_CHECK(order[4] == &a[20]); //TI 20
+		}
+	}
+	return 0;
+}
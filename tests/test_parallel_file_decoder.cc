@@ -0,0 +1,128 @@
+/*
+ * test_parallel_file_decoder.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "CCSDSParallelFileDecoder.hh"
+#include "CCSDSTest.hh"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/** Concatenates packets of random APIDs and lengths, with occasional garbage bytes in between. */
+static std::vector<uint8_t> createStream(size_t nPackets, size_t& nGarbageBytes) {
+	std::vector<uint8_t> stream;
+	nGarbageBytes = 0;
+	for (size_t i = 0; i < nPackets; i++) {
+		CCSDSSpacePacket packet;
+		packet.getPrimaryHeader()->setAPID(rand() % 2048);
+		packet.getPrimaryHeader()->setSecondaryHeaderFlag((uint8_t) (rand() % 2));
+		packet.getPrimaryHeader()->setSequenceCount(i);
+		packet.getSecondaryHeader()->setSecondaryHeaderType(std::bitset<1>(rand() % 2));
+		packet.getSecondaryHeader()->setTime((uint32_t) i);
+		std::vector<uint8_t> data(rand() % 300 + 1);
+		for (size_t k = 0; k < data.size(); k++) {
+			data[k] = (uint8_t) rand();
+		}
+		packet.setUserDataField(data);
+		packet.setPacketDataLength();
+		std::vector<uint8_t> bytes = packet.getAsByteVector();
+		stream.insert(stream.end(), bytes.begin(), bytes.end());
+		if (rand() % 200 == 0) {
+			size_t n = rand() % 50;
+			for (size_t k = 0; k < n; k++) {
+				stream.push_back((uint8_t) rand());
+			}
+			nGarbageBytes += n;
+		}
+	}
+	return stream;
+}
+
+int main() {
+	srand(1);
+
+	//views of a hand-made packet
+	{
+		CCSDSSpacePacket packet;
+		packet.getPrimaryHeader()->setAPID(0x456);
+		packet.getPrimaryHeader()->setSequenceCount(0x1ABC);
+		packet.getPrimaryHeader()->setSecondaryHeaderFlag(CCSDSSpacePacketSecondaryHeaderFlag::Present);
+		packet.getSecondaryHeader()->setSecondaryHeaderType(CCSDSSpacePacketSecondaryHeaderType::ADUChannelIsUsed);
+		packet.getSecondaryHeader()->setTime((uint32_t) 0x01020304);
+		packet.getSecondaryHeader()->setADUChannelID(7);
+		packet.getSecondaryHeader()->setADUSegmentCount(0x2345);
+		std::vector<uint8_t> data(20, 0xAA);
+		packet.setUserDataField(data);
+		packet.setPacketDataLength();
+		std::vector<uint8_t> bytes = packet.getAsByteVector();
+		CCSDS_CHECK(CCSDSSpacePacketView::isPlausiblePacket(&bytes[0], bytes.size()));
+		CCSDS_CHECK(!CCSDSSpacePacketView::isPlausiblePacket(&bytes[0], bytes.size() - 1));
+		CCSDSSpacePacketView view(&bytes[0], bytes.size());
+		CCSDS_CHECK(view.getAPIDAsInteger() == 0x456 && view.getSequenceCount() == 0x1ABC);
+		CCSDS_CHECK(view.isSecondaryHeaderPresent() && view.isADUChannelUsed());
+		CCSDS_CHECK(view.getSecondaryHeaderLength() == 9);
+		CCSDS_CHECK(view.getTimeAsInteger() == 0x01020304 && view.getADUChannelID() == 7);
+		CCSDS_CHECK(view.getADUSegmentCount() == 0x2345);
+		CCSDS_CHECK(view.getUserDataFieldLength() == 20 && view.getUserDataField()[0] == 0xAA);
+		CCSDS_CHECK(view.getTotalPacketLength() == bytes.size() && view.getAsByteVector() == bytes);
+		CCSDSSpacePacket interpreted;
+		view.interpretAs(&interpreted);
+		CCSDS_CHECK(interpreted.getAsByteVector() == bytes);
+	}
+
+	//parallel decoding gives the same packets as sequential decoding, also across garbage bytes
+	for (size_t trial = 0; trial < 10; trial++) {
+		size_t nGarbageBytes;
+		std::vector<uint8_t> stream = createStream(3000, nGarbageBytes);
+		CCSDSParallelFileDecoder sequential(&stream[0], stream.size());
+		sequential.setNumberOfThreads(1);
+		std::vector<CCSDSSpacePacketView> expected = sequential.decode();
+
+		CCSDSParallelFileDecoder parallel(&stream[0], stream.size());
+		parallel.setNumberOfThreads(1 + rand() % 40);
+		parallel.setMinimumRangeSize(1 + rand() % 5000);
+		std::vector<CCSDSSpacePacketView> views = parallel.decode();
+		CCSDS_CHECK(views.size() == expected.size());
+		for (size_t i = 0; i < views.size() && i < expected.size(); i++) {
+			CCSDS_CHECK(views[i].data == expected[i].data && views[i].length == expected[i].length);
+		}
+		CCSDS_CHECK(parallel.getNumberOfSkippedBytes() == sequential.getNumberOfSkippedBytes());
+
+		std::vector<CCSDSSpacePacket*> packets = parallel.decodeToPackets();
+		CCSDS_CHECK(packets.size() == expected.size());
+		for (size_t i = 0; i < packets.size(); i++) {
+			CCSDS_CHECK(packets[i]->getAsByteVector() == expected[i].getAsByteVector());
+			delete packets[i];
+		}
+	}
+
+	//a memory-mapped file
+	{
+		size_t nGarbageBytes;
+		std::vector<uint8_t> stream = createStream(100, nGarbageBytes);
+		const char* filename = "test_parallel_file_decoder.bin";
+		FILE* file = fopen(filename, "wb");
+		fwrite(&stream[0], 1, stream.size(), file);
+		fclose(file);
+		{
+			CCSDSParallelFileDecoder decoder(filename);
+			decoder.setNumberOfThreads(4);
+			decoder.setMinimumRangeSize(256);
+			CCSDS_CHECK(decoder.getBufferSize() == stream.size());
+			CCSDS_CHECK(decoder.decode().size() == 100 && decoder.getNumberOfSkippedBytes() == nGarbageBytes);
+		}
+		std::remove(filename);
+
+		bool thrown = false;
+		try {
+			CCSDSParallelFileDecoder decoder(filename);
+		} catch (CCSDSParallelFileDecoderException& e) {
+			thrown = true;
+		}
+		CCSDS_CHECK(thrown);
+	}
+	return 0;
+}
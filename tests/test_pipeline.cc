@@ -0,0 +1,191 @@
+/*
+ * test_pipeline.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "CCSDSPipeline.hh"
+#include "CCSDSTest.hh"
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <thread>
+#include <vector>
+
+static void appendPacket(std::vector<uint8_t>& stream, uint16_t apid, uint16_t sequenceCount, bool aduChannelUsed,
+		uint32_t segmentFlag, uint8_t aduCount, uint16_t segmentCount, uint32_t ti) {
+	CCSDSSpacePacket packet;
+	packet.getPrimaryHeader()->setAPID(apid);
+	packet.getPrimaryHeader()->setSequenceCount((size_t) sequenceCount);
+	if (aduChannelUsed) {
+		packet.getPrimaryHeader()->setSecondaryHeaderFlag(CCSDSSpacePacketSecondaryHeaderFlag::Present);
+		packet.getSecondaryHeader()->setSecondaryHeaderType(CCSDSSpacePacketSecondaryHeaderType::ADUChannelIsUsed);
+		packet.getSecondaryHeader()->setADUChannelID(1);
+		packet.getSecondaryHeader()->setADUSegmentFlag(segmentFlag);
+		packet.getSecondaryHeader()->setADUCount(aduCount);
+		packet.getSecondaryHeader()->setADUSegmentCount((size_t) segmentCount);
+		packet.getSecondaryHeader()->setTime(ti);
+	}
+	packet.setUserDataField(std::vector<uint8_t>(40, (uint8_t) apid));
+	packet.setPacketDataLength();
+	std::vector<uint8_t> bytes = packet.getAsByteVector();
+	stream.insert(stream.end(), bytes.begin(), bytes.end());
+}
+
+/** Records ADUs and packets, and checks that packets of each APID arrive in order. */
+class RecordingSink: public CCSDSPipelineSink {
+public:
+	std::map<uint16_t, std::vector<uint32_t> > aduTIs;
+	std::map<uint16_t, uint16_t> lastSequenceCounts;
+	std::map<uint16_t, size_t> nPacketsPerAPID;
+	uint64_t nPackets;
+	bool inOrder;
+	size_t delayInMicroseconds;
+
+	RecordingSink() {
+		nPackets = 0;
+		inOrder = true;
+		delayInMicroseconds = 0;
+	}
+
+	virtual void onADU(const ADU& adu) {
+		aduTIs[adu.lowerAPID].push_back(adu.TI);
+	}
+
+	virtual void onPacket(const CCSDSSpacePacket& packet) {
+		uint16_t apid = packet.getPrimaryHeader()->getAPIDAsInteger();
+		uint16_t sequenceCount = packet.getPrimaryHeader()->getSequenceCount().to_ulong();
+		if (lastSequenceCounts.count(apid) != 0 && sequenceCount != ((lastSequenceCounts[apid] + 1) & 0x3FFF)) {
+			inOrder = false;
+		}
+		lastSequenceCounts[apid] = sequenceCount;
+		nPacketsPerAPID[apid]++;
+		nPackets++;
+		if (delayInMicroseconds != 0) {
+			std::this_thread::sleep_for(std::chrono::microseconds(delayInMicroseconds));
+		}
+	}
+};
+
+int main() {
+	//lock-free ring: capacity, FIFO order, and multiple producers and consumers
+	{
+		CCSDSLockFreeRing<size_t> ring(5);
+		CCSDS_CHECK(ring.getCapacity() == 8 && ring.empty());
+		for (size_t i = 0; i < 8; i++) {
+			CCSDS_CHECK(ring.tryPush(i));
+		}
+		CCSDS_CHECK(!ring.tryPush(8) && ring.size() == 8);
+		size_t value;
+		for (size_t i = 0; i < 8; i++) {
+			CCSDS_CHECK(ring.tryPop(value) && value == i);
+		}
+		CCSDS_CHECK(!ring.tryPop(value) && ring.empty());
+
+		const size_t nThreads = 4;
+		const size_t nValuesPerProducer = 100000;
+		CCSDSLockFreeRing<size_t> shared(64);
+		std::vector<std::atomic<uint32_t>*> nReceived;
+		for (size_t i = 0; i < nThreads * nValuesPerProducer; i++) {
+			nReceived.push_back(new std::atomic<uint32_t>(0));
+		}
+		std::atomic<size_t> nPopped(0);
+		std::vector<std::thread> threads;
+		for (size_t t = 0; t < nThreads; t++) {
+			threads.push_back(std::thread([&, t]() {
+				for (size_t i = 0; i < nValuesPerProducer; i++) {
+					while (!shared.tryPush(t * nValuesPerProducer + i)) {
+						std::this_thread::yield();
+					}
+				}
+			}));
+			threads.push_back(std::thread([&]() {
+				size_t received;
+				while (nPopped.load() < nThreads * nValuesPerProducer) {
+					if (shared.tryPop(received)) {
+						(*nReceived[received])++;
+						nPopped++;
+					} else {
+						std::this_thread::yield();
+					}
+				}
+			}));
+		}
+		for (size_t i = 0; i < threads.size(); i++) {
+			threads[i].join();
+		}
+		size_t nWrong = 0;
+		for (size_t i = 0; i < nReceived.size(); i++) {
+			if (nReceived[i]->load() != 1) {
+				nWrong++;
+			}
+			delete nReceived[i];
+		}
+		CCSDS_CHECK(nWrong == 0 && shared.empty());
+	}
+
+	//ADUs of three segments on even APIDs and plain packets on odd APIDs
+	std::vector<uint8_t> stream;
+	size_t nADUs = 0;
+	size_t nPlainPackets = 0;
+	for (size_t i = 0; i < 6000; i++) {
+		uint16_t apid = 0x10 + (i % 6);
+		uint16_t n = i / 6;
+		if (apid & 0x01) {
+			appendPacket(stream, apid, n, false, 0, 0, 0, 0);
+			nPlainPackets++;
+		} else {
+			const uint32_t flags[3] = { CCSDSSpacePacketADUSegmentFlag::TheFirstSegment,
+					CCSDSSpacePacketADUSegmentFlag::ContinuationSegument, CCSDSSpacePacketADUSegmentFlag::TheLastSegment };
+			for (uint16_t s = 0; s < 3; s++) {
+				appendPacket(stream, apid, (n * 3 + s) & 0x3FFF, true, flags[s], (uint8_t) n, (n * 3 + s) & 0x3FFF, i);
+			}
+			nADUs++;
+		}
+	}
+
+	//every ADU and packet is delivered in order, with any number of lanes
+	for (size_t nLanes = 1; nLanes <= 3; nLanes++) {
+		CCSDSBufferPacketSource source(&stream[0], stream.size());
+		RecordingSink sink;
+		CCSDSPipeline pipeline(&source, &sink, nLanes, 64);
+		pipeline.start();
+		pipeline.join();
+		CCSDS_CHECK(pipeline.getNumberOfIngestedPackets() == nADUs * 3 + nPlainPackets);
+		CCSDS_CHECK(pipeline.getNumberOfADUs() == nADUs && pipeline.getNumberOfSinkPackets() == nPlainPackets);
+		CCSDS_CHECK(pipeline.getNumberOfDroppedPackets() == 0 && pipeline.getNumberOfDecodeErrors() == 0);
+		CCSDS_CHECK(pipeline.getNumberOfReassemblyErrors() == 0);
+		CCSDS_CHECK(sink.nPackets == nPlainPackets && sink.inOrder);
+		size_t nReceivedADUs = 0;
+		for (std::map<uint16_t, std::vector<uint32_t> >::iterator it = sink.aduTIs.begin(); it != sink.aduTIs.end(); it++) {
+			for (size_t k = 1; k < it->second.size(); k++) {
+				CCSDS_CHECK(it->second[k - 1] < it->second[k]);
+			}
+			nReceivedADUs += it->second.size();
+		}
+		CCSDS_CHECK(nReceivedADUs == nADUs);
+		std::vector<CCSDSPipelineQueueStatistics> statistics = pipeline.getQueueStatistics();
+		CCSDS_CHECK(statistics.size() == 2 * nLanes + 1);
+		CCSDS_CHECK(statistics[0].name == "decode[0]" && statistics.back().name == "sink");
+		CCSDS_CHECK(statistics.back().capacity == 64 && statistics.back().depth == 0);
+	}
+
+	//with a slow sink, dropped packets are accounted for and the highest priority is never dropped
+	for (size_t p = 0; p < 2; p++) {
+		CCSDSBufferPacketSource source(&stream[0], stream.size());
+		RecordingSink sink;
+		sink.delayInMicroseconds = 20;
+		CCSDSPipeline pipeline(&source, &sink, 1, 16);
+		pipeline.setReassemblyEnabled(false);
+		pipeline.setBackpressurePolicy((p == 0) ? CCSDSPipeline::DropOldest : CCSDSPipeline::DropByAPIDPriority);
+		pipeline.setAPIDPriority(0x11, CCSDSPipeline::NPriorityLevels - 1);
+		pipeline.start();
+		pipeline.join();
+		CCSDS_CHECK(pipeline.getNumberOfIngestedPackets() == sink.nPackets + pipeline.getNumberOfDroppedPackets());
+		if (p == 1) {
+			CCSDS_CHECK(sink.nPacketsPerAPID[0x11] == nPlainPackets / 3);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,155 @@
+/*
+ * test_secondary_header_policies.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "CCSDSSpacePacketSecondaryHeaderPolicies.hh"
+#include "CCSDSTest.hh"
+#include <vector>
+
+/** Serializes a packet with a 10-byte User Data Field, interprets it into another instance, and checks both agree. */
+template<class Packet>
+static std::vector<uint8_t> roundTrip(Packet& packet, Packet& decoded) {
+	packet.getPrimaryHeader()->setAPID(0x123);
+	packet.getPrimaryHeader()->setSecondaryHeaderFlag(CCSDSSpacePacketSecondaryHeaderFlag::Present);
+	std::vector<uint8_t> userData(10, 0x5A);
+	packet.setUserDataField(userData);
+	packet.setPacketDataLength();
+	std::vector<uint8_t> bytes = packet.getAsByteVector();
+	decoded.interpret(&bytes[0], bytes.size());
+	CCSDS_CHECK(decoded.getAsByteVector() == bytes);
+	CCSDS_CHECK(*decoded.getUserDataField() == userData);
+	return bytes;
+}
+
+template<class SecondaryHeader>
+static bool isRejectedWhenTooShort() {
+	SecondaryHeader secondaryHeader;
+	std::vector<uint8_t> data(SecondaryHeader::Length - 1, 0x00);
+	try {
+		secondaryHeader.interpret(&data[0], data.size());
+	} catch (CCSDSSpacePacketException& e) {
+		return e.getStatus() == CCSDSSpacePacketException::SecondaryHeaderTooShort;
+	}
+	return false;
+}
+
+int main() {
+	const size_t PrimaryHeaderLength = CCSDSSpacePacketPrimaryHeader::PrimaryHeaderLength;
+
+	//ISAS with ADU Channel: same bytes as the run-time Secondary Header
+	{
+		CCSDSSpacePacketWithADUChannel packet, decoded;
+		packet.getSecondaryHeader()->setTime((uint32_t) 0xDEADBEEF);
+		packet.getSecondaryHeader()->setCategory(5);
+		packet.getSecondaryHeader()->setADUChannelID(3);
+		packet.getSecondaryHeader()->setADUSegmentFlag(CCSDSSpacePacketADUSegmentFlag::TheFirstSegment);
+		packet.getSecondaryHeader()->setADUSegmentCount(0x1234);
+		std::vector<uint8_t> bytes = roundTrip(packet, decoded);
+		CCSDS_CHECK(bytes.size() == PrimaryHeaderLength + 9 + 10);
+		CCSDS_CHECK(decoded.getSecondaryHeader()->getTimeAsInteger() == 0xDEADBEEF);
+		CCSDS_CHECK(decoded.getSecondaryHeader()->getADUChannelID() == 3);
+		CCSDS_CHECK(decoded.getSecondaryHeader()->isADUFirstSegment());
+		CCSDS_CHECK(decoded.getSecondaryHeader()->getADUSegmentCount().to_ulong() == 0x1234);
+		CCSDSSpacePacketSecondaryHeader runtime;
+		runtime.interpret(&bytes[PrimaryHeaderLength], 9);
+		CCSDS_CHECK(runtime.isADUChannelUsed() && runtime.getADUChannelID() == 3);
+		CCSDS_CHECK(runtime.getAsByteVector() == packet.getSecondaryHeader()->getAsByteVector());
+		CCSDS_CHECK(isRejectedWhenTooShort<CCSDSISASSecondaryHeaderWithADUChannel>());
+	}
+
+	//ISAS without ADU Channel
+	{
+		CCSDSSpacePacketWithoutADUChannel packet, decoded;
+		packet.getSecondaryHeader()->setTime((uint32_t) 0x01020304);
+		packet.getSecondaryHeader()->setCategory(0x7F);
+		packet.getSecondaryHeader()->setADUCount(9);
+		std::vector<uint8_t> bytes = roundTrip(packet, decoded);
+		CCSDS_CHECK(bytes.size() == PrimaryHeaderLength + 6 + 10);
+		CCSDS_CHECK(decoded.getSecondaryHeader()->getCategory().to_ulong() == 0x7F);
+		CCSDS_CHECK(decoded.getSecondaryHeader()->getADUCount() == 9);
+		CCSDS_CHECK(!decoded.getSecondaryHeader()->isADUChannelUsed());
+	}
+
+	//CUC with P-field: P-field, Coarse Time and Fine Time are big endian in this order
+	{
+		typedef CCSDSCUCSecondaryHeader<4, 2, true> CUC;
+		CCSDS_CHECK(CUC::Length == 7);
+		CCSDS_CHECK(CUC::DefaultPField == 0x2E);
+		CCSDSSpacePacketT<CUC> packet, decoded;
+		packet.getSecondaryHeader()->setCoarseTime(0x11223344);
+		packet.getSecondaryHeader()->setFineTime(0x8000);
+		std::vector<uint8_t> bytes = roundTrip(packet, decoded);
+		const uint8_t expected[] = { 0x2E, 0x11, 0x22, 0x33, 0x44, 0x80, 0x00 };
+		CCSDS_CHECK(std::vector<uint8_t>(bytes.begin() + PrimaryHeaderLength, bytes.begin() + PrimaryHeaderLength + 7)
+				== std::vector<uint8_t>(expected, expected + 7));
+		CCSDS_CHECK(decoded.getSecondaryHeader()->getCoarseTime() == 0x11223344);
+		CCSDS_CHECK(decoded.getSecondaryHeader()->getTimeInSeconds() == 0x11223344 + 0.5);
+
+		//a P-field read from a packet is kept
+		bytes[PrimaryHeaderLength] = 0x1E;
+		decoded.interpret(&bytes[0], bytes.size());
+		CCSDS_CHECK(decoded.getSecondaryHeader()->getPField() == 0x1E);
+		CCSDS_CHECK(isRejectedWhenTooShort<CUC>());
+	}
+
+	//CUC without P-field: the P-field is implied
+	{
+		typedef CCSDSCUCSecondaryHeader<2, 1> CUC;
+		CCSDS_CHECK(CUC::Length == 3);
+		CCSDSSpacePacketT<CUC> packet, decoded;
+		packet.getSecondaryHeader()->setCoarseTime(0xABCD);
+		packet.getSecondaryHeader()->setFineTime(0x40);
+		packet.getSecondaryHeader()->setPField(0x00);
+		std::vector<uint8_t> bytes = roundTrip(packet, decoded);
+		CCSDS_CHECK(bytes.size() == PrimaryHeaderLength + 3 + 10);
+		CCSDS_CHECK(bytes[PrimaryHeaderLength] == 0xAB && bytes[PrimaryHeaderLength + 2] == 0x40);
+		CCSDS_CHECK(decoded.getSecondaryHeader()->getPField() == CUC::DefaultPField);
+		CCSDS_CHECK(decoded.getSecondaryHeader()->getTimeInSeconds() == 0xABCD + 0.25);
+	}
+
+	//CDS with P-field and microseconds
+	{
+		typedef CCSDSCDSSecondaryHeader<2, 2, true> CDS;
+		CCSDS_CHECK(CDS::Length == 9);
+		CCSDS_CHECK(CDS::DefaultPField == 0x49);
+		CCSDSSpacePacketT<CDS> packet, decoded;
+		packet.getSecondaryHeader()->setDay(0x0102);
+		packet.getSecondaryHeader()->setMillisecondsOfDay(0x03040506);
+		packet.getSecondaryHeader()->setSubmilliseconds(0x0708);
+		std::vector<uint8_t> bytes = roundTrip(packet, decoded);
+		const uint8_t expected[] = { 0x49, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08 };
+		CCSDS_CHECK(std::vector<uint8_t>(bytes.begin() + PrimaryHeaderLength, bytes.begin() + PrimaryHeaderLength + 9)
+				== std::vector<uint8_t>(expected, expected + 9));
+		CCSDS_CHECK(decoded.getSecondaryHeader()->getDay() == 0x0102);
+		CCSDS_CHECK(decoded.getSecondaryHeader()->getMillisecondsOfDay() == 0x03040506);
+		CCSDS_CHECK(decoded.getSecondaryHeader()->getSubmilliseconds() == 0x0708);
+		CCSDS_CHECK(isRejectedWhenTooShort<CDS>());
+	}
+
+	//CDS with 24-bit day and picoseconds, without P-field
+	{
+		typedef CCSDSCDSSecondaryHeader<3, 4> CDS;
+		CCSDS_CHECK(CDS::Length == 11);
+		CCSDS_CHECK(CDS::DefaultPField == 0x4E);
+		CCSDSSpacePacketT<CDS> packet, decoded;
+		packet.getSecondaryHeader()->setDay(0x010203);
+		packet.getSecondaryHeader()->setMillisecondsOfDay(1500);
+		packet.getSecondaryHeader()->setSubmilliseconds(250000000);
+		std::vector<uint8_t> bytes = roundTrip(packet, decoded);
+		CCSDS_CHECK(bytes[PrimaryHeaderLength] == 0x01 && bytes[PrimaryHeaderLength + 2] == 0x03);
+		CCSDS_CHECK(decoded.getSecondaryHeader()->getDay() == 0x010203);
+		CCSDS_CHECK(decoded.getSecondaryHeader()->getTimeInSeconds() == 0x010203 * 86400.0 + 1.50025);
+	}
+
+	//no Secondary Header: the whole Packet Data Field is User Data even if the flag is set
+	{
+		CCSDSSpacePacketWithoutSecondaryHeader packet, decoded;
+		std::vector<uint8_t> bytes = roundTrip(packet, decoded);
+		CCSDS_CHECK(bytes.size() == PrimaryHeaderLength + 10);
+		CCSDS_CHECK(decoded.getSecondaryHeader()->getLength() == 0);
+	}
+	return 0;
+}
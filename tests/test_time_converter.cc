@@ -0,0 +1,85 @@
+/*
+ * test_time_converter.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "CCSDSTimeConverter.hh"
+#include "CCSDSTest.hh"
+#include <random>
+
+static bool isClose(double a, double b) {
+	return std::fabs(a - b) < 1e-9;
+}
+
+int main() {
+	//without points, with one point, and interpolation/extrapolation between points
+	CCSDSTimeConverter converter;
+	CCSDS_CHECK(converter.convertToSeconds(128) == 2.0);
+	converter.addCorrelationPoint(1000, 100.0);
+	CCSDS_CHECK(converter.convertToSeconds(1064) == 101.0);
+	CCSDS_CHECK(converter.convertToNanoseconds(936) == 99000000000LL);
+	converter.addCorrelationPoint(2000, 116.0);
+	converter.addCorrelationPoint(3000, 131.0);
+	CCSDS_CHECK(isClose(converter.convertToSeconds(1500), 108.0));
+	CCSDS_CHECK(isClose(converter.convertToSeconds(2500), 123.5));
+	CCSDS_CHECK(isClose(converter.convertToSeconds(0), 84.0));
+	CCSDS_CHECK(isClose(converter.convertToSeconds(4000), 146.0));
+
+	//the SIMD kernels (when available) and the scalar loop give identical results,
+	//which also equal the single-value conversions
+	CCSDSTimeConverter utc;
+	utc.addCorrelationPoint(0x10000000, 1791590400.0);
+	utc.addCorrelationPoint(0x10540000, 1791676800.0);
+	utc.addCorrelationPoint(0x20000000, 1.8e9);
+	std::mt19937 random(1);
+	//mostly increasing TI that crosses the points, with occasional random values; n is not a multiple of 4
+	const size_t n = 100003;
+	std::vector<uint32_t> ti(n);
+	uint32_t t = 0x0FFF0000;
+	for (size_t i = 0; i < n; i++) {
+		t += random() % 4096;
+		ti[i] = (random() % 1000 == 0) ? (uint32_t) random() : t;
+	}
+	ti[0] = 0;
+	ti[1] = 0xFFFFFFFF;
+	ti[2] = 0x10000000;
+	ti[3] = 0x10540000;
+	std::vector<double> scalarSeconds(n), simdSeconds(n);
+	std::vector<int64_t> scalarNanoseconds(n), simdNanoseconds(n);
+	utc.setSIMDEnabled(false);
+	utc.convertToSeconds(&ti[0], n, &scalarSeconds[0]);
+	utc.convertToNanoseconds(&ti[0], n, &scalarNanoseconds[0]);
+	utc.setSIMDEnabled(true);
+	utc.convertToSeconds(&ti[0], n, &simdSeconds[0]);
+	utc.convertToNanoseconds(&ti[0], n, &simdNanoseconds[0]);
+	for (size_t i = 0; i < n; i++) {
+		CCSDS_CHECK(simdSeconds[i] == scalarSeconds[i]);
+		CCSDS_CHECK(simdNanoseconds[i] == scalarNanoseconds[i]);
+		CCSDS_CHECK(scalarSeconds[i] == utc.convertToSeconds(ti[i]));
+		CCSDS_CHECK(scalarNanoseconds[i] == utc.convertToNanoseconds(ti[i]));
+	}
+
+	//TI extraction from views and from raw pointers
+	std::vector<uint8_t> buffer(n * 16, 0x00);
+	std::vector<CCSDSSpacePacketView> views(n);
+	std::vector<const uint8_t*> pointers(n);
+	for (size_t i = 0; i < n; i++) {
+		uint8_t* packet = &buffer[i * 16];
+		packet[0] = 0x08;
+		packet[5] = 16 - 7;
+		packet[6] = ti[i] >> 24;
+		packet[7] = ti[i] >> 16;
+		packet[8] = ti[i] >> 8;
+		packet[9] = ti[i];
+		views[i] = CCSDSSpacePacketView(packet, 16);
+		pointers[i] = packet;
+	}
+	std::vector<uint32_t> fromViews(n), fromPointers(n);
+	CCSDSTimeConverter::extractTI(&views[0], n, &fromViews[0]);
+	CCSDSTimeConverter::extractTI(&pointers[0], n, &fromPointers[0]);
+	CCSDS_CHECK(fromViews == ti);
+	CCSDS_CHECK(fromPointers == ti);
+	return 0;
+}
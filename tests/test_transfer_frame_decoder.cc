@@ -0,0 +1,130 @@
+/*
+ * test_transfer_frame_decoder.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "CCSDSTransferFrameDecoder.hh"
+#include "CCSDSTest.hh"
+
+class Listener: public CCSDSTransferFrameDecoderListener {
+public:
+	std::vector<std::vector<uint8_t> > packets;
+
+public:
+	void onPacket(uint8_t, const CCSDSSpacePacketView& view) {
+		packets.push_back(std::vector<uint8_t>(view.data, view.data + view.length));
+	}
+};
+
+static const size_t FrameLength = 64;
+static const size_t DataFieldLength = FrameLength - CCSDSTransferFrameView::PrimaryHeaderLength;
+
+static std::vector<uint8_t> createPacket(uint16_t apid, size_t length) {
+	std::vector<uint8_t> packet(length, 0xA5);
+	packet[0] = (uint8_t) (apid >> 8);
+	packet[1] = (uint8_t) (apid & 0xFF);
+	packet[2] = 0xC0;
+	packet[3] = 0x00;
+	packet[4] = (uint8_t) ((length - 7) >> 8);
+	packet[5] = (uint8_t) ((length - 7) & 0xFF);
+	return packet;
+}
+
+static std::vector<uint8_t> createFrame(uint8_t frameCount, uint16_t firstHeaderPointer, const std::vector<uint8_t>& dataField) {
+	std::vector<uint8_t> frame(CCSDSTransferFrameView::PrimaryHeaderLength, 0x00);
+	frame[0] = 0x01;
+	frame[3] = frameCount;
+	frame[4] = (uint8_t) (firstHeaderPointer >> 8);
+	frame[5] = (uint8_t) (firstHeaderPointer & 0xFF);
+	frame.insert(frame.end(), dataField.begin(), dataField.end());
+	if (frame.size() < FrameLength) {
+		//fill the rest with an Idle Packet
+		std::vector<uint8_t> idle = createPacket(0x7FF, FrameLength - frame.size());
+		frame.insert(frame.end(), idle.begin(), idle.end());
+	}
+	return frame;
+}
+
+int main() {
+	//an invalid header of a continued packet: extraction restarts at the First Header Pointer of the same frame
+	{
+		//frame 1 ends with the first 3 bytes of a Primary Header with an invalid Packet Version Number
+		std::vector<uint8_t> a = createPacket(0x100, DataFieldLength - 3);
+		std::vector<uint8_t> dataField1 = a;
+		dataField1.push_back(0xE1);
+		dataField1.push_back(0x01);
+		dataField1.push_back(0xC0);
+		std::vector<uint8_t> frame1 = createFrame(0, 0, dataField1);
+		//frame 2 holds the rest of the header, then c at the First Header Pointer
+		std::vector<uint8_t> c = createPacket(0x102, 20);
+		std::vector<uint8_t> dataField2(3, 0x00);
+		dataField2.insert(dataField2.end(), c.begin(), c.end());
+		std::vector<uint8_t> frame2 = createFrame(1, 3, dataField2);
+		CCSDS_CHECK(frame1.size() == FrameLength && frame2.size() == FrameLength);
+
+		Listener listener;
+		CCSDSTransferFrameDecoder decoder(FrameLength, &listener);
+		decoder.decode(&frame1[0]);
+		decoder.decode(&frame2[0]);
+		CCSDS_CHECK(listener.packets.size() == 2);
+		CCSDS_CHECK(listener.packets[0] == a);
+		CCSDS_CHECK(listener.packets[1] == c);
+		CCSDS_CHECK(decoder.getNumberOfFrameErrors() == 1);
+	}
+
+	//only partial packets that are actually dropped are counted when the First Header Pointer disagrees
+	{
+		//frame 1 ends exactly at the end of a; frame 2 has spare bytes before the First Header Pointer
+		std::vector<uint8_t> a = createPacket(0x100, DataFieldLength);
+		std::vector<uint8_t> frame1 = createFrame(0, 0, a);
+		std::vector<uint8_t> c = createPacket(0x102, 20);
+		std::vector<uint8_t> dataField2(4, 0x00);
+		dataField2.insert(dataField2.end(), c.begin(), c.end());
+		std::vector<uint8_t> frame2 = createFrame(1, 4, dataField2);
+		//frame 3 ends with the first 10 bytes of b; frame 4 points to c before b is complete
+		std::vector<uint8_t> b = createPacket(0x101, 30);
+		std::vector<uint8_t> dataField3 = createPacket(0x100, DataFieldLength - 10);
+		dataField3.insert(dataField3.end(), b.begin(), b.begin() + 10);
+		std::vector<uint8_t> frame3 = createFrame(2, 0, dataField3);
+		std::vector<uint8_t> dataField4(b.begin() + 10, b.begin() + 15);
+		dataField4.insert(dataField4.end(), c.begin(), c.end());
+		std::vector<uint8_t> frame4 = createFrame(3, 5, dataField4);
+
+		Listener listener;
+		CCSDSTransferFrameDecoder decoder(FrameLength, &listener);
+		decoder.decode(&frame1[0]);
+		decoder.decode(&frame2[0]);
+		CCSDS_CHECK(listener.packets.size() == 2 && listener.packets[1] == c);
+		CCSDS_CHECK(decoder.getNumberOfDiscardedPartialPackets() == 0);
+		decoder.decode(&frame3[0]);
+		decoder.decode(&frame4[0]);
+		CCSDS_CHECK(listener.packets.size() == 4 && listener.packets[3] == c);
+		CCSDS_CHECK(decoder.getNumberOfDiscardedPartialPackets() == 1);
+	}
+
+	//frames too short for their headers and trailer are rejected without reading past the frame
+	{
+		Listener listener;
+		std::vector<uint8_t> frame(4, 0x00);
+		CCSDSTransferFrameDecoder decoder(frame.size(), &listener);
+		decoder.setFrameErrorControlFieldPresent(true);
+		decoder.decode(&frame[0]);
+		CCSDS_CHECK(decoder.getNumberOfFrameErrors() == 1);
+
+		//Secondary Header and Operational Control Field longer than the frame
+		std::vector<uint8_t> frame2 = createFrame(0, 0, createPacket(0x100, 20));
+		frame2[1] |= 0x01;
+		frame2[4] |= 0x80;
+		frame2[6] = 0x3F;
+		CCSDSTransferFrameView view(&frame2[0], frame2.size());
+		CCSDS_CHECK(!view.isLengthValid(false));
+		CCSDS_CHECK(view.getDataFieldLength(false) == 0);
+		CCSDSTransferFrameDecoder decoder2(FrameLength, &listener);
+		decoder2.decode(&frame2[0]);
+		CCSDS_CHECK(decoder2.getNumberOfFrameErrors() == 1);
+		CCSDS_CHECK(listener.packets.empty());
+	}
+	return 0;
+}
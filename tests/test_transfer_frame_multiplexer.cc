@@ -0,0 +1,131 @@
+/*
+ * test_transfer_frame_multiplexer.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "CCSDSTransferFrameMultiplexer.hh"
+#include "CCSDSTest.hh"
+#include <cstdlib>
+
+class Listener: public CCSDSTransferFrameDecoderListener {
+public:
+	std::vector<std::vector<uint8_t> > packets[CCSDSTransferFrameView::NVirtualChannels];
+
+public:
+	void onPacket(uint8_t virtualChannelID, const CCSDSSpacePacketView& view) {
+		packets[virtualChannelID].push_back(std::vector<uint8_t>(view.data, view.data + view.length));
+	}
+};
+
+static std::vector<uint8_t> createPacket(uint16_t apid, size_t length) {
+	std::vector<uint8_t> packet(length);
+	for (size_t i = 0; i < length; i++) {
+		packet[i] = (uint8_t) rand();
+	}
+	packet[0] = (uint8_t) (apid >> 8);
+	packet[1] = (uint8_t) (apid & 0xFF);
+	packet[2] = 0xC0;
+	packet[4] = (uint8_t) ((length - 7) >> 8);
+	packet[5] = (uint8_t) ((length - 7) & 0xFF);
+	return packet;
+}
+
+int main() {
+	//packets of several Virtual Channels are recovered by CCSDSTransferFrameDecoder
+	{
+		const size_t frameLength = 1115;
+		CCSDSTransferFrameMultiplexer multiplexer(frameLength, 0x123);
+		multiplexer.setFrameErrorControlFieldPresent(true);
+		multiplexer.setOperationalControlField(true, 0xDEADBEEF);
+		multiplexer.addVirtualChannel(0, 1, 1);
+		multiplexer.addVirtualChannel(1, 0, 3);
+		multiplexer.addVirtualChannel(2, 0, 1);
+		Listener listener;
+		CCSDSTransferFrameDecoder decoder(frameLength, &listener);
+		decoder.setFrameErrorControlFieldPresent(true);
+		std::vector<std::vector<uint8_t> > pushed[3];
+		std::vector<uint8_t> frame(frameLength);
+		for (size_t round = 0; round < 2000; round++) {
+			for (uint8_t vc = 0; vc < 3; vc++) {
+				if (rand() % 3 != 0) {
+					continue;
+				}
+				std::vector<uint8_t> packet = createPacket(vc * 10 + 1, 7 + rand() % ((rand() % 20 == 0) ? 3000 : 400));
+				if (multiplexer.push(vc, &packet[0], packet.size())) {
+					pushed[vc].push_back(packet);
+				}
+			}
+			multiplexer.buildFrame(&frame[0]);
+			decoder.decode(&frame[0]);
+		}
+		for (size_t i = 0; i < 300; i++) {
+			multiplexer.buildFrame(&frame[0]);
+			decoder.decode(&frame[0]);
+		}
+		for (uint8_t vc = 0; vc < 3; vc++) {
+			CCSDS_CHECK(listener.packets[vc] == pushed[vc]);
+		}
+		CCSDS_CHECK(decoder.getNumberOfFrameErrors() == 0);
+		CCSDS_CHECK(decoder.getNumberOfFrameCountJumps() == 0);
+	}
+
+	//idle fill ends with the frame, and a few idle bytes left over do not get a frame of their own
+	{
+		const size_t frameLength = 64;
+		CCSDSTransferFrameMultiplexer multiplexer(frameLength, 0x123);
+		multiplexer.addVirtualChannel(0, 1, 1);
+		multiplexer.addVirtualChannel(1, 0, 1);
+		const size_t dataFieldLength = multiplexer.getDataFieldLength();
+		Listener listener;
+		CCSDSTransferFrameDecoder decoder(frameLength, &listener);
+		std::vector<uint8_t> frame(frameLength);
+
+		//the Idle Packet exactly fills the rest of the frame
+		std::vector<uint8_t> a = createPacket(0x001, 20);
+		multiplexer.push(0, &a[0], a.size());
+		CCSDS_CHECK(multiplexer.buildFrame(&frame[0]) == 0);
+		decoder.decode(&frame[0]);
+		CCSDS_CHECK(multiplexer.getQueuedBytes(0) == 0);
+
+		//3 bytes remain after b: the 7-byte Idle Packet continues into the next VC 0 frame
+		std::vector<uint8_t> b = createPacket(0x002, dataFieldLength - 3);
+		std::vector<uint8_t> c = createPacket(0x011, 20);
+		multiplexer.push(0, &b[0], b.size());
+		multiplexer.push(1, &c[0], c.size());
+		CCSDS_CHECK(multiplexer.buildFrame(&frame[0]) == 0);
+		decoder.decode(&frame[0]);
+		CCSDS_CHECK(multiplexer.getQueuedBytes(0) == 4);
+		//the lower-priority channel is served next
+		CCSDS_CHECK(multiplexer.buildFrame(&frame[0]) == 1);
+		decoder.decode(&frame[0]);
+		CCSDS_CHECK(multiplexer.buildFrame(&frame[0]) == CCSDSTransferFrameMultiplexer::DefaultIdleFrameVirtualChannelID);
+
+		//the next VC 0 frame starts with the rest of the Idle Packet
+		std::vector<uint8_t> d = createPacket(0x003, 20);
+		multiplexer.push(0, &d[0], d.size());
+		CCSDS_CHECK(multiplexer.buildFrame(&frame[0]) == 0);
+		CCSDSTransferFrameView view(&frame[0], frameLength);
+		CCSDS_CHECK(view.getFirstHeaderPointer() == 4);
+		decoder.decode(&frame[0]);
+		CCSDS_CHECK(listener.packets[0].size() == 3);
+		CCSDS_CHECK(listener.packets[0][1] == b && listener.packets[0][2] == d);
+		CCSDS_CHECK(listener.packets[1].size() == 1 && listener.packets[1][0] == c);
+		CCSDS_CHECK(decoder.getNumberOfFrameErrors() == 0);
+	}
+
+	//frames longer than the TM maximum are rejected
+	{
+		CCSDSTransferFrameMultiplexer multiplexer(CCSDSTransferFrameMultiplexer::MaximumFrameLength, 0x123);
+		CCSDS_CHECK(multiplexer.getFrameLength() == CCSDSTransferFrameMultiplexer::MaximumFrameLength);
+		bool thrown = false;
+		try {
+			CCSDSTransferFrameMultiplexer tooLong(CCSDSTransferFrameMultiplexer::MaximumFrameLength + 1, 0x123);
+		} catch (CCSDSTransferFrameMultiplexerException& e) {
+			thrown = true;
+		}
+		CCSDS_CHECK(thrown);
+	}
+	return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * test_udp_packet_source.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: yuasa
+ */
+
+#include "CCSDSUDPPacketSource.hh"
+#include "CCSDSTest.hh"
+#include <vector>
+
+static std::vector<uint8_t> createPacket(uint16_t apid, size_t userDataLength) {
+	CCSDSSpacePacket packet;
+	packet.getPrimaryHeader()->setAPID(apid);
+	packet.setUserDataField(std::vector<uint8_t>(userDataLength, (uint8_t) apid));
+	packet.setPacketDataLength();
+	return packet.getAsByteVector();
+}
+
+static void send(int socketDescriptor, uint16_t port, const std::vector<uint8_t>& datagram) {
+	struct sockaddr_in socketAddress;
+	memset(&socketAddress, 0, sizeof(socketAddress));
+	socketAddress.sin_family = AF_INET;
+	socketAddress.sin_port = htons(port);
+	inet_pton(AF_INET, "127.0.0.1", &socketAddress.sin_addr);
+	sendto(socketDescriptor, &datagram[0], datagram.size(), 0, (struct sockaddr*) &socketAddress, sizeof(socketAddress));
+}
+
+int main() {
+	//datagrams carrying one packet, two packets followed by garbage, and more bytes than a slot
+	{
+		CCSDSUDPPacketSource source(0, "127.0.0.1", 8, 2, 256);
+		source.setReceiveTimeout(200);
+		uint16_t port = source.getPort();
+		CCSDS_CHECK(port != 0);
+
+		int socketDescriptor = socket(AF_INET, SOCK_DGRAM, 0);
+		send(socketDescriptor, port, createPacket(1, 10));
+		std::vector<uint8_t> datagram = createPacket(2, 20);
+		std::vector<uint8_t> second = createPacket(3, 30);
+		datagram.insert(datagram.end(), second.begin(), second.end());
+		datagram.push_back(0xFF);
+		datagram.push_back(0xFF);
+		datagram.push_back(0xFF);
+		send(socketDescriptor, port, datagram);
+		send(socketDescriptor, port, createPacket(4, 300));
+		close(socketDescriptor);
+
+		std::vector<CCSDSSpacePacketView> views;
+		CCSDSSpacePacketView view;
+		while (source.next(view)) {
+			views.push_back(view);
+		}
+		CCSDS_CHECK(views.size() == 3);
+		for (size_t i = 0; i < views.size(); i++) {
+			CCSDS_CHECK(views[i].getAPIDAsInteger() == i + 1);
+			CCSDS_CHECK(views[i].length == views[i].getTotalPacketLength());
+			CCSDS_CHECK(views[i].getUserDataFieldLength() == 10 * (i + 1));
+			CCSDS_CHECK(views[i].getUserDataField()[0] == i + 1);
+		}
+		CCSDS_CHECK(source.getNumberOfDatagrams() == 3 && source.getNumberOfPackets() == 3);
+		CCSDS_CHECK(source.getNumberOfTruncatedDatagrams() == 1);
+		CCSDS_CHECK(source.getNumberOfInvalidBytes() >= 3 + 256);
+		CCSDS_CHECK(source.getNumberOfDrops() == 0 && source.getNumberOfOverruns() == 0);
+		source.resetCounters();
+		CCSDS_CHECK(source.getNumberOfDatagrams() == 0 && source.getNumberOfPackets() == 0);
+	}
+
+	//a full batch is counted as an overrun, and views of a batch stay valid while the next batch is received
+	{
+		CCSDSUDPPacketSource source(0, "127.0.0.1", 2, 2, 256);
+		source.setReceiveTimeout(200);
+		int socketDescriptor = socket(AF_INET, SOCK_DGRAM, 0);
+		for (uint16_t apid = 1; apid <= 3; apid++) {
+			send(socketDescriptor, source.getPort(), createPacket(apid, 8));
+		}
+		close(socketDescriptor);
+		std::vector<CCSDSSpacePacketView> first, second;
+		CCSDS_CHECK(source.receiveBatch(first) && first.size() == 2);
+		CCSDS_CHECK(source.receiveBatch(second) && second.size() == 1);
+		CCSDS_CHECK(first.size() == 2 && first[0].getAPIDAsInteger() == 1 && first[1].getAPIDAsInteger() == 2);
+		CCSDS_CHECK(second.size() == 1 && second[0].getAPIDAsInteger() == 3);
+		CCSDS_CHECK(source.getNumberOfOverruns() == 1 && source.getNumberOfBatches() == 2);
+		CCSDS_CHECK(!source.receiveBatch(second) && second.empty());
+	}
+
+	//an invalid address
+	{
+		bool thrown = false;
+		try {
+			CCSDSUDPPacketSource source(0, "not an address");
+		} catch (CCSDSUDPPacketSourceException& e) {
+			thrown = true;
+		}
+		CCSDS_CHECK(thrown);
+	}
+	return 0;
+}